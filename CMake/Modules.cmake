@@ -61,21 +61,21 @@ register_module(
   Samples
   sockets
   "ReG_Steer_Samples_Transport_Sockets.c"
-  "ReG_Steer_Sockets_Common.c"
+  "ReG_Steer_Sockets_Common.c;ReG_Steer_Uring.c"
 )
 
 register_module(
   Samples
   files
   "ReG_Steer_Samples_Transport_Files.c"
-  "ReG_Steer_Files_Common.c"
+  "ReG_Steer_Files_Common.c;ReG_Steer_Files_Writer.c;ReG_Steer_Uring.c"
 )
 
 register_module(
   Samples
   proxy
   "ReG_Steer_Samples_Transport_Proxy.c"
-  "ReG_Steer_Sockets_Common.c"
+  "ReG_Steer_Sockets_Common.c;ReG_Steer_Uring.c"
 )
 
 register_module(
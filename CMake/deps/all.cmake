@@ -59,6 +59,9 @@ endif(NOT MALLOC_IN_STDLIB)
 CHECK_SYMBOL_EXISTS(SIGXCPU signal.h REG_HAS_SIGXCPU)
 CHECK_SYMBOL_EXISTS(SIGUSR2 signal.h REG_HAS_SIGUSR2)
 
+# check whether large pooled buffers can ask for huge pages
+CHECK_SYMBOL_EXISTS(MADV_HUGEPAGE sys/mman.h REG_HAS_MADV_HUGEPAGE)
+
 #
 # find the required external libraries and
 # keep a track of them to help with configuring
@@ -102,6 +105,22 @@ if(XDR_FOUND)
   endif(NOT XDR_LIBRARY STREQUAL "XDR_LIBRARY-NOTFOUND")
 endif(XDR_FOUND)
 
+# optional, experimental io_uring backend for the sockets and files
+# samples transports - a synchronous shim that batches packets with
+# the following payload. Driven with raw system calls so only needs
+# the kernel headers
+option(REG_USE_IO_URING "Build the experimental, synchronous io_uring backend for the samples transports (Linux only). Default is OFF." OFF)
+mark_as_advanced(REG_USE_IO_URING)
+if(REG_USE_IO_URING)
+  CHECK_INCLUDE_FILES("linux/io_uring.h" REG_HAS_LINUX_IO_URING_H)
+  CHECK_SYMBOL_EXISTS(__NR_io_uring_setup "sys/syscall.h" REG_HAS_IO_URING_SYSCALLS)
+  if(REG_HAS_LINUX_IO_URING_H AND REG_HAS_IO_URING_SYSCALLS)
+    set(REG_HAS_IO_URING 1)
+  else(REG_HAS_LINUX_IO_URING_H AND REG_HAS_IO_URING_SYSCALLS)
+    message(WARNING "io_uring is not available on this platform - building without it")
+  endif(REG_HAS_LINUX_IO_URING_H AND REG_HAS_IO_URING_SYSCALLS)
+endif(REG_USE_IO_URING)
+
 # Do specific checks for the example applications
 include(deps/Examples)
 
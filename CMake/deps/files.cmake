@@ -49,3 +49,17 @@ if(REG_USE_MODULE_Steering STREQUAL "Files")
   option(REG_KEEP_XML_MESSAGES "Keep file-based xml messages for debugging purposes. Default is OFF." OFF)
   mark_as_advanced(REG_KEEP_XML_MESSAGES)
 endif(REG_USE_MODULE_Steering STREQUAL "Files")
+
+# the write-behind writer for file-based samples needs threads
+find_package(Threads)
+if(CMAKE_USE_PTHREADS_INIT)
+  set(REG_HAS_PTHREADS 1)
+  set(REG_EXTERNAL_LIBS ${REG_EXTERNAL_LIBS} ${CMAKE_THREAD_LIBS_INIT})
+endif(CMAKE_USE_PTHREADS_INIT)
+
+# optional I/O features used by the write-behind writer
+set(CMAKE_REQUIRED_DEFINITIONS -D_GNU_SOURCE)
+CHECK_SYMBOL_EXISTS(O_DIRECT "fcntl.h" REG_HAS_O_DIRECT)
+CHECK_SYMBOL_EXISTS(posix_fadvise "fcntl.h" REG_HAS_POSIX_FADVISE)
+CHECK_SYMBOL_EXISTS(fdatasync "unistd.h" REG_HAS_FDATASYNC)
+set(CMAKE_REQUIRED_DEFINITIONS)
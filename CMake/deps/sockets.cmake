@@ -63,3 +63,15 @@ if(REG_TEST_SOCKETS_H)
   CHECK_SYMBOL_EXISTS(MSG_DONTWAIT ${REG_TEST_SOCKETS_H} REG_HAS_MSG_DONTWAIT)
   CHECK_SYMBOL_EXISTS(MSG_WAITALL  ${REG_TEST_SOCKETS_H} REG_HAS_MSG_WAITALL)
 endif(REG_TEST_SOCKETS_H)
+
+# same-host samples transport over Unix-domain sockets
+CHECK_INCLUDE_FILES("sys/un.h" REG_HAS_SYS_UN_H)
+
+# zero-copy sends of large payloads, with completions reported on the
+# socket's error queue
+set(CMAKE_REQUIRED_DEFINITIONS -D_GNU_SOURCE)
+CHECK_INCLUDE_FILES("time.h;linux/errqueue.h" REG_HAS_LINUX_ERRQUEUE_H)
+if(REG_HAS_LINUX_ERRQUEUE_H)
+  CHECK_SYMBOL_EXISTS(MSG_ZEROCOPY "sys/socket.h" REG_HAS_MSG_ZEROCOPY)
+endif(REG_HAS_LINUX_ERRQUEUE_H)
+set(CMAKE_REQUIRED_DEFINITIONS)
@@ -0,0 +1,664 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+/** @file ReG_Archive_Reader.c
+    @brief Random access to data files written by the file-based
+    samples transport.
+    @author Robert Haines */
+
+#include "ReG_Examples_Config.h"
+#include "ReG_Steer_types.h"
+#include "ReG_Archive_Reader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/** Number of data sets/slices to allocate at a time when scanning */
+#define REG_ARCHIVE_BLOCK 16
+
+/*----------------------------------------------------------------*/
+
+/* Positioned read - does not use or move the file offset so is safe
+   to use from several threads at once */
+static int archive_pread(const int fd, void* buf, size_t nbytes,
+			 unsigned long long offset) {
+  char*  pchar = (char*) buf;
+  long   n;
+
+#ifdef _MSC_VER
+  /* No pread on Windows - not thread-safe */
+  if(_lseeki64(fd, (__int64)offset, SEEK_SET) < 0) return REG_FAILURE;
+  while(nbytes > 0) {
+    if((n = _read(fd, pchar, (unsigned int)nbytes)) <= 0) return REG_FAILURE;
+    pchar += n;
+    nbytes -= n;
+  }
+#else
+  while(nbytes > 0) {
+    n = (long) pread(fd, pchar, nbytes, (off_t)offset);
+    if(n <= 0) return REG_FAILURE;
+    pchar += n;
+    nbytes -= n;
+    offset += n;
+  }
+#endif
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+static void archive_close_fd(const int fd) {
+#ifdef _MSC_VER
+  _close(fd);
+#else
+  close(fd);
+#endif
+}
+
+/*----------------------------------------------------------------*/
+
+static int archive_open_fd(const char* path) {
+#ifdef _MSC_VER
+  return _open(path, _O_RDONLY | _O_BINARY);
+#else
+  return open(path, O_RDONLY);
+#endif
+}
+
+/*----------------------------------------------------------------*/
+
+static void archive_free_index(REG_archive_type* archive) {
+  int i;
+
+  if(archive->datasets) {
+    for(i = 0; i < archive->num_datasets; i++) {
+      free(archive->datasets[i].slices);
+    }
+    free(archive->datasets);
+  }
+  archive->datasets = NULL;
+  archive->num_datasets = 0;
+
+  if(archive->stripes) {
+    for(i = 0; i < archive->num_stripes; i++) {
+      if(archive->stripes[i].fd >= 0) archive_close_fd(archive->stripes[i].fd);
+    }
+    free(archive->stripes);
+  }
+  archive->stripes = NULL;
+  archive->num_stripes = 0;
+}
+
+/*----------------------------------------------------------------*/
+
+/* Add a stripe file to the table and open it. If it isn't where it
+   was written, look for it alongside the archive itself. */
+static int archive_add_stripe(REG_archive_type* archive,
+			      const char* archive_path,
+			      const char* stripe_path) {
+  REG_archive_stripe_type* stripe;
+  const char*              base;
+  const char*              dir_end;
+  void*                    ptr;
+
+  ptr = realloc(archive->stripes, (archive->num_stripes + 1) *
+		sizeof(REG_archive_stripe_type));
+  if(!ptr) return REG_FAILURE;
+  archive->stripes = (REG_archive_stripe_type*) ptr;
+
+  stripe = &(archive->stripes[archive->num_stripes++]);
+  strncpy(stripe->path, stripe_path, REG_ARCHIVE_PATH_LEN - 1);
+  stripe->path[REG_ARCHIVE_PATH_LEN - 1] = '\0';
+
+  if((stripe->fd = archive_open_fd(stripe->path)) >= 0) return REG_SUCCESS;
+
+  base = strrchr(stripe_path, '/');
+  base = base ? base + 1 : stripe_path;
+  dir_end = strrchr(archive_path, '/');
+  if(dir_end) {
+    snprintf(stripe->path, REG_ARCHIVE_PATH_LEN, "%.*s/%s",
+	     (int)(dir_end - archive_path), archive_path, base);
+  }
+  else {
+    snprintf(stripe->path, REG_ARCHIVE_PATH_LEN, "%s", base);
+  }
+
+  if((stripe->fd = archive_open_fd(stripe->path)) < 0) {
+    fprintf(stderr, "REG_archive_open: cannot open stripe file %s\n",
+	    stripe_path);
+  }
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+static int archive_read_index(REG_archive_type* archive,
+			      const char* path) {
+  unsigned char      trailer[REG_ARCHIVE_TRAILER_SIZE];
+  unsigned char*     index;
+  unsigned char*     p;
+  unsigned char*     end;
+  unsigned long long index_offset;
+  unsigned long      index_bytes;
+  unsigned long      version;
+  size_t             dataset_size;
+  size_t             slice_size;
+  size_t             left;
+  char               stripe_path[REG_ARCHIVE_PATH_LEN];
+  REG_archive_dataset_type* ds;
+  REG_archive_slice_type*   slice;
+  int                i;
+  int                j;
+  int                k;
+
+  if(archive->file_size < REG_ARCHIVE_TRAILER_SIZE) return REG_FAILURE;
+
+  if(archive_pread(archive->fd, trailer, REG_ARCHIVE_TRAILER_SIZE,
+		   archive->file_size - REG_ARCHIVE_TRAILER_SIZE)
+     != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  if(memcmp(trailer, REG_ARCHIVE_MAGIC, REG_ARCHIVE_MAGIC_LEN)) {
+    return REG_FAILURE;
+  }
+
+  /* Version 1 records are shorter and have no stripe information */
+  version = REG_ARCHIVE_GET32(&trailer[8]);
+  if(version == 1) {
+    dataset_size = REG_ARCHIVE_DATASET_SIZE_V1;
+    slice_size = REG_ARCHIVE_SLICE_SIZE_V1;
+  }
+  else if(version == REG_ARCHIVE_VERSION) {
+    dataset_size = REG_ARCHIVE_DATASET_SIZE;
+    slice_size = REG_ARCHIVE_SLICE_SIZE;
+  }
+  else {
+    fprintf(stderr, "REG_archive_open: unsupported index version %lu\n",
+	    version);
+    return REG_FAILURE;
+  }
+
+  archive->num_datasets = (int) REG_ARCHIVE_GET32(&trailer[12]);
+  index_offset = REG_ARCHIVE_GET64(&trailer[16]);
+  index_bytes = REG_ARCHIVE_GET32(&trailer[24]);
+  archive->alignment = (int) REG_ARCHIVE_GET32(&trailer[28]);
+
+  /* Nothing in the trailer can be trusted, so check it without
+     letting the sums overflow */
+  if(archive->num_datasets < 0) {
+    fprintf(stderr, "REG_archive_open: index is corrupt\n");
+    return REG_FAILURE;
+  }
+  if(index_bytes > archive->file_size - REG_ARCHIVE_TRAILER_SIZE ||
+     index_offset > archive->file_size - REG_ARCHIVE_TRAILER_SIZE -
+     index_bytes) {
+    fprintf(stderr, "REG_archive_open: index extends beyond end of file\n");
+    return REG_FAILURE;
+  }
+
+  if(!(index = (unsigned char*) malloc(index_bytes))) {
+    return REG_FAILURE;
+  }
+  if(archive_pread(archive->fd, index, index_bytes,
+		   index_offset) != REG_SUCCESS) {
+    free(index);
+    return REG_FAILURE;
+  }
+
+  archive->datasets = (REG_archive_dataset_type*)
+    calloc(archive->num_datasets ? archive->num_datasets : 1,
+	   sizeof(REG_archive_dataset_type));
+  if(!archive->datasets) {
+    free(index);
+    return REG_FAILURE;
+  }
+
+  p = index;
+  end = index + index_bytes;
+  for(i = 0; i < archive->num_datasets; i++) {
+    if((size_t)(end - p) < dataset_size) break;
+
+    ds = &(archive->datasets[i]);
+    ds->seqnum = (int) REG_ARCHIVE_GET32(&p[0]);
+    ds->num_slices = (int) REG_ARCHIVE_GET32(&p[4]);
+    ds->header_offset = REG_ARCHIVE_GET64(&p[8]);
+    memcpy(ds->label, &p[16], REG_ARCHIVE_LABEL_LEN);
+    ds->label[REG_ARCHIVE_LABEL_LEN - 1] = '\0';
+    if(version > 1) {
+      ds->num_stripes = (int) REG_ARCHIVE_GET32(&p[16 + REG_ARCHIVE_LABEL_LEN]);
+    }
+    ds->first_stripe = archive->num_stripes;
+    p += dataset_size;
+
+    /* Check the counts by division so that a corrupt one can't
+       overflow the check */
+    if(ds->num_slices < 0 || ds->num_stripes < 0) break;
+    left = (size_t)(end - p);
+    if((size_t)ds->num_slices > left / slice_size) break;
+    left -= (size_t)ds->num_slices * slice_size;
+    if((size_t)ds->num_stripes > left / REG_ARCHIVE_PATH_LEN) break;
+
+    ds->slices = (REG_archive_slice_type*)
+      calloc(ds->num_slices ? ds->num_slices : 1,
+	     sizeof(REG_archive_slice_type));
+    if(!ds->slices) break;
+
+    for(j = 0; j < ds->num_slices; j++) {
+      slice = &(ds->slices[j]);
+      slice->type = (int) REG_ARCHIVE_GET32(&p[0]);
+      slice->count = (int) REG_ARCHIVE_GET32(&p[4]);
+      slice->num_bytes = REG_ARCHIVE_GET64(&p[8]);
+      slice->is_fortran = (int) REG_ARCHIVE_GET32(&p[16]);
+      for(k = 0; k < 3; k++) {
+	slice->tot[k] = (int) REG_ARCHIVE_GET32(&p[20 + 4*k]);
+	slice->n[k] = (int) REG_ARCHIVE_GET32(&p[32 + 4*k]);
+	slice->start[k] = (int) REG_ARCHIVE_GET32(&p[44 + 4*k]);
+      }
+      slice->header_offset = REG_ARCHIVE_GET64(&p[56]);
+      slice->data_offset = REG_ARCHIVE_GET64(&p[64]);
+      slice->stripe = -1;
+      if(version > 1 && (k = (int) REG_ARCHIVE_GET32(&p[72])) >= 0) {
+	if(k >= ds->num_stripes) break;
+	slice->stripe = ds->first_stripe + k;
+      }
+      p += slice_size;
+    }
+    if(j != ds->num_slices) break;
+
+    for(j = 0; j < ds->num_stripes; j++) {
+      memcpy(stripe_path, p, REG_ARCHIVE_PATH_LEN);
+      stripe_path[REG_ARCHIVE_PATH_LEN - 1] = '\0';
+      if(archive_add_stripe(archive, path, stripe_path) != REG_SUCCESS) break;
+      p += REG_ARCHIVE_PATH_LEN;
+    }
+    if(j != ds->num_stripes) break;
+  }
+  free(index);
+
+  if(i != archive->num_datasets) {
+    fprintf(stderr, "REG_archive_open: index is corrupt\n");
+    archive->num_datasets = i;
+    return REG_FAILURE;
+  }
+
+  archive->indexed = 1;
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+/* Read the next packet, skipping any alignment padding before it.
+   On return @p offset is that of the start of the packet. */
+static int archive_next_packet(const REG_archive_type* archive,
+			       unsigned long long* offset,
+			       char* packet) {
+  size_t n;
+
+  while(1) {
+    if(*offset + REG_PACKET_SIZE > archive->file_size ||
+       archive_pread(archive->fd, packet, REG_PACKET_SIZE,
+		     *offset) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+
+    for(n = 0; n < REG_PACKET_SIZE && packet[n] == '\0'; n++);
+
+    if(n == 0) break;
+    *offset += n;
+  }
+  packet[REG_PACKET_SIZE - 1] = '\0';
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+/* Build the index of a file that doesn't have one by walking the
+   packet stream */
+static int archive_scan(REG_archive_type* archive, const char* path) {
+  char                      packet[REG_PACKET_SIZE];
+  char                      stripe_path[REG_ARCHIVE_PATH_LEN];
+  char*                     pchar;
+  int                       k;
+  unsigned long long        offset = 0;
+  REG_archive_dataset_type* ds;
+  REG_archive_slice_type*   slice;
+  void*                     ptr;
+  int                       num_bytes;
+  int                       max_datasets = 0;
+  int                       max_slices;
+
+  archive->num_datasets = 0;
+
+  while(offset < archive->file_size &&
+	archive_next_packet(archive, &offset, packet) == REG_SUCCESS &&
+	!strncmp(packet, REG_DATA_HEADER, strlen(REG_DATA_HEADER))) {
+
+    if(archive->num_datasets == max_datasets) {
+      ptr = realloc(archive->datasets, (max_datasets + REG_ARCHIVE_BLOCK) *
+		    sizeof(REG_archive_dataset_type));
+      if(!ptr) return REG_FAILURE;
+      archive->datasets = (REG_archive_dataset_type*) ptr;
+      max_datasets += REG_ARCHIVE_BLOCK;
+    }
+    ds = &(archive->datasets[archive->num_datasets++]);
+    memset(ds, 0, sizeof(REG_archive_dataset_type));
+    ds->seqnum = -1;
+    ds->header_offset = offset;
+    offset += REG_PACKET_SIZE;
+    max_slices = 0;
+
+    /* Payloads may be in stripe files - we can only look for them
+       alongside this file */
+    ds->first_stripe = archive->num_stripes;
+    if((pchar = strstr(packet, "<Stripes>")) &&
+       sscanf(pchar, REG_STRIPES_FORMAT, &(ds->num_stripes)) == 1) {
+      for(k = 0; k < ds->num_stripes; k++) {
+	snprintf(stripe_path, REG_ARCHIVE_PATH_LEN, "%s%s%d", path,
+		 REG_STRIPE_SUFFIX, k);
+	if(archive_add_stripe(archive, path, stripe_path) != REG_SUCCESS) {
+	  return REG_FAILURE;
+	}
+      }
+    }
+
+    while(1) {
+      if(archive_next_packet(archive, &offset, packet) != REG_SUCCESS) {
+	fprintf(stderr, "REG_archive_open: truncated data set\n");
+	return REG_FAILURE;
+      }
+
+      if(!strncmp(packet, REG_DATA_FOOTER, strlen(REG_DATA_FOOTER))) {
+	offset += REG_PACKET_SIZE;
+	break;
+      }
+
+      if(strncmp(packet, "<ReG_data_slice_header>", 23)) {
+	fprintf(stderr, "REG_archive_open: unexpected packet at offset %llu\n",
+		offset);
+	return REG_FAILURE;
+      }
+
+      if(ds->num_slices == max_slices) {
+	ptr = realloc(ds->slices, (max_slices + REG_ARCHIVE_BLOCK) *
+		      sizeof(REG_archive_slice_type));
+	if(!ptr) return REG_FAILURE;
+	ds->slices = (REG_archive_slice_type*) ptr;
+	max_slices += REG_ARCHIVE_BLOCK;
+      }
+      slice = &(ds->slices[ds->num_slices]);
+      memset(slice, 0, sizeof(REG_archive_slice_type));
+      slice->header_offset = offset;
+      offset += REG_PACKET_SIZE;
+
+      /* Type, count, bytes and ordering, then end of header */
+      if(archive_pread(archive->fd, packet, REG_PACKET_SIZE,
+		       offset) != REG_SUCCESS ||
+	 sscanf(packet, "<Data_type>%d</Data_type>", &(slice->type)) != 1) {
+	return REG_FAILURE;
+      }
+      offset += REG_PACKET_SIZE;
+      if(archive_pread(archive->fd, packet, REG_PACKET_SIZE,
+		       offset) != REG_SUCCESS ||
+	 sscanf(packet, "<Num_objects>%d</Num_objects>", &(slice->count)) != 1) {
+	return REG_FAILURE;
+      }
+      offset += REG_PACKET_SIZE;
+      if(archive_pread(archive->fd, packet, REG_PACKET_SIZE,
+		       offset) != REG_SUCCESS ||
+	 sscanf(packet, "<Num_bytes>%d</Num_bytes>", &num_bytes) != 1) {
+	return REG_FAILURE;
+      }
+      slice->num_bytes = (unsigned long long) num_bytes;
+      offset += REG_PACKET_SIZE;
+      if(archive_pread(archive->fd, packet, REG_PACKET_SIZE,
+		       offset) != REG_SUCCESS) {
+	return REG_FAILURE;
+      }
+      packet[REG_PACKET_SIZE - 1] = '\0';
+      slice->is_fortran = strstr(packet, "FORTRAN") ? 1 : 0;
+      offset += 2*REG_PACKET_SIZE;
+
+      slice->stripe = -1;
+      if(ds->num_stripes > 0) {
+	/* Payload is in a stripe file */
+	if(archive_pread(archive->fd, packet, REG_PACKET_SIZE,
+			 offset) != REG_SUCCESS) {
+	  return REG_FAILURE;
+	}
+	packet[REG_PACKET_SIZE - 1] = '\0';
+	if(sscanf(packet, REG_STRIPE_FORMAT, &k, &(slice->data_offset)) != 2 ||
+	   k < 0 || k >= ds->num_stripes) {
+	  fprintf(stderr, "REG_archive_open: bad stripe packet at offset "
+		  "%llu\n", offset);
+	  return REG_FAILURE;
+	}
+	slice->stripe = ds->first_stripe + k;
+	offset += REG_PACKET_SIZE;
+      }
+      else {
+	slice->data_offset = offset;
+	offset += slice->num_bytes;
+      }
+      ds->num_slices++;
+    }
+  }
+
+  archive->indexed = 0;
+  return archive->num_datasets > 0 ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*----------------------------------------------------------------*/
+
+int REG_archive_open(const char* path, REG_archive_type* archive) {
+  struct stat st;
+
+  memset(archive, 0, sizeof(REG_archive_type));
+
+  if((archive->fd = archive_open_fd(path)) < 0) {
+    fprintf(stderr, "REG_archive_open: failed to open %s\n", path);
+    return REG_FAILURE;
+  }
+
+  if(fstat(archive->fd, &st) != 0) {
+    REG_archive_close(archive);
+    return REG_FAILURE;
+  }
+  archive->file_size = (unsigned long long) st.st_size;
+
+  if(archive_read_index(archive, path) == REG_SUCCESS) {
+    return REG_SUCCESS;
+  }
+
+  /* No (usable) index - walk the file instead */
+  archive_free_index(archive);
+  archive->alignment = 0;
+
+  if(archive_scan(archive, path) != REG_SUCCESS) {
+    fprintf(stderr, "REG_archive_open: %s is not a ReG data file\n", path);
+    REG_archive_close(archive);
+    return REG_FAILURE;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+void REG_archive_close(REG_archive_type* archive) {
+
+  archive_free_index(archive);
+
+  if(archive->fd >= 0) archive_close_fd(archive->fd);
+
+  memset(archive, 0, sizeof(REG_archive_type));
+  archive->fd = -1;
+}
+
+/*----------------------------------------------------------------*/
+
+const REG_archive_slice_type* REG_archive_slice(const REG_archive_type* archive,
+						const int dataset,
+						const int slice) {
+  if(dataset < 0 || dataset >= archive->num_datasets) return NULL;
+  if(slice < 0 || slice >= archive->datasets[dataset].num_slices) return NULL;
+
+  return &(archive->datasets[dataset].slices[slice]);
+}
+
+/*----------------------------------------------------------------*/
+
+int REG_archive_read(const REG_archive_type*       archive,
+		     const REG_archive_slice_type* slice,
+		     const unsigned long long      offset,
+		     const size_t                  num_bytes,
+		     void*                         buffer) {
+
+  if(offset + num_bytes > slice->num_bytes) {
+    fprintf(stderr, "REG_archive_read: request extends beyond end "
+	    "of slice\n");
+    return REG_FAILURE;
+  }
+
+  if(slice->stripe >= 0) {
+    if(slice->stripe >= archive->num_stripes ||
+       archive->stripes[slice->stripe].fd < 0) {
+      fprintf(stderr, "REG_archive_read: stripe file is not available\n");
+      return REG_FAILURE;
+    }
+    return archive_pread(archive->stripes[slice->stripe].fd, buffer,
+			 num_bytes, slice->data_offset + offset);
+  }
+
+  return archive_pread(archive->fd, buffer, num_bytes,
+		       slice->data_offset + offset);
+}
+
+/*----------------------------------------------------------------*/
+
+int REG_archive_decode(const int   type,
+		       const void* raw,
+		       const size_t count,
+		       void*       out) {
+  const unsigned char* p = (const unsigned char*) raw;
+  unsigned long long   w;
+  unsigned int         u;
+  float                f;
+  double               d;
+  size_t               i;
+
+  switch(type) {
+
+  case REG_XDR_INT:
+    for(i = 0; i < count; i++, p += 4) {
+      ((int*)out)[i] = (int) REG_ARCHIVE_GET32(p);
+    }
+    break;
+
+  case REG_XDR_LONG:
+    /* XDR longs are always four bytes */
+    for(i = 0; i < count; i++, p += 4) {
+      ((long*)out)[i] = (long)(int) REG_ARCHIVE_GET32(p);
+    }
+    break;
+
+  case REG_XDR_FLOAT:
+    for(i = 0; i < count; i++, p += 4) {
+      u = (unsigned int) REG_ARCHIVE_GET32(p);
+      memcpy(&f, &u, sizeof(float));
+      ((float*)out)[i] = f;
+    }
+    break;
+
+  case REG_XDR_DOUBLE:
+    for(i = 0; i < count; i++, p += 8) {
+      w = REG_ARCHIVE_GET64(p);
+      memcpy(&d, &w, sizeof(double));
+      ((double*)out)[i] = d;
+    }
+    break;
+
+  case REG_INT:
+    memcpy(out, raw, count*sizeof(int));
+    break;
+
+  case REG_LONG:
+    memcpy(out, raw, count*sizeof(long));
+    break;
+
+  case REG_FLOAT:
+    memcpy(out, raw, count*sizeof(float));
+    break;
+
+  case REG_DOUBLE:
+    memcpy(out, raw, count*sizeof(double));
+    break;
+
+  case REG_CHAR:
+  case REG_BIN:
+    memcpy(out, raw, count);
+    break;
+
+  default:
+    fprintf(stderr, "REG_archive_decode: unrecognised data type %d\n", type);
+    return REG_FAILURE;
+  }
+
+  return REG_SUCCESS;
+}
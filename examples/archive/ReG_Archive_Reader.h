@@ -0,0 +1,173 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+#ifndef __REG_ARCHIVE_READER_H__
+#define __REG_ARCHIVE_READER_H__
+
+/** @file ReG_Archive_Reader.h
+    @brief A small library for random access to data files written by
+    the file-based samples transport.
+
+    A file is opened with REG_archive_open() which reads the index
+    from the end of the file (see ReG_Steer_Samples_Archive.h). Files
+    written before the index was introduced are scanned once to build
+    the same index in memory. Any slice can then be read directly with
+    REG_archive_read(), which does not move a shared file position and
+    so may be called from several threads at once, @e e.g. to read
+    different slices or different parts of one large slice in parallel.
+    Payloads that were striped over several directories are read from
+    the stripe files named in the index, or from alongside the file
+    if they have since been moved there.
+    @author Robert Haines */
+
+#include <stddef.h>
+#include "ReG_Steer_Samples_Archive.h"
+
+/** Description of a data set held in an archive */
+typedef struct {
+  /** Sequence number the data set was emitted with (-1 if unknown) */
+  int                     seqnum;
+  /** Label of the IOType that emitted the data set */
+  char                    label[REG_ARCHIVE_LABEL_LEN];
+  /** Offset of the data set header packet */
+  unsigned long long      header_offset;
+  /** Number of slices in the data set */
+  int                     num_slices;
+  /** The slices themselves */
+  REG_archive_slice_type* slices;
+  /** Number of stripe files holding the payloads of this data set */
+  int                     num_stripes;
+  /** Index in the archive's table of stripe files of this data set's
+      first stripe file */
+  int                     first_stripe;
+} REG_archive_dataset_type;
+
+/** A stripe file that holds slice payloads */
+typedef struct {
+  /** Name of the stripe file */
+  char path[REG_ARCHIVE_PATH_LEN];
+  /** File descriptor of the open file, -1 if it could not be opened */
+  int  fd;
+} REG_archive_stripe_type;
+
+/** An open archive */
+typedef struct {
+  /** File descriptor of the open file */
+  int                       fd;
+  /** Size of the file in bytes */
+  unsigned long long        file_size;
+  /** Whether the index was read from the file (1) or built by
+      scanning it (0) */
+  int                       indexed;
+  /** Alignment applied to slice payloads by the writer, 0 if none */
+  int                       alignment;
+  /** Number of data sets in the file */
+  int                       num_datasets;
+  /** The data sets themselves */
+  REG_archive_dataset_type* datasets;
+  /** Number of stripe files used by all data sets */
+  int                       num_stripes;
+  /** The stripe files. The @p stripe field of a slice indexes this
+      table once the archive is open. */
+  REG_archive_stripe_type*  stripes;
+} REG_archive_type;
+
+/** @param path Name of the file to open
+    @param archive Archive structure to fill in
+    @return REG_SUCCESS or REG_FAILURE
+
+    Open the named file and any stripe files and load (or build) its
+    index */
+int REG_archive_open(const char* path, REG_archive_type* archive);
+
+/** @param archive Archive to close
+
+    Close the file and any stripe files and free the index */
+void REG_archive_close(REG_archive_type* archive);
+
+/** @param archive An open archive
+    @param dataset Index of data set (0 to num_datasets-1)
+    @param slice Index of slice within the data set
+    @return Pointer to the slice description or NULL if out of range
+
+    Look up a slice in O(1) */
+const REG_archive_slice_type* REG_archive_slice(const REG_archive_type* archive,
+						const int dataset,
+						const int slice);
+
+/** @param archive An open archive
+    @param slice Slice to read from
+    @param offset Offset into the payload of the slice
+    @param num_bytes Number of bytes to read
+    @param buffer Buffer to read into
+    @return REG_SUCCESS or REG_FAILURE
+
+    Read all or part of the raw (as written, @e i.e. usually XDR
+    encoded) payload of a slice. Safe to call concurrently from
+    several threads on the same archive. */
+int REG_archive_read(const REG_archive_type*       archive,
+		     const REG_archive_slice_type* slice,
+		     const unsigned long long      offset,
+		     const size_t                  num_bytes,
+		     void*                         buffer);
+
+/** @param type Type of the data as held in the slice description
+    @param raw Raw data as read by REG_archive_read()
+    @param count Number of objects to decode
+    @param out Buffer to receive native data
+    @return REG_SUCCESS or REG_FAILURE
+
+    Decode XDR encoded data into native types. For REG_XDR_INT,
+    REG_XDR_FLOAT, REG_XDR_DOUBLE and REG_XDR_LONG @p out must hold
+    @p count ints, floats, doubles or longs respectively. Data of
+    native types (REG_INT, REG_CHAR @e etc.) is copied unchanged. */
+int REG_archive_decode(const int   type,
+		       const void* raw,
+		       const size_t count,
+		       void*       out);
+
+#endif /* __REG_ARCHIVE_READER_H__ */
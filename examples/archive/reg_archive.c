@@ -0,0 +1,281 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+/** @file reg_archive.c
+    @brief Command line tool to inspect data files written by the
+    file-based samples transport.
+
+    Usage:
+    - reg_archive list &lt;file&gt;
+    - reg_archive dump &lt;file&gt; &lt;dataset&gt; &lt;slice&gt; [max_values]
+    - reg_archive extract &lt;file&gt; &lt;dataset&gt; &lt;slice&gt; &lt;out_file&gt;
+
+    @c extract writes the slice payload decoded into native types.
+    @author Robert Haines */
+
+#include "ReG_Examples_Config.h"
+#include "ReG_Steer_types.h"
+#include "ReG_Archive_Reader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*-------------------------------------------------------------------------*/
+
+static const char* type_name(const int type) {
+  switch(type) {
+  case REG_INT:        return "int";
+  case REG_FLOAT:      return "float";
+  case REG_DOUBLE:     return "double";
+  case REG_CHAR:       return "char";
+  case REG_XDR_INT:    return "xdr_int";
+  case REG_XDR_FLOAT:  return "xdr_float";
+  case REG_XDR_DOUBLE: return "xdr_double";
+  case REG_BIN:        return "binary";
+  case REG_LONG:       return "long";
+  case REG_XDR_LONG:   return "xdr_long";
+  default:             return "unknown";
+  }
+}
+
+/*-------------------------------------------------------------------------*/
+
+/* Size of one decoded object of the given type */
+static size_t native_size(const int type) {
+  switch(type) {
+  case REG_INT:
+  case REG_XDR_INT:    return sizeof(int);
+  case REG_FLOAT:
+  case REG_XDR_FLOAT:  return sizeof(float);
+  case REG_DOUBLE:
+  case REG_XDR_DOUBLE: return sizeof(double);
+  case REG_LONG:
+  case REG_XDR_LONG:   return sizeof(long);
+  default:             return 1;
+  }
+}
+
+/*-------------------------------------------------------------------------*/
+
+static void usage(const char* prog) {
+  fprintf(stderr, "Usage: %s list <file>\n"
+	  "       %s dump <file> <dataset> <slice> [max_values]\n"
+	  "       %s extract <file> <dataset> <slice> <out_file>\n",
+	  prog, prog, prog);
+}
+
+/*-------------------------------------------------------------------------*/
+
+static int list(const REG_archive_type* archive) {
+  const REG_archive_dataset_type* ds;
+  const REG_archive_slice_type*   slice;
+  int i;
+  int j;
+
+  printf("%s index, %d data set(s), payload alignment %d\n",
+	 archive->indexed ? "Stored" : "Scanned",
+	 archive->num_datasets, archive->alignment);
+
+  for(i = 0; i < archive->num_datasets; i++) {
+    ds = &(archive->datasets[i]);
+    printf("Data set %d: label '%s', seqnum %d, %d slice(s)\n",
+	   i, ds->label, ds->seqnum, ds->num_slices);
+    for(j = 0; j < ds->num_stripes; j++) {
+      printf("  Stripe %d: %s\n", j,
+	     archive->stripes[ds->first_stripe + j].path);
+    }
+
+    for(j = 0; j < ds->num_slices; j++) {
+      slice = &(ds->slices[j]);
+      printf("  Slice %d: %s x %d, %llu bytes at offset %llu, %s order, "
+	     "array %dx%dx%d, sub-array %dx%dx%d at (%d,%d,%d)\n",
+	     j, type_name(slice->type), slice->count, slice->num_bytes,
+	     slice->data_offset, slice->is_fortran ? "Fortran" : "C",
+	     slice->tot[0], slice->tot[1], slice->tot[2],
+	     slice->n[0], slice->n[1], slice->n[2],
+	     slice->start[0], slice->start[1], slice->start[2]);
+      if(slice->stripe >= 0) {
+	printf("    (in stripe %d)\n", slice->stripe - ds->first_stripe);
+      }
+    }
+  }
+
+  return REG_SUCCESS;
+}
+
+/*-------------------------------------------------------------------------*/
+
+static void* read_slice(const REG_archive_type*       archive,
+			const REG_archive_slice_type* slice) {
+  void* raw;
+  void* native;
+
+  raw = malloc(slice->num_bytes ? (size_t)slice->num_bytes : 1);
+  native = malloc(slice->count ? slice->count*native_size(slice->type) : 1);
+
+  if(!raw || !native ||
+     REG_archive_read(archive, slice, 0, (size_t)slice->num_bytes,
+		      raw) != REG_SUCCESS ||
+     REG_archive_decode(slice->type, raw, (size_t)slice->count,
+			native) != REG_SUCCESS) {
+    free(raw);
+    free(native);
+    return NULL;
+  }
+
+  free(raw);
+  return native;
+}
+
+/*-------------------------------------------------------------------------*/
+
+static int dump(const REG_archive_type*       archive,
+		const REG_archive_slice_type* slice,
+		int                           max_values) {
+  void* data;
+  int   i;
+
+  if(!(data = read_slice(archive, slice))) return REG_FAILURE;
+
+  if(max_values < 0 || max_values > slice->count) max_values = slice->count;
+
+  for(i = 0; i < max_values; i++) {
+    switch(slice->type) {
+    case REG_INT:
+    case REG_XDR_INT:
+      printf("%d\n", ((int*)data)[i]);
+      break;
+    case REG_FLOAT:
+    case REG_XDR_FLOAT:
+      printf("%.9g\n", ((float*)data)[i]);
+      break;
+    case REG_DOUBLE:
+    case REG_XDR_DOUBLE:
+      printf("%.17g\n", ((double*)data)[i]);
+      break;
+    case REG_LONG:
+    case REG_XDR_LONG:
+      printf("%ld\n", ((long*)data)[i]);
+      break;
+    default:
+      putchar(((char*)data)[i]);
+      break;
+    }
+  }
+
+  free(data);
+  return REG_SUCCESS;
+}
+
+/*-------------------------------------------------------------------------*/
+
+static int extract(const REG_archive_type*       archive,
+		   const REG_archive_slice_type* slice,
+		   const char*                   out_name) {
+  void*  data;
+  FILE*  fp;
+  size_t nbytes;
+  int    status = REG_SUCCESS;
+
+  if(!(data = read_slice(archive, slice))) return REG_FAILURE;
+
+  if(!(fp = fopen(out_name, "wb"))) {
+    fprintf(stderr, "Failed to open %s\n", out_name);
+    free(data);
+    return REG_FAILURE;
+  }
+
+  nbytes = slice->count*native_size(slice->type);
+  if(fwrite(data, 1, nbytes, fp) != nbytes) status = REG_FAILURE;
+
+  fclose(fp);
+  free(data);
+  return status;
+}
+
+/*-------------------------------------------------------------------------*/
+
+int main(int argc, char** argv) {
+  REG_archive_type              archive;
+  const REG_archive_slice_type* slice = NULL;
+  int                           status;
+
+  if(argc < 3) {
+    usage(argv[0]);
+    return REG_FAILURE;
+  }
+
+  if(REG_archive_open(argv[2], &archive) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  if(argc >= 5) {
+    if(!(slice = REG_archive_slice(&archive, atoi(argv[3]), atoi(argv[4])))) {
+      fprintf(stderr, "No slice %s in data set %s\n", argv[4], argv[3]);
+      REG_archive_close(&archive);
+      return REG_FAILURE;
+    }
+  }
+
+  if(!strcmp(argv[1], "list")) {
+    status = list(&archive);
+  }
+  else if(!strcmp(argv[1], "dump") && slice) {
+    status = dump(&archive, slice, argc > 5 ? atoi(argv[5]) : -1);
+  }
+  else if(!strcmp(argv[1], "extract") && slice && argc > 5) {
+    status = extract(&archive, slice, argv[5]);
+  }
+  else {
+    usage(argv[0]);
+    status = REG_FAILURE;
+  }
+
+  REG_archive_close(&archive);
+  return status;
+}
@@ -0,0 +1,341 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+/** @file xml_bench.c
+    @brief Compare the time taken to parse large steering messages
+    with the DOM and the single pass (SAX) xml parsers.
+
+    Usage: xml_bench [num_params] [num_log_entries] [num_iterations]
+
+    A parameter definitions message and a parameter log message are
+    built with the library's own message writer and each is parsed
+    repeatedly by both parsers. The results of the two parsers are
+    checked against each other before any times are reported.
+    @author Robert Haines */
+
+#include "ReG_Steer_Config.h"
+#include "ReG_Steer_types.h"
+#include "ReG_Steer_Common.h"
+#include "ReG_Steer_XML.h"
+#include "ReG_Steer_SAX.h"
+#include "ReG_Steer_Number.h"
+
+#include <sys/time.h>
+
+/** Parameters logged in each entry of the log message */
+#define BENCH_PARAMS_PER_ENTRY 8
+
+int  make_param_defs(Msg_writer_type* msg, int num_params);
+int  make_log(Msg_writer_type* msg, int num_entries);
+int  parse_dom(Msg_writer_type* msg, struct msg_struct* result);
+int  parse_sax(Msg_writer_type* msg, struct msg_struct* result);
+long count_params(struct msg_struct* result, long* num_chars);
+int  run_bench(const char* name, Msg_writer_type* msg, int num_iter);
+double wall_time();
+
+/*-------------------------------------------------------------------------*/
+
+int main(int argc, char** argv) {
+
+  Msg_writer_type msg;
+  int num_params = 1000;
+  int num_entries = 500;
+  int num_iter = 100;
+  int status = REG_SUCCESS;
+
+  if(argc > 1) num_params = atoi(argv[1]);
+  if(argc > 2) num_entries = atoi(argv[2]);
+  if(argc > 3) num_iter = atoi(argv[3]);
+
+  if(num_params < 1 || num_entries < 1 || num_iter < 1) {
+    fprintf(stderr, "Usage: %s [num_params] [num_log_entries] "
+	    "[num_iterations]\n", argv[0]);
+    return REG_FAILURE;
+  }
+
+  Init_xml_parser();
+
+  printf("%-24s %10s %12s %12s %8s\n", "message", "bytes", "DOM (us)",
+	 "SAX (us)", "speed-up");
+
+  if(make_param_defs(&msg, num_params) != REG_SUCCESS ||
+     run_bench("Param_defs", &msg, num_iter) != REG_SUCCESS) {
+    status = REG_FAILURE;
+  }
+  free(msg.buf);
+
+  if(make_log(&msg, num_entries) != REG_SUCCESS ||
+     run_bench("Steer_log", &msg, num_iter) != REG_SUCCESS) {
+    status = REG_FAILURE;
+  }
+  free(msg.buf);
+
+  Cleanup_xml_parser();
+
+  return status;
+}
+
+/*-------------------------------------------------------------------------*/
+
+int make_param_defs(Msg_writer_type* msg, int num_params) {
+
+  int i;
+  char label[32];
+  char value[REG_NUM_BUF_LEN];
+  int status;
+
+  if(Init_msg_writer(msg, REG_MAX_MSG_SIZE, REG_WIRE_XML) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  status = Msg_writer_header(msg);
+  if(status == REG_SUCCESS) {
+    status = Msg_writer_begin(msg, MSG_TAG_PARAM_DEFS);
+  }
+
+  for(i = 0; i < num_params && status == REG_SUCCESS; i++) {
+    snprintf(label, sizeof(label), "parameter_%d", i);
+    Format_double(i/3.0, value);
+    if(Msg_writer_begin(msg, MSG_TAG_PARAM) != REG_SUCCESS ||
+       Msg_writer_element_string(msg, MSG_TAG_LABEL, label) != REG_SUCCESS ||
+       Msg_writer_element_int(msg, MSG_TAG_STEERABLE, i%2) != REG_SUCCESS ||
+       Msg_writer_element_int(msg, MSG_TAG_TYPE, REG_DBL) != REG_SUCCESS ||
+       Msg_writer_element_int(msg, MSG_TAG_HANDLE, i) != REG_SUCCESS ||
+       Msg_writer_element_string(msg, MSG_TAG_VALUE, value) != REG_SUCCESS ||
+       Msg_writer_element_string(msg, MSG_TAG_IS_INTERNAL, "FALSE") !=
+       REG_SUCCESS ||
+       Msg_writer_element_string(msg, MSG_TAG_MIN_VALUE,
+				 "-10000000000") != REG_SUCCESS ||
+       Msg_writer_element_string(msg, MSG_TAG_MAX_VALUE,
+				 "10000000000") != REG_SUCCESS) {
+      status = REG_FAILURE;
+    }
+    else {
+      status = Msg_writer_end(msg, MSG_TAG_PARAM);
+    }
+  }
+
+  if(status == REG_SUCCESS) {
+    status = Msg_writer_end(msg, MSG_TAG_PARAM_DEFS);
+  }
+  if(status == REG_SUCCESS) {
+    status = Msg_writer_footer(msg);
+  }
+
+  return status;
+}
+
+/*-------------------------------------------------------------------------*/
+
+int make_log(Msg_writer_type* msg, int num_entries) {
+
+  int i;
+  int j;
+  char value[REG_NUM_BUF_LEN];
+  int status;
+
+  if(Init_msg_writer(msg, REG_MAX_MSG_SIZE, REG_WIRE_XML) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  status = Msg_writer_header(msg);
+  if(status == REG_SUCCESS) {
+    status = Msg_writer_begin(msg, MSG_TAG_STEER_LOG);
+  }
+
+  for(i = 0; i < num_entries && status == REG_SUCCESS; i++) {
+    if(Msg_writer_begin(msg, MSG_TAG_LOG_ENTRY) != REG_SUCCESS ||
+       Msg_writer_element_int(msg, MSG_TAG_KEY, i) != REG_SUCCESS) {
+      status = REG_FAILURE;
+    }
+
+    for(j = 0; j < BENCH_PARAMS_PER_ENTRY && status == REG_SUCCESS; j++) {
+      Format_double((double) i*j/7.0, value);
+      if(Msg_writer_begin(msg, MSG_TAG_PARAM) != REG_SUCCESS ||
+	 Msg_writer_element_int(msg, MSG_TAG_HANDLE, j) != REG_SUCCESS ||
+	 Msg_writer_element_string(msg, MSG_TAG_VALUE, value) !=
+	 REG_SUCCESS) {
+	status = REG_FAILURE;
+      }
+      else {
+	status = Msg_writer_end(msg, MSG_TAG_PARAM);
+      }
+    }
+
+    if(status == REG_SUCCESS) {
+      status = Msg_writer_end(msg, MSG_TAG_LOG_ENTRY);
+    }
+  }
+
+  if(status == REG_SUCCESS) {
+    status = Msg_writer_end(msg, MSG_TAG_STEER_LOG);
+  }
+  if(status == REG_SUCCESS) {
+    status = Msg_writer_footer(msg);
+  }
+
+  return status;
+}
+
+/*-------------------------------------------------------------------------*/
+
+int parse_dom(Msg_writer_type* msg, struct msg_struct* result) {
+
+  xmlDocPtr doc;
+
+  doc = xmlReadMemory(msg->buf, (int) (msg->pos - msg->buf),
+		      "http://www.realitygrid.org", NULL,
+		      XML_PARSE_NOWARNING | XML_PARSE_NOERROR);
+  if(!doc) return REG_FAILURE;
+
+  /* Parse_xml() frees the document */
+  return Parse_xml(doc, result, NULL);
+}
+
+/*-------------------------------------------------------------------------*/
+
+int parse_sax(Msg_writer_type* msg, struct msg_struct* result) {
+
+  return Parse_sax_buf(msg->buf, (int) (msg->pos - msg->buf), result, NULL);
+}
+
+/*-------------------------------------------------------------------------*/
+
+long count_params(struct msg_struct* result, long* num_chars) {
+
+  struct param_struct*     param = NULL;
+  struct log_entry_struct* entry = NULL;
+  long count = 0;
+
+  *num_chars = 0;
+
+  if(result->status) param = result->status->first_param;
+  if(result->log) entry = result->log->first_entry;
+
+  while(param || entry) {
+    if(!param) {
+      param = entry->first_param_log;
+      entry = entry->next;
+      continue;
+    }
+
+    count++;
+    if(param->label) *num_chars += xmlStrlen(param->label);
+    if(param->value) *num_chars += xmlStrlen(param->value);
+    if(param->max_val) *num_chars += xmlStrlen(param->max_val);
+    param = param->next;
+  }
+
+  return count;
+}
+
+/*-------------------------------------------------------------------------*/
+
+int run_bench(const char* name, Msg_writer_type* msg, int num_iter) {
+
+  struct msg_struct* result;
+  double t_dom;
+  double t_sax;
+  long   count[2];
+  long   chars[2];
+  int    i;
+  int    pass;
+  int    status;
+
+  for(pass = 0; pass < 2; pass++) {
+
+    /* Check the two parsers agree before timing them */
+    result = New_msg_struct();
+    status = pass ? parse_sax(msg, result) : parse_dom(msg, result);
+    count[pass] = count_params(result, &(chars[pass]));
+    Delete_msg_struct(&result);
+
+    if(status != REG_SUCCESS) {
+      fprintf(stderr, "%s: %s parser failed\n", name, pass ? "SAX" : "DOM");
+      return REG_FAILURE;
+    }
+  }
+
+  if(count[0] != count[1] || chars[0] != chars[1]) {
+    fprintf(stderr, "%s: parsers disagree: DOM found %ld params (%ld "
+	    "chars), SAX found %ld (%ld chars)\n", name, count[0], chars[0],
+	    count[1], chars[1]);
+    return REG_FAILURE;
+  }
+
+  t_dom = wall_time();
+  for(i = 0; i < num_iter; i++) {
+    result = New_msg_struct();
+    parse_dom(msg, result);
+    Delete_msg_struct(&result);
+  }
+  t_dom = (wall_time() - t_dom)*1.0e6/num_iter;
+
+  t_sax = wall_time();
+  for(i = 0; i < num_iter; i++) {
+    result = New_msg_struct();
+    parse_sax(msg, result);
+    Delete_msg_struct(&result);
+  }
+  t_sax = (wall_time() - t_sax)*1.0e6/num_iter;
+
+  printf("%-24s %10d %12.1f %12.1f %8.2f\n", name,
+	 (int) (msg->pos - msg->buf), t_dom, t_sax, t_dom/t_sax);
+
+  return REG_SUCCESS;
+}
+
+/*-------------------------------------------------------------------------*/
+
+double wall_time() {
+
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+
+  return (double) tv.tv_sec + 1.0e-6*(double) tv.tv_usec;
+}
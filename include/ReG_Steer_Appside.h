@@ -57,6 +57,7 @@
   */
 
 #include "ReG_Steer_types.h"
+#include <stddef.h>
 
 #ifdef __cplusplus
   #define PREFIX "C"
@@ -155,6 +156,19 @@ extern PREFIX int Register_IOType(const char* IOLabel,
 				  const int   IOFrequency,
 				  int*        IOType);
 
+/**
+   @param FullEvery Send every parameter in one status report in this
+   many, or zero (the default) to send every parameter in all of them
+   @return REG_SUCCESS
+
+   With many monitored parameters the status report sent to the
+   steerer each step can dominate the cost of steering. Once this is
+   called, status reports only hold the parameters whose values have
+   changed since they were last sent, plus the library's own, with a
+   full report every @p FullEvery reports and whenever a steerer
+   attaches. The steerer merges them into what it already has. */
+extern PREFIX int Enable_delta_status(int FullEvery);
+
 /**
    Toggle whether (@p toggle = @c REG_TRUE) or not (@p toggle = @c
    REG_FALSE) to enable IOTypes during calls to the family of
@@ -211,6 +225,112 @@ extern PREFIX int Enable_IOType_acks(int IOType);
  */
 extern PREFIX int Disable_IOType_acks(int IOType);
 
+/**
+   Allow the transport to send large slices passed to
+   Emit_data_slice() for the specified IOType straight from the
+   application's buffer, rather than copying them first. In return the
+   application must not modify or free such a buffer until
+   Emit_data_slice_release() reports that it may. Only socket-based
+   IO on Linux takes advantage of this (see REG_IO_ZEROCOPY_THRESHOLD).
+   Since XDR encoding is itself a copy, numeric data emitted on a
+   zero-copy IOType is sent in native format, so the consumer must
+   share the emitter's byte order. Takes effect at the next
+   Emit_start().
+   @e N.B. zero-copy is OFF by default.
+   @see Disable_IOType_zerocopy(), Emit_data_slice_release()
+ */
+extern PREFIX int Enable_IOType_zerocopy(int IOType);
+
+/**
+   Turn off zero-copy sends for the specified IOType, so that buffers
+   passed to Emit_data_slice() may be reused as soon as it returns.
+   Buffers sent before this call must still be released with
+   Emit_data_slice_release().
+   @see Enable_IOType_zerocopy()
+ */
+extern PREFIX int Disable_IOType_zerocopy(int IOType);
+
+/**
+   @param IOType Handle of the IOType, as returned by Register_IOType()
+   @param Nx No. of elements in the @e x direction (varies fastest)
+   @param Ny No. of elements in the @e y direction
+   @param Nz No. of elements in the @e z direction
+   @return REG_SUCCESS, REG_FAILURE
+
+   Tell the library the shape of the array emitted on the specified
+   (REG_IO_OUT) IOType so that it can honour a consumer's request,
+   made with Request_IOType_roi(), for only part of it. Any slice of
+   exactly @p Nx*Ny*Nz elements is then cut down to the part asked for
+   before it is sent. Pass zero extents to stop this.
+   Only socket-based IO carries such requests.
+   @see Request_IOType_roi(), Get_data_slice_roi()
+ */
+extern PREFIX int Set_IOType_array_extents(int IOType,
+					   int Nx,
+					   int Ny,
+					   int Nz);
+
+/**
+   @param IOType Handle of the IOType, as returned by Register_IOType()
+   @param Origin Array of three ints giving the first element wanted
+   in each direction, or NULL for (0,0,0)
+   @param Extent Array of three ints giving the no. of elements the
+   sub-block spans in each direction, or NULL to ask for whole arrays
+   again
+   @param Stride Array of three ints giving the spacing of the
+   elements wanted in each direction, or NULL for (1,1,1)
+   @return REG_SUCCESS, REG_FAILURE
+
+   Ask the emitter of the specified (REG_IO_IN) IOType to send only
+   every @p Stride'th element of the given sub-block of each array
+   (see Set_IOType_array_extents()). The request goes to the emitter
+   with the next acknowledgement of a data set, so it takes effect
+   from the data set after that one. Use Get_data_slice_roi() to
+   find out which part of an array a slice holds.
+   @see Get_data_slice_roi()
+ */
+extern PREFIX int Request_IOType_roi(int  IOType,
+				     int *Origin,
+				     int *Extent,
+				     int *Stride);
+
+/**
+   @param IOType Handle of the IOType, as returned by Register_IOType()
+   @param NumLevels No. of levels of detail to send each array in, or
+   1 (or less) for full resolution only
+   @return REG_SUCCESS, REG_FAILURE
+
+   Have each REG_FLOAT or REG_DBL array (see Set_IOType_array_extents())
+   emitted on the specified (REG_IO_OUT) IOType sent as a pyramid of
+   slices, coarsest first. Each level halves the resolution of the one
+   after it by averaging blocks of 2x2x2 elements, and the last is the
+   array itself, so a consumer can show something as soon as the first
+   slice arrives. Fewer levels are sent if the array becomes a single
+   element first. If the consumer asks for only the coarsest few with
+   Request_IOType_lod(), the rest (including the array itself) are not
+   sent at all.
+   @see Get_data_slice_lod()
+ */
+extern PREFIX int Set_IOType_lod_levels(int IOType,
+					int NumLevels);
+
+/**
+   @param IOType Handle of the IOType, as returned by Register_IOType()
+   @param NumLevels The most levels of detail wanted, or 0 for as many
+   as the emitter sends
+   @return REG_SUCCESS, REG_FAILURE
+
+   Ask the emitter of the specified (REG_IO_IN) IOType to stop after
+   the coarsest @p NumLevels levels of each array sent as a pyramid
+   (see Set_IOType_lod_levels()), to save bandwidth when a coarse
+   version of the array will do. Like Request_IOType_roi(), this
+   takes effect from the data set after the next acknowledgement.
+   Only socket-based IO carries such requests.
+   @see Get_data_slice_lod()
+ */
+extern PREFIX int Request_IOType_lod(int IOType,
+				     int NumLevels);
+
 /**
    @param NumTypes No. of checkpoint types to register
    @param ChkLabel Unique label for each Chk type
@@ -487,6 +607,10 @@ extern PREFIX int Disable_param_logging(const char* ParamLabel);
    client. (The values themselves will have been updated using the
    pointers previously registered with the library.)
 
+   At most REG_MAX_NUM_STR_CMDS commands and REG_MAX_NUM_STR_PARAMS
+   labels are returned by any one call.  Any beyond those limits are
+   held over and returned, oldest first, by the following call(s).
+
    The commands returned by this routine may include pre-defined
    commands (such as 'stop') as well as commands to emit/consume a
    sample (of type @p IOType) or create/restart from a checkpoint (of
@@ -647,6 +771,60 @@ extern PREFIX int Emit_data_slice(int	            IOTypeIndex,
 				  int               Count,
 				  const void       *pData);
 
+/**
+   @param IOTypeIndex is the handle returned by a prior call to Emit_start()
+   @param DataType Type of the data, as for Emit_data_slice()
+   @param NumDims No. of dimensions in the layout (at most
+   @c REG_MAX_LAYOUT_DIMS)
+   @param Extent No. of elements to emit in each dimension, the first
+   varying fastest
+   @param Stride Distance in @e bytes between neighbouring elements
+   in each dimension
+   @param Origin Index of the first element to emit in each
+   dimension, or NULL for all zeroes
+   @param pData Pointer to the element with index zero in every
+   dimension
+   @return REG_SUCCESS, REG_FAILURE
+
+   Emit data that isn't contiguous in memory - the interior of an
+   array with halos, or one component of an array of structures, say
+   - as a single slice of the product of @p Extent elements, without
+   the application having to pack it first. Element
+   (i<sub>0</sub>, i<sub>1</sub>, ...) is read from
+   @p pData + sum((Origin[d] + i<sub>d</sub>)*Stride[d]). The
+   elements are gathered straight into the buffer the slice is
+   encoded and sent from. Any sub-block or levels of detail the
+   consumer asked for only apply to layouts that turn out to be
+   contiguous.
+   @see Consume_data_slice_layout()
+*/
+extern PREFIX int Emit_data_slice_layout(int         IOTypeIndex,
+					 int         DataType,
+					 int         NumDims,
+					 const int  *Extent,
+					 const long *Stride,
+					 const int  *Origin,
+					 const void *pData);
+
+/**
+   Find out whether a buffer passed to Emit_data_slice() may be
+   modified or freed again. This is only ever in doubt when
+   Enable_IOType_zerocopy() has been called for the IOType; otherwise
+   this routine always returns REG_SUCCESS.
+   @param IOType The handle of the IOType the buffer was emitted on
+   (as returned by Register_IOType(), @e not Emit_start())
+   @param pData The buffer passed to Emit_data_slice(), or NULL for
+   every buffer emitted on the IOType
+   @param Block If non-zero, wait until the buffer may be reused
+   @return REG_SUCCESS if the buffer may be reused, REG_NOT_READY if
+   it is still being sent (only when @p Block is zero), REG_FAILURE if
+   the connection was lost while it was being sent
+   @see Enable_IOType_zerocopy()
+*/
+extern PREFIX int Emit_data_slice_release(int         IOType,
+					  const void* pData,
+					  int         Block);
+
 /**
    Signal the end of the emission of the sample/data set referred to by
    IOHandle.   This signals the receiving end that the
@@ -713,12 +891,164 @@ extern PREFIX int Consume_data_slice_header(int  IOTypeIndex,
 			                    int *DataType,
 			                    int *Count);
 
+/**
+   @param IOTypeIndex The index returned from call to Consume_start()
+   @param Origin On success, the first element of the sub-block in
+   each direction (array of three ints)
+   @param Extent On success, the no. of elements the sub-block spans
+   in each direction (array of three ints)
+   @param Stride On success, the spacing of the elements sent in each
+   direction (array of three ints)
+   @return REG_SUCCESS, or REG_FAILURE if the slice holds the whole
+   array
+
+   Find out which part of an array the slice last described by
+   Consume_data_slice_header() holds, following a call to
+   Request_IOType_roi(). The slice holds
+   ceil(Extent[i]/Stride[i]) elements in each direction, @e x varying
+   fastest.
+*/
+extern PREFIX int Get_data_slice_roi(int  IOTypeIndex,
+				     int *Origin,
+				     int *Extent,
+				     int *Stride);
+
+/**
+   @param IOTypeIndex The index returned from call to Consume_start()
+   @param Level On success, the level of detail the slice holds, 0
+   being the coarsest
+   @param NumLevels On success, the no. of levels the array is being
+   sent in; the last is full resolution
+   @param Extent On success, the extent of the array at this level
+   (array of three ints, @e x varying fastest)
+   @return REG_SUCCESS, or REG_FAILURE if the slice isn't part of a
+   pyramid
+
+   Find out which level of detail the slice last described by
+   Consume_data_slice_header() holds. The levels of an array follow
+   one another, coarsest first.
+   @see Set_IOType_lod_levels()
+*/
+extern PREFIX int Get_data_slice_lod(int  IOTypeIndex,
+				     int *Level,
+				     int *NumLevels,
+				     int *Extent);
+
+/**
+   @param IOType Handle of the IOType, as returned by Register_IOType()
+   @param NumDatasets No. of data sets to keep (at most
+   REG_MAX_HISTORY_DEPTH), or 0 for none
+   @return REG_SUCCESS, REG_FAILURE
+
+   Have the library keep the last @p NumDatasets data sets consumed on
+   the specified (REG_IO_IN) IOType, decoded, so that they can be
+   looked at again with Get_IOType_history_slice() without the
+   application copying them. Each data set is given a sequence number
+   by Consume_start(), counting from 0. Storage is aligned on
+   REG_BUFFER_ALIGNMENT bytes and is reused by later data sets, so
+   the pointers returned for a data set are only good until
+   @p NumDatasets more data sets have been started. Any data sets
+   already held are thrown away.
+   @see Get_IOType_history_range()
+*/
+extern PREFIX int Set_IOType_history_depth(int IOType,
+					   int NumDatasets);
+
+/**
+   @param IOType Handle of the IOType, as returned by Register_IOType()
+   @param Oldest On success, the sequence no. of the oldest data set
+   held
+   @param Newest On success, the sequence no. of the newest data set
+   held (the one being consumed, if any)
+   @return REG_SUCCESS, or REG_FAILURE if no data sets are held
+
+   Find out which data sets an IOType's history holds.
+   @see Set_IOType_history_depth()
+*/
+extern PREFIX int Get_IOType_history_range(int  IOType,
+					   int *Oldest,
+					   int *Newest);
+
+/**
+   @param IOType Handle of the IOType, as returned by Register_IOType()
+   @param SeqNum Sequence no. of the data set
+   @param NumSlices On success, the no. of slices held for it
+   @return REG_SUCCESS, or REG_FAILURE if the data set isn't held
+*/
+extern PREFIX int Get_IOType_history_dataset(int  IOType,
+					     int  SeqNum,
+					     int *NumSlices);
+
+/**
+   @param IOType Handle of the IOType, as returned by Register_IOType()
+   @param SeqNum Sequence no. of the data set
+   @param Slice Which slice of the data set, counting from 0
+   @param DataType On success, the type of the data (REG_INT etc.)
+   @param Count On success, the no. of objects of type @p DataType
+   @param pData On success, points to the decoded data, which belongs
+   to the library
+   @return REG_SUCCESS, or REG_FAILURE if the slice isn't held
+
+   Get at a slice kept in an IOType's history.
+   @see Set_IOType_history_depth()
+*/
+extern PREFIX int Get_IOType_history_slice(int    IOType,
+					   int    SeqNum,
+					   int    Slice,
+					   int   *DataType,
+					   int   *Count,
+					   void **pData);
+
+/**
+   @param IOType Handle of the IOType, as returned by Register_IOTypes()
+   @param Buffer The application's buffer, or NULL to go back to
+   buffers the library provides
+   @param NumBytes Size of @p Buffer in bytes
+   @return REG_SUCCESS, REG_FAILURE
+
+   Register a buffer of the application's own for the library to use
+   when encoding and decoding data for this IOType. A slice that is
+   passed to Emit_data_slice() in @p Buffer is converted to XDR where
+   it is, so its contents are not preserved. For an IOType that is
+   being consumed, slices that fit in @p Buffer are read and decoded
+   into it and Consume_data_slice() may be given @p Buffer itself to
+   avoid a copy. Larger slices fall back to a buffer from the library
+   until the end of the data set. Must not be called between
+   Consume_start() and Consume_stop().
+*/
+extern PREFIX int Register_IOType_buffer(int     IOType,
+					 void   *Buffer,
+					 size_t  NumBytes);
+
+/**
+   @param BytesInUse On return, the bytes in data buffers the library
+   is currently using
+   @param BytesCached On return, the bytes in data buffers kept for
+   reuse
+   @param PeakBytesInUse On return, the most that @p BytesInUse has
+   been
+   @param NumAllocs On return, the no. of buffers the library has had
+   to get from the system
+   @return REG_SUCCESS
+
+   The library takes the buffers it needs to encode, decode and keep
+   data sets from a pool shared by all IOTypes, and keeps those it is
+   done with for reuse. Once data sets of a steady shape are flowing
+   @p NumAllocs should stop rising. The memory kept for reuse is
+   limited by the REG_POOL_MAX_CACHED environment variable.
+*/
+extern PREFIX int Get_buffer_pool_usage(size_t        *BytesInUse,
+					size_t        *BytesCached,
+					size_t        *PeakBytesInUse,
+					unsigned long *NumAllocs);
+
 /**
    @param IOTypeIndex The index returned from call to
    Consume_start() - identifies the IO channel to be read.
    @param DataType The type of the data to read
    @param Count The number of objects of type @p DataType to read
-   @param pData Pointer to array large enough to hold incoming data
+   @param pData Pointer to array large enough to hold incoming data,
+   or NULL if the IOType keeps a history
    @return REG_SUCCESS, REG_FAILURE
 
    Wraps the low-level IO for receiving sample data from another
@@ -726,13 +1056,44 @@ extern PREFIX int Consume_data_slice_header(int  IOTypeIndex,
    has been consumed. The type of data to consume is specified using
    the coding scheme given in ReG_Steer_types.h.  The amount and type
    of the data to consume is obtained from a prior call to
-   Consume_data_slice_header().
+   Consume_data_slice_header(). If the IOType keeps a history (see
+   Set_IOType_history_depth()) the slice is also kept there; with
+   @p pData NULL it is kept only there and no copy is made.
 */
 extern PREFIX int Consume_data_slice(int     IOTypeIndex,
 		                     int     DataType,
 		                     int     Count,
 		                     void   *pData);
 
+/**
+   @param IOTypeIndex Index of the IOType as returned by Consume_start()
+   @param DataType The type of the data to read
+   @param NumDims No. of dimensions in the layout (at most
+   @c REG_MAX_LAYOUT_DIMS)
+   @param Extent No. of elements in each dimension, the first varying
+   fastest. Their product must match the count given by
+   Consume_data_slice_header()
+   @param Stride Distance in @e bytes between neighbouring elements
+   in each dimension
+   @param Origin Index of the first element in each dimension, or NULL
+   for all zeroes
+   @param pData Pointer to the element with index zero in every
+   dimension
+   @return REG_SUCCESS, REG_FAILURE
+
+   The counterpart of Emit_data_slice_layout(): consume a slice and
+   scatter it into memory laid out as described, straight from the
+   buffer it was read and decoded in. Elements outside the layout are
+   left alone.
+*/
+extern PREFIX int Consume_data_slice_layout(int         IOTypeIndex,
+					    int         DataType,
+					    int         NumDims,
+					    const int  *Extent,
+					    const long *Stride,
+					    const int  *Origin,
+					    void       *pData);
+
 /**
    @param IOTypeIndex Index of the open IOType channel to close.  Not
    valid once this call has completed.
@@ -89,20 +89,44 @@ typedef struct {
       often we perform steering activity while steerer is connected */
   int                   steer_interval;
 
-  /** String to hold 'supported commands' message 'cos we can't
-      actually send it until a steerer has connected in the case
-      where we're using SOAP */
-  char			supp_cmds[REG_MAX_MSG_SIZE];
-
-  /** Buffer to hold received messages */
-  char			msg_buffer[REG_MAX_MSG_SIZE];
+  /** The 'supported commands' message 'cos we can't actually send
+      it until a steerer has connected in the case where we're
+      using SOAP */
+  Msg_writer_type	supp_cmds;
 
   /** Flag indicating whether or not lib should handle pause cmd
      internally (REG_TRUE) or pass it up to the app (REG_FALSE) */
   int                   handle_pause_cmd;
 
+  /** Wire format (REG_WIRE_XML or REG_WIRE_TLV) in which messages
+      are sent to the steerer. Switched to the binary format by a
+      steering transport once it knows the steerer understands it. */
+  int                   wire_format;
+
 } Steerer_connection_table_type;
 
+/** @internal
+    Commands and steered parameters that did not fit in the arrays
+    the application passed to Steering_control(). They are passed back
+    by its next call(s), oldest first. */
+typedef struct {
+
+  /** No. of commands held over */
+  int   num_cmds;
+  /** Max. no. of commands that can currently be held (is dynamic) */
+  int   max_cmds;
+  /** The commands and their parameters */
+  Cmd_log_entry_type *cmd;
+  /** No. of steered parameters held over */
+  int   num_params;
+  /** Max. no. of parameters that can currently be held (is
+      dynamic) */
+  int   max_params;
+  /** Handles of the steered parameters */
+  int  *param_handles;
+
+} Held_over_type;
+
 /*--------- Prototypes of internal library functions -------------*/
 
 /** @internal
@@ -128,6 +152,9 @@ int Emit_ChkType_defs();
    @param NumSteerParams No. of params that have been steered
    @param SteerParamHandles Array holding handles of steered params
    @param SteerParamLabels Array holding labels of steered params
+   @param MaxCommands Capacity of @p Commands and @p CommandParams
+   @param MaxSteerParams Capacity of @p SteerParamHandles and
+   @p SteerParamLabels
 
    Consume a control message (if any present) from the steerer. Returns
    any commands and associated parameters (the latter as a space-separated
@@ -136,13 +163,18 @@ int Emit_ChkType_defs();
    allocated for them. Also returns
    the handles and labels of any (steerable) parameters whose values have
    changed. (The values themselves are updated from within this routine.)
+   Every parameter in the message is updated.  Commands and parameters
+   beyond @p MaxCommands and @p MaxSteerParams are held over to the next
+   call of Steering_control().
 */
 int Consume_control(int    *NumCommands,
 		    int    *Commands,
 		    char  **CommandParams,
 		    int    *NumSteerParams,
 		    int    *SteerParamHandles,
-		    char  **SteerParamLabels);
+		    char  **SteerParamLabels,
+		    int     MaxCommands,
+		    int     MaxSteerParams);
 
 /** @internal
    @param SeqNum The current sequence number of the simulation
@@ -209,13 +241,25 @@ int Update_ptr_value(param_entry *param);
    with the entry */
 int Get_ptr_value(param_entry *param);
 
+/** @internal
+   @param param Pointer to struct holding information on parameter
+   @return REG_TRUE if the value has changed since it was last sent
+   in a status report (or never has been), REG_FALSE otherwise
+
+   Compares the bit pattern of the variable pointed to by @p param
+   with the one last sent, without formatting it. The new one is kept
+   in @p status_due_bits; Emit_status() only records it as sent once
+   the report has gone. */
+int Param_changed_since_status(param_entry *param);
+
 /** @internal
     Catch any signals and thus allow the library to clean up if the
     application crashes or is stopped abruptly */
 void Steering_signal_handler(int aSignal);
 
 /** @internal
-    @param buf Pointer to message (xml document) to send
+    @param buf Pointer to message (xml document or, once negotiated,
+    binary message) to send
 
     Send a status message to attached steering client */
 int Send_status_msg(char *buf);
@@ -223,15 +267,17 @@ int Send_status_msg(char *buf);
 /** @internal
     @param NumSupportedCmds The number of commands supported
     @param SupportedCmds Array of commands that are supported
-    @param msg Pointer to existing buffer in which to create message
-    @param max_msg_size Size of buffer (bytes) pointed to by @p msg
+    @param msg Message writer to build the message with. It is set up
+    by this routine and must be deleted by the caller.
+    @param WireFormats Wire formats, other than xml, that the steering
+    transport can use (@e e.g. "tlv") or NULL if it only speaks xml
 
     Create the xml message to tell steerer what standard commands
     the application supports. */
-int Make_supp_cmds_msg(int   NumSupportedCmds,
-		       int  *SupportedCmds,
-		       char *msg,
-		       int   max_msg_size);
+int Make_supp_cmds_msg(int              NumSupportedCmds,
+		       int             *SupportedCmds,
+		       Msg_writer_type *msg,
+		       const char      *WireFormats);
 
 /** @internal
     @return NULL if no message else pointer to a valid msg_struct.
@@ -379,6 +425,108 @@ int Emit_iotype_msg_header(int IOTypeIndex,
 			   int NumBytes,
 			   int IsFortranArray);
 
+/** @internal
+    @param IOTypeIndex Index of IOType being used
+    @param DataType Type of data in the slice
+    @param Count No. of data elements in the slice; on return the
+    no. to send
+    @param pData Pointer to the slice; on return the data to send
+    @return REG_SUCCESS, REG_FAILURE
+
+    Cut an array being emitted down to the part the consumer has asked
+    for, if it has asked for one. */
+int Extract_data_slice_roi(int          IOTypeIndex,
+			   int          DataType,
+			   int         *Count,
+			   const void **pData);
+
+/** @internal
+    @param IOTypeIndex Index of IOType being used
+    @param DataType Type of data in the slice
+    @param Count No. of data elements in the slice
+    @param pData Pointer to the slice
+    @param Done On return, REG_TRUE if the consumer wants no more
+    levels so that the array itself mustn't be sent
+    @return REG_SUCCESS, REG_FAILURE
+
+    Send coarser versions of an array being emitted ahead of the array
+    itself, if asked to. Leaves the level of detail of the array
+    itself set for the slice header. */
+int Emit_data_slice_lod(int         IOTypeIndex,
+			int         DataType,
+			int         Count,
+			const void *pData,
+			int        *Done);
+
+/** @internal
+    @param IOTypeIndex Index of IOType being used
+    @param DataType Type of data in the slice
+    @param Count No. of data elements in the slice
+    @param pData Pointer to the slice
+    @return REG_SUCCESS, REG_FAILURE
+
+    Encode (if required) and send a single slice along with its
+    header. */
+int Send_data_slice(int         IOTypeIndex,
+		    int         DataType,
+		    int         Count,
+		    const void *pData);
+
+/** @internal
+    @param Caller Name of the calling routine, for error messages
+    @param DataType Type of the data in the slice
+    @param NumDims No. of dimensions in the layout
+    @param Extent No. of elements in each dimension
+    @param Stride Distance in bytes between neighbouring elements in
+    each dimension
+    @param Origin Index of the first element in each dimension, or
+    NULL for all zeroes
+    @param pData Pointer to the element with index zero in every
+    dimension
+    @param Size On return, the size in bytes of each element
+    @param Count On return, the no. of elements in the layout
+    @param pBase On return, pointer to the first element in the layout
+    @return REG_SUCCESS, REG_FAILURE if the layout isn't valid
+
+    Check a layout passed to Emit_data_slice_layout() or
+    Consume_data_slice_layout() and work out where it starts. */
+int Resolve_data_slice_layout(const char  *Caller,
+			      int          DataType,
+			      int          NumDims,
+			      const int   *Extent,
+			      const long  *Stride,
+			      const int   *Origin,
+			      const void  *pData,
+			      size_t      *Size,
+			      int         *Count,
+			      const void **pBase);
+
+/** @internal
+    @param IOTypeIndex Index of IOType being used
+    @param DataType Type of the (already encoded) data in the slice
+    @param Count No. of data elements in the slice
+    @param NumBytes No. of bytes to send
+    @param pData Pointer to the encoded slice
+    @return REG_SUCCESS, REG_FAILURE
+
+    Send a slice that is ready to go along with its header. */
+int Send_encoded_data_slice(int         IOTypeIndex,
+			    int         DataType,
+			    int         Count,
+			    size_t      NumBytes,
+			    const void *pData);
+
+/** @internal
+    @param IOTypeIndex Index of IOType being used
+    @param pData Pointer to data about to be sent
+    @return REG_TRUE if @p pData lies in one of the library's own
+    buffers for this IOType, REG_FALSE otherwise
+
+    The library's buffers are reused for the next slice so transports
+    must not hang on to them. */
+int IOType_owns_buffer(int         IOTypeIndex,
+		       const void *pData);
+
 /** @internal
     @param index Index of IOType
     @param num_bytes No. of bytes to specify in realloc
@@ -387,6 +535,13 @@ int Emit_iotype_msg_header(int IOTypeIndex,
 int Realloc_iotype_buffer(int index,
 			  int num_bytes);
 
+/** @internal
+    @param index Index of IOType
+
+    Give any buffer from the pool back and return to the
+    application's registered buffer, if it has one. */
+void Release_iotype_buffer(int index);
+
 /** @internal
     @param index Index of IOType
     @param num_bytes No. of bytes to specify in realloc
@@ -426,16 +581,36 @@ int Toggle_param_logging(const char* ParamLabel,
     new values in the message
     @param SteerParamLabels Array holding list of labels of the parameters
     given new values in the message
+    @param MaxCommands Capacity of @p Commands and @p CommandParams
+    @param MaxSteerParams Capacity of @p SteerParamHandles and
+    @p SteerParamLabels
 
     Takes the supplied structure holding a control message
-    and returns its constituents */
+    and returns its constituents.  All of the new parameter values
+    are applied and logged, however many there are.  Commands and
+    steered parameters that don't fit in the supplied arrays are held
+    over (see Hold_over_cmd() and Hold_over_param()). */
 int Unpack_control_msg(struct control_struct *ctrl,
 		       int    *NumCommands,
 		       int    *Commands,
 		       char  **CommandParams,
 		       int    *NumSteerParams,
 		       int    *SteerParamHandles,
-		       char  **SteerParamLabels);
+		       char  **SteerParamLabels,
+		       int     MaxCommands,
+		       int     MaxSteerParams);
+
+/** @internal
+    @param log The log of steering activity
+    @param num_params No. of parameter updates it must be able to hold
+    @param num_cmds No. of commands it must be able to hold
+    @return REG_SUCCESS, REG_FAILURE
+
+    Grow the storage of the steering-activity log so that it can hold
+    everything in one control message. */
+int Realloc_steer_log(Steer_log_type *log,
+		      int             num_params,
+		      int             num_cmds);
 
 /** @internal
     Extracts the valid_time (if any) from the message and compares
@@ -444,4 +619,49 @@ int Unpack_control_msg(struct control_struct *ctrl,
     @returns 1 if msg valid, 0 otherwise */
 int Control_msg_now_valid(struct msg_struct *msg);
 
+/** @internal
+    @param Id The command
+    @param Params Its parameters
+    @return REG_SUCCESS, REG_FAILURE
+
+    Keep a command that doesn't fit in the application's arrays for
+    the next call of Steering_control(). A command that is already
+    held over with the same parameters isn't held twice. */
+int Hold_over_cmd(int         Id,
+		  const char *Params);
+
+/** @internal
+    @param Handle Handle of a steered parameter
+    @return REG_SUCCESS, REG_FAILURE
+
+    Keep the handle of a steered parameter whose label doesn't fit in
+    the application's arrays for the next call of Steering_control().
+    (Its new value has already been applied.) */
+int Hold_over_param(int Handle);
+
+/** @internal
+    @param NumCommands No. of entries already in @p Commands, updated
+    on return
+    @param Commands Array of commands to add to
+    @param CommandParams Parameters of @p Commands
+    @param MaxCommands Capacity of @p Commands and @p CommandParams
+    @param NumSteerParams No. of entries already in
+    @p SteerParamHandles, updated on return
+    @param SteerParamHandles Array of steered parameter handles to
+    add to
+    @param SteerParamLabels Labels of @p SteerParamHandles
+    @param MaxSteerParams Capacity of @p SteerParamHandles and
+    @p SteerParamLabels
+
+    Move as many held-over commands and steered parameters as will
+    fit into the supplied arrays, oldest first. */
+void Take_held_over(int    *NumCommands,
+		    int    *Commands,
+		    char  **CommandParams,
+		    int     MaxCommands,
+		    int    *NumSteerParams,
+		    int    *SteerParamHandles,
+		    char  **SteerParamLabels,
+		    int     MaxSteerParams);
+
 #endif
@@ -0,0 +1,116 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+#ifndef __REG_STEER_BUFFER_POOL_H__
+#define __REG_STEER_BUFFER_POOL_H__
+
+/** @internal
+    @file ReG_Steer_Buffer_Pool.h
+    @brief A pool of aligned buffers shared by all IOTypes.
+
+    Requests are rounded up to a power of two (at least
+    REG_POOL_MIN_BLOCK bytes) and blocks that are given back are kept
+    on a free list for that size class, so a steady stream of data
+    sets of much the same shape reuses the same few blocks rather
+    than going back to the system each time. Blocks bigger than
+    REG_POOL_MAX_BLOCK are not pooled. The pool is not thread-safe;
+    it is only used from the application's thread.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_types.h"
+
+/** Smallest block handed out, in bytes */
+#define REG_POOL_MIN_BLOCK 64
+/** Largest block that is pooled, in bytes */
+#define REG_POOL_MAX_BLOCK (1UL << 30)
+/** Default limit on the bytes held on the free lists */
+#define REG_POOL_MAX_CACHED (256UL << 20)
+
+/** @internal
+    @param nbytes No. of bytes wanted
+    @return Pointer to a block of at least @p nbytes bytes, aligned on
+    REG_BUFFER_ALIGNMENT bytes, or NULL on failure */
+void* Pool_alloc(const size_t nbytes);
+
+/** @internal
+    @param ptr Block to resize, or NULL
+    @param nbytes No. of bytes wanted
+    @return Pointer to a block of at least @p nbytes bytes holding the
+    contents of @p ptr, or NULL on failure (when @p ptr is untouched)
+
+    The block is only moved if it is too small. */
+void* Pool_realloc(void* ptr, const size_t nbytes);
+
+/** @internal
+    @param ptr Block to give back, or NULL
+
+    Return a block to its free list, or to the system if it is too
+    big to pool or the free lists already hold their limit. */
+void Pool_free(void* ptr);
+
+/** @internal
+    @param ptr Block from Pool_alloc()
+    @return No. of bytes that may be used in @p ptr */
+size_t Pool_block_size(const void* ptr);
+
+/** @internal
+    @param in_use On return, the bytes in blocks handed out
+    @param cached On return, the bytes in blocks on the free lists
+    @param peak On return, the most that @p in_use has been
+    @param num_allocs On return, the no. of blocks obtained from the
+    system */
+void Pool_usage(size_t*        in_use,
+		size_t*        cached,
+		size_t*        peak,
+		unsigned long* num_allocs);
+
+/** @internal
+    Give all blocks on the free lists back to the system */
+void Pool_trim();
+
+#endif /* __REG_STEER_BUFFER_POOL_H__ */
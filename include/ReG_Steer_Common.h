@@ -89,12 +89,32 @@ typedef struct {
 #endif
 } Steer_lib_config_type;
 
+/** @internal The value of a parameter, or of one of its limits, held
+    in its native type. Which member is in use follows from the type
+    of the parameter: @p i, @p l, @p f and @p d for REG_INT, REG_LONG,
+    REG_FLOAT and REG_DBL and @p s for REG_CHAR. The limits of REG_CHAR
+    and REG_BIN parameters are lengths and so use @p i. The values are
+    only converted to text when they go into a message or a log file. */
+typedef union {
+  int     i;
+  long    l;
+  float   f;
+  double  d;
+  /** Buffer of REG_MAX_STRING_LENGTH characters allocated when a
+      string is first stored (see Param_value_set_string()), NULL
+      before then */
+  char   *s;
+
+} Param_value_type;
+
 /** @internal Used to log parameter values */
 typedef struct {
   /** Handle of logged parameter */
   int  handle;
+  /** Type of logged parameter */
+  int  type;
   /** Value of logged parameter */
-  char value[REG_MAX_STRING_LENGTH];
+  Param_value_type value;
 
 } Param_log_entry_type;
 
@@ -113,12 +133,17 @@ typedef struct {
 
   /** No. of log entries for parameter updates */
   int   num_params;
+  /** Max. no. of parameter updates the log can currently hold (is
+      dynamic) */
+  int   max_params;
   /** Array holding the log entries for parameter updates */
-  Param_log_entry_type param[REG_MAX_NUM_STR_PARAMS];
+  Param_log_entry_type *param;
   /** No. of other logged steering commands */
   int   num_cmds;
+  /** Max. no. of commands the log can currently hold (is dynamic) */
+  int   max_cmds;
   /** Array holding logged steering commands */
-  Cmd_log_entry_type cmd[REG_MAX_NUM_STR_CMDS];
+  Cmd_log_entry_type *cmd;
 
 } Steer_log_type;
 
@@ -132,14 +157,107 @@ typedef struct {
   char                 chk_tag[REG_MAX_STRING_LENGTH];
   /** No. of parameter values logged with this checkpoint */
   int                  num_param;
+  /** Max. no. of parameter values this entry can currently hold
+      (is dynamic) */
+  int                  max_param;
   /** Array of logged parameters */
-  Param_log_entry_type param[REG_MAX_NUM_STR_PARAMS];
+  Param_log_entry_type *param;
   /** Whether or not (REG_TRUE or REG_FALSE) this entry has been
       sent to the attached steering client(s) */
   int                  sent_to_steerer;
 
 } Chk_log_entry_type;
 
+/** @internal Wire formats in which a steering message can be built */
+#define REG_WIRE_XML 0
+/** @internal Binary wire format: each element is a one-byte tag
+    followed by the length of its content as a 4-byte, network-order
+    integer and then the content itself. The content of a leaf
+    element is its value as text, that of any other element is the
+    concatenation of its children. */
+#define REG_WIRE_TLV 1
+
+/** @internal First byte of a message in the binary wire format -
+    can never begin an XML document */
+#define REG_TLV_MAGIC   0xB7
+/** @internal Version of the binary wire format - the second byte
+    of a message in that format */
+#define REG_TLV_VERSION 1
+/** @internal No. of bytes (tag + length) preceding the content of
+    each element in the binary wire format */
+#define REG_TLV_ELEMENT_HDR 5
+
+/** @internal Max. depth to which elements may be nested in a message
+    built with a Msg_writer_type */
+#define REG_MAX_MSG_DEPTH 8
+
+/** @internal Max. no. of message buffers kept for reuse once the
+    messages they held have been sent */
+#define REG_MAX_FREE_MSG_BUFS 4
+
+/** @internal Message buffers bigger than this (bytes) are given back
+    to the system rather than kept for reuse */
+#define REG_MSG_BUF_MAX_RETAINED (8*REG_MAX_MSG_SIZE)
+
+/** @internal The elements that make up a steering message. In the
+    binary wire format these are the tags of the elements; the names
+    used in the XML format are returned by Msg_tag_name(). */
+typedef enum {
+  MSG_TAG_NOTSET = 0,
+  MSG_TAG_STEER_MESSAGE,
+  MSG_TAG_APP_STATUS,
+  MSG_TAG_STEER_CONTROL,
+  MSG_TAG_PARAM_DEFS,
+  MSG_TAG_IOTYPE_DEFS,
+  MSG_TAG_CHKTYPE_DEFS,
+  MSG_TAG_STEER_LOG,
+  MSG_TAG_SUPP_CMDS,
+  MSG_TAG_PARAM,
+  MSG_TAG_HANDLE,
+  MSG_TAG_LABEL,
+  MSG_TAG_VALUE,
+  MSG_TAG_STEERABLE,
+  MSG_TAG_TYPE,
+  MSG_TAG_IS_INTERNAL,
+  MSG_TAG_MIN_VALUE,
+  MSG_TAG_MAX_VALUE,
+  MSG_TAG_COMMAND,
+  MSG_TAG_CMD_ID,
+  MSG_TAG_CMD_NAME,
+  MSG_TAG_CMD_PARAM,
+  MSG_TAG_VALID_AFTER,
+  MSG_TAG_IOTYPE,
+  MSG_TAG_CHKTYPE,
+  MSG_TAG_DIRECTION,
+  MSG_TAG_FREQ_HANDLE,
+  MSG_TAG_LOG_ENTRY,
+  MSG_TAG_KEY,
+  MSG_TAG_CHK_LOG_ENTRY,
+  MSG_TAG_CHK_HANDLE,
+  MSG_TAG_CHK_TAG,
+  MSG_TAG_WIRE_FORMAT,
+  MSG_NUM_TAGS
+} msg_tag_type;
+
+/** @internal A message that is built in one piece in a buffer
+    that grows as it is written to */
+typedef struct {
+  /** The buffer holding the message */
+  char *buf;
+  /** Next free byte in the buffer; always holds a terminating '\0' */
+  char *pos;
+  /** Size of the buffer in bytes */
+  int   size;
+  /** Wire format of the message - REG_WIRE_XML or REG_WIRE_TLV */
+  int   format;
+  /** No. of elements currently open */
+  int   depth;
+  /** Offsets into @p buf of the lengths of the open elements (binary
+      wire format only) */
+  int   open[REG_MAX_MSG_DEPTH];
+
+} Msg_writer_type;
+
 /** @internal Logs can be for checkpoints or parameter values */
 typedef enum {PARAM, CHKPT} log_type_type ;
 
@@ -169,8 +287,11 @@ typedef struct {
       another one attaches some time later. */
   int                 send_all;
   /** Array of flags indicating whether or not the log for each
-      registered parameter has been sent to the steering client */
-  int                 param_send_all[REG_MAX_NUM_STR_PARAMS];
+      registered parameter has been sent to the steering client.
+      Indexed like the table of parameters and grown to match it. */
+  int                *param_send_all;
+  /** No. of entries in param_send_all */
+  int                 num_param_send_all;
   /** Flag to indicate whether a send of the log data (read in on
       a previous occasion) is still in progress.  This feature
       prevents a deluge of log messages being emitted.
@@ -183,12 +304,8 @@ typedef struct {
   /** Ptr to buffer holding contents of log buffer for log
       emits spread over several calls to Emit_log */
   char               *file_content;
-  /** Ptr to buffer containing logged steering cmds */
-  char               *pSteer_cmds;
-  /** Ptr to next free space in this buffer */
-  char               *pSteer_cmds_slot;
-  /** No. of bytes currently allocated to buffer */
-  int                 steer_cmds_bytes;
+  /** Logged steering cmds */
+  Msg_writer_type     steer_cmds;
 
 } Chk_log_type;
 
@@ -214,7 +331,10 @@ typedef struct {
       raw data */
   unsigned int raw_buf_size;
   /** Most recent value of the parameter obtained from @p ptr */
-  char  value[REG_MAX_STRING_LENGTH];
+  Param_value_type value;
+  /** Whether @p value holds a value yet (steering side only; the
+      application side always has one) */
+  int   value_set;
   /** Whether param has been modified by steerer (steering side only) */
   int   modified;
   /** Whether param is for internal use by the library */
@@ -222,11 +342,11 @@ typedef struct {
   /** Whether param has a valid minimum value */
   int   min_val_valid;
   /** The minimum allowed value of this parameter (if any) */
-  char  min_val[REG_MAX_STRING_LENGTH];
+  Param_value_type min_val;
   /** Whether param has a valid maximum value */
   int   max_val_valid;
   /** The maximum allowed value of this parameter (if any) */
-  char  max_val[REG_MAX_STRING_LENGTH];
+  Param_value_type max_val;
   /** Pointer to array containing logged values (cast to double) */
   double* log;
   /** Current position in @p log */
@@ -235,6 +355,17 @@ typedef struct {
   int     log_size;
   /** Whether logging is on for this parameter */
   int     logging_on;
+  /** Whether the value has been sent in a status report since the
+      last full one */
+  int     status_sent;
+  /** Bit pattern (or hash, for strings and binary data) of the value
+      last sent in a status report */
+  unsigned long long status_bits;
+  /** Whether the value is to go in the status report being built */
+  int     status_due;
+  /** Bit pattern (or hash) of the value going in the status report
+      being built */
+  unsigned long long status_due_bits;
 
 } param_entry;
 
@@ -252,6 +383,22 @@ typedef struct {
   int          log_all;
   /** Array of parameter descriptions */
   param_entry *param;
+  /** Indices of the entries in use, in the order they were added,
+      so that walking them costs O(live params) */
+  int         *live;
+  /** No. of indices in @p live */
+  int          num_live;
+  /** Size of the @p live array */
+  int          max_live;
+  /** Hash of handle to index (open addressing, -1 marks an empty
+      slot) */
+  int         *by_handle;
+  /** Hash of label to index (open addressing, -1 marks an empty
+      slot) */
+  int         *by_label;
+  /** No. of slots in each hash (a power of two), zero if the table
+      isn't indexed */
+  int          hash_size;
 
 } Param_table_type;
 
@@ -293,6 +440,84 @@ typedef struct {
 
 } Array_type;
 
+/** @internal
+    Type definition for variable describing the sub-block of an array,
+    and the stride through it, that a consumer wants to be sent */
+typedef struct {
+
+  /** Whether a sub-block has been asked for */
+  int is_set;
+  /** Whether the request has yet to be sent to the emitter */
+  int pending;
+  /** Origin of sub-block within whole array */
+  int sx, sy, sz;
+  /** Extent of sub-block */
+  int nx, ny, nz;
+  /** Stride through sub-block */
+  int dx, dy, dz;
+
+} Roi_type;
+
+/** @internal
+    Type definition for variable describing which level of a
+    multi-resolution (mean pyramid) version of an array a slice holds */
+typedef struct {
+
+  /** Level held by the slice, 0 being the coarsest */
+  int level;
+  /** No. of levels the array is sent in (0 if it isn't) */
+  int num_levels;
+  /** Extent of the array at this level */
+  int nx, ny, nz;
+
+} Lod_type;
+
+/** @internal
+    Type definition for a slice held in an IOType's history */
+typedef struct {
+
+  /** Type of the data (REG_INT etc.) */
+  int     type;
+  /** No. of elements */
+  int     count;
+  /** Decoded data, aligned on REG_BUFFER_ALIGNMENT bytes */
+  void   *data;
+  /** Size of the block at @p data, kept when the slot is reused */
+  size_t  max_bytes;
+
+} History_slice_type;
+
+/** @internal
+    Type definition for a data set held in an IOType's history */
+typedef struct {
+
+  /** Sequence no. of the data set, -1 if the slot is empty */
+  int                 seqnum;
+  /** No. of slices read so far */
+  int                 num_slices;
+  /** No. of slices there is room for in @p slices */
+  int                 max_slices;
+  /** The slices, whose storage outlives the data set */
+  History_slice_type *slices;
+
+} History_dataset_type;
+
+/** @internal
+    Type definition for the ring of data sets recently consumed on
+    an IOType */
+typedef struct {
+
+  /** No. of data sets to keep, 0 for none */
+  int                   depth;
+  /** Slot of the data set being (or last) consumed, -1 if none yet */
+  int                   current;
+  /** Sequence no. to give the next data set */
+  int                   next_seqnum;
+  /** @p depth slots, reused in turn */
+  History_dataset_type *datasets;
+
+} History_type;
+
 /** @internal
     Description of a single IOType */
 typedef struct {
@@ -309,6 +534,11 @@ typedef struct {
   int				freq_param_handle;
   /** Pointer to buffer to hold data */
   void			       *buffer;
+  /** Staging buffer supplied by the application, NULL if none; used
+      as @p buffer whenever it is big enough */
+  void                         *user_buffer;
+  /** Size of @p user_buffer in bytes */
+  size_t                        user_buffer_bytes;
   /** How much data there is currently in @p buffer */
   int                           buffer_bytes;
   /** Size of the @p buffer */
@@ -320,6 +550,33 @@ typedef struct {
   int                           num_xdr_bytes;
   /** Details on incoming array (if available) */
   Array_type                    array;
+  /** Part of each array the consumer wants (REG_IO_OUT) or has asked
+      for (REG_IO_IN) */
+  Roi_type                      roi;
+  /** Part of the array sent in the current slice */
+  Roi_type                      slice_roi;
+  /** Buffer to gather the part of the array to send into */
+  void                         *roi_buffer;
+  /** Size of the @p roi_buffer */
+  size_t                        roi_buffer_bytes;
+  /** No. of levels of detail to send each array in (REG_IO_OUT) or
+      the most the consumer wants (REG_IO_IN, 0 for all) */
+  int                           lod_levels;
+  /** The most levels of detail the consumer wants (REG_IO_OUT, 0 for
+      all) */
+  int                           lod_limit;
+  /** Whether @p lod_levels has yet to be sent to the emitter
+      (REG_IO_IN) */
+  int                           lod_pending;
+  /** Level of detail of the array in the current slice */
+  Lod_type                      slice_lod;
+  /** Buffer to hold the coarser levels of detail */
+  void                         *lod_buffer;
+  /** Size of the @p lod_buffer */
+  size_t                        lod_buffer_bytes;
+  /** The last few data sets consumed, if the application asked for
+      them to be kept */
+  History_type                  history;
   /** Whether or not (1 or 0) we'll need to convert the ordering of
       the array */
   int                           convert_array_order;
@@ -336,6 +593,10 @@ typedef struct {
      attempting to emit the next data set. Setting @p use_ack to REG_FALSE
      OVERRIDES this flag. */
   int                           ack_needed;
+  /** Whether or not the application waits for
+      Emit_data_slice_release() before reusing buffers passed to
+      Emit_data_slice(), so that they may be sent without copying */
+  int                           use_zerocopy;
   /** Whether (REG_TRUE) or not (REG_FALSE) we are in the process of
       consuming data.  For use with ioProxy in event of unexpected
       shut down */
@@ -434,12 +695,158 @@ extern PREFIX int Next_free_param_index(Param_table_type *table);
 extern PREFIX int Param_index_from_handle(Param_table_type *table,
 					  int ParamHandle);
 
+/** @internal
+    @param handle Handle of a parameter
+    @return Hash of @p handle */
+extern PREFIX unsigned int Hash_param_handle(int handle);
+
+/** @internal
+    @param label Label of a parameter
+    @return Hash of @p label */
+extern PREFIX unsigned int Hash_param_label(const char *label);
+
+/** @internal
+    @param table Pointer to table of registered parameters
+    @param index Index of the entry to add
+
+    Add an entry to the handle and label hashes of the table, which
+    must have room for it. */
+extern PREFIX void Hash_param_entry(Param_table_type *table,
+				    int               index);
+
+/** @internal
+    @param table Pointer to table of registered parameters
+    @param Label Label of parameter to get index for
+    @return The index of the first parameter registered with
+    @p Label, or -1 if there is none
+
+    A look-up function - return the index of the parameter with the
+    given label. Only tables with an index (see
+    Param_table_index_add()) can be searched. */
+extern PREFIX int Param_index_from_label(Param_table_type *table,
+					 const char       *Label);
+
+/** @internal
+    @param table Pointer to table of registered parameters
+
+    Set up a table with an empty index. */
+extern PREFIX void Init_param_table_index(Param_table_type *table);
+
+/** @internal
+    @param table Pointer to table of registered parameters
+    @param index Index of the entry, whose handle and label must be set
+    @return REG_SUCCESS, REG_FAILURE
+
+    Add an entry that has just been filled in to the table's list of
+    live entries and to its handle and label look-ups. Every entry
+    given a handle must be added. */
+extern PREFIX int Param_table_index_add(Param_table_type *table,
+					int               index);
+
+/** @internal
+    @param table Pointer to table of registered parameters
+
+    Free the memory used by a table's index. */
+extern PREFIX void Delete_param_table_index(Param_table_type *table);
+
 /** @internal
     @param param Pointer to parameter entry to initialize
 
     Initializes the supplied parameter entry. */
 extern PREFIX void Init_param_entry(param_entry *param);
 
+/** @internal
+    @param value The value to set
+    @param str The string to store
+    @param len Length of @p str, or -1 if it is '\0'-terminated
+    @return REG_SUCCESS, REG_FAILURE
+
+    Store a string in the @p s member of a value, allocating its
+    buffer if it doesn't have one yet. Strings longer than
+    REG_MAX_STRING_LENGTH - 1 characters are truncated. */
+extern PREFIX int Param_value_set_string(Param_value_type *value,
+					 const char       *str,
+					 int               len);
+
+/** @internal
+    @param type Type of the parameter (REG_INT etc.)
+    @param str The value as text
+    @param value The value to set
+    @return REG_SUCCESS, or REG_FAILURE if @p str could not be read
+
+    Set a value from its textual form. Values of REG_BIN parameters
+    are not held here so are left untouched. */
+extern PREFIX int Param_value_from_string(int               type,
+					  const char       *str,
+					  Param_value_type *value);
+
+/** @internal
+    @param type Type of the parameter (REG_INT etc.)
+    @param value The value
+    @param buf Buffer of at least REG_NUM_BUF_LEN characters to format
+    a number into
+    @return The value as text: either @p buf or, for a REG_CHAR
+    parameter, the stored string itself
+
+    Get the textual form of a value. */
+extern PREFIX const char *Param_value_to_string(int                     type,
+						const Param_value_type *value,
+						char                   *buf);
+
+/** @internal
+    @param type Type of the parameter (REG_INT etc.)
+    @param value The value
+    @return The value as a double
+
+    Strings are read as numbers, which gives zero if they don't hold
+    one; REG_BIN values are always zero. */
+extern PREFIX double Param_value_to_double(int                     type,
+					   const Param_value_type *value);
+
+/** @internal
+    @param type Type of the parameter (REG_INT etc.)
+    @return The type in which the limits of the parameter are held
+
+    Limits of strings and raw data are their lengths so are REG_INT. */
+extern PREFIX int Param_limit_type(int type);
+
+/** @internal
+    @param type Type of the parameter (REG_INT etc.)
+    @param value The value to free
+
+    Free any memory held by a value. */
+extern PREFIX void Free_param_value(int type, Param_value_type *value);
+
+/** @internal
+    @param param Pointer to parameter entry
+
+    Free any memory held by the value and limits of a parameter
+    entry. */
+extern PREFIX void Free_param_entry_values(param_entry *param);
+
+/** @internal
+    @param entry The log entry to set
+    @param handle Handle of the parameter
+    @param type Type of the parameter
+    @param value The value to log
+    @return REG_SUCCESS, REG_FAILURE
+
+    Record a parameter value in a log entry. Numbers are copied as
+    they are, strings into a buffer that the entry keeps for reuse. */
+extern PREFIX int Set_log_param_value(Param_log_entry_type   *entry,
+				      int                     handle,
+				      int                     type,
+				      const Param_value_type *value);
+
+/** @internal
+    @param params Array of log entries
+    @param num_params No. of entries in @p params
+
+    Free the strings held by an array of log entries (but not the
+    array itself). */
+extern PREFIX void Free_log_param_values(Param_log_entry_type *params,
+					 int                   num_params);
+
 /** @internal
     @param table Pointer to table of registered IOTypes
     @param IOdefHandle Handle of IOType to search for
@@ -480,6 +887,34 @@ extern PREFIX int Increment_iodef_registered(IOdef_table_type *table);
     more memory if required. */
 extern PREFIX int Increment_log_entry(Chk_log_type *log);
 
+/** @internal
+    @param log Pointer to table of logs
+    @param first Index of the first entry to initialise
+
+    Mark entries @p first to max_entries-1 of the log as empty, with
+    no storage for parameter values. */
+extern PREFIX void Init_log_entries(Chk_log_type *log,
+				    int           first);
+
+/** @internal
+    @param log Pointer to table of logs
+
+    Free the parameter storage of every entry in the log and then
+    the table of entries itself. */
+extern PREFIX void Delete_log_entries(Chk_log_type *log);
+
+/** @internal
+    @param entry Pointer to the log entry
+    @param num_param No. of parameter values the entry must be able
+    to hold
+    @return REG_SUCCESS, REG_FAILURE
+
+    Grow the storage for the parameter values of a log entry so that
+    it can hold at least @p num_param of them. Existing values are
+    kept. */
+extern PREFIX int Realloc_log_entry_params(Chk_log_entry_type *entry,
+					   int                 num_param);
+
 /** @internal
     @param name Name of message
     @return Corresponding ENUM value
@@ -489,23 +924,218 @@ extern PREFIX int Increment_log_entry(Chk_log_type *log);
 extern PREFIX int Get_message_type(const char *name);
 
 /** @internal
-    @param pchar Pointer to buffer in which to put header
-    @param bytes_free How long the supplied buffer is. This is
-    modified with the number of bytes_free after the header
-    has been written.
+    @param writer The message writer to set up
+    @param size Initial size of its buffer in bytes
+    @param format Wire format of the message, REG_WIRE_XML or
+    REG_WIRE_TLV
+    @return REG_SUCCESS, REG_FAILURE
+
+    Get a buffer for a message writer, reusing one given back by
+    Delete_msg_writer() where possible. The buffer is grown as the
+    message is written so that a message of any size can be built
+    in one piece. */
+extern PREFIX int Init_msg_writer(Msg_writer_type *writer,
+				  int              size,
+				  int              format);
+
+/** @internal
+    @param writer The message writer
+    @param num_bytes No. of bytes (including the terminating
+    '\0') that must fit after the current position
+    @return REG_SUCCESS, REG_FAILURE
+
+    Make sure there is room for at least @p num_bytes more bytes
+    in the buffer of the message writer. */
+extern PREFIX int Msg_writer_reserve(Msg_writer_type *writer,
+				     int              num_bytes);
+
+/** @internal
+    @param writer The message writer
+    @param format printf-style format string
+    @return REG_SUCCESS, REG_FAILURE
+
+    Append formatted text to the message, growing the buffer
+    as needed. */
+extern PREFIX int Msg_writer_printf(Msg_writer_type *writer,
+				    const char      *format, ...);
+
+/** @internal
+    @param writer The message writer
+    @param format printf-style format string
+    @param args Arguments for @p format
+    @return REG_SUCCESS, REG_FAILURE
+
+    As Msg_writer_printf() but takes a va_list. */
+extern PREFIX int Msg_writer_vprintf(Msg_writer_type *writer,
+				     const char      *format,
+				     va_list          args);
+
+/** @internal
+    @param writer The message writer
+    @param data The bytes to append
+    @param num_bytes How many of them there are
+    @return REG_SUCCESS, REG_FAILURE
+
+    Append raw bytes to the message, growing the buffer as
+    needed. */
+extern PREFIX int Msg_writer_write(Msg_writer_type *writer,
+				   const char      *data,
+				   int              num_bytes);
+
+/** @internal
+    @param writer The message writer
+    @param str The text to append
+    @param len Length of @p str, or -1 if it is '\0'-terminated
+    @return REG_SUCCESS, REG_FAILURE
+
+    Append text to the message, escaping any characters that are
+    markup in the xml wire format. */
+extern PREFIX int Msg_writer_string(Msg_writer_type *writer,
+				    const char      *str,
+				    int              len);
+
+/** @internal
+    @param writer The message writer
+    @param value The integer to append
+    @return REG_SUCCESS, REG_FAILURE
+
+    Append an integer to the message in decimal. */
+extern PREFIX int Msg_writer_int(Msg_writer_type *writer,
+				 int              value);
+
+/** @internal
+    @param writer The message writer
+    @param tag The element
+    @param closing REG_TRUE for a closing tag
+    @param newline REG_TRUE to follow the tag with a newline
+    @return REG_SUCCESS, REG_FAILURE
+
+    Append the opening or closing xml tag of an element. */
+extern PREFIX int Msg_writer_tag(Msg_writer_type *writer,
+				 int              tag,
+				 int              closing,
+				 int              newline);
+
+/** @internal
+    @param writer The message writer
+    @return REG_SUCCESS, REG_FAILURE
+
+    Begin the message: the ReG-specific XML header or, in the binary
+    wire format, the magic and version bytes followed by the opening
+    of the root element. */
+extern PREFIX int Msg_writer_header(Msg_writer_type *writer);
+
+/** @internal
+    @param writer The message writer
+    @return REG_SUCCESS, REG_FAILURE
+
+    Complete the message begun with Msg_writer_header(). */
+extern PREFIX int Msg_writer_footer(Msg_writer_type *writer);
+
+/** @internal
+    @param writer The message writer
+    @param tag The element to open
+    @return REG_SUCCESS, REG_FAILURE
+
+    Open an element that will contain other elements. It must be
+    closed with Msg_writer_end(). */
+extern PREFIX int Msg_writer_begin(Msg_writer_type *writer,
+				   int              tag);
+
+/** @internal
+    @param writer The message writer
+    @param tag The element to close - must be the one most recently
+    opened with Msg_writer_begin()
+    @return REG_SUCCESS, REG_FAILURE
+
+    Close an element opened with Msg_writer_begin(). */
+extern PREFIX int Msg_writer_end(Msg_writer_type *writer,
+				 int              tag);
+
+/** @internal
+    @param writer The message writer
+    @param tag The element to write
+    @param value The value of the element, '\0'-terminated
+    @return REG_SUCCESS, REG_FAILURE
+
+    Append a leaf element holding a string, escaped as necessary. */
+extern PREFIX int Msg_writer_element_string(Msg_writer_type *writer,
+					    int              tag,
+					    const char      *value);
+
+/** @internal
+    @param writer The message writer
+    @param tag The element to write
+    @param value The value of the element
+    @return REG_SUCCESS, REG_FAILURE
+
+    Append a leaf element holding an integer. */
+extern PREFIX int Msg_writer_element_int(Msg_writer_type *writer,
+					 int              tag,
+					 int              value);
 
-    Write ReG-specific XML header information into supplied message
-    buffer  */
-extern PREFIX int Write_xml_header(char** pchar, int* bytes_free);
+/** @internal
+    @param writer The message writer
+    @param tag The element to write
+    @param type Type of the parameter the value belongs to
+    @param value The value of the element
+    @return REG_SUCCESS, REG_FAILURE
+
+    Append a leaf element holding a parameter value, converted to
+    text (see Param_value_to_string()). */
+extern PREFIX int Msg_writer_element_value(Msg_writer_type        *writer,
+					   int                     tag,
+					   int                     type,
+					   const Param_value_type *value);
+
+/** @internal
+    @param writer The message writer
+    @param tag The element to write
+    @param data The value of the element
+    @param num_bytes Length of @p data, or -1 if it is
+    '\0'-terminated
+    @return REG_SUCCESS, REG_FAILURE
+
+    Append a leaf element whose value is held in a buffer that
+    need not be '\0'-terminated (@e e.g. Base64-encoded data).
+    The value is escaped as necessary. */
+extern PREFIX int Msg_writer_element_bytes(Msg_writer_type *writer,
+					   int              tag,
+					   const char      *data,
+					   int              num_bytes);
+
+/** @internal
+    @param tag The element
+    @return The name of the element in the XML wire format
+
+    Look up the name of a message element. */
+extern PREFIX const char *Msg_tag_name(int tag);
+
+/** @internal
+    @param writer The message writer
+
+    Done with a message writer - its buffer is kept for reuse by
+    Init_msg_writer(). */
+extern PREFIX void Delete_msg_writer(Msg_writer_type *writer);
 
 /** @internal
-    @param pchar Pointer to buffer in which to put footer
-    @param bytes_free Amount of free space in supplied buffer
+    @param writer The message writer
 
-    Write ReG-specific XML footer information into supplied message
-    buffer */
-extern PREFIX int Write_xml_footer(char **pchar,
-				   int bytes_free);
+    Empty the message writer, ready to build another message in
+    the same buffer. */
+extern PREFIX void Msg_writer_reset(Msg_writer_type *writer);
+
+/** @internal
+    @param writer The message writer
+    @return The buffer holding the message
+
+    Take the buffer away from a message writer. The caller must
+    free() it. */
+extern PREFIX char *Msg_writer_take_buf(Msg_writer_type *writer);
+
+/** @internal
+    Free the message buffers kept for reuse. */
+extern PREFIX void Free_msg_writer_bufs();
 
 /** @internal
     @param filename Name of file to read
@@ -540,6 +1170,166 @@ extern PREFIX int Reorder_decode_array(IOdef_entry *io,
 				       int          count,
 				       void        *pData);
 
+/** @internal
+    @param type Type of data (REG_INT, REG_LONG, REG_FLOAT or REG_DBL)
+    @param count No. of data elements
+    @param pData Pointer to the data
+    @param encode Whether to encode (REG_TRUE) to XDR or decode
+    (REG_FALSE) from it
+    @return No. of bytes the data takes up in XDR form, or 0 if
+    @p type can't be converted
+
+    Convert an array to or from XDR without a second buffer. XDR
+    longs are four bytes, so an encoded REG_LONG array shrinks to the
+    front of @p pData and a decoded one grows back out. */
+extern PREFIX size_t Convert_xdr_in_place(int   type,
+					  int   count,
+					  void *pData,
+					  int   encode);
+
+/** @internal
+    @param array Extent of the whole array in @p totx, @p toty and
+    @p totz
+    @param roi Sub-block and stride wanted; on return clipped to lie
+    within the array
+    @return No. of elements in the sub-block, zero if it misses the
+    array altogether
+
+    Fit a consumer's request for part of an array to the array. */
+extern PREFIX int Clip_array_roi(const Array_type *array,
+				 Roi_type         *roi);
+
+/** @internal
+    @param array Extent of the whole array, @e x varying fastest
+    @param roi Sub-block and stride to gather, as returned by
+    Clip_array_roi()
+    @param size Size in bytes of each array element
+    @param pIn Pointer to the whole array
+    @param pOut Pointer to buffer to hold the sub-block (must hold
+    as many elements as Clip_array_roi() said)
+
+    Copy every @p dx, @p dy, @p dz'th element of the sub-block of
+    @p pIn described by @p roi into @p pOut. */
+extern PREFIX void Gather_array_roi(const Array_type *array,
+				    const Roi_type   *roi,
+				    size_t            size,
+				    const void       *pIn,
+				    void             *pOut);
+
+/** @internal
+    @param ndims No. of dimensions in the layout
+    @param extent No. of elements in each dimension
+    @param stride Distance in bytes between neighbouring elements in
+    each dimension
+    @param size Size in bytes of each element
+    @return REG_TRUE if the elements are packed one after the other,
+    REG_FALSE otherwise */
+extern PREFIX int Layout_is_contiguous(int         ndims,
+				       const int  *extent,
+				       const long *stride,
+				       size_t      size);
+
+/** @internal
+    @param out Pointer to first element to write
+    @param out_stride Distance in bytes between elements written
+    @param in Pointer to first element to read
+    @param in_stride Distance in bytes between elements read
+    @param n No. of elements to copy
+    @param size Size in bytes of each element
+
+    Copy a run of @p n elements between two strided arrays. */
+extern PREFIX void Copy_strided_row(char       *out,
+				    long        out_stride,
+				    const char *in,
+				    long        in_stride,
+				    int         n,
+				    size_t      size);
+
+/** @internal
+    @param ndims No. of dimensions in the layout (at most
+    REG_MAX_LAYOUT_DIMS)
+    @param extent No. of elements in each dimension, the first
+    varying fastest
+    @param stride Distance in bytes between neighbouring elements in
+    each dimension
+    @param size Size in bytes of each element
+    @param pStrided Pointer to the first element of the strided array
+    @param pPacked Pointer to the packed array
+    @param gather If REG_TRUE, copy from @p pStrided to @p pPacked;
+    otherwise scatter from @p pPacked back to @p pStrided
+
+    Gather a strided array into, or scatter it from, a packed one a
+    row at a time. */
+extern PREFIX void Copy_array_layout(int         ndims,
+				     const int  *extent,
+				     const long *stride,
+				     size_t      size,
+				     void       *pStrided,
+				     void       *pPacked,
+				     int         gather);
+
+/** @internal
+    @param n Extent of the array in each direction, @e x varying
+    fastest
+    @param DataType Type of the array elements (REG_FLOAT or REG_DBL)
+    @param pIn Pointer to the array
+    @param pOut Pointer to buffer to hold the coarser array, with
+    (n[i]+1)/2 elements in each direction
+    @return REG_SUCCESS, REG_FAILURE
+
+    Halve the resolution of an array by averaging each 2x2x2 block of
+    elements (fewer at odd edges) into one. */
+extern PREFIX int Coarsen_array(const int  *n,
+				int         DataType,
+				const void *pIn,
+				void       *pOut);
+
+/** @internal
+    @param history The history to set up
+    @param depth No. of data sets to keep (at most
+    REG_MAX_HISTORY_DEPTH), 0 for none
+    @return REG_SUCCESS, REG_FAILURE
+
+    Set up an IOType's history of consumed data sets, throwing away
+    any data sets it held. */
+extern PREFIX int History_init(History_type *history,
+			       int           depth);
+
+/** @internal
+    @param history The history to free
+
+    Free all of the storage held by an IOType's history. */
+extern PREFIX void History_free(History_type *history);
+
+/** @internal
+    @param history The history to add to
+
+    Start a new data set in the history, in place of the oldest if
+    the history is full. The slot's storage is kept for reuse. */
+extern PREFIX void History_begin_dataset(History_type *history);
+
+/** @internal
+    @param history The history to add to
+    @param type Type of the data (REG_INT etc.)
+    @param count No. of elements
+    @param nbytes Size of the decoded data in bytes
+    @return Pointer to aligned storage for the slice, or NULL on
+    failure
+
+    Add a slice to the current data set in the history and return
+    where to put it. */
+extern PREFIX void *History_add_slice(History_type *history,
+				      int           type,
+				      int           count,
+				      size_t        nbytes);
+
+/** @internal
+    @param history The history to search
+    @param seqnum Sequence no. of the data set wanted
+    @return The data set, or NULL if it isn't held */
+extern PREFIX History_dataset_type *History_find_dataset(History_type *history,
+							 int           seqnum);
+
 /** @internal
     Return the current (GMT) date and time as a string in the format
     YYYY-MM-DDTHH:MM:SSZ suitable for inclusion in XML documents */
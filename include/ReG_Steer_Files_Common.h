@@ -55,6 +55,42 @@
  */
 
 #include "ReG_Steer_types.h"
+#include "ReG_Steer_Samples_Archive.h"
+#include "ReG_Steer_Files_Writer.h"
+#include "ReG_Steer_Uring.h"
+
+/** No striping - all data files go to one directory */
+#define REG_STRIPE_NONE       0
+/** Whole data sets are spread over the directories */
+#define REG_STRIPE_DATASET    1
+/** The slices of each data set are spread over the directories */
+#define REG_STRIPE_SLICE      2
+
+/** Directories are used in turn */
+#define REG_STRIPE_ROUNDROBIN 0
+/** Directory is chosen by hashing label and sequence/slice number */
+#define REG_STRIPE_HASH       1
+
+/** Separator between entries in REG_DATA_DIRECTORIES */
+#ifdef _MSC_VER
+#define REG_PATH_LIST_SEPARATOR ';'
+#else
+#define REG_PATH_LIST_SEPARATOR ':'
+#endif
+
+/** One stripe file of a data set whose slices are striped */
+typedef struct {
+  /** Full path of the stripe file */
+  char  filename[REG_MAX_STRING_LENGTH];
+  /** Pointer to open file - reading or synchronous writing */
+  FILE* fp;
+  /** Write-behind writer - NULL if writing synchronously with @p fp */
+  file_writer_type* writer;
+  /** Whether the stripe file is currently open via @p writer */
+  int   writer_open;
+  /** Current position in the stripe file */
+  unsigned long long offset;
+} file_stripe_type;
 
 typedef struct {
   /** Base filename - for file-based IO */
@@ -63,6 +99,47 @@ typedef struct {
   char  directory[REG_MAX_STRING_LENGTH];
   /** Pointer to open file - for file-based IO */
   FILE* fp;
+  /** Number of bytes written to the current data file */
+  unsigned long long offset;
+  /** Alignment (bytes) to apply to slice payloads, 0 for none */
+  int   alignment;
+  /** Sequence number of the data set being written */
+  int   seqnum;
+  /** Index entries for the slices written to the current data file */
+  REG_archive_slice_type* slices;
+  /** Number of entries used in @p slices */
+  int   num_slices;
+  /** Number of entries allocated in @p slices */
+  int   max_slices;
+  /** Write-behind writer - NULL if writing synchronously with @p fp */
+  file_writer_type* writer;
+  /** Whether a data file is currently open via @p writer */
+  int   writer_open;
+  /** No. of blocks queued by @p writer (monitored parameter) */
+  int   write_queue_depth;
+  /** Throughput of @p writer in MB/s (monitored parameter) */
+  float write_mbps;
+  /** Group of files to publish together when writers are in use */
+  file_writer_group_type* group;
+  /** Number of entries in @p directories - 0 if only @p directory
+      is in use */
+  int   num_directories;
+  /** Directories to stripe over (from REG_DATA_DIRECTORIES) */
+  char** directories;
+  /** One of REG_STRIPE_NONE, REG_STRIPE_DATASET or REG_STRIPE_SLICE */
+  int   stripe_mode;
+  /** One of REG_STRIPE_ROUNDROBIN or REG_STRIPE_HASH */
+  int   stripe_policy;
+  /** Stripe files of the current data set */
+  file_stripe_type* stripes;
+  /** Number of entries allocated in @p stripes */
+  int   max_stripes;
+  /** Number of stripe files in use for the current data set */
+  int   num_stripes;
+  /** Stripe that the next payload goes to/comes from, -1 for none */
+  int   current_stripe;
+  /** io_uring used for synchronous writes, NULL to use stdio */
+  uring_type* uring;
 } file_info_type;
 
 typedef struct {
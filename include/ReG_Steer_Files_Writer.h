@@ -0,0 +1,260 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+#ifndef __REG_STEER_FILES_WRITER_H__
+#define __REG_STEER_FILES_WRITER_H__
+
+/** @internal
+    @file ReG_Steer_Files_Writer.h
+    @brief A write-behind file writer for file-based sample data.
+
+    Data handed to the writer is copied into large, aligned blocks
+    which a separate thread writes to disk, so the caller only pays
+    for a memcpy. The number of blocks in flight is bounded: once
+    they are all queued the caller blocks until one has been written.
+    Optionally files are opened with O_DIRECT and/or the written
+    pages are dropped from the page cache with posix_fadvise once
+    they are on disk. A file is only "published", by creating its
+    lock file, once it has been flushed to disk.
+
+    Requests are processed strictly in order so a writer may be used
+    for a sequence of files.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_types.h"
+
+#if REG_HAS_PTHREADS
+#include <pthread.h>
+#endif
+
+/** Default size of a write block in bytes */
+#define REG_WRITER_BLOCK_SIZE 4194304
+/** Alignment of write blocks (and block size) for direct I/O */
+#define REG_WRITER_ALIGNMENT 4096
+
+/** Open files with O_DIRECT if supported */
+#define REG_WRITER_DIRECT_IO 1
+/** Drop written pages from the page cache once on disk */
+#define REG_WRITER_FADVISE   2
+
+/** @internal A set of files, possibly written by different writers,
+    that is published with a single lock file once all of them are on
+    disk */
+typedef struct {
+  /** No. of files still to be closed */
+  int  remaining;
+  /** Non-zero if writing any of the files failed */
+  int  error;
+  /** Name of the file whose lock file is created */
+  char filename[REG_MAX_STRING_LENGTH];
+#if REG_HAS_PTHREADS
+  pthread_mutex_t mutex;
+#endif
+} file_writer_group_type;
+
+/** @internal A request for the writer thread */
+typedef struct {
+  /** One of REG_WRITER_OPEN, REG_WRITER_DATA, REG_WRITER_CLOSE */
+  int    type;
+  /** Block of data (REG_WRITER_DATA only) */
+  char*  block;
+  /** Number of valid bytes in @p block */
+  size_t num_bytes;
+  /** File to open or close */
+  char   filename[REG_MAX_STRING_LENGTH];
+  /** Number of the file to open (REG_WRITER_OPEN only) */
+  int    file_id;
+  /** Group the file being closed belongs to, if any */
+  file_writer_group_type* group;
+} file_writer_request_type;
+
+/** @internal State of a write-behind writer */
+typedef struct {
+  /** Max. no. of blocks that may be queued at once */
+  int    queue_depth;
+  /** Size of each block in bytes */
+  size_t block_size;
+  /** Combination of REG_WRITER_DIRECT_IO and REG_WRITER_FADVISE */
+  int    flags;
+
+  /** Ring of outstanding requests */
+  file_writer_request_type* requests;
+  /** Size of the @p requests ring */
+  int    max_requests;
+  /** Index of the next request to process */
+  int    head;
+  /** No. of requests in the ring */
+  int    num_requests;
+
+  /** Blocks not currently queued or being filled */
+  char** free_blocks;
+  /** No. of entries in @p free_blocks */
+  int    num_free;
+  /** Block currently being filled by the caller */
+  char*  block;
+  /** No. of bytes used in @p block */
+  size_t block_used;
+
+  /** File descriptor of the file being written (writer thread only) */
+  int    fd;
+  /** Whether the file being written has O_DIRECT set */
+  int    fd_direct;
+  /** Non-zero if a write to the current file failed (writer thread
+      only) */
+  int    error;
+  /** Number of the file being written (writer thread only) */
+  int    file_id;
+  /** No. of files the caller has opened */
+  int    num_opened;
+  /** Number of the last file that could not be written. Protected
+      by @p mutex */
+  int    failed_file;
+  /** Whether the writer thread should keep running */
+  int    running;
+
+  /** Bytes written to the current file */
+  double bytes_written;
+  /** Time the current file was opened */
+  double start_time;
+  /** Throughput in MB/s achieved for the last completed file */
+  float  mbps;
+
+#if REG_HAS_PTHREADS
+  pthread_t       thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+#endif
+} file_writer_type;
+
+/** @internal
+    @param writer Writer to initialize
+    @param queue_depth Max. no. of blocks in flight
+    @param block_size Size of each block (rounded up to
+    REG_WRITER_ALIGNMENT), 0 for REG_WRITER_BLOCK_SIZE
+    @param flags Combination of REG_WRITER_DIRECT_IO and
+    REG_WRITER_FADVISE
+    @return REG_SUCCESS or REG_FAILURE
+
+    Allocate the blocks and start the writer thread */
+int File_writer_init(file_writer_type* writer,
+		     const int         queue_depth,
+		     const size_t      block_size,
+		     const int         flags);
+
+/** @internal
+    @param writer Writer to shut down
+
+    Wait for all outstanding requests to complete then stop the
+    writer thread and free its resources */
+void File_writer_finalize(file_writer_type* writer);
+
+/** @internal
+    @param writer Writer to use
+    @param filename Full path of file to create
+    @return REG_SUCCESS or REG_FAILURE
+
+    Queue the creation of a new file. Data written subsequently goes
+    to this file */
+int File_writer_open(file_writer_type* writer,
+		     const char*       filename);
+
+/** @internal
+    @param writer Writer to use
+    @param data Data to write
+    @param num_bytes Number of bytes to write
+    @return REG_SUCCESS or REG_FAILURE if writing the current file
+    has already failed
+
+    Copy data into the current block, queueing blocks as they fill.
+    Blocks if the queue is full */
+int File_writer_write(file_writer_type* writer,
+		      const void*       data,
+		      const size_t      num_bytes);
+
+/** @internal
+    @param writer Writer to use
+    @param filename Full path of the file being closed
+    @param group Group the file belongs to or NULL
+    @return REG_SUCCESS or REG_FAILURE
+
+    Queue any partly-filled block and the closing of the current
+    file. Once it is on disk the file's lock file is created or, if
+    @p group is not NULL, the group's lock file is created once the
+    last of its files is on disk. Does not wait for this to happen. */
+int File_writer_close(file_writer_type*       writer,
+		      const char*             filename,
+		      file_writer_group_type* group);
+
+/** @internal
+    @param filename Full path of the file to publish
+    @param num_files Number of files in the group
+    @return The new group or NULL on failure
+
+    Create a group of @p num_files files that will be closed with
+    File_writer_close(). The group frees itself once all of them have
+    been closed. */
+file_writer_group_type* File_writer_group_create(const char* filename,
+						 const int   num_files);
+
+/** @internal
+    @param group Group to free
+
+    Free a group that was never handed to File_writer_close() */
+void File_writer_group_free(file_writer_group_type* group);
+
+/** @internal
+    @param writer Writer to query
+    @param queue_depth On return, no. of blocks queued for writing
+    @param mbps On return, MB/s achieved for the last completed file
+
+    Report the state of the writer */
+void File_writer_stats(file_writer_type* writer,
+		       int*              queue_depth,
+		       float*            mbps);
+
+#endif /* __REG_STEER_FILES_WRITER_H__ */
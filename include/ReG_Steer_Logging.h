@@ -59,6 +59,16 @@
 
 #include "ReG_Steer_XML.h"
 
+/** @internal
+    @param log Pointer to the parameter log
+    @param num_param No. of parameter slots the log must have a
+    flag for
+    @return REG_SUCCESS, REG_FAILURE
+
+    Grow the array of per-parameter 'send all' flags of a parameter
+    log.  New flags are set to REG_TRUE. */
+int Realloc_param_send_all(Chk_log_type *log, int num_param);
+
 /** @internal
     @param log Pointer to log to emit
     @param handle Which parameter log to emit if @p is a parameter log
@@ -152,28 +162,25 @@ int Log_to_xml(Chk_log_type *log,
 
 /** @internal
     @param log Pointer to log structure to get data from
-    @param pchar Pointer to buffer for extracted log data
-    @param count No. of bytes of data returned in @p pchar
+    @param msg Message writer to append the extracted log data to
     @param not_sent_only If set to REG_TRUE then only those entries not
     already sent to the steering client are retrieved
 
     Called from Log_to_xml() for Checkpoint logs */
-int Chk_log_to_xml(Chk_log_type *log,
-		   char        **pchar,
-		   int          *count,
-		   const int     not_sent_only);
+int Chk_log_to_xml(Chk_log_type    *log,
+		   Msg_writer_type *msg,
+		   const int        not_sent_only);
 
 /** @internal
     @param log Pointer to log structure to get data from
     @param handle Handle of parameter for which to extract log data
-    @param pchar On return, pointer to buffer containing extracted data
-    @param count No. of bytes in @p pchar
+    @param msg Message writer to append the extracted log data to
     @param not_sent_only If set to REG_TRUE then only those entries not
     already sent to the steering client are retrieved
 
     Called from Log_to_xml() to get xml representation of a parameter log. */
-int Param_log_to_xml(Chk_log_type *log, int handle, char **pchar,
-		     int *count, const int not_sent_only);
+int Param_log_to_xml(Chk_log_type *log, int handle, Msg_writer_type *msg,
+		     const int not_sent_only);
 
 /** @internal
     @param log Pointer to log structure from which to get data
@@ -196,16 +203,18 @@ int Log_param_values();
 /** @internal
     @param buf Points to the columnar data (space delimited data on
     lines delimited by new-line chars)
-    @param out_buf Points to a buffer pre-allocated to receive the
-    new format log
-    @param out_buf_size Size of @p out_buf in bytes
+    @param msg Message writer to append the xml to
+    @param max_bytes Stop once the message holds this many bytes
     @param handle Specifies which parameter to pull out
+    @return REG_EOD once all of @p buf has been converted, REG_SUCCESS
+    if it stopped early (when @p buf is left pointing at the next
+    line to convert) or REG_FAILURE
 
     Convert a columnar-format log back into XML. */
-int Log_columns_to_xml(char **buf,
-		       char  *out_buf,
-		       int    out_buf_size,
-		       int    handle);
+int Log_columns_to_xml(char            **buf,
+		       Msg_writer_type  *msg,
+		       int               max_bytes,
+		       int               handle);
 
 /** @internal
     @param pBuf Pointer to buffer containing XML describing a log
@@ -216,6 +225,15 @@ int Log_columns_to_xml(char **buf,
     entries which are packed into messages and sent to client */
 int Pack_send_log_entries(char **pBuf, int *msg_count);
 
+/** @internal
+    @param msg Message holding log entries
+    @return REG_SUCCESS, REG_FAILURE or REG_UNFINISHED if the message
+    could not be sent
+
+    Complete a message begun by Pack_send_log_entries() and send it
+    to the client */
+int Send_log_msg(Msg_writer_type *msg);
+
 /** @internal
     @param control The control message to log
 
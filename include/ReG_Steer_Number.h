@@ -0,0 +1,114 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+#ifndef __REG_STEER_NUMBER_H__
+#define __REG_STEER_NUMBER_H__
+
+/** @internal
+    @file ReG_Steer_Number.h
+    @brief Routines for converting floating point parameter values to
+    and from text.
+
+    Values are written with the fewest significant digits that still
+    read back as exactly the same number (the Grisu2 algorithm), so
+    they are both shorter and quicker to produce than with
+    <code>"%.20g"</code>. Text is read back with an exact fast path for
+    the values that this produces and falls back to the C library for
+    anything else, so values sent by older versions of the library are
+    still understood.
+    @author Robert Haines
+  */
+
+/** @internal Size of the buffer needed by Format_double() and
+    Format_float(), including the terminating '\0' */
+#define REG_NUM_BUF_LEN 32
+
+/** @internal
+    @param value The value to format
+    @param buf Buffer of at least REG_NUM_BUF_LEN characters to write
+    the value into
+    @return The number of characters written, not counting the
+    terminating '\0'
+
+    Write @p value using the shortest string that reads back as
+    exactly @p value. Infinities are written as <code>inf</code> and
+    NaNs as <code>nan</code>. */
+int Format_double(double value, char *buf);
+
+/** @internal
+    @param value The value to format
+    @param buf Buffer of at least REG_NUM_BUF_LEN characters to write
+    the value into
+    @return The number of characters written, not counting the
+    terminating '\0'
+
+    As Format_double() but the string is the shortest one that reads
+    back as exactly @p value when read as a float. */
+int Format_float(float value, char *buf);
+
+/** @internal
+    @param str The string to read
+    @param value On success, the value read
+    @return REG_SUCCESS or REG_FAILURE if @p str does not start with a
+    number
+
+    Read a double from the start of @p str. As with
+    <code>sscanf(str, "%lg", value)</code>, leading white space is
+    skipped and anything after the number is ignored. The result is
+    always the double nearest to the decimal value in @p str. */
+int Parse_double(const char *str, double *value);
+
+/** @internal
+    @param str The string to read
+    @param value On success, the value read
+    @return REG_SUCCESS or REG_FAILURE if @p str does not start with a
+    number
+
+    As Parse_double() but for a float. */
+int Parse_float(const char *str, float *value);
+
+#endif
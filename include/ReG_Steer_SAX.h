@@ -0,0 +1,264 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+#ifndef __REG_STEER_SAX_H__
+#define __REG_STEER_SAX_H__
+
+/** @internal
+    @file ReG_Steer_SAX.h
+    @brief Routines for parsing steering messages in a single pass.
+
+    Rather than building a DOM tree and then copying it into a
+    msg_struct, the routines here drive libxml2's SAX2 interface and
+    fill in the msg_struct directly as each element is read. One
+    parser context, and so one string dictionary, is kept for all the
+    messages that are parsed so the names of elements are only ever
+    looked up once and can then be matched by pointer.
+
+    Only ReG_steer_message documents are handled here; anything else
+    (the ResourceProperties documents of the steering web services)
+    is left for Parse_xml() to deal with.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_XML.h"
+
+/** @internal Whether messages are parsed with the SAX parser. The
+    DOM parser is kept when messages are validated against the
+    schema as validation needs the whole document. */
+#define REG_USE_SAX_PARSER (REG_HAS_XMLREADMEMORY && !REG_VALIDATE_XML)
+
+/** @internal Size the string dictionary may grow to before the
+    parser context is thrown away and started afresh */
+#define REG_SAX_MAX_DICT_SIZE 4096
+
+/** @internal What the content of an element being parsed goes
+    into */
+typedef enum {
+  SAX_IGNORE = 0,
+  SAX_ROOT,
+  SAX_STATUS,
+  SAX_CONTROL,
+  SAX_SUPP_CMD,
+  SAX_IO_DEFS,
+  SAX_CHK_DEFS,
+  SAX_IO,
+  SAX_LOG,
+  SAX_LOG_ENTRY,
+  SAX_CHK_LOG_ENTRY,
+  SAX_PARAM,
+  SAX_CMD,
+  SAX_LEAF
+} sax_frame_kind;
+
+/** @internal An element that is open in the message being parsed */
+typedef struct {
+  /** What the element's content goes into */
+  sax_frame_kind kind;
+  /** The structure it fills in or, for a leaf element, the string it
+      is stored in */
+  void          *obj;
+} Sax_frame_type;
+
+/** @internal State of the SAX parser while it works through a
+    message */
+typedef struct {
+  /** The libxml2 parser context, reused for every message */
+  xmlParserCtxtPtr ctxt;
+  /** The dictionary that @p names were looked up in */
+  xmlDictPtr       dict;
+  /** Names of the message elements (indexed by msg_tag_type) as held
+      in @p dict */
+  const xmlChar   *names[MSG_NUM_TAGS];
+  /** The structure being filled in */
+  struct msg_struct *msg;
+  /** Where message UIDs are stored */
+  struct msg_uid_history_struct *uid_store;
+  /** Depth of the element currently open */
+  int              depth;
+  /** The elements currently open */
+  Sax_frame_type   frames[REG_MAX_MSG_DEPTH];
+  /** Whether the type of the message has been found */
+  int              have_type;
+  /** Outcome of the parse so far */
+  int              status;
+  /** Content of the leaf element currently open */
+  char            *text;
+  /** Length of @p text */
+  int              text_len;
+  /** Size of the buffer holding @p text */
+  int              text_size;
+} Sax_parser_type;
+
+/** @internal
+    @param buf Pointer to the message to parse
+    @param size Size (bytes) of the message
+    @param msg Pointer to message struct to hold results
+    @param sim Pointer to Sim_entry struct or NULL (if not called by
+    a steering client)
+    @return REG_SUCCESS, REG_FAILURE or REG_UNFINISHED if the document
+    is not a ReG_steer_message and must be parsed with Parse_xml()
+    instead
+
+    Parse a steering message held in a buffer.
+    @see Parse_xml_buf() */
+int Parse_sax_buf(const char*        buf,
+		  int                size,
+		  struct msg_struct* msg,
+		  Sim_entry_type*    sim);
+
+/** @internal
+    @param filename Name of the file to read and parse
+    @param msg Pointer to message struct to hold results
+    @param sim Pointer to Sim_entry struct or NULL
+    @return As for Parse_sax_buf()
+
+    Parse a steering message held in a file.
+    @see Parse_xml_file() */
+int Parse_sax_file(const char*        filename,
+		   struct msg_struct* msg,
+		   Sim_entry_type*    sim);
+
+/** @internal
+    Free the parser context and everything else held by the SAX
+    parser. It is set up again the next time it is needed. */
+void Cleanup_sax_parser();
+
+/** @internal
+    @param sax The parser
+    @param msg Pointer to message struct to hold results
+    @param sim Pointer to Sim_entry struct or NULL
+    @return REG_SUCCESS or REG_FAILURE
+
+    Get the parser ready to parse a new message, creating its context
+    if need be. */
+int Sax_start_msg(Sax_parser_type*   sax,
+		  struct msg_struct* msg,
+		  Sim_entry_type*    sim);
+
+/** @internal
+    @param sax The parser
+    @return REG_SUCCESS, REG_FAILURE or REG_UNFINISHED
+
+    Finish off a message once libxml2 has been through it and work out
+    the outcome of the parse. */
+int Sax_end_msg(Sax_parser_type* sax);
+
+/** @internal
+    @param sax The parser
+    @param name Local name of an element
+    @return The element's tag or MSG_TAG_NOTSET if it is not one of
+    the message elements
+
+    Identify an element from its name. */
+int Sax_lookup_tag(Sax_parser_type* sax,
+		   const xmlChar*   name);
+
+/** @internal
+    @param sax The parser
+    @param kind What the content of the new element goes into
+    @param obj The structure or string it fills in
+
+    Record what a newly opened element fills in. */
+void Sax_open_frame(Sax_parser_type* sax,
+		    sax_frame_kind   kind,
+		    void*            obj);
+
+/** @internal
+    @param arena The arena of the message
+    @param first The first param in the list
+    @param cur The last param in the list, updated on return
+    @return The new param
+
+    Append a new param to a list of them. */
+struct param_struct* Sax_append_param(Msg_arena_type*       arena,
+				      struct param_struct** first,
+				      struct param_struct** cur);
+
+/** @internal
+    @param arena The arena of the message
+    @param first The first command in the list
+    @param cur The last command in the list, updated on return
+    @return The new command
+
+    Append a new command to a list of them. */
+struct cmd_struct* Sax_append_cmd(Msg_arena_type*     arena,
+				  struct cmd_struct** first,
+				  struct cmd_struct** cur);
+
+/** @internal
+    SAX2 callback for the start of an element */
+void Sax_start_element(void*           ctx,
+		       const xmlChar*  localname,
+		       const xmlChar*  prefix,
+		       const xmlChar*  URI,
+		       int             nb_namespaces,
+		       const xmlChar** namespaces,
+		       int             nb_attributes,
+		       int             nb_defaulted,
+		       const xmlChar** attributes);
+
+/** @internal
+    SAX2 callback for the end of an element */
+void Sax_end_element(void*          ctx,
+		     const xmlChar* localname,
+		     const xmlChar* prefix,
+		     const xmlChar* URI);
+
+/** @internal
+    SAX2 callback for errors. These are not reported as the outcome
+    of the parse is. */
+void Sax_error(void*       ctx,
+	       xmlErrorPtr error);
+
+/** @internal
+    SAX2 callback for character data and CDATA sections */
+void Sax_characters(void*          ctx,
+		    const xmlChar* ch,
+		    int            len);
+
+#endif /* __REG_STEER_SAX_H__ */
@@ -0,0 +1,199 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+#ifndef __REG_STEER_SAMPLES_ARCHIVE_H__
+#define __REG_STEER_SAMPLES_ARCHIVE_H__
+
+/** @file ReG_Steer_Samples_Archive.h
+ *  @brief Layout of the index appended to file-based sample data sets.
+ *
+ *  Every data file written by the file-based samples transport is a
+ *  normal ReG data stream (header, slices, footer) followed by an
+ *  index describing each data set and slice held in the file and a
+ *  fixed-size trailer. Readers that only understand the packet stream
+ *  stop at the footer and never see the index. Readers that do
+ *  understand it read the trailer from the end of the file, then the
+ *  index, and can then seek directly to any slice.
+ *
+ *  All integers in the index and trailer are stored big-endian (as
+ *  for XDR) so that files can be moved between platforms.
+ *
+ *  @code
+ *  [<ReG_data>] ([pad] [slice header] [payload])* [</ReG_data>]
+ *  [index: (dataset record, slice record * num_slices,
+ *           stripe path * num_stripes) * num_datasets]
+ *  [trailer]
+ *  @endcode
+ *
+ *  When slices are striped over several directories the payloads are
+ *  not held in the file itself. Each slice header is instead followed
+ *  by a REG_STRIPE_TAG packet giving the stripe file and the offset of
+ *  the payload within it, and the index lists the stripe files.
+ *
+ *  @author Robert Haines
+ */
+
+/** Magic string at the start of the trailer */
+#define REG_ARCHIVE_MAGIC "ReG_IDX1"
+/** Length of the magic string (no terminator is stored) */
+#define REG_ARCHIVE_MAGIC_LEN 8
+/** Version of the index format. Version 1 had no stripe information
+    (@e i.e. no stripe field in slice records, no num_stripes field in
+    data set records and no stripe paths) */
+#define REG_ARCHIVE_VERSION 2
+
+/** Size of the trailer in bytes. Layout:
+    - 0:  magic (8 bytes)
+    - 8:  version (uint32)
+    - 12: number of data sets (uint32)
+    - 16: offset of the index from start of file (uint64)
+    - 24: length of the index in bytes (uint32)
+    - 28: alignment applied to slice payloads, 0 if none (uint32) */
+#define REG_ARCHIVE_TRAILER_SIZE 32
+
+/** Length of the label field in a data set record */
+#define REG_ARCHIVE_LABEL_LEN 128
+
+/** Length of a stripe path in the index */
+#define REG_ARCHIVE_PATH_LEN 256
+
+/** Size of a data set record in bytes. Layout:
+    - 0:   sequence number (int32)
+    - 4:   number of slices (uint32)
+    - 8:   offset of the data set header packet (uint64)
+    - 16:  IOType label, '\\0'-padded (REG_ARCHIVE_LABEL_LEN bytes)
+    - 144: number of stripe files (uint32)
+    - 148: reserved (4 bytes)
+
+    The slice records are followed by the full paths of the stripe
+    files, '\\0'-padded to REG_ARCHIVE_PATH_LEN bytes each. */
+#define REG_ARCHIVE_DATASET_SIZE (24 + REG_ARCHIVE_LABEL_LEN)
+/** Size of a version 1 data set record in bytes */
+#define REG_ARCHIVE_DATASET_SIZE_V1 (16 + REG_ARCHIVE_LABEL_LEN)
+
+/** Size of a slice record in bytes. Layout:
+    - 0:  data type as given in the slice header, e.g. REG_XDR_DOUBLE (int32)
+    - 4:  number of objects (int32)
+    - 8:  number of bytes of payload (uint64)
+    - 16: non-zero if the array has Fortran ordering (int32)
+    - 20: array geometry - totx, toty, totz, nx, ny, nz,
+          sx, sy, sz (9 x int32)
+    - 56: offset of the slice header (uint64)
+    - 64: offset of the payload (uint64) - in the stripe file if the
+          slice is striped
+    - 72: stripe file holding the payload, -1 if held in this file (int32)
+    - 76: reserved (4 bytes) */
+#define REG_ARCHIVE_SLICE_SIZE 80
+/** Size of a version 1 slice record in bytes */
+#define REG_ARCHIVE_SLICE_SIZE_V1 72
+
+/** Opening tag of the packet following a striped slice header; it
+    holds the stripe number and the offset of the payload in that
+    stripe file */
+#define REG_STRIPE_TAG "<ReG_stripe>"
+/** Format of the stripe packet */
+#define REG_STRIPE_FORMAT "<ReG_stripe>%d %llu</ReG_stripe>"
+/** Tag added to the data header packet to give the no. of stripe files */
+#define REG_STRIPES_FORMAT "<Stripes>%d</Stripes>"
+/** Suffix (followed by the stripe number) of stripe file names */
+#define REG_STRIPE_SUFFIX ".stripe"
+
+/** Description of a single slice as held in the index */
+typedef struct {
+  /** Type of the data as written (@e e.g. REG_XDR_DOUBLE) */
+  int                type;
+  /** Number of objects in the slice */
+  int                count;
+  /** Number of bytes of payload */
+  unsigned long long num_bytes;
+  /** Whether the array has Fortran ordering */
+  int                is_fortran;
+  /** Total extent of the array in each dimension */
+  int                tot[3];
+  /** Extent of this slice in each dimension */
+  int                n[3];
+  /** Starting indices of this slice */
+  int                start[3];
+  /** Offset of the slice header from the start of the file */
+  unsigned long long header_offset;
+  /** Offset of the payload from the start of the file (or of the
+      stripe file) */
+  unsigned long long data_offset;
+  /** Stripe file holding the payload, -1 if in the file itself */
+  int                stripe;
+} REG_archive_slice_type;
+
+/** @internal Store a 32-bit value big-endian at @p p */
+#define REG_ARCHIVE_PUT32(p, v) do {		\
+    unsigned char* _q = (unsigned char*)(p);	\
+    unsigned long  _v = (unsigned long)(v);	\
+    _q[0] = (unsigned char)(_v >> 24);		\
+    _q[1] = (unsigned char)(_v >> 16);		\
+    _q[2] = (unsigned char)(_v >> 8);		\
+    _q[3] = (unsigned char)(_v);		\
+  } while(0)
+
+/** @internal Store a 64-bit value big-endian at @p p */
+#define REG_ARCHIVE_PUT64(p, v) do {					\
+    unsigned long long _w = (unsigned long long)(v);			\
+    REG_ARCHIVE_PUT32((unsigned char*)(p), _w >> 32);			\
+    REG_ARCHIVE_PUT32((unsigned char*)(p) + 4, _w & 0xffffffffULL);	\
+  } while(0)
+
+/** @internal Read a big-endian 32-bit value from @p p */
+#define REG_ARCHIVE_GET32(p)					\
+  (((unsigned long)((const unsigned char*)(p))[0] << 24) |	\
+   ((unsigned long)((const unsigned char*)(p))[1] << 16) |	\
+   ((unsigned long)((const unsigned char*)(p))[2] << 8)  |	\
+   ((unsigned long)((const unsigned char*)(p))[3]))
+
+/** @internal Read a big-endian 64-bit value from @p p */
+#define REG_ARCHIVE_GET64(p)					\
+  (((unsigned long long)REG_ARCHIVE_GET32(p) << 32) |		\
+   (unsigned long long)REG_ARCHIVE_GET32((const unsigned char*)(p) + 4))
+
+#endif /* __REG_STEER_SAMPLES_ARCHIVE_H__ */
@@ -195,6 +195,25 @@ int Consume_ack_impl(const int index);
  */
 int Get_IOType_address_impl(int index, char** pbuf, int* bytes_left);
 
+/** @internal
+    @param index Index of the IOType the buffer was emitted on
+    @param pData Buffer passed to Emit_data_impl(), or NULL for all
+    @param block Whether to wait until the buffer may be reused
+    @return REG_SUCCESS if the buffer may be reused, REG_NOT_READY or
+    REG_FAILURE
+
+    Report whether the transport has finished with a buffer it was
+    allowed to send from without copying. */
+int Release_data_impl(const int index, const void* pData, const int block);
+
+/** @internal
+    @param index Index of an emitting IOType
+
+    Called between data sets so that the transport can deal with
+    consumers that have connected since the last one, @e e.g. by
+    giving them a copy of it. */
+int Poll_IOType_impl(const int index);
+
 int Emit_start_impl(int index, int seqnum);
 
 int Emit_stop_impl(int index);
@@ -220,6 +239,8 @@ REG_DECLARE_FUNC(int, Consume_data_read, (const int, const int, const int, void*
 REG_DECLARE_FUNC(int, Emit_ack, (const int));
 REG_DECLARE_FUNC(int, Consume_ack, (const int));
 REG_DECLARE_FUNC(int, Get_IOType_address, (int, char**, int*));
+REG_DECLARE_FUNC(int, Release_data, (const int, const void*, const int));
+REG_DECLARE_FUNC(int, Poll_IOType, (const int));
 REG_DECLARE_FUNC(int, Emit_start, (int, int));
 REG_DECLARE_FUNC(int, Emit_stop, (int));
 REG_DECLARE_FUNC(int, Consume_stop, (int));
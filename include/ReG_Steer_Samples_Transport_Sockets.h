@@ -63,18 +63,84 @@
     Create a listening socket */
 int create_listener_samples(const int index);
 
+/** @internal
+    @param index Index of the IOType to which socket belongs
+
+    Create a Unix-domain listening socket alongside the TCP one, if
+    REG_IO_UNIX_DIRECTORY is set, for consumers on the same host */
+int create_local_listener_samples(const int index);
+
+/** @internal
+    @param index Index of the IOType to which socket belongs
+
+    Connect to the emitter over a Unix-domain socket if it is on this
+    host and listening on one */
+int connect_local_connector_samples(const int index);
+
+/** @internal
+    @param index Index of the IOType to which socket belongs
+
+    Set up an io_uring for the IOType's sends and receives if
+    REG_IO_URING is set. Failure is not fatal - the IOType then uses
+    plain system calls. */
+void create_uring_samples(const int index);
+
 /** @internal
     @param index Index of the IOType to which socket belongs
 
     Create a connector socket */
 int create_connector_samples(const int index);
 
+/** @internal
+    @param index Index of the IOType to which socket belongs
+    @return The bound socket or REG_SOCKETS_ERROR
+
+    Create a socket bound to a port in the range we may connect out of */
+int bind_connector_samples(const int index);
+
 /** @internal
     @param index Index of the IOType to which socket belongs
 
     Sets up and then attempts to connect a connector */
 int connect_connector_samples(const int index);
 
+/** @internal
+    @param index Index of the IOType to which socket belongs
+    @param addr Address the first connection was made to
+    @param addrlen Length of @p addr
+
+    Make the extra connections to the emitter that data may be striped
+    over, if REG_IO_STREAMS asks for them. On failure we carry on with
+    the one connection. */
+int connect_streams_samples(const int index, const struct sockaddr* addr,
+			    const socklen_t addrlen);
+
+/** @internal
+    @param index Index of the IOType to which socket belongs
+    @return REG_TRUE once all of the consumer's extra connections have
+    been accepted, REG_FALSE otherwise
+
+    Accept any extra connections the consumer has made so that data
+    can be striped over them. */
+int accept_streams_samples(const int index);
+
+/** @internal
+    @param index Index of the IOType to which socket belongs
+
+    Emit_header() for an IOType with several subscribers: accept any
+    new ones and start building the next data set for them */
+int Emit_subscribers_header_sockets(const int index);
+
+/** @internal
+    @param index Index of the IOType to which socket belongs
+    @param num_bytes No. of bytes being sent
+    @param pData Pointer to the data being sent
+
+    Add data being sent to the copy of the data set kept for late
+    consumers, if one is being kept (see REG_IO_RETAIN_LAST) */
+void retain_data_sockets(const int index, const size_t num_bytes,
+			 const void* pData);
+
 /** @internal
     @param index Index of the IOType to which socket belongs
 
@@ -99,6 +165,15 @@ void close_listener_handle_samples(const int index);
     Calls close on the connector handle */
 void close_connector_handle_samples(const int index);
 
+/** @internal
+    @param index Index of the IOType to which socket belongs
+    @return REG_SUCCESS, REG_FAILURE if the connection has gone
+
+    Reads any requests from the consumer for only part of each array,
+    or fewer levels of detail, that are waiting ahead of its
+    acknowledgement */
+int Consume_consumer_requests(const int index);
+
 /** @internal
     @param index Index of the IOType to which socket belongs
 
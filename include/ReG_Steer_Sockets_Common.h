@@ -55,9 +55,85 @@
  */
 
 #include "ReG_Steer_types.h"
+#include "ReG_Steer_Uring.h"
 
 #define REG_SOCKETS_ERROR -1
 
+/** Prefix of an address that names a Unix-domain socket */
+#define REG_UNIX_ADDRESS_PREFIX "unix:"
+/** Default size (bytes) of payload at and above which payloads are
+    sent with MSG_ZEROCOPY, if the IOType allows it */
+#define REG_ZEROCOPY_THRESHOLD 1048576
+/** Smallest allowed zero-copy threshold - below this the cost of
+    pinning pages and handling notifications outweighs the copy */
+#define REG_ZEROCOPY_MIN_THRESHOLD 16384
+/** Most TCP connections that an IOType's data may be striped over */
+#define REG_MAX_STREAMS 16
+/** Size (bytes) of the chunks that payloads are split into when
+    striped over several connections */
+#define REG_STREAM_CHUNK 1048576
+/** Format of the packet that opens each extra connection; gives the
+    consumer's port on the first connection, the index of this
+    connection and the total no. of connections */
+#define REG_STREAM_HELLO_FORMAT "<ReG_stream>%d %d %d</ReG_stream>"
+/** Format of the packet with which an emitter starts striping; gives
+    the no. of connections and the chunk size */
+#define REG_STREAMS_FORMAT "<ReG_streams>%d %lu</ReG_streams>"
+
+/** @internal
+    A user buffer that the kernel may still be sending from because
+    it was passed to send() with MSG_ZEROCOPY */
+typedef struct {
+  /** Start of the buffer */
+  const void*		data;
+  /** Id of the first send() made from the buffer */
+  unsigned int		first;
+  /** Id of the last send() made from the buffer */
+  unsigned int		last;
+  /** No. of those sends that the kernel has finished with */
+  unsigned int		completed;
+} zerocopy_buffer_type;
+
+/** Most consumers that one emitting IOType may send to at once */
+#define REG_MAX_SUBSCRIBERS 64
+
+/** @internal
+    A data set as sent down the wire - built once and shared by all the
+    subscribers it is being sent to */
+typedef struct {
+  /** The data */
+  char*			data;
+  /** No. of bytes of @p data used */
+  size_t		size;
+  /** No. of bytes allocated for @p data */
+  size_t		max;
+  /** No. of subscribers still sending it, plus one while it's being
+      built */
+  int			refs;
+} dataset_buffer_type;
+
+/** @internal
+    One of several consumers connected to an emitting IOType */
+typedef struct {
+  /** Handle of the connection */
+  int			handle;
+  /** Data set being sent, NULL if none */
+  dataset_buffer_type*	dataset;
+  /** No. of bytes of @p dataset sent so far */
+  size_t		sent;
+  /** Whether to wait for an acknowledgement of @p dataset before
+      sending another */
+  int			use_ack;
+  /** Whether we are waiting for an acknowledgement */
+  int			ack_needed;
+  /** Partial acknowledgement read so far */
+  char			ack[17];
+  /** No. of bytes in @p ack */
+  int			ack_bytes;
+  /** No. of data sets not sent because the consumer was busy */
+  int			skipped;
+} subscriber_type;
+
 /** @internal
     Structure to hold socket information */
 typedef struct {
@@ -87,6 +163,54 @@ typedef struct {
   int			listener_status;
   /** status indicator for connecting socket */
   int			comms_status;
+  /** Handle of Unix-domain listener socket, -1 if none */
+  int			local_listener_handle;
+  /** Path of the Unix-domain socket listened on or connected to */
+  char*                 local_path;
+  /** Whether the connection is over a Unix-domain socket */
+  int			is_local;
+  /** io_uring used for sends and receives, NULL to use plain system
+      calls */
+  uring_type*		uring;
+  /** Payloads of at least this many bytes are sent with MSG_ZEROCOPY
+      if the IOType allows it (zero to never do so) */
+  size_t		zerocopy_threshold;
+  /** Whether SO_ZEROCOPY has been set on the current connection */
+  int			zerocopy_enabled;
+  /** Id the kernel will give the next MSG_ZEROCOPY send() */
+  unsigned int		zerocopy_next;
+  /** Buffers the kernel may still be sending from */
+  zerocopy_buffer_type* zerocopy_buffers;
+  /** No. of entries used in @p zerocopy_buffers */
+  int			zerocopy_num;
+  /** No. of entries allocated in @p zerocopy_buffers */
+  int			zerocopy_max;
+  /** Most TCP connections to stripe data over (one to never stripe) */
+  int			num_streams;
+  /** No. of connections data is currently striped over */
+  int			streams;
+  /** Payloads are striped in chunks of this many bytes */
+  size_t		stream_chunk;
+  /** Handles of the connections after the first, -1 if unused */
+  int			stream_handles[REG_MAX_STREAMS - 1];
+  /** Most consumers to send each data set to (zero for just the one
+      on @p connector_handle) */
+  int			max_subscribers;
+  /** No. of entries used in @p subscribers */
+  int			num_subscribers;
+  /** The consumers being sent to, if @p max_subscribers is set */
+  subscriber_type*	subscribers;
+  /** Data set being built, NULL if none */
+  dataset_buffer_type*	dataset;
+  /** Data set buffer kept for reuse, NULL if none */
+  dataset_buffer_type*	spare_dataset;
+  /** Whether to keep the last complete data set for consumers that
+      connect after it was emitted */
+  int			retain_last;
+  /** The last complete data set, NULL if none */
+  dataset_buffer_type*	retained;
+  /** Whether the consumer must acknowledge @p retained */
+  int			retained_use_ack;
 } socket_info_type;
 
 typedef struct {
@@ -179,6 +303,139 @@ ssize_t send_no_signal(int s, const void *buf, size_t len, int flags);
     See recv(2). */
 ssize_t recv_wait_all(int s, void *buf, size_t len, int flags);
 
+/** @internal
+    @param socket_info Socket information for a connected TCP socket
+    @param buf Pointer to the data to send
+    @param len Number of bytes to send
+    @return REG_SUCCESS or REG_FAILURE
+
+    Send data with MSG_ZEROCOPY so that the kernel reads it straight
+    from @p buf. @p buf must not be modified until
+    release_zerocopy() says that it may. Falls back to an ordinary
+    send() if zero-copy is not supported on the socket. */
+int send_zerocopy(socket_info_type* socket_info, const void* buf,
+		  size_t len);
+
+/** @internal
+    @param socket_info Socket information for the connection
+    @param buf Buffer previously passed to send_zerocopy(), or NULL
+    for all such buffers
+    @param block Whether to wait for the kernel to finish with the
+    buffer
+    @return REG_SUCCESS if the buffer may be reused, REG_NOT_READY if
+    it may not (non-blocking only) or REG_FAILURE
+
+    Read zero-copy completion notifications from the socket's error
+    queue and report whether the kernel has finished with @p buf. */
+int release_zerocopy(socket_info_type* socket_info, const void* buf,
+		     int block);
+
+/** @internal
+    @param socket_info Socket information for the connection about to
+    be closed
+
+    Give outstanding zero-copy sends a short time to complete and
+    then forget about them, ready for a new connection. */
+void reset_zerocopy(socket_info_type* socket_info);
+
+/** @internal
+    @param socket_info Socket information for the connection
+    @param buf Pointer to the data to send
+    @param len Number of bytes to send
+    @return REG_SUCCESS or REG_FAILURE
+
+    Send data split into chunks of @p stream_chunk bytes, dealt out
+    in turn to each of the @p streams connections. Each connection is
+    written to as soon as it can take more data. */
+int send_striped(socket_info_type* socket_info, const void* buf,
+		 size_t len);
+
+/** @internal
+    @param socket_info Socket information for the connection
+    @param buf Pointer to buffer in which to put received data (must
+    be at least @p len in size)
+    @param len Number of bytes expected
+    @return As recv_wait_all()
+
+    Blocking receive of data sent with send_striped(), reassembled in
+    order. */
+ssize_t recv_striped(socket_info_type* socket_info, void* buf,
+		     size_t len);
+
+/** @internal
+    @param socket_info Socket information for the connection
+
+    Close any connections after the first and go back to sending
+    everything down the first. */
+void close_streams(socket_info_type* socket_info);
+
+/** @internal
+    @param socket_info Socket information for an emitting IOType with
+    @p max_subscribers set
+    @return REG_SUCCESS if any subscriber is ready for a new data set,
+    REG_FAILURE otherwise
+
+    Accept new subscribers from the listeners, collect their
+    acknowledgements and carry on sending them their data sets, as far
+    as can be done without blocking. Subscribers that have gone away
+    are dropped. */
+int service_subscribers(socket_info_type* socket_info);
+
+/** @internal
+    @param socket_info Socket information for the emitting IOType
+    @return REG_SUCCESS or REG_FAILURE
+
+    Start building a new data set to send to the subscribers. */
+int begin_dataset(socket_info_type* socket_info);
+
+/** @internal
+    @param socket_info Socket information for the emitting IOType
+    @param buf Pointer to the data to add
+    @param len Number of bytes to add
+    @return REG_SUCCESS or REG_FAILURE
+
+    Add data to the end of the data set being built. */
+int append_dataset(socket_info_type* socket_info, const void* buf,
+		   size_t len);
+
+/** @internal
+    @param socket_info Socket information for the emitting IOType
+    @param use_ack Whether subscribers must acknowledge the data set
+    before being sent another
+
+    Start sending the data set just built to every subscriber that is
+    ready for it. Those still busy with an earlier one miss it. */
+void publish_dataset(socket_info_type* socket_info, const int use_ack);
+
+/** @internal
+    @param socket_info Socket information for the emitting IOType
+
+    Throw away the data set being built. */
+void abandon_dataset(socket_info_type* socket_info);
+
+/** @internal
+    @param socket_info Socket information for the emitting IOType
+    @param use_ack Whether a consumer must acknowledge the data set
+
+    Keep the data set just built, in place of the last one, to give to
+    consumers that connect before the next is complete. */
+void retain_dataset(socket_info_type* socket_info, const int use_ack);
+
+/** @internal
+    @param socket_info Socket information for the emitting IOType
+    @param s File descriptor of the socket to send on
+    @return REG_SUCCESS or REG_FAILURE
+
+    Send the retained data set down @p s, blocking until it has all
+    gone. */
+int send_retained_dataset(socket_info_type* socket_info, const int s);
+
+/** @internal
+    @param socket_info Socket information for the emitting IOType
+
+    Disconnect all subscribers and free the data sets. */
+void close_subscribers(socket_info_type* socket_info);
+
 /** @internal
     @param s File descriptor of the socket to set.
 
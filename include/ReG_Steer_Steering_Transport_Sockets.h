@@ -59,9 +59,11 @@
 #include "ReG_Steer_Sockets_Common.h"
 
 int consume_supp_cmds(int index);
+int send_wire_format_ack(socket_info_type* socket_info);
 
 int send_steering_msg(socket_info_type* socket_info, const size_t, void*);
-int consume_steering_msg(socket_info_type* socket_info, char*);
+int consume_steering_msg(socket_info_type* socket_info, char**, int*);
+int parse_steering_msg(char*, int, struct msg_struct*, Sim_entry_type*);
 int poll_steering_msg(socket_info_type* socket_info, int);
 
 int create_steering_connector(socket_info_type* socket_info);
@@ -74,7 +74,9 @@
 typedef struct {
   /** Tag associated with this checkpoing */
   char   chk_tag[REG_MAX_STRING_LENGTH];
-  /** No. of parameters for which we have details at this chkpt */
+  /** No. of parameters for which we have details at this chkpt
+      (at most REG_MAX_NUM_STR_PARAMS - a warning is printed if the
+      log entry holds more) */
   int    num_param;
   /** Associated parameter labels at this chkpt */
   char   param_labels[REG_MAX_NUM_STR_PARAMS][REG_MAX_STRING_LENGTH];
@@ -209,7 +211,9 @@ extern PREFIX int Consume_ChkType_defs(int SimHandle);
    @param SimHandle Handle of simulation from which to receive status msg
    @param SeqNum Measure of progress of attached simulation
    @param NumCmds No. of commands received from simulation
-   @param Commands List of commands received from simulation
+   @param Commands List of commands received from simulation - must
+   hold REG_MAX_NUM_STR_CMDS; a warning is printed if the message
+   holds more
    @return REG_SUCCESS, REG_FAILURE, REG_MEM_FAIL
 
    Consume a status message emitted by the simulation associated with
@@ -217,7 +221,9 @@ extern PREFIX int Consume_ChkType_defs(int SimHandle);
    a list of any commands received (@e e.g. notification that it has
    finished). Any parameter values received by this routine are
    automatically used to update the internal library table of
-   parameters.
+   parameters. A simulation that has called Enable_delta_status()
+   only sends the parameters that have changed, and the others keep
+   the values they had.
 */
 extern PREFIX int Consume_status(int   SimHandle,
 				 int  *SeqNum,
@@ -241,8 +247,11 @@ extern PREFIX int Consume_log(int   SimHandle);
 
 /**
    @param SimHandle Handle of the simulation to send control msg to
-   @param NumCommands No. of commands to send (cannot exceed
-   REG_MAX_NUM_STR_CMDS, defined in ReG_Steer_types.h)
+   @param NumCommands No. of commands to send.  All of them, and every
+   modified parameter, go in a single message.  The application passes
+   at most REG_MAX_NUM_STR_CMDS (defined in ReG_Steer_types.h) commands
+   on to its caller per call of Steering_control() and holds the rest
+   over to the next call.
    @param SysCommands List of commands to send
    @param SysCmdParams Parameters (if any) to go with each command
    @return REG_SUCCESS, REG_FAILURE
@@ -0,0 +1,212 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+#ifndef __REG_STEER_TLV_H__
+#define __REG_STEER_TLV_H__
+
+/** @internal
+    @file ReG_Steer_TLV.h
+    @brief Routines for the binary (TLV) steering wire format.
+
+    A message in the binary format holds exactly the same elements as
+    its xml counterpart (see msg_tag_type) but each one is encoded as
+    a one-byte tag, the length of its content and then the content
+    itself, so it can be built and read without any text parsing.
+    Messages are built with a Msg_writer_type and decoded here into
+    the same structures that Parse_xml_buf() produces. The format is
+    negotiated by the steering transport: xml remains the default and
+    the fallback.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_XML.h"
+
+/** @internal
+    @param buf The message
+    @return Total size of the message in bytes or -1 if @p buf is not
+    a message in the binary format
+
+    Find the size of a binary message from its header. Its contents
+    are not checked. */
+int Tlv_msg_size(const char* buf);
+
+/** @internal
+    @return REG_TRUE or REG_FALSE
+
+    Whether the binary wire format may be used. It can be turned off
+    by setting REG_STEER_WIRE_FORMAT to "xml". */
+int Tlv_wire_format_enabled();
+
+/** @internal
+    @param buf Pointer to the message to decode
+    @param size Size (bytes) of the message
+    @param msg Pointer to message struct to hold results
+    @param sim Pointer to Sim_entry struct or NULL (if not called by
+    a steering client)
+    @return REG_SUCCESS or REG_FAILURE if the message is malformed
+
+    Decode a message in the binary format.
+    @see Parse_xml_buf() */
+int Parse_tlv_buf(const char*        buf,
+		  int                size,
+		  struct msg_struct* msg,
+		  Sim_entry_type*    sim);
+
+/** @internal
+    @param pos Position of the next element, advanced past it on
+    return
+    @param end End of the enclosing element
+    @param tag The tag of the element
+    @param value Its content
+    @param len Length of its content
+    @return REG_SUCCESS, REG_EOD if there are no more elements or
+    REG_FAILURE if the element overruns @p end
+
+    Step to the next element within an enclosing element. */
+int Tlv_next_element(const unsigned char** pos,
+		     const unsigned char*  end,
+		     int*                  tag,
+		     const unsigned char** value,
+		     int*                  len);
+
+/** @internal
+    @param arena The arena of the message being decoded
+    @param dest Where to store the string, replacing any already
+    there
+    @param value Content of a leaf element
+    @param len Length of the content
+
+    Store the value of a leaf element as a string. */
+void Tlv_store_string(Msg_arena_type*      arena,
+		      xmlChar**            dest,
+		      const unsigned char* value,
+		      int                  len);
+
+/** @internal
+    Decode the content of a Status or Param_defs element
+    @see parseStatus() */
+int parseTlvStatus(const unsigned char*  buf,
+		   int                   len,
+		   Msg_arena_type*       arena,
+		   struct status_struct* status);
+
+/** @internal
+    Decode the content of a Steer_control element
+    @see parseControl() */
+int parseTlvControl(const unsigned char*   buf,
+		    int                    len,
+		    Msg_arena_type*        arena,
+		    struct control_struct* ctrl);
+
+/** @internal
+    Decode the content of a Supported_commands element
+    @see parseSuppCmd() */
+int parseTlvSuppCmd(const unsigned char*    buf,
+		    int                     len,
+		    Msg_arena_type*         arena,
+		    struct supp_cmd_struct* supp_cmd);
+
+/** @internal
+    @param type_tag MSG_TAG_IOTYPE or MSG_TAG_CHKTYPE
+
+    Decode the content of an IOType_defs or ChkType_defs element
+    @see parseIOTypeDef() */
+int parseTlvIOTypeDef(const unsigned char*  buf,
+		      int                   len,
+		      int                   type_tag,
+		      Msg_arena_type*       arena,
+		      struct io_def_struct* io_def);
+
+/** @internal
+    Decode the content of an IOType or ChkType element
+    @see parseIOType() */
+int parseTlvIOType(const unsigned char* buf,
+		   int                  len,
+		   Msg_arena_type*      arena,
+		   struct io_struct*    io);
+
+/** @internal
+    Decode the content of a Steer_log element
+    @see parseLog() */
+int parseTlvLog(const unsigned char* buf,
+		int                  len,
+		Msg_arena_type*      arena,
+		struct log_struct*   log);
+
+/** @internal
+    Decode the content of a Log_entry element
+    @see parseLogEntry() */
+int parseTlvLogEntry(const unsigned char*     buf,
+		     int                      len,
+		     Msg_arena_type*          arena,
+		     struct log_entry_struct* log);
+
+/** @internal
+    Decode the content of a Chk_log_entry element
+    @see parseChkLogEntry() */
+int parseTlvChkLogEntry(const unsigned char*         buf,
+			int                          len,
+			Msg_arena_type*              arena,
+			struct chk_log_entry_struct* log_entry);
+
+/** @internal
+    Decode the content of a Param or Cmd_param element
+    @see parseParam() */
+int parseTlvParam(const unsigned char* buf,
+		  int                  len,
+		  Msg_arena_type*      arena,
+		  struct param_struct* param);
+
+/** @internal
+    Decode the content of a Command element
+    @see parseCmd() */
+int parseTlvCmd(const unsigned char* buf,
+		int                  len,
+		Msg_arena_type*      arena,
+		struct cmd_struct*   cmd);
+
+#endif /* __REG_STEER_TLV_H__ */
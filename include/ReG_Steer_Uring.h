@@ -0,0 +1,207 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+#ifndef __REG_STEER_URING_H__
+#define __REG_STEER_URING_H__
+
+/** @internal
+    @file ReG_Steer_Uring.h
+    @brief An experimental, synchronous io_uring shim for the samples
+    transports.
+
+    Small writes and sends (packets and message headers) are copied
+    into a staging buffer that is registered with the kernel. They go
+    out together with the next large payload, so that a slice costs a
+    single io_uring_enter() rather than one system call per packet.
+
+    This is all it does. Every call submits its requests and waits for
+    them, because the emit and consume API lets the caller reuse its
+    buffer as soon as a call returns. Nothing is pipelined across
+    slices, payloads are not taken from fixed buffers (only the staging
+    buffer is registered), and the staged bytes cost a memcpy. It is
+    therefore no faster than plain system calls for large payloads and
+    is only built and used when asked for.
+
+    The ring is driven with raw system calls so that liburing is not
+    needed. When the library is built without io_uring support
+    Uring_init() fails and callers fall back to their usual paths.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_types.h"
+
+/** Default no. of submission queue entries */
+#define REG_URING_ENTRIES      8
+/** Default size of the staging buffer in bytes */
+#define REG_URING_STAGING_SIZE 65536
+
+/** @internal State of an io_uring instance */
+typedef struct {
+  /** File descriptor of the ring */
+  int      fd;
+  /** No. of submission queue entries */
+  unsigned entries;
+
+  /** Submission queue ring and its size in bytes */
+  void*    sq_ring;
+  size_t   sq_ring_size;
+  /** Completion queue ring (may be the same mapping as @p sq_ring) */
+  void*    cq_ring;
+  size_t   cq_ring_size;
+  /** Array of submission queue entries and its size in bytes */
+  void*    sqes;
+  size_t   sqes_size;
+
+  /** Pointers into the mapped rings */
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  void*     cqes;
+
+  /** Staging buffer, registered as fixed buffer 0 if possible */
+  char*    staging;
+  /** Size of @p staging in bytes */
+  size_t   staging_size;
+  /** Whether @p staging is registered with the kernel */
+  int      registered;
+  /** No. of bytes waiting in @p staging */
+  size_t   staged;
+  /** File descriptor the staged bytes are destined for */
+  int      staged_fd;
+  /** File offset of the staged bytes (writes only) */
+  unsigned long long staged_offset;
+  /** Writes/sends smaller than this are staged */
+  size_t   stage_limit;
+  /** Tag of the current batch of requests */
+  unsigned batch;
+} uring_type;
+
+/** @internal
+    @param ring Ring to initialize
+    @param entries No. of submission queue entries, 0 for
+    REG_URING_ENTRIES
+    @param staging_size Size of the staging buffer, 0 for
+    REG_URING_STAGING_SIZE
+    @return REG_SUCCESS or REG_FAILURE if io_uring is not available
+
+    Set up the ring and register its staging buffer */
+int Uring_init(uring_type*    ring,
+	       const unsigned entries,
+	       const size_t   staging_size);
+
+/** @internal
+    @param ring Ring to shut down
+
+    Unmap and close the ring and free its staging buffer. Anything
+    still staged is discarded. */
+void Uring_finalize(uring_type* ring);
+
+/** @internal
+    @param ring Ring to use
+    @param fd File to write to
+    @param offset Position in the file to write at
+    @param data Data to write
+    @param num_bytes Number of bytes to write
+    @return REG_SUCCESS or REG_FAILURE
+
+    Write to a file at an explicit offset. Small writes that follow on
+    from the staged data are staged; anything else is submitted along
+    with the staged data and waited for. */
+int Uring_write(uring_type*              ring,
+		const int                fd,
+		const unsigned long long offset,
+		const void*              data,
+		const size_t             num_bytes);
+
+/** @internal
+    @param ring Ring to use
+    @param fd Socket to send on
+    @param data Data to send, may be NULL if @p num_bytes is 0
+    @param num_bytes Number of bytes to send
+    @param more Non-zero to stage the data and return without sending
+    @return REG_SUCCESS or REG_FAILURE
+
+    Send the staged data followed by @p data on a stream socket with a
+    single sendmsg, retrying until it has all gone */
+int Uring_send(uring_type*  ring,
+	       const int    fd,
+	       const void*  data,
+	       const size_t num_bytes,
+	       const int    more);
+
+/** @internal
+    @param ring Ring to use
+    @param fd Socket to receive from
+    @param data Buffer to receive into
+    @param num_bytes Number of bytes to receive
+    @return Number of bytes received (less than @p num_bytes only if
+    the connection was closed) or -1 on error
+
+    Receive exactly @p num_bytes from a stream socket */
+int Uring_recv(uring_type*  ring,
+	       const int    fd,
+	       void*        data,
+	       const size_t num_bytes);
+
+/** @internal
+    @param ring Ring to use
+    @return REG_SUCCESS or REG_FAILURE
+
+    Write out any staged file data and wait for it */
+int Uring_flush(uring_type* ring);
+
+/** @internal
+    @param ring Ring to use
+
+    Throw away any staged data, e.g. when a connection is lost */
+void Uring_discard(uring_type* ring);
+
+#endif /* __REG_STEER_URING_H__ */
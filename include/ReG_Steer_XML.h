@@ -69,6 +69,47 @@
 #define REG_SUCCESS 0
 #define REG_FAILURE 1
 
+/** @internal Size (bytes) of the first block of each message arena */
+#define REG_MSG_ARENA_BLOCK_SIZE 16384
+/** @internal Max. size (bytes) of the blocks an arena keeps hold of
+    when it is put on the free list */
+#define REG_MSG_ARENA_MAX_RETAINED 1048576
+/** @internal Max. no. of arenas kept on the free list */
+#define REG_MAX_FREE_MSG_ARENAS 8
+/** @internal Round a size up so that every allocation from an arena
+    is aligned for any type */
+#define REG_MSG_ARENA_ROUND(n) (((n) + 15) & ~((size_t)15))
+
+/*-----------------------------------------------------------------*/
+
+/** @internal A block of memory belonging to a Msg_arena_type. The
+    memory handed out follows this header. */
+typedef struct msg_arena_block_struct {
+  /** The next block in the arena (if any) */
+  struct msg_arena_block_struct *next;
+  /** No. of bytes in the block */
+  size_t size;
+  /** No. of those bytes handed out so far */
+  size_t used;
+} Msg_arena_block_type;
+
+/** @internal Size of the header at the start of each arena block */
+#define REG_MSG_ARENA_HDR REG_MSG_ARENA_ROUND(sizeof(Msg_arena_block_type))
+
+/** @internal
+    Memory from which a message and all of its constituents are
+    allocated. Nothing is freed individually; the whole arena is
+    released at once by Delete_msg_struct() and put on a free list
+    to be reused by the next message. */
+typedef struct msg_arena_struct {
+  /** The first block, allocated along with the arena itself */
+  Msg_arena_block_type    *first;
+  /** The block currently being allocated from */
+  Msg_arena_block_type    *cur;
+  /** The next arena on the free list */
+  struct msg_arena_struct *next_free;
+} Msg_arena_type;
+
 /*-----------------------------------------------------------------*/
 
 /** @internal
@@ -159,6 +200,9 @@ struct supp_cmd_struct{
   struct cmd_struct   *first_cmd;
   /** Linked list of supported commands */
   struct cmd_struct   *cmd;
+  /** Wire formats other than xml that the application can receive
+      (if any) */
+  xmlChar             *wire_format;
 };
 
 /** @internal Structure for holding IOType defs */
@@ -225,6 +269,8 @@ struct msg_struct{
   struct io_def_struct    *chk_def;
   /** Pointer to details of log message */
   struct log_struct       *log;
+  /** The arena holding this message and everything it points to */
+  Msg_arena_type          *arena;
 };
 
 /** @internal
@@ -265,6 +311,9 @@ typedef struct {
   /** Set to REG_TRUE once detach has been called - prevents us
       calling detach more than once on the SWS */
   int                  detached;
+  /** Wire format (REG_WIRE_XML or REG_WIRE_TLV) in which control
+      messages are sent to this simulation */
+  int                  wire_format;
   /** Last status message received from this simulation - filled in
       Get_next_message() and used by whichever Consume_... routine
       is called in response to the message type */
@@ -296,14 +345,17 @@ typedef struct {
 
     Initialize libXML2 properly. This is only required when
     calling libXML2 functions from different threads but
-    this might happen so we must be prepared.
+    this might happen so we must be prepared.  Also compiles the
+    schema when validating messages.  Calls nest, only the first
+    does any work.
  */
 void Init_xml_parser();
 
 /** @internal
 
     Cleanup libXML2. This isn't strictly needed but shuts
-    things like valgrind up.
+    things like valgrind up.  Only the call matching the first
+    Init_xml_parser() does any work.
  */
 void Cleanup_xml_parser();
 
@@ -347,7 +399,19 @@ int Parse_xml(xmlDocPtr          doc,
 
 #if REG_VALIDATE_XML
 /** @internal
-    Validate the DOM document against the reg_steer_comm schema
+    Compile the reg_steer_comm schema built into the library and
+    create the context used to validate messages against it.  Called
+    once by Init_xml_parser(). */
+int Load_xml_schema();
+
+/** @internal
+    Free the compiled schema and its validation context. */
+void Free_xml_schema();
+
+/** @internal
+    Validate the DOM document against the reg_steer_comm schema.
+    Only every Nth document is checked if REG_VALIDATE_XML_EVERY
+    is set to N.
     @param doc The DOM document to parse */
 int Validate_xml(xmlDocPtr doc);
 #endif
@@ -378,179 +442,224 @@ int parseResourceProperties(xmlDocPtr       doc,
     Parse a Status message
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param status Pointer to struct to fill with msg details */
 int parseStatus(xmlDocPtr             doc,
 		xmlNodePtr            cur,
+		Msg_arena_type       *arena,
 	        struct status_struct *status);
 
 /** @internal
     Parse a Control message.
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param ctrl Pointer to struct to fill with msg details */
 int parseControl(xmlDocPtr              doc,
 		 xmlNodePtr             cur,
+		 Msg_arena_type        *arena,
 	         struct control_struct *ctrl);
 
 /** @internal
     Parse a Supported Commands message
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param supp_cmd Pointer to struct to fill with msg details */
 int parseSuppCmd(xmlDocPtr               doc,
 		 xmlNodePtr              cur,
+		 Msg_arena_type         *arena,
 		 struct supp_cmd_struct *supp_cmd);
 
 /** @internal
     Parse a Parameter element
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param param Pointer to struct to fill with parameter details */
 int parseParam(xmlDocPtr            doc,
 	       xmlNodePtr           cur,
+	       Msg_arena_type      *arena,
 	       struct param_struct *param);
 
 /** @internal
     Parse a Command element
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param cmd Pointer to struct to fill with command details */
 int parseCmd(xmlDocPtr          doc,
 	     xmlNodePtr         cur,
+	     Msg_arena_type    *arena,
 	     struct cmd_struct *cmd);
 
 /** @internal
     Parse a Checkpoint Type definition element
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param chk_def Pointer to struct to fill with ChkType definition */
 int parseChkTypeDef(xmlDocPtr             doc,
 		    xmlNodePtr            cur,
+		    Msg_arena_type       *arena,
 		    struct io_def_struct *chk_def);
 
 /** @internal
     Parse an IOType definition element
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param io_def Pointer to struct to fill with IOType definition */
 extern PREFIX int parseIOTypeDef(xmlDocPtr             doc,
 				 xmlNodePtr            cur,
+				 Msg_arena_type       *arena,
 				 struct io_def_struct *io_def);
 
 /** @internal
     Parse an IOType/ChkType element
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param io Pointer to struct to fill with IOType details */
 int parseIOType(xmlDocPtr         doc,
 		xmlNodePtr        cur,
+		Msg_arena_type   *arena,
 		struct io_struct *io);
 
 /** @internal
     Parse a Logging message
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param log Pointer to struct to fill with log details */
 int parseLog(xmlDocPtr          doc,
 	     xmlNodePtr         cur,
+	     Msg_arena_type    *arena,
 	     struct log_struct *log);
 
 /** @internal
     Parse a Logging entry
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param log_entry Pointer to struct to fill with details of a log entry */
 int parseLogEntry(xmlDocPtr                doc,
 		  xmlNodePtr               cur,
+		  Msg_arena_type          *arena,
 		  struct log_entry_struct *log_entry);
 
 /** @internal
     Parse a Checkpoint Log entry
     @param doc The DOM document to parse
     @param cur Current XML node
+    @param arena Arena to allocate the results from
     @param log_entry Ptr to struct to fill with details of a chkpoint log entry */
 int parseChkLogEntry(xmlDocPtr                    doc,
 		     xmlNodePtr                   cur,
+		     Msg_arena_type              *arena,
 		     struct chk_log_entry_struct *log_entry);
 
 /** @internal
     Create a new msg_store_struct and return pointer to it */
 struct msg_store_struct            *New_msg_store_struct();
-/** Create a new msg_struct and return pointer to it */
+/** Create a new msg_struct, in an arena of its own, and return
+    pointer to it */
 extern PREFIX struct msg_struct    *New_msg_struct();
 /** @internal
-    Create a new status_struct and return a pointer to it */
-struct status_struct               *New_status_struct();
+    Create a new status_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+struct status_struct               *New_status_struct(Msg_arena_type *arena);
 /** @internal
-    Create a new control_struct and return a pointer to it */
-struct control_struct              *New_control_struct();
+    Create a new control_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+struct control_struct              *New_control_struct(Msg_arena_type *arena);
 /** @internal
-    Create a new supp_cmd_struct and return a pointer to it */
-struct supp_cmd_struct             *New_supp_cmd_struct();
-/** Create a new io_def_struct and return a pointer to it */
-extern PREFIX struct io_def_struct *New_io_def_struct();
+    Create a new supp_cmd_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+struct supp_cmd_struct             *New_supp_cmd_struct(Msg_arena_type *arena);
+/** Create a new io_def_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+extern PREFIX struct io_def_struct *New_io_def_struct(Msg_arena_type *arena);
 /** @internal
-    Create a new io_struct and return a pointer to it */
-struct io_struct                   *New_io_struct();
+    Create a new io_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+struct io_struct                   *New_io_struct(Msg_arena_type *arena);
 /** @internal
-    Create a new param_struct and return a pointer to it */
-struct param_struct                *New_param_struct();
+    Create a new param_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+struct param_struct                *New_param_struct(Msg_arena_type *arena);
 /** @internal
-    Create a new cmd_struct and return a pointer to it */
-struct cmd_struct                  *New_cmd_struct();
+    Create a new cmd_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+struct cmd_struct                  *New_cmd_struct(Msg_arena_type *arena);
 /** @internal
-    Create a new chk_log_entry_struct and return a pointer to it */
-struct chk_log_entry_struct        *New_chk_log_entry_struct();
+    Create a new chk_log_entry_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+struct chk_log_entry_struct        *New_chk_log_entry_struct(
+						  Msg_arena_type *arena);
 /** @internal
-    Create a new log_entry_struct and return a pointer to it */
-struct log_entry_struct            *New_log_entry_struct();
+    Create a new log_entry_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+struct log_entry_struct            *New_log_entry_struct(Msg_arena_type *arena);
 /** @internal
-    Create a new log_struct and return a pointer to it */
-struct log_struct                  *New_log_struct();
+    Create a new log_struct and return a pointer to it
+    @param arena The arena of the message it belongs to */
+struct log_struct                  *New_log_struct(Msg_arena_type *arena);
 /** @internal
-    Delete a msg_struct and all its constituents
+    Delete a msg_struct and all its constituents by releasing its
+    arena
     @param msgIn Pointer to msg_struct to delete */
 extern PREFIX void Delete_msg_struct(struct msg_struct **msgIn);
 /** @internal
-    Delete a status_struct and all its constituents
-    @param status Pointer to status_struct to delete */
-void               Delete_status_struct(struct status_struct *status);
-/** @internal
-    Delete a control_struct and all its constituents
-    @param ctrl Pointer to control_struct to delete */
-void               Delete_control_struct(struct control_struct *ctrl);
-/** @internal
-    Delete supp_cmd_struct and all its constituents
-    @param supp_cmd Pointer to supp_cmd_struct to delete */
-void 		   Delete_supp_cmd_struct(struct supp_cmd_struct *supp_cmd);
-/** @internal
-    Delete a param_struct and all its constituents
-    @param param Pointer to param_struct to delete */
-void 		   Delete_param_struct(struct param_struct *param);
-/** @internal
-    Delete a cmd_struct and all its constituents
-    @param cmd Pointer to cmd_struct to delete */
-void 		   Delete_cmd_struct(struct cmd_struct *cmd);
-/** @internal
-    Delete an io_def_struct and all its constituents
-    @param io_def Pointer to io_def_struct to delete */
-void 		   Delete_io_def_struct(struct io_def_struct *io_def);
-/** @internal
-    Delete an io_struct and all its constituents
-    @param io Pointer to io_struct to delete */
-void 		   Delete_io_struct(struct io_struct *io);
-/** @internal
-    Delete a chk_log_entry_struct and all its constituents
-    @param log Pointer to chk_log_entry_struct to delete */
-void 		   Delete_chk_log_entry_struct(struct chk_log_entry_struct *log);
-/** @internal
-    Delete a log_entry_struct and all its constituents
-    @param log Pointer to log_entry_struct to delete */
-void 		   Delete_log_entry_struct(struct log_entry_struct *log);
-/** @internal
-    Delete a log_struct and all its constituents
-    @param log Pointer to log_struct to delete */
-void 		   Delete_log_struct(struct log_struct *log);
+    Take an empty arena from the free list or, if there are none,
+    allocate a new one
+    @return The arena or NULL if malloc failed */
+Msg_arena_type    *New_msg_arena();
+/** @internal
+    Empty an arena and put it on the free list. Any blocks it grew
+    beyond REG_MSG_ARENA_MAX_RETAINED are freed, as is the arena
+    itself if the free list is full.
+    @param arena The arena to release */
+void               Release_msg_arena(Msg_arena_type *arena);
+/** @internal
+    Free an arena and all of its blocks
+    @param arena The arena to free */
+void               Free_msg_arena(Msg_arena_type *arena);
+/** @internal
+    Free every arena on the free list */
+void               Free_msg_arenas();
+/** @internal
+    Allocate memory from an arena
+    @param arena The arena to allocate from
+    @param size No. of bytes required
+    @return Pointer to the memory or NULL if malloc failed */
+void              *Msg_arena_alloc(Msg_arena_type *arena,
+				   size_t          size);
+/** @internal
+    Copy a string into an arena
+    @param arena The arena to allocate from
+    @param str The string to copy
+    @param len Length of @p str or -1 if it is '\0'-terminated
+    @return The copy or NULL if @p str is NULL or malloc failed */
+xmlChar           *Msg_arena_strndup(Msg_arena_type *arena,
+				     const xmlChar  *str,
+				     int             len);
+/** @internal
+    Get the text content of an element as a string in an arena
+    @param arena The arena to allocate from
+    @param doc The DOM document being parsed
+    @param cur The element
+    @return The string or NULL if the element is empty */
+xmlChar           *Msg_arena_node_string(Msg_arena_type *arena,
+					 xmlDocPtr       doc,
+					 xmlNodePtr      cur);
+/** @internal
+    Move a string allocated by libxml2 into an arena
+    @param arena The arena to allocate from
+    @param str The string, which is freed
+    @return The copy or NULL if @p str is NULL or malloc failed */
+xmlChar           *Msg_arena_take_string(Msg_arena_type *arena,
+					 xmlChar        *str);
 /** Print out a message to stderr
     @param msg Pointer to msg to print */
 extern PREFIX void Print_msg(struct msg_struct *msg);
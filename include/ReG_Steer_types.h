@@ -100,10 +100,15 @@
 /** Return value indicating more data needs to be sent - NOT USED? */
 #define REG_UNFINISHED 6
 
-/** Limit on number of commands steerer can send at any one time */
+/** Size of the caller-supplied arrays that receive steering commands
+    (e.g. from Steering_control()).  Messages themselves are not
+    limited to this many commands. */
 #define REG_MAX_NUM_STR_CMDS 20
 
-/** Limit on number of parameters steerer can modify at any one time */
+/** Size of the caller-supplied arrays that receive the labels of
+    steered parameters (e.g. from Steering_control()) and of those in
+    an Output_log_struct.  Messages and logs themselves are not limited
+    to this many parameters. */
 #define REG_MAX_NUM_STR_PARAMS 40
 
 /** Limit on number of log messages we can send in one go */
@@ -176,6 +181,26 @@
 /** Marks the end of a header for an individual 'slice' of data
     being sent down a socket */
 #define END_SLICE_HEADER   "</ReG_data_slice_header>"
+/** Optional slice header packet saying which part of the array was
+    sent: origin, extent and stride of the sub-block */
+#define REG_SLICE_ROI_FORMAT "<Array_roi>%d %d %d %d %d %d %d %d %d</Array_roi>"
+/** Packet with which a consumer asks for only part of each array:
+    origin, extent and stride of the sub-block (zero extent for all) */
+#define REG_ROI_FORMAT "<ReG_roi>%d %d %d %d %d %d %d %d %d</ReG_roi>"
+/** Maximum no. of levels of detail an array can be sent in */
+#define REG_MAX_LOD_LEVELS 16
+/** Optional slice header packet saying which level of detail a slice
+    holds: level (0 coarsest), no. of levels and extent of the level */
+#define REG_SLICE_LOD_FORMAT "<Array_lod>%d %d %d %d %d</Array_lod>"
+/** Packet with which a consumer asks for no more than the given
+    no. of levels of detail (zero for as many as the emitter sends) */
+#define REG_LOD_FORMAT "<ReG_lod>%d</ReG_lod>"
+/** Maximum no. of data sets an input IOType can keep a history of */
+#define REG_MAX_HISTORY_DEPTH 64
+/** Alignment (bytes) of the buffers the library allocates for data */
+#define REG_BUFFER_ALIGNMENT 64
+/** Maximum no. of dimensions in a data slice layout */
+#define REG_MAX_LAYOUT_DIMS 8
 
 
 /* Coding scheme for data types */
@@ -58,6 +58,8 @@
 #include "ReG_Steer_Steering_Transport_API.h"
 #include "ReG_Steer_Logging.h"
 #include "ReG_Steer_XML.h"
+#include "ReG_Steer_Number.h"
+#include "ReG_Steer_Buffer_Pool.h"
 #include "Base64.h"
 #include "soapRealityGrid.nsmap"
 
@@ -121,6 +123,12 @@ static double ReG_TotalSimTimeSecs = 0.0;
 static double ReG_SimTimeStepSecs = 0.0;
 /** Name (and version) of the application that has called us */
 char ReG_AppName[REG_MAX_STRING_LENGTH];
+/** How often (in status reports) to send every parameter value
+    rather than just those that have changed - zero to always send
+    every one */
+static int ReG_StatusFullEvery = 0;
+/** No. of status reports until the next one with every parameter */
+static int ReG_StatusUntilFull = 0;
 #if REG_USE_TIMING
 /** For monitoring wall-clock time per step */
 static float ReG_WallClockPerStep = 0.0;
@@ -149,6 +157,10 @@ static struct msg_store_struct *ReG_ctrl_msg_first = NULL;
     that are not yet valid */
 static struct msg_store_struct *ReG_ctrl_msg_current = NULL;
 
+/** Commands and steered params that didn't fit in the arrays passed
+    to Steering_control - returned by its next call */
+static Held_over_type Held_over = {0, 0, NULL, 0, 0, NULL};
+
 /** Structure for holding multiple messages obtained by parsing
     SWS' ResourceProperties document - used by application-side
     of library */
@@ -309,6 +321,8 @@ int Steering_initialize(const char* AppName,
     return REG_FAILURE;
   }
 
+  Init_param_table_index(&Params_table);
+
   /* Initialize parameter handles */
 
   for(i = 0; i < Params_table.max_entries; i++) {
@@ -317,6 +331,9 @@ int Steering_initialize(const char* AppName,
     Params_table.param[i].max_val_valid = REG_FALSE;
     Params_table.param[i].ptr_raw       = NULL;
     Params_table.param[i].raw_buf_size  = 0;
+    Params_table.param[i].status_sent   = REG_FALSE;
+    Params_table.param[i].status_due    = REG_FALSE;
+    memset(&(Params_table.param[i].value), 0, sizeof(Param_value_type));
   }
 
   /* 'Sequence number' is treated as a parameter */
@@ -328,12 +345,12 @@ int Steering_initialize(const char* AppName,
   Params_table.param[0].is_internal=REG_FALSE;
   Params_table.param[0].logging_on =REG_TRUE;
   strcpy(Params_table.param[0].label, "SEQUENCE_NUM");
-  strcpy(Params_table.param[0].value, "-1");
-  strcpy(Params_table.param[0].min_val, "-1");
+  Params_table.param[0].value.i = -1;
+  Params_table.param[0].min_val.i = -1;
   Params_table.param[0].min_val_valid = REG_TRUE;
   /* Max. value for sequence number is unlimited */
-  strcpy(Params_table.param[0].max_val, " ");
   Params_table.param[0].max_val_valid = REG_FALSE;
+  Param_table_index_add(&Params_table, 0);
   Increment_param_registered(&Params_table);
 
   /* Parameter for monitoring CPU time per step */
@@ -346,11 +363,10 @@ int Steering_initialize(const char* AppName,
   Params_table.param[i].is_internal=REG_FALSE;
   Params_table.param[i].logging_on =REG_TRUE;
   strcpy(Params_table.param[i].label, "CPU_TIME_PER_STEP");
-  strcpy(Params_table.param[i].value, "0.0");
-  strcpy(Params_table.param[i].min_val, "");
+  Params_table.param[i].value.f = 0.0f;
   Params_table.param[i].min_val_valid = REG_FALSE;
-  strcpy(Params_table.param[i].max_val, "");
   Params_table.param[i].max_val_valid = REG_FALSE;
+  Param_table_index_add(&Params_table, i);
   Increment_param_registered(&Params_table);
 
   /* Parameter for recording time stamp - currently ONLY used
@@ -364,11 +380,10 @@ int Steering_initialize(const char* AppName,
   Params_table.param[i].is_internal=REG_TRUE;
   Params_table.param[i].logging_on =REG_FALSE;
   strcpy(Params_table.param[i].label, "TIMESTAMP");
-  strcpy(Params_table.param[i].value, "");
-  strcpy(Params_table.param[i].min_val, "");
+  Params_table.param[i].value.s = NULL;
   Params_table.param[i].min_val_valid = REG_FALSE;
-  strcpy(Params_table.param[i].max_val, "");
   Params_table.param[i].max_val_valid = REG_FALSE;
+  Param_table_index_add(&Params_table, i);
   Increment_param_registered(&Params_table);
 
   /* Set-up a steerable parameter to control how often the steering lib.
@@ -385,11 +400,11 @@ int Steering_initialize(const char* AppName,
   Params_table.param[i].is_internal=REG_FALSE;
   Params_table.param[i].logging_on =REG_TRUE;
   strcpy(Params_table.param[i].label, "STEERING_INTERVAL");
-  strcpy(Params_table.param[i].value, "1");
-  strcpy(Params_table.param[i].min_val, "1");
+  Params_table.param[i].value.i = 1;
+  Params_table.param[i].min_val.i = 1;
   Params_table.param[i].min_val_valid = REG_TRUE;
-  strcpy(Params_table.param[i].max_val, "");
   Params_table.param[i].max_val_valid = REG_FALSE;
+  Param_table_index_add(&Params_table, i);
   Increment_param_registered(&Params_table);
 
   /* Flag that we have registered some parameters */
@@ -453,6 +468,10 @@ int Steering_initialize(const char* AppName,
 
   Steer_log.num_cmds = 0;
   Steer_log.num_params = 0;
+  Steer_log.max_cmds = 0;
+  Steer_log.max_params = 0;
+  Steer_log.cmd = NULL;
+  Steer_log.param = NULL;
 
   /* Initialize Samples Transport */
   Initialize_samples_transport_impl();
@@ -533,12 +552,18 @@ int Steering_finalize()
 
     /* Free buffers associated with each iotype */
     for(i = 0; i < IOTypes_table.num_registered; i++) {
-      if(IOTypes_table.io_def[i].buffer) {
-	free(IOTypes_table.io_def[i].buffer);
-	IOTypes_table.io_def[i].buffer = NULL;
-	IOTypes_table.io_def[i].buffer_bytes = 0;
-	IOTypes_table.io_def[i].buffer_max_bytes = 0;
+      Release_iotype_buffer(i);
+      if(IOTypes_table.io_def[i].roi_buffer) {
+	Pool_free(IOTypes_table.io_def[i].roi_buffer);
+	IOTypes_table.io_def[i].roi_buffer = NULL;
+	IOTypes_table.io_def[i].roi_buffer_bytes = 0;
       }
+      if(IOTypes_table.io_def[i].lod_buffer) {
+	Pool_free(IOTypes_table.io_def[i].lod_buffer);
+	IOTypes_table.io_def[i].lod_buffer = NULL;
+	IOTypes_table.io_def[i].lod_buffer_bytes = 0;
+      }
+      History_free(&(IOTypes_table.io_def[i].history));
     }
     free(IOTypes_table.io_def);
     IOTypes_table.io_def = NULL;
@@ -553,7 +578,7 @@ int Steering_finalize()
   if(ChkTypes_table.io_def) {
     for(i = 0; i < ChkTypes_table.num_registered; i++) {
       if(ChkTypes_table.io_def[i].buffer) {
-	free(ChkTypes_table.io_def[i].buffer);
+	Pool_free(ChkTypes_table.io_def[i].buffer);
 	ChkTypes_table.io_def[i].buffer = NULL;
 	ChkTypes_table.io_def[i].buffer_bytes = 0;
 	ChkTypes_table.io_def[i].buffer_max_bytes = 0;
@@ -565,10 +590,31 @@ int Steering_finalize()
   ChkTypes_table.num_registered = 0;
   ChkTypes_table.max_entries = REG_INITIAL_NUM_IOTYPES;
 
+  /* Hand back the buffers kept for reuse */
+  Pool_trim();
+
   /* Clean-up log of checkpoints & params */
   Finalize_log(&Chk_log);
   Finalize_log(&Param_log);
 
+  if(Steer_log.cmd) free(Steer_log.cmd);
+  if(Steer_log.param){
+    Free_log_param_values(Steer_log.param, Steer_log.max_params);
+    free(Steer_log.param);
+  }
+  Steer_log.cmd = NULL;
+  Steer_log.param = NULL;
+  Steer_log.max_cmds = 0;
+  Steer_log.max_params = 0;
+
+  /* Anything still held over can no longer be returned */
+  if(Held_over.cmd) free(Held_over.cmd);
+  if(Held_over.param_handles) free(Held_over.param_handles);
+  Held_over.cmd = NULL;
+  Held_over.param_handles = NULL;
+  Held_over.num_cmds = Held_over.max_cmds = 0;
+  Held_over.num_params = Held_over.max_params = 0;
+
   /* Clean-up parameters table */
 
   if(Params_table.param != NULL) {
@@ -578,11 +624,13 @@ int Steering_finalize()
 	  free(Params_table.param[i].ptr_raw);
 	  Params_table.param[i].ptr_raw = NULL;
 	}
+	Free_param_entry_values(&(Params_table.param[i]));
       }
     }
     free(Params_table.param);
     Params_table.param = NULL;
   }
+  Delete_param_table_index(&Params_table);
 
   Params_table.num_registered = 0;
   Params_table.max_entries = REG_INITIAL_NUM_IOTYPES;
@@ -608,6 +656,7 @@ int Steering_finalize()
   /* Flag that library no-longer initialised */
   ReG_SteeringInit    = REG_FALSE;
 
+  Free_msg_writer_bufs();
   Cleanup_xml_parser();
 
 #ifdef REG_DEBUG
@@ -737,6 +786,8 @@ int Register_IOType(const char* IOLabel,
   }
 
   IOTypes_table.io_def[current].buffer = NULL;
+  IOTypes_table.io_def[current].user_buffer = NULL;
+  IOTypes_table.io_def[current].user_buffer_bytes = 0;
   IOTypes_table.io_def[current].buffer_bytes = 0;
   IOTypes_table.io_def[current].buffer_max_bytes = 0;
   IOTypes_table.io_def[current].use_xdr = REG_FALSE;
@@ -747,12 +798,35 @@ int Register_IOType(const char* IOLabel,
   IOTypes_table.io_def[current].array.sx = 0;
   IOTypes_table.io_def[current].array.sy = 0;
   IOTypes_table.io_def[current].array.sz = 0;
+  IOTypes_table.io_def[current].array.totx = 0;
+  IOTypes_table.io_def[current].array.toty = 0;
+  IOTypes_table.io_def[current].array.totz = 0;
+  /* Whole arrays are sent until the consumer asks otherwise */
+  IOTypes_table.io_def[current].roi.is_set = REG_FALSE;
+  IOTypes_table.io_def[current].roi.pending = REG_FALSE;
+  IOTypes_table.io_def[current].slice_roi.is_set = REG_FALSE;
+  IOTypes_table.io_def[current].roi_buffer = NULL;
+  IOTypes_table.io_def[current].roi_buffer_bytes = 0;
+  /* ...at full resolution only */
+  IOTypes_table.io_def[current].lod_levels = 0;
+  IOTypes_table.io_def[current].lod_limit = 0;
+  IOTypes_table.io_def[current].lod_pending = REG_FALSE;
+  IOTypes_table.io_def[current].slice_lod.num_levels = 0;
+  IOTypes_table.io_def[current].lod_buffer = NULL;
+  IOTypes_table.io_def[current].lod_buffer_bytes = 0;
+  /* No history unless asked for */
+  IOTypes_table.io_def[current].history.depth = 0;
+  IOTypes_table.io_def[current].history.current = -1;
+  IOTypes_table.io_def[current].history.next_seqnum = 0;
+  IOTypes_table.io_def[current].history.datasets = NULL;
   IOTypes_table.io_def[current].convert_array_order = REG_FALSE;
   IOTypes_table.io_def[current].is_enabled = IOTypes_table.enable_on_registration;
   /* Use acknowledgements by default */
   IOTypes_table.io_def[current].use_ack    = REG_TRUE;
   /* No ack needed for first data set to be emitted */
   IOTypes_table.io_def[current].ack_needed = REG_FALSE;
+  /* Buffers are always copied unless the application says otherwise */
+  IOTypes_table.io_def[current].use_zerocopy = REG_FALSE;
   /* For use with ioProxy so that we know whether we were in the
      process of consuming data when we hit the signal handler */
   IOTypes_table.io_def[current].consuming  = REG_FALSE;
@@ -961,274 +1035,811 @@ int Disable_IOType_acks(int IOType) {
 
 /*----------------------------------------------------------------*/
 
-int Set_f90_array_ordering(int IOTypeIndex, int flag) {
+int Enable_IOType_zerocopy(int IOType) {
+
+  int index;
 
   /* Check that steering is enabled */
   if(!ReG_SteeringEnabled) return REG_SUCCESS;
 
   /* Can only call this function if steering lib initialised */
-  if(!ReG_SteeringInit) return REG_FAILURE;
+  if(!ReG_SteeringInit) {
+    fprintf(stderr, "STEER: ERROR: Enable_IOType_zerocopy: "
+	    "steering library not initialised\n");
+    return REG_FAILURE;
+  }
 
-  if(IOTypeIndex < 0) {
-    fprintf(stderr, "STEER: Set_f90_array_ordering: IOTypeIndex is < 0\n");
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Enable_IOType_zerocopy: "
+	    "failed to find matching IOType\n");
     return REG_FAILURE;
   }
 
-  IOTypes_table.io_def[IOTypeIndex].array.is_f90 = flag;
+  /* Let the transport send from the application's buffers */
+  IOTypes_table.io_def[index].use_zerocopy = REG_TRUE;
 
   return REG_SUCCESS;
 }
 
 /*----------------------------------------------------------------*/
 
-int Called_from_f90(int flag) {
+int Disable_IOType_zerocopy(int IOType) {
 
-  if(flag == REG_TRUE) {
-    ReG_CalledFromF90 = REG_TRUE;
-  }
-  else if(flag == REG_FALSE) {
-    ReG_CalledFromF90 = REG_FALSE;
+  int index;
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
+
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) {
+    fprintf(stderr, "STEER: ERROR: Disable_IOType_zerocopy: "
+	    "steering library not initialised\n");
+    return REG_FAILURE;
   }
-  else {
-    fprintf(stderr, "STEER: Called_from_f90: flag is neither REG_TRUE or REG_FALSE\n");
+
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Disable_IOType_zerocopy: "
+	    "failed to find matching IOType\n");
     return REG_FAILURE;
   }
 
+  /* Buffers already sent without copying still need releasing */
+  IOTypes_table.io_def[index].use_zerocopy = REG_FALSE;
+
   return REG_SUCCESS;
 }
 
 /*----------------------------------------------------------------*/
 
-int Register_ChkTypes(const int    NumTypes,
-		      char** ChkLabel,
-		      int*   direction,
-		      int*   ChkFrequency,
-		      int*   ChkType)
-{
-  int 	       i;
-  int          return_status = REG_SUCCESS;
+int Emit_data_slice_release(int         IOType,
+			    const void* pData,
+			    int         Block) {
 
-  /* Check that steering is enabled */
+  int index;
 
-  if(!ReG_SteeringEnabled) {
-    for(i=0; i<NumTypes; i++){
-      ChkType[i] = REG_IODEF_HANDLE_NOTSET;
-    }
-    return REG_SUCCESS;
-  }
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
 
   /* Can only call this function if steering lib initialised */
-
   if(!ReG_SteeringInit) return REG_FAILURE;
 
-  for(i = 0; i < NumTypes; i++) {
-    if(Register_ChkType(ChkLabel[i],
-			direction[i],
-			ChkFrequency[i],
-			&(ChkType[i])) != REG_SUCCESS) {
-      return_status = REG_FAILURE;
-    }
-  } /* End of loop over Chk types to register */
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Emit_data_slice_release: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
 
-  return return_status;
+  return Release_data_impl(index, pData, Block);
 }
 
 /*----------------------------------------------------------------*/
 
-int Register_ChkType(const char* ChkLabel,
-		     const int         direction,
-		     const int         ChkFrequency,
-		     int*        ChkType)
-{
-  int current;
-  int iparam;
-  int new_size;
-  IOdef_entry* dum_ptr;
+int Set_IOType_array_extents(int IOType,
+			     int Nx,
+			     int Ny,
+			     int Nz) {
 
-  /* Check that steering is enabled */
+  int index;
 
-  if(!ReG_SteeringEnabled) {
-    *ChkType = REG_IODEF_HANDLE_NOTSET;
-    return REG_SUCCESS;
-  }
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
 
   /* Can only call this function if steering lib initialised */
-
   if(!ReG_SteeringInit) return REG_FAILURE;
 
-  /* Chk types cannot be deleted so is safe to use num_registered to
-     get next free entry */
-  current = ChkTypes_table.num_registered;
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Set_IOType_array_extents: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
 
-  if(String_contains_xml_chars(ChkLabel) == REG_TRUE) {
-    fprintf(stderr, "STEER: ERROR: Register_ChkType: Chk label contains "
-	    "reserved xml characters (<,>,&): %s\n", ChkLabel);
+  if(Nx < 0 || Ny < 0 || Nz < 0) {
+    fprintf(stderr, "STEER: ERROR: Set_IOType_array_extents: "
+	    "extents must not be negative\n");
     return REG_FAILURE;
   }
 
-  strcpy(ChkTypes_table.io_def[current].label, ChkLabel);
+  /* Each slice holds the whole array */
+  IOTypes_table.io_def[index].array.totx = Nx;
+  IOTypes_table.io_def[index].array.toty = Ny;
+  IOTypes_table.io_def[index].array.totz = Nz;
+  IOTypes_table.io_def[index].array.nx = Nx;
+  IOTypes_table.io_def[index].array.ny = Ny;
+  IOTypes_table.io_def[index].array.nz = Nz;
+  IOTypes_table.io_def[index].array.sx = 0;
+  IOTypes_table.io_def[index].array.sy = 0;
+  IOTypes_table.io_def[index].array.sz = 0;
 
-  /* filename not used currently */
-/*   sprintf(ChkTypes_table.io_def[current].filename, "NOT_SET"); */
+  return REG_SUCCESS;
+}
 
-  /* Whether input or output */
-  ChkTypes_table.io_def[current].direction = direction;
+/*----------------------------------------------------------------*/
 
-  /* Set variables required for registration of associated io
-     frequency as a steerable parameter (but only if checkpoint is
-     to be emitted) */
-  if(direction != REG_IO_IN) {
-    /* Set variables required for registration of associated io
-       frequency as a steerable parameter */
+int Request_IOType_roi(int  IOType,
+		       int *Origin,
+		       int *Extent,
+		       int *Stride) {
 
-    ChkTypes_table.io_def[current].frequency = ChkFrequency;
+  int       index;
+  Roi_type *roi;
 
-    Register_param("Chk_Frequency",
-		   REG_TRUE,
-		   (void *)&(ChkTypes_table.io_def[current].frequency),
-		   REG_INT,
-		   "0", " ");
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
 
-    /* Store the handle given to this parameter - this line MUST
-       immediately succeed the call to Register_params */
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
 
-    ChkTypes_table.io_def[current].freq_param_handle =
-	                               Params_table.next_handle - 1;
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Request_IOType_roi: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
 
-    /* Annotate the parameter table entry just created to flag that
-       it is a parameter that is internal to the steering library */
-    iparam = Param_index_from_handle(&Params_table,
-			  ChkTypes_table.io_def[current].freq_param_handle);
-    if(iparam != -1) {
-      Params_table.param[iparam].is_internal = REG_TRUE;
-    }
-    else {
-#ifdef REG_DEBUG
-      fprintf(stderr, "STEER: Register_ChkType: failed to get handle for param\n");
-#endif
-      *ChkType = REG_IODEF_HANDLE_NOTSET;
+  if(IOTypes_table.io_def[index].direction != REG_IO_IN) {
+    fprintf(stderr, "STEER: ERROR: Request_IOType_roi: IOType "
+	    "is not an input\n");
+    return REG_FAILURE;
+  }
+
+  roi = &(IOTypes_table.io_def[index].roi);
+
+  if(Extent) {
+    if(Extent[0] < 1 || Extent[1] < 1 || Extent[2] < 1) {
+      fprintf(stderr, "STEER: ERROR: Request_IOType_roi: extents must "
+	      "be positive\n");
       return REG_FAILURE;
     }
+    roi->is_set = REG_TRUE;
+    roi->nx = Extent[0];
+    roi->ny = Extent[1];
+    roi->nz = Extent[2];
+    roi->sx = Origin ? Origin[0] : 0;
+    roi->sy = Origin ? Origin[1] : 0;
+    roi->sz = Origin ? Origin[2] : 0;
+    roi->dx = Stride ? Stride[0] : 1;
+    roi->dy = Stride ? Stride[1] : 1;
+    roi->dz = Stride ? Stride[2] : 1;
   }
   else {
-    /* Auto consume is senseless for checkpoints so set frequency-related
-       elements to 'null' values */
-    ChkTypes_table.io_def[current].freq_param_handle = REG_PARAM_HANDLE_NOTSET;
-    ChkTypes_table.io_def[current].frequency = 0;
+    roi->is_set = REG_FALSE;
   }
 
-  /* Set-up buffer used to store checkpoint filenames */
-  ChkTypes_table.io_def[current].buffer = NULL;
-  ChkTypes_table.io_def[current].buffer_bytes = 0;
-  ChkTypes_table.io_def[current].buffer_max_bytes = 0;
+  /* Sent with the next acknowledgement */
+  roi->pending = REG_TRUE;
 
-  /* Create, store and return a handle for this ChkType */
-  ChkTypes_table.io_def[current].handle = Next_IO_Chk_handle++;
-  *ChkType = ChkTypes_table.io_def[current].handle;
+  return REG_SUCCESS;
+}
 
-  /* Check whether we need to allocate more storage */
-  current++;
-  if(current == ChkTypes_table.max_entries) {
-    new_size = ChkTypes_table.max_entries + REG_INITIAL_NUM_IOTYPES;
+/*----------------------------------------------------------------*/
 
-    dum_ptr = (IOdef_entry*)realloc((void *)(ChkTypes_table.io_def),
-		                    new_size*sizeof(IOdef_entry));
+int Get_data_slice_roi(int  IOTypeIndex,
+		       int *Origin,
+		       int *Extent,
+		       int *Stride) {
 
-    if(dum_ptr == NULL) {
-      fprintf(stderr, "STEER: Register_ChkType: failed to allocate memory\n");
-      return REG_FAILURE;
-    }
-    else {
+  Roi_type *roi;
 
-      ChkTypes_table.io_def = dum_ptr;
-    }
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_FAILURE;
 
-    ChkTypes_table.max_entries += REG_INITIAL_NUM_IOTYPES;
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  if(IOTypeIndex < 0 || IOTypeIndex >= IOTypes_table.num_registered) {
+    fprintf(stderr, "STEER: ERROR: Get_data_slice_roi: invalid IOType "
+	    "handle (%d) supplied\n", IOTypeIndex);
+    return REG_FAILURE;
   }
 
-  ChkTypes_table.num_registered = current;
+  roi = &(IOTypes_table.io_def[IOTypeIndex].slice_roi);
+  if(!roi->is_set) return REG_FAILURE;
 
-  /* Flag that the registered Chk Types have changed */
-  ReG_ChkTypesChanged = REG_TRUE;
+  Origin[0] = roi->sx; Origin[1] = roi->sy; Origin[2] = roi->sz;
+  Extent[0] = roi->nx; Extent[1] = roi->ny; Extent[2] = roi->nz;
+  Stride[0] = roi->dx; Stride[1] = roi->dy; Stride[2] = roi->dz;
 
   return REG_SUCCESS;
 }
 
 /*----------------------------------------------------------------*/
 
-int Record_Chkpt(int   ChkType,
-		 char *ChkTag)
-{
-  int    index;
-  int    count;
-  time_t time_now;
-  char   *pchar;
+int Set_IOType_lod_levels(int IOType,
+			  int NumLevels) {
 
-  /* Can only call this function if steering lib initialised */
+  int index;
 
-  if(!ReG_SteeringInit) return REG_FAILURE;
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
 
-  if(ChkType == REG_IODEF_HANDLE_NOTSET) return REG_SUCCESS;
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
 
-  /* Check that we have enough storage space - if not then store
-     current entries on disk (rather than continually grab more
-     memory) */
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Set_IOType_lod_levels: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
 
-  if(Chk_log.num_entries == Chk_log.max_entries) {
-    /* Save_log also resets Chk_log.num_entries to zero */
-    if(Save_log(&Chk_log) != REG_SUCCESS) {
-      fprintf(stderr, "STEER: Record_Chkpt: Save_log failed\n");
-      return REG_FAILURE;
-    }
+  if(IOTypes_table.io_def[index].direction != REG_IO_OUT) {
+    fprintf(stderr, "STEER: ERROR: Set_IOType_lod_levels: IOType "
+	    "is not an output\n");
+    return REG_FAILURE;
   }
 
-  Chk_log.entry[Chk_log.num_entries].key = Chk_log.primary_key_value++;
-  strcpy(Chk_log.entry[Chk_log.num_entries].chk_tag, ChkTag);
-  Chk_log.entry[Chk_log.num_entries].chk_handle      = ChkType;
-  Chk_log.entry[Chk_log.num_entries].sent_to_steerer = REG_FALSE;
+  /* One level is just the array itself */
+  IOTypes_table.io_def[index].lod_levels = (NumLevels > 1) ? NumLevels : 0;
 
-  /* Store the values of all registered parameters at this point (so
-     long as they're not internal to the library) */
-  count = 0;
-  for(index = 0; index<Params_table.max_entries; index++) {
-    if(Params_table.param[index].handle == REG_PARAM_HANDLE_NOTSET ||
-       Params_table.param[index].is_internal == REG_TRUE) {
+  return REG_SUCCESS;
+}
 
-      /* Time stamp is a special case - is internal but we do want
-	 it for checkpoint records */
-      if(Params_table.param[index].handle != REG_TIMESTAMP_HANDLE) {
-	continue;
-      }
-      else {
-	/* Get timestamp */
-	if((int)(time_now = time(NULL)) != -1) {
-	  pchar = ctime(&time_now);
-	  strcpy(Params_table.param[index].value, pchar);
-	  /* Remove new-line character */
-          Params_table.param[index].value[strlen(pchar)-1] = '\0';
-	}
-	else {
-	  strcpy(Params_table.param[index].value, "");
-	}
-      }
-    }
+/*----------------------------------------------------------------*/
 
-    /* Don't include raw binary parameters in the log */
-    if(Params_table.param[index].type == REG_BIN) continue;
+int Request_IOType_lod(int IOType,
+		       int NumLevels) {
 
-    /* This is one we want - store its handle and current value */
-    Chk_log.entry[Chk_log.num_entries].param[count].handle =
-                                           Params_table.param[index].handle;
+  int index;
 
-    /* Update value associated with pointer */
-    Get_ptr_value(&(Params_table.param[index]));
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
+
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Request_IOType_lod: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
+
+  if(IOTypes_table.io_def[index].direction != REG_IO_IN) {
+    fprintf(stderr, "STEER: ERROR: Request_IOType_lod: IOType "
+	    "is not an input\n");
+    return REG_FAILURE;
+  }
+
+  IOTypes_table.io_def[index].lod_levels = (NumLevels > 0) ? NumLevels : 0;
+
+  /* Sent with the next acknowledgement */
+  IOTypes_table.io_def[index].lod_pending = REG_TRUE;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Get_data_slice_lod(int  IOTypeIndex,
+		       int *Level,
+		       int *NumLevels,
+		       int *Extent) {
+
+  Lod_type *lod;
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_FAILURE;
+
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  if(IOTypeIndex < 0 || IOTypeIndex >= IOTypes_table.num_registered) {
+    fprintf(stderr, "STEER: ERROR: Get_data_slice_lod: invalid IOType "
+	    "handle (%d) supplied\n", IOTypeIndex);
+    return REG_FAILURE;
+  }
+
+  lod = &(IOTypes_table.io_def[IOTypeIndex].slice_lod);
+  if(lod->num_levels < 1) return REG_FAILURE;
+
+  *Level = lod->level;
+  *NumLevels = lod->num_levels;
+  Extent[0] = lod->nx; Extent[1] = lod->ny; Extent[2] = lod->nz;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Set_IOType_history_depth(int IOType,
+			     int NumDatasets) {
+
+  int index;
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
+
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Set_IOType_history_depth: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
+
+  if(IOTypes_table.io_def[index].direction != REG_IO_IN) {
+    fprintf(stderr, "STEER: ERROR: Set_IOType_history_depth: IOType "
+	    "is not an input\n");
+    return REG_FAILURE;
+  }
+
+  /* Not while the slices are going into it */
+  if(IOTypes_table.io_def[index].consuming == REG_TRUE) {
+    fprintf(stderr, "STEER: ERROR: Set_IOType_history_depth: IOType "
+	    "is being consumed\n");
+    return REG_FAILURE;
+  }
+
+  return History_init(&(IOTypes_table.io_def[index].history),
+		      (NumDatasets > 0) ? NumDatasets : 0);
+}
+
+/*----------------------------------------------------------------*/
+
+int Get_IOType_history_range(int  IOType,
+			     int *Oldest,
+			     int *Newest) {
+
+  History_type *history;
+  int           index;
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_FAILURE;
+
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Get_IOType_history_range: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
+
+  history = &(IOTypes_table.io_def[index].history);
+  if(history->current < 0) return REG_FAILURE;
+
+  *Newest = history->next_seqnum - 1;
+  *Oldest = *Newest - history->depth + 1;
+  if(*Oldest < 0) *Oldest = 0;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Get_IOType_history_dataset(int  IOType,
+			       int  SeqNum,
+			       int *NumSlices) {
+
+  History_dataset_type *dataset;
+  int                   index;
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_FAILURE;
+
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Get_IOType_history_dataset: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
+
+  dataset = History_find_dataset(&(IOTypes_table.io_def[index].history),
+				 SeqNum);
+  if(!dataset) return REG_FAILURE;
+
+  *NumSlices = dataset->num_slices;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Get_IOType_history_slice(int    IOType,
+			     int    SeqNum,
+			     int    Slice,
+			     int   *DataType,
+			     int   *Count,
+			     void **pData) {
+
+  History_dataset_type *dataset;
+  int                   index;
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_FAILURE;
+
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Get_IOType_history_slice: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
+
+  dataset = History_find_dataset(&(IOTypes_table.io_def[index].history),
+				 SeqNum);
+  if(!dataset || Slice < 0 || Slice >= dataset->num_slices) {
+    return REG_FAILURE;
+  }
+
+  *DataType = dataset->slices[Slice].type;
+  *Count = dataset->slices[Slice].count;
+  *pData = dataset->slices[Slice].data;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Enable_delta_status(int FullEvery)
+{
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
+
+  ReG_StatusFullEvery = FullEvery > 0 ? FullEvery : 0;
+  ReG_StatusUntilFull = 0;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Register_IOType_buffer(int     IOType,
+			   void   *Buffer,
+			   size_t  NumBytes) {
+
+  int index;
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
+
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  /* Find corresponding entry in table of IOtypes */
+  index = IOdef_index_from_handle(&IOTypes_table, IOType);
+  if(index == REG_IODEF_HANDLE_NOTSET) {
+    fprintf(stderr, "STEER: ERROR: Register_IOType_buffer: "
+	    "failed to find matching IOType\n");
+    return REG_FAILURE;
+  }
+
+  /* Not while a data set is being read into the old one */
+  if(IOTypes_table.io_def[index].consuming == REG_TRUE) {
+    fprintf(stderr, "STEER: ERROR: Register_IOType_buffer: IOType "
+	    "is being consumed\n");
+    return REG_FAILURE;
+  }
+
+  if(NumBytes > (size_t)INT_MAX) NumBytes = (size_t)INT_MAX;
+
+  /* Give back any pool buffer standing in for the old one while
+     that is still recorded as the application's (so that it isn't
+     mistaken for one of ours) and only then switch to the new one */
+  Release_iotype_buffer(index);
+
+  IOTypes_table.io_def[index].user_buffer = Buffer;
+  IOTypes_table.io_def[index].user_buffer_bytes = Buffer ? NumBytes : 0;
+  IOTypes_table.io_def[index].buffer = Buffer;
+  IOTypes_table.io_def[index].buffer_bytes = 0;
+  IOTypes_table.io_def[index].buffer_max_bytes =
+    (int)IOTypes_table.io_def[index].user_buffer_bytes;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Get_buffer_pool_usage(size_t        *BytesInUse,
+			  size_t        *BytesCached,
+			  size_t        *PeakBytesInUse,
+			  unsigned long *NumAllocs) {
+
+  Pool_usage(BytesInUse, BytesCached, PeakBytesInUse, NumAllocs);
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Set_f90_array_ordering(int IOTypeIndex, int flag) {
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
+
+  /* Can only call this function if steering lib initialised */
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  if(IOTypeIndex < 0) {
+    fprintf(stderr, "STEER: Set_f90_array_ordering: IOTypeIndex is < 0\n");
+    return REG_FAILURE;
+  }
+
+  IOTypes_table.io_def[IOTypeIndex].array.is_f90 = flag;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Called_from_f90(int flag) {
+
+  if(flag == REG_TRUE) {
+    ReG_CalledFromF90 = REG_TRUE;
+  }
+  else if(flag == REG_FALSE) {
+    ReG_CalledFromF90 = REG_FALSE;
+  }
+  else {
+    fprintf(stderr, "STEER: Called_from_f90: flag is neither REG_TRUE or REG_FALSE\n");
+    return REG_FAILURE;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Register_ChkTypes(const int    NumTypes,
+		      char** ChkLabel,
+		      int*   direction,
+		      int*   ChkFrequency,
+		      int*   ChkType)
+{
+  int 	       i;
+  int          return_status = REG_SUCCESS;
+
+  /* Check that steering is enabled */
+
+  if(!ReG_SteeringEnabled) {
+    for(i=0; i<NumTypes; i++){
+      ChkType[i] = REG_IODEF_HANDLE_NOTSET;
+    }
+    return REG_SUCCESS;
+  }
+
+  /* Can only call this function if steering lib initialised */
+
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  for(i = 0; i < NumTypes; i++) {
+    if(Register_ChkType(ChkLabel[i],
+			direction[i],
+			ChkFrequency[i],
+			&(ChkType[i])) != REG_SUCCESS) {
+      return_status = REG_FAILURE;
+    }
+  } /* End of loop over Chk types to register */
+
+  return return_status;
+}
+
+/*----------------------------------------------------------------*/
+
+int Register_ChkType(const char* ChkLabel,
+		     const int         direction,
+		     const int         ChkFrequency,
+		     int*        ChkType)
+{
+  int current;
+  int iparam;
+  int new_size;
+  IOdef_entry* dum_ptr;
+
+  /* Check that steering is enabled */
+
+  if(!ReG_SteeringEnabled) {
+    *ChkType = REG_IODEF_HANDLE_NOTSET;
+    return REG_SUCCESS;
+  }
+
+  /* Can only call this function if steering lib initialised */
+
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  /* Chk types cannot be deleted so is safe to use num_registered to
+     get next free entry */
+  current = ChkTypes_table.num_registered;
+
+  if(String_contains_xml_chars(ChkLabel) == REG_TRUE) {
+    fprintf(stderr, "STEER: ERROR: Register_ChkType: Chk label contains "
+	    "reserved xml characters (<,>,&): %s\n", ChkLabel);
+    return REG_FAILURE;
+  }
+
+  strcpy(ChkTypes_table.io_def[current].label, ChkLabel);
+
+  /* filename not used currently */
+/*   sprintf(ChkTypes_table.io_def[current].filename, "NOT_SET"); */
+
+  /* Whether input or output */
+  ChkTypes_table.io_def[current].direction = direction;
+
+  /* Set variables required for registration of associated io
+     frequency as a steerable parameter (but only if checkpoint is
+     to be emitted) */
+  if(direction != REG_IO_IN) {
+    /* Set variables required for registration of associated io
+       frequency as a steerable parameter */
+
+    ChkTypes_table.io_def[current].frequency = ChkFrequency;
+
+    Register_param("Chk_Frequency",
+		   REG_TRUE,
+		   (void *)&(ChkTypes_table.io_def[current].frequency),
+		   REG_INT,
+		   "0", " ");
+
+    /* Store the handle given to this parameter - this line MUST
+       immediately succeed the call to Register_params */
 
-    /* Save this value */
-    strcpy(Chk_log.entry[Chk_log.num_entries].param[count].value,
-           Params_table.param[index].value);
+    ChkTypes_table.io_def[current].freq_param_handle =
+	                               Params_table.next_handle - 1;
 
-    /* Storage for params associated with log entry is static */
-    if(++count >= REG_MAX_NUM_STR_PARAMS) break;
+    /* Annotate the parameter table entry just created to flag that
+       it is a parameter that is internal to the steering library */
+    iparam = Param_index_from_handle(&Params_table,
+			  ChkTypes_table.io_def[current].freq_param_handle);
+    if(iparam != -1) {
+      Params_table.param[iparam].is_internal = REG_TRUE;
+    }
+    else {
+#ifdef REG_DEBUG
+      fprintf(stderr, "STEER: Register_ChkType: failed to get handle for param\n");
+#endif
+      *ChkType = REG_IODEF_HANDLE_NOTSET;
+      return REG_FAILURE;
+    }
+  }
+  else {
+    /* Auto consume is senseless for checkpoints so set frequency-related
+       elements to 'null' values */
+    ChkTypes_table.io_def[current].freq_param_handle = REG_PARAM_HANDLE_NOTSET;
+    ChkTypes_table.io_def[current].frequency = 0;
+  }
+
+  /* Set-up buffer used to store checkpoint filenames */
+  ChkTypes_table.io_def[current].buffer = NULL;
+  ChkTypes_table.io_def[current].buffer_bytes = 0;
+  ChkTypes_table.io_def[current].buffer_max_bytes = 0;
+  ChkTypes_table.io_def[current].user_buffer = NULL;
+  ChkTypes_table.io_def[current].user_buffer_bytes = 0;
+
+  /* Create, store and return a handle for this ChkType */
+  ChkTypes_table.io_def[current].handle = Next_IO_Chk_handle++;
+  *ChkType = ChkTypes_table.io_def[current].handle;
+
+  /* Check whether we need to allocate more storage */
+  current++;
+  if(current == ChkTypes_table.max_entries) {
+    new_size = ChkTypes_table.max_entries + REG_INITIAL_NUM_IOTYPES;
+
+    dum_ptr = (IOdef_entry*)realloc((void *)(ChkTypes_table.io_def),
+		                    new_size*sizeof(IOdef_entry));
+
+    if(dum_ptr == NULL) {
+      fprintf(stderr, "STEER: Register_ChkType: failed to allocate memory\n");
+      return REG_FAILURE;
+    }
+    else {
+
+      ChkTypes_table.io_def = dum_ptr;
+    }
+
+    ChkTypes_table.max_entries += REG_INITIAL_NUM_IOTYPES;
+  }
+
+  ChkTypes_table.num_registered = current;
+
+  /* Flag that the registered Chk Types have changed */
+  ReG_ChkTypesChanged = REG_TRUE;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Record_Chkpt(int   ChkType,
+		 char *ChkTag)
+{
+  int    i;
+  int    index;
+  int    count;
+  time_t time_now;
+  char   *pchar;
+  Chk_log_entry_type *entry;
+
+  /* Can only call this function if steering lib initialised */
+
+  if(!ReG_SteeringInit) return REG_FAILURE;
+
+  if(ChkType == REG_IODEF_HANDLE_NOTSET) return REG_SUCCESS;
+
+  /* Check that we have enough storage space - if not then store
+     current entries on disk (rather than continually grab more
+     memory) */
+
+  if(Chk_log.num_entries == Chk_log.max_entries) {
+    /* Save_log also resets Chk_log.num_entries to zero */
+    if(Save_log(&Chk_log) != REG_SUCCESS) {
+      fprintf(stderr, "STEER: Record_Chkpt: Save_log failed\n");
+      return REG_FAILURE;
+    }
+  }
+
+  Chk_log.entry[Chk_log.num_entries].key = Chk_log.primary_key_value++;
+  strcpy(Chk_log.entry[Chk_log.num_entries].chk_tag, ChkTag);
+  Chk_log.entry[Chk_log.num_entries].chk_handle      = ChkType;
+  Chk_log.entry[Chk_log.num_entries].sent_to_steerer = REG_FALSE;
+
+  /* Store the values of all registered parameters at this point (so
+     long as they're not internal to the library) */
+  count = 0;
+  if(Realloc_log_entry_params(&(Chk_log.entry[Chk_log.num_entries]),
+			      Params_table.num_live) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+  for(i = 0; i<Params_table.num_live; i++) {
+    index = Params_table.live[i];
+    if(Params_table.param[index].is_internal == REG_TRUE) {
+
+      /* Time stamp is a special case - is internal but we do want
+	 it for checkpoint records */
+      if(Params_table.param[index].handle != REG_TIMESTAMP_HANDLE) {
+	continue;
+      }
+      else {
+	/* Get timestamp */
+	if((int)(time_now = time(NULL)) != -1) {
+	  pchar = ctime(&time_now);
+	  /* Leave off the new-line character */
+	  Param_value_set_string(&(Params_table.param[index].value), pchar,
+				 (int)strlen(pchar) - 1);
+	}
+	else {
+	  Param_value_set_string(&(Params_table.param[index].value), "", 0);
+	}
+      }
+    }
+
+    /* Don't include raw binary parameters in the log */
+    if(Params_table.param[index].type == REG_BIN) continue;
+
+    /* This is one we want - update value associated with pointer */
+    Get_ptr_value(&(Params_table.param[index]));
+
+    /* Save its handle and value */
+    entry = &(Chk_log.entry[Chk_log.num_entries]);
+    if(Set_log_param_value(&(entry->param[count]),
+			   Params_table.param[index].handle,
+			   Params_table.param[index].type,
+			   &(Params_table.param[index].value)) != REG_SUCCESS){
+      return REG_FAILURE;
+    }
+    count++;
   }
 
   /* Store the no. of params this entry has */
@@ -1321,6 +1932,8 @@ int Add_checkpoint_file(int   ChkType,
 int Consume_start(int  IOType,
 		  int *IOTypeIndex)
 {
+  int status;
+
   /* Check that steering is enabled */
   if(!ReG_SteeringEnabled) return REG_SUCCESS;
 
@@ -1356,7 +1969,14 @@ int Consume_start(int  IOType,
   /* Initialise array-ordering flags */
   IOTypes_table.io_def[*IOTypeIndex].convert_array_order = REG_FALSE;
 
-  return Consume_start_data_check(*IOTypeIndex);
+  if((status = Consume_start_data_check(*IOTypeIndex)) != REG_SUCCESS) {
+    return status;
+  }
+
+  /* Make room for this data set in the history */
+  History_begin_dataset(&(IOTypes_table.io_def[*IOTypeIndex].history));
+
+  return REG_SUCCESS;
 }
 
 /*----------------------------------------------------------------*/
@@ -1425,12 +2045,7 @@ int Consume_stop(int *IOTypeIndex)
   Consume_stop_impl(*IOTypeIndex);
 
   /* Free memory associated with channel */
-  if( IOTypes_table.io_def[*IOTypeIndex].buffer ){
-    free(IOTypes_table.io_def[*IOTypeIndex].buffer);
-    IOTypes_table.io_def[*IOTypeIndex].buffer = NULL;
-    IOTypes_table.io_def[*IOTypeIndex].buffer_bytes = 0;
-    IOTypes_table.io_def[*IOTypeIndex].buffer_max_bytes = 0;
-  }
+  Release_iotype_buffer(*IOTypeIndex);
 
   /* Reset handle associated with channel */
   *IOTypeIndex = REG_IODEF_HANDLE_NOTSET;
@@ -1526,6 +2141,8 @@ int Consume_data_slice(int    IOTypeIndex,
 {
   int              return_status = REG_SUCCESS;
   size_t	   num_bytes_to_read;
+  size_t	   num_bytes_decoded;
+  void            *pSlice = pData;
 
   /* Check that steering is enabled */
   if(!ReG_SteeringEnabled) return REG_SUCCESS;
@@ -1545,6 +2162,7 @@ int Consume_data_slice(int    IOTypeIndex,
     else {
       num_bytes_to_read = Count*sizeof(int);
     }
+    num_bytes_decoded = Count*sizeof(int);
     break;
 
   case REG_LONG:
@@ -1554,6 +2172,7 @@ int Consume_data_slice(int    IOTypeIndex,
     else {
       num_bytes_to_read = Count*sizeof(long);
     }
+    num_bytes_decoded = Count*sizeof(long);
     break;
 
   case REG_FLOAT:
@@ -1563,6 +2182,7 @@ int Consume_data_slice(int    IOTypeIndex,
     else {
       num_bytes_to_read = Count*sizeof(float);
     }
+    num_bytes_decoded = Count*sizeof(float);
     break;
 
   case REG_DBL:
@@ -1572,10 +2192,12 @@ int Consume_data_slice(int    IOTypeIndex,
     else {
       num_bytes_to_read = Count*sizeof(double);
     }
+    num_bytes_decoded = Count*sizeof(double);
     break;
 
   case REG_CHAR:
     num_bytes_to_read = Count*sizeof(char);
+    num_bytes_decoded = num_bytes_to_read;
     break;
 
   default:
@@ -1608,6 +2230,31 @@ int Consume_data_slice(int    IOTypeIndex,
     }
   }
 
+  /* Keep the slice in the IOType's history, reading it straight into
+     the history's storage so the application needn't have its own
+     copy at all */
+  if(IOTypes_table.io_def[IOTypeIndex].history.depth > 0) {
+    pSlice = History_add_slice(&(IOTypes_table.io_def[IOTypeIndex].history),
+			       DataType, Count, num_bytes_decoded);
+    if(!pSlice) pSlice = pData;
+  }
+  if(!pSlice) {
+    fprintf(stderr, "STEER: Consume_data_slice: no buffer to read "
+	    "slice into\n");
+    IOTypes_table.io_def[IOTypeIndex].use_xdr = REG_FALSE;
+    IOTypes_table.io_def[IOTypeIndex].num_xdr_bytes = 0;
+    return REG_FAILURE;
+  }
+
+  if(pSlice == IOTypes_table.io_def[IOTypeIndex].buffer &&
+     IOTypes_table.io_def[IOTypeIndex].convert_array_order == REG_TRUE) {
+    fprintf(stderr, "STEER: Consume_data_slice: cannot re-order array "
+	    "in the IOType's own buffer\n");
+    IOTypes_table.io_def[IOTypeIndex].use_xdr = REG_FALSE;
+    IOTypes_table.io_def[IOTypeIndex].num_xdr_bytes = 0;
+    return REG_FAILURE;
+  }
+
   /* Read this number of bytes - if xdr is being used or the array needs to
      be reordered then the data is read into
      IOTypes_table.io_def[IOTypeIndex].buffer, else it is stored
@@ -1615,20 +2262,100 @@ int Consume_data_slice(int    IOTypeIndex,
   if (Consume_data_read(IOTypeIndex,
 			DataType,
 			num_bytes_to_read,
-			pData) != REG_SUCCESS)
+			pSlice) != REG_SUCCESS)
+    return REG_FAILURE;
+
+
+  /* Re-order and decode (xdr) data as necessary - CURRENTLY
+     ONLY DECODES. If the slice was read straight into the
+     application's own staging buffer it is decoded where it is. */
+  if(pSlice == IOTypes_table.io_def[IOTypeIndex].buffer &&
+     IOTypes_table.io_def[IOTypeIndex].use_xdr &&
+     IOTypes_table.io_def[IOTypeIndex].convert_array_order != REG_TRUE) {
+    Convert_xdr_in_place(DataType, Count, pSlice, REG_FALSE);
+  }
+  else {
+    Reorder_decode_array(&(IOTypes_table.io_def[IOTypeIndex]),
+			 DataType, Count,  pSlice);
+  }
+
+  if(pData && pSlice != pData) {
+    memcpy(pData, pSlice, num_bytes_decoded);
+  }
+
+  /* Reset use_xdr flag set as only valid on a per-slice basis */
+  IOTypes_table.io_def[IOTypeIndex].use_xdr = REG_FALSE;
+  IOTypes_table.io_def[IOTypeIndex].num_xdr_bytes = 0;
+
+  return return_status;
+}
+
+/*----------------------------------------------------------------*/
+
+int Consume_data_slice_layout(int         IOTypeIndex,
+			      int         DataType,
+			      int         NumDims,
+			      const int  *Extent,
+			      const long *Stride,
+			      const int  *Origin,
+			      void       *pData)
+{
+  size_t      size;
+  size_t      num_bytes;
+  int         count;
+  const void *base;
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
+
+  if(IOTypeIndex < 0 || IOTypeIndex >= IOTypes_table.num_registered){
+    fprintf(stderr, "STEER: ERROR: Consume_data_slice_layout: invalid "
+	    "IOType handle (%d) supplied\n", IOTypeIndex);
     return REG_FAILURE;
+  }
+
+  if(Resolve_data_slice_layout("Consume_data_slice_layout", DataType,
+			       NumDims, Extent, Stride, Origin, pData,
+			       &size, &count, &base) != REG_SUCCESS){
+    IOTypes_table.io_def[IOTypeIndex].use_xdr = REG_FALSE;
+    IOTypes_table.io_def[IOTypeIndex].num_xdr_bytes = 0;
+    return REG_FAILURE;
+  }
+
+  /* Nothing to scatter - this is just an ordinary slice */
+  if(Layout_is_contiguous(NumDims, Extent, Stride, size)){
+    return Consume_data_slice(IOTypeIndex, DataType, count, (void *)base);
+  }
 
+  /* Read and decode the slice in the IOType's buffer and scatter it
+     from there. Make the buffer big enough for both the encoded and
+     the decoded slice now so that it doesn't move under
+     Consume_data_slice(). */
+  num_bytes = count*size;
+  if(IOTypes_table.io_def[IOTypeIndex].use_xdr &&
+     (size_t)IOTypes_table.io_def[IOTypeIndex].num_xdr_bytes > num_bytes){
+    num_bytes = (size_t)IOTypes_table.io_def[IOTypeIndex].num_xdr_bytes;
+  }
 
-  /* Re-order and decode (xdr) data as necessary - CURRENTLY
-     ONLY DECODES.*/
-  Reorder_decode_array(&(IOTypes_table.io_def[IOTypeIndex]),
-		       DataType, Count,  pData);
+  if(num_bytes > (size_t)IOTypes_table.io_def[IOTypeIndex].buffer_max_bytes){
 
-  /* Reset use_xdr flag set as only valid on a per-slice basis */
-  IOTypes_table.io_def[IOTypeIndex].use_xdr = REG_FALSE;
-  IOTypes_table.io_def[IOTypeIndex].num_xdr_bytes = 0;
+    if(Realloc_iotype_buffer(IOTypeIndex, (int)num_bytes) != REG_SUCCESS){
+      IOTypes_table.io_def[IOTypeIndex].use_xdr = REG_FALSE;
+      IOTypes_table.io_def[IOTypeIndex].num_xdr_bytes = 0;
+      return REG_FAILURE;
+    }
+  }
 
-  return return_status;
+  if(Consume_data_slice(IOTypeIndex, DataType, count,
+			IOTypes_table.io_def[IOTypeIndex].buffer)
+     != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+
+  Copy_array_layout(NumDims, Extent, Stride, size, (void *)base,
+		    IOTypes_table.io_def[IOTypeIndex].buffer, REG_FALSE);
+
+  return REG_SUCCESS;
 }
 
 /*----------------------------------------------------------------*/
@@ -1664,8 +2391,10 @@ int Emit_start(int  IOType,
     return REG_FAILURE;
   }
 
-  /* Set whether or not to encode as XDR */
-  IOTypes_table.io_def[*IOTypeIndex].use_xdr = REG_TRUE;
+  /* Set whether or not to encode as XDR - encoding is a copy so
+     zero-copy IOTypes send numeric data in native format */
+  IOTypes_table.io_def[*IOTypeIndex].use_xdr =
+    !IOTypes_table.io_def[*IOTypeIndex].use_zerocopy;
 
   /* Initialise array-ordering flags */
   IOTypes_table.io_def[*IOTypeIndex].convert_array_order = REG_FALSE;
@@ -1754,6 +2483,12 @@ int Emit_stop(int *IOTypeIndex)
 
   Emit_stop_impl(*IOTypeIndex);
 
+  /* Go back to the application's staging buffer if a slice was too
+     big for it */
+  if(IOTypes_table.io_def[*IOTypeIndex].user_buffer) {
+    Release_iotype_buffer(*IOTypeIndex);
+  }
+
   /* Flag that we'll want an acknowledgement of this data set
      before we try to read another one */
   if(return_status == REG_SUCCESS){
@@ -1783,11 +2518,7 @@ int Emit_data_slice(int		      IOTypeIndex,
 		    int               Count,
 		    const void       *pData)
 {
-  int              datatype;
-  int              actual_count;
-  size_t	   num_bytes_to_send;
-  XDR              xdrs;
-  void            *out_ptr;
+  int done;
 
   /* Check that steering is enabled */
   if(!ReG_SteeringEnabled) return REG_SUCCESS;
@@ -1810,8 +2541,191 @@ int Emit_data_slice(int		      IOTypeIndex,
     return REG_FAILURE;
   }
 
+  /* Only send the part of the array the consumer wants */
+  if(Extract_data_slice_roi(IOTypeIndex, DataType, &Count,
+			    &pData) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  /* Send coarser versions of it first if asked to */
+  if(Emit_data_slice_lod(IOTypeIndex, DataType, Count, pData,
+			 &done) != REG_SUCCESS) {
+    IOTypes_table.io_def[IOTypeIndex].ack_needed = REG_FALSE;
+    return REG_FAILURE;
+  }
+
+  /* ...which may be all the consumer wants */
+  if(done) return REG_SUCCESS;
+
+  return Send_data_slice(IOTypeIndex, DataType, Count, pData);
+}
+
+/*----------------------------------------------------------------*/
+
+int Emit_data_slice_layout(int         IOTypeIndex,
+			   int         DataType,
+			   int         NumDims,
+			   const int  *Extent,
+			   const long *Stride,
+			   const int  *Origin,
+			   const void *pData)
+{
+  size_t      size;
+  int         count;
+  const void *base;
+
+  /* Check that steering is enabled */
+  if(!ReG_SteeringEnabled) return REG_SUCCESS;
+
+  /* Can only call this function if steering lib initialised */
+  if (!ReG_SteeringInit) return REG_FAILURE;
+
+  if(IOTypeIndex < 0 || IOTypeIndex >= IOTypes_table.num_registered){
+    fprintf(stderr, "STEER: ERROR: Emit_data_slice_layout: invalid "
+	    "IOType handle (%d) supplied\n", IOTypeIndex);
+    return REG_FAILURE;
+  }
+
+  if(Resolve_data_slice_layout("Emit_data_slice_layout", DataType,
+			       NumDims, Extent, Stride, Origin, pData,
+			       &size, &count, &base) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+
+  /* Nothing to gather - this is just an ordinary slice */
+  if(Layout_is_contiguous(NumDims, Extent, Stride, size)){
+    return Emit_data_slice(IOTypeIndex, DataType, count, base);
+  }
+
+  /* check comms connection has been made */
+  if (Get_communication_status(IOTypeIndex) !=  REG_SUCCESS)
+    return REG_FAILURE;
+
+  /* Check that this IOType is enabled */
+  if(IOTypes_table.io_def[IOTypeIndex].is_enabled == REG_FALSE){
+    return REG_FAILURE;
+  }
+
+  /* Gather straight into the buffer the slice is sent from, where
+     Send_data_slice() will encode it in place */
+  if(count*size > (size_t)IOTypes_table.io_def[IOTypeIndex].buffer_max_bytes){
+
+    if(Realloc_iotype_buffer(IOTypeIndex, (int)(count*size))
+       != REG_SUCCESS){
+      IOTypes_table.io_def[IOTypeIndex].ack_needed = REG_FALSE;
+      return REG_FAILURE;
+    }
+  }
+
+  Copy_array_layout(NumDims, Extent, Stride, size, (void *)base,
+		    IOTypes_table.io_def[IOTypeIndex].buffer, REG_TRUE);
+
+  return Send_data_slice(IOTypeIndex, DataType, count,
+			 IOTypes_table.io_def[IOTypeIndex].buffer);
+}
+
+/*----------------------------------------------------------------*/
+
+int Resolve_data_slice_layout(const char  *Caller,
+			      int          DataType,
+			      int          NumDims,
+			      const int   *Extent,
+			      const long  *Stride,
+			      const int   *Origin,
+			      const void  *pData,
+			      size_t      *Size,
+			      int         *Count,
+			      const void **pBase)
+{
+  const char *base = (const char *)pData;
+  double      total = 1.0;
+  int         d;
+
+  switch(DataType){
+  case REG_INT:
+    *Size = sizeof(int);
+    break;
+  case REG_LONG:
+    *Size = sizeof(long);
+    break;
+  case REG_FLOAT:
+    *Size = sizeof(float);
+    break;
+  case REG_DBL:
+    *Size = sizeof(double);
+    break;
+  case REG_CHAR:
+    *Size = sizeof(char);
+    break;
+  default:
+    fprintf(stderr, "STEER: %s: Unrecognised data type\n", Caller);
+    return REG_FAILURE;
+  }
+
+  if(NumDims < 1 || NumDims > REG_MAX_LAYOUT_DIMS || !Extent || !Stride){
+    fprintf(stderr, "STEER: %s: layout must have between 1 and %d "
+	    "dimensions\n", Caller, REG_MAX_LAYOUT_DIMS);
+    return REG_FAILURE;
+  }
+
+  for(d = 0; d < NumDims; d++){
+    if(Extent[d] < 0){
+      fprintf(stderr, "STEER: %s: negative extent (%d) in dimension "
+	      "%d\n", Caller, Extent[d], d);
+      return REG_FAILURE;
+    }
+    total *= Extent[d];
+    if(Origin) base += Origin[d]*Stride[d];
+  }
+
+  if(total*(double)(*Size) > (double)INT_MAX){
+    fprintf(stderr, "STEER: %s: layout holds too many elements\n",
+	    Caller);
+    return REG_FAILURE;
+  }
+
+  *Count = (int)total;
+  *pBase = base;
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Send_data_slice(int         IOTypeIndex,
+		    int         DataType,
+		    int         Count,
+		    const void *pData)
+{
+  int              datatype;
+  int              actual_count;
+  size_t	   num_bytes_to_send;
+  XDR              xdrs;
+  void            *out_ptr;
+
   actual_count = Count;
 
+  /* Slices in the application's own staging buffer, or already
+     gathered into the IOType's buffer, are encoded where they are */
+  if(IOTypes_table.io_def[IOTypeIndex].use_xdr && pData &&
+     (pData == IOTypes_table.io_def[IOTypeIndex].user_buffer ||
+      pData == IOTypes_table.io_def[IOTypeIndex].buffer)) {
+
+    num_bytes_to_send = Convert_xdr_in_place(DataType, actual_count,
+					     (void *)pData, REG_TRUE);
+    switch(DataType){
+    case REG_INT:   datatype = REG_XDR_INT;    break;
+    case REG_LONG:  datatype = REG_XDR_LONG;   break;
+    case REG_FLOAT: datatype = REG_XDR_FLOAT;  break;
+    case REG_DBL:   datatype = REG_XDR_DOUBLE; break;
+    default:        datatype = DataType;
+      num_bytes_to_send = actual_count;
+      break;
+    }
+
+    return Send_encoded_data_slice(IOTypeIndex, datatype, actual_count,
+				   num_bytes_to_send, pData);
+  }
+
   /* Check data type, calculate number of bytes to send and convert
      to XDR if required */
   switch(DataType){
@@ -1963,19 +2877,31 @@ int Emit_data_slice(int		      IOTypeIndex,
     break;
   }
 
+  return Send_encoded_data_slice(IOTypeIndex, datatype, actual_count,
+				 num_bytes_to_send, out_ptr);
+}
+
+/*----------------------------------------------------------------*/
+
+int Send_encoded_data_slice(int         IOTypeIndex,
+			    int         DataType,
+			    int         Count,
+			    size_t      NumBytes,
+			    const void *pData)
+{
   /* Send ReG-specific header */
 
   if( Emit_iotype_msg_header(IOTypeIndex,
-			     datatype,
-			     actual_count,
-			     num_bytes_to_send,
+			     DataType,
+			     Count,
+			     NumBytes,
 			     ReG_CalledFromF90) == REG_SUCCESS){
 
     /* Send data */
     if( Emit_data(IOTypeIndex,
-		  datatype,
-		  num_bytes_to_send,
-		  out_ptr) == REG_SUCCESS) return REG_SUCCESS;
+		  DataType,
+		  NumBytes,
+		  (void *)pData) == REG_SUCCESS) return REG_SUCCESS;
   }
 
   IOTypes_table.io_def[IOTypeIndex].ack_needed = REG_FALSE;
@@ -1992,10 +2918,7 @@ int Register_param(const char* ParamLabel,
                    const char* ParamMaximum)
 {
   int    current;
-  int    dum_int;
-  long   dum_long;
-  float  dum_flt;
-  double dum_dbl;
+  int    limit_type;
 
   /* Check that steering is enabled */
 
@@ -2051,64 +2974,23 @@ int Register_param(const char* ParamLabel,
   /* Logging of parameter values is on by default */
   Params_table.param[current].logging_on = REG_TRUE;
 
-  /* Range of validity for this parameter - assume invalid
-     first and check second */
-  Params_table.param[current].min_val_valid = REG_FALSE;
-  Params_table.param[current].max_val_valid = REG_FALSE;
+  /* Always goes in the next status report */
+  Params_table.param[current].status_sent = REG_FALSE;
+
+  /* Range of validity for this parameter - limits of strings and
+     raw data are their lengths */
   switch(ParamType){
 
   case REG_INT:
-    if(sscanf(ParamMinimum, "%d", &dum_int) == 1){
-      Params_table.param[current].min_val_valid = REG_TRUE;
-    }
-    if(sscanf(ParamMaximum, "%d", &dum_int) == 1){
-      Params_table.param[current].max_val_valid = REG_TRUE;
-    }
-    break;
-
   case REG_LONG:
-    if(sscanf(ParamMinimum, "%ld", &dum_long) == 1){
-      Params_table.param[current].min_val_valid = REG_TRUE;
-    }
-    if(sscanf(ParamMaximum, "%ld", &dum_long) == 1){
-      Params_table.param[current].max_val_valid = REG_TRUE;
-    }
-    break;
-
   case REG_FLOAT:
-    if(sscanf(ParamMinimum, "%f", &dum_flt) == 1){
-      Params_table.param[current].min_val_valid = REG_TRUE;
-    }
-    if(sscanf(ParamMaximum, "%f", &dum_flt) == 1){
-      Params_table.param[current].max_val_valid = REG_TRUE;
-    }
-    break;
-
   case REG_DBL:
-    if(sscanf(ParamMinimum, "%lg", &dum_dbl) == 1){
-      Params_table.param[current].min_val_valid = REG_TRUE;
-    }
-    if(sscanf(ParamMaximum, "%lg", &dum_dbl) == 1){
-      Params_table.param[current].max_val_valid = REG_TRUE;
-    }
+    limit_type = ParamType;
     break;
 
   case REG_CHAR:
-    /* Limits are taken as lengths for a string */
-    if(sscanf(ParamMinimum, "%d", &dum_int) == 1){
-      Params_table.param[current].min_val_valid = REG_TRUE;
-    }
-    if(sscanf(ParamMaximum, "%d", &dum_int) == 1){
-      Params_table.param[current].max_val_valid = REG_TRUE;
-    }
-    break;
-
   case REG_BIN:
-    /* Upper limit is taken as no. of bytes for raw data
-       buffer */
-    if(sscanf(ParamMaximum, "%d", &dum_int) == 1){
-      Params_table.param[current].max_val_valid = REG_TRUE;
-    }
+    limit_type = REG_INT;
     break;
 
   default:
@@ -2116,25 +2998,30 @@ int Register_param(const char* ParamLabel,
             "type - skipping parameter >%s<\n", ParamLabel);
     return REG_FAILURE;
   }
-  if(Params_table.param[current].min_val_valid == REG_TRUE){
-    strncpy(Params_table.param[current].min_val, ParamMinimum,
-            REG_MAX_STRING_LENGTH);
-  }
-  else{
-    sprintf(Params_table.param[current].min_val, " ");
-  }
 
-  if(Params_table.param[current].max_val_valid == REG_TRUE){
-    strncpy(Params_table.param[current].max_val, ParamMaximum,
-            REG_MAX_STRING_LENGTH);
-  }
-  else{
-    sprintf(Params_table.param[current].max_val, " ");
-  }
+  /* Upper limit of raw data is its no. of bytes; it has no lower one */
+  Params_table.param[current].min_val_valid =
+    (ParamType != REG_BIN &&
+     Param_value_from_string(limit_type, ParamMinimum,
+			     &(Params_table.param[current].min_val)) ==
+     REG_SUCCESS) ? REG_TRUE : REG_FALSE;
+
+  Params_table.param[current].max_val_valid =
+    (Param_value_from_string(limit_type, ParamMaximum,
+			     &(Params_table.param[current].max_val)) ==
+     REG_SUCCESS) ? REG_TRUE : REG_FALSE;
+
+  /* No value until one is read from ParamPtr */
+  memset(&(Params_table.param[current].value), 0, sizeof(Param_value_type));
 
   /* Create handle for this parameter */
   Params_table.param[current].handle = Params_table.next_handle++;
 
+  if(Param_table_index_add(&Params_table, current) != REG_SUCCESS){
+    Params_table.param[current].handle = REG_PARAM_HANDLE_NOTSET;
+    return REG_FAILURE;
+  }
+
   Params_table.num_registered++;
 
   /* If this is the special time-step parameter then also register
@@ -2151,11 +3038,11 @@ int Register_param(const char* ParamLabel,
     Params_table.param[current].is_internal=REG_FALSE;
     Params_table.param[current].logging_on =REG_FALSE;
     strcpy(Params_table.param[current].label, "REG_TOT_SIM_TIME_S");
-    strcpy(Params_table.param[current].value, "0.0");
-    strcpy(Params_table.param[current].min_val, "0.0");
+    Params_table.param[current].value.d = 0.0;
+    Params_table.param[current].min_val.d = 0.0;
     Params_table.param[current].min_val_valid = REG_TRUE;
-    strcpy(Params_table.param[current].max_val, "");
     Params_table.param[current].max_val_valid = REG_FALSE;
+    Param_table_index_add(&Params_table, current);
     Increment_param_registered(&Params_table);
   }
 
@@ -2287,6 +3174,12 @@ int Toggle_param_logging(const char* ParamLabel,
     lToggle = REG_TRUE;
   }
 
+  /* Exact matches are found without looking at every label */
+  if((i = Param_index_from_label(&Params_table, ParamLabel)) != -1){
+    Params_table.param[i].logging_on = lToggle;
+    return REG_SUCCESS;
+  }
+
   /* Take special care to avoid problems with trailing white
      space in labels passed to us from F90 */
   len1 = strlen(ParamLabel);
@@ -2343,6 +3236,7 @@ int Steering_control(int     SeqNum,
   int    return_status = REG_SUCCESS;
   int    num_commands  = 0;
   int    num_param     = 0;
+  int    num_held      = 0;
   int    commands[REG_MAX_NUM_STR_CMDS];
   int    param_handles[REG_MAX_NUM_STR_PARAMS];
   char*  param_labels[REG_MAX_NUM_STR_PARAMS];
@@ -2400,14 +3294,14 @@ int Steering_control(int     SeqNum,
 
   /* Update any library-controlled monitored variables */
   if(seq_num_index > -1){
-    sprintf(Params_table.param[seq_num_index].value, "%d", SeqNum);
+    Params_table.param[seq_num_index].value.i = SeqNum;
     Params_table.param[seq_num_index].modified = REG_TRUE;
   }
   else if(seq_num_index == NOT_LOOKED){
     seq_num_index = Param_index_from_handle(&(Params_table),
 					    REG_SEQ_NUM_HANDLE);
     if(seq_num_index != -1){
-      sprintf(Params_table.param[seq_num_index].value, "%d", SeqNum);
+      Params_table.param[seq_num_index].value.i = SeqNum;
       Params_table.param[seq_num_index].modified = REG_TRUE;
     }
     else{
@@ -2418,12 +3312,9 @@ int Steering_control(int     SeqNum,
   /* Time-step related values (for coupled models) */
   if(time_step_index > -1){
     Get_ptr_value(&(Params_table.param[time_step_index]));
-    /*fprintf(stderr, "ARPDBG: dt = %s\n",
-              Params_table.param[time_step_index].value);*/
-    if(sscanf(Params_table.param[time_step_index].value, "%lg",
-	      &ReG_SimTimeStepSecs) != 1){
-      fprintf(stderr, "STEER: Steering_control - sscanf failed!\n");
-    }
+    ReG_SimTimeStepSecs =
+      Param_value_to_double(Params_table.param[time_step_index].type,
+			    &(Params_table.param[time_step_index].value));
 
     ReG_TotalSimTimeSecs += ReG_SimTimeStepSecs;
 
@@ -2431,20 +3322,24 @@ int Steering_control(int     SeqNum,
 	    ReG_TotalSimTimeSecs);
   }
   else if(time_step_index == NOT_LOOKED){
-    for(i=0; i<Params_table.max_entries; i++){
+    /* Labels containing (not just matching) REG_TIMESTEP_LABEL count
+       too, so fall back to looking at every live one */
+    time_step_index = Param_index_from_label(&Params_table,
+					     REG_TIMESTEP_LABEL);
+    for(i=0; i<Params_table.num_live && time_step_index == -1; i++){
 
-      if(Params_table.param[i].handle != REG_PARAM_HANDLE_NOTSET &&
-	 strstr(Params_table.param[i].label, REG_TIMESTEP_LABEL)){
+      if(strstr(Params_table.param[Params_table.live[i]].label,
+		REG_TIMESTEP_LABEL)){
 
-	time_step_index = i;
-	break;
+	time_step_index = Params_table.live[i];
       }
     }
 
     if(time_step_index != NOT_LOOKED){
       Get_ptr_value(&(Params_table.param[time_step_index]));
-      sscanf(Params_table.param[time_step_index].value, "%lg",
-	     &ReG_SimTimeStepSecs);
+      ReG_SimTimeStepSecs =
+	Param_value_to_double(Params_table.param[time_step_index].type,
+			      &(Params_table.param[time_step_index].value));
 
       ReG_TotalSimTimeSecs += ReG_SimTimeStepSecs;
     }
@@ -2455,16 +3350,14 @@ int Steering_control(int     SeqNum,
 
   /* Total-simulated time-related values (for coupled models) */
   if(tot_time_index > -1){
-    sprintf(Params_table.param[tot_time_index].value, "%.20g",
-	    ReG_TotalSimTimeSecs);
+    Params_table.param[tot_time_index].value.d = ReG_TotalSimTimeSecs;
     Params_table.param[tot_time_index].modified = REG_TRUE;
   }
   else if(tot_time_index == NOT_LOOKED){
     tot_time_index = Param_index_from_handle(&(Params_table),
 					    REG_TOT_SIM_TIME_HANDLE);
     if(tot_time_index != -1){
-      sprintf(Params_table.param[tot_time_index].value, "%.20g",
-	      ReG_TotalSimTimeSecs);
+      Params_table.param[tot_time_index].value.d = ReG_TotalSimTimeSecs;
 
       Params_table.param[tot_time_index].modified = REG_TRUE;
     }
@@ -2480,8 +3373,9 @@ int Steering_control(int     SeqNum,
     time_per_step = (float)(new_time - previous_time)*inv_clocks_per_sec;
     previous_time = new_time;
 
-    sprintf(Params_table.param[step_time_index].value, "%.3f",
-	    time_per_step);
+    /* Keep to the nearest millisecond, as it used to be reported */
+    Params_table.param[step_time_index].value.f =
+      (float)(long)(time_per_step*1000.0f + 0.5f)/1000.0f;
     Params_table.param[step_time_index].modified = REG_TRUE;
   }
   else if(step_time_index == NOT_LOOKED || first_time == REG_TRUE){
@@ -2501,6 +3395,16 @@ int Steering_control(int     SeqNum,
 
   if(Params_table.log_all == REG_TRUE)Log_param_values();
 
+  /* Let the transport look after consumers that have connected to an
+     output since its last data set was emitted */
+
+  for(i = 0; i < IOTypes_table.num_registered; i++){
+    if(IOTypes_table.io_def[i].direction == REG_IO_OUT &&
+       IOTypes_table.io_def[i].is_enabled == REG_TRUE){
+      Poll_IOType_impl(i);
+    }
+  }
+
   /* Check to see if a steerer is trying to get control */
 
   if(!ReG_SteeringActive){
@@ -2517,6 +3421,8 @@ int Steering_control(int     SeqNum,
 
 	ReG_SteeringActive = REG_TRUE;
 	first_time = REG_TRUE;
+	/* A new steerer knows none of the parameter values */
+	ReG_StatusUntilFull = 0;
 #ifdef REG_DEBUG
 	fprintf(stderr, "STEER: Steering_control: steerer has connected\n");
 #endif
@@ -2534,10 +3440,15 @@ int Steering_control(int     SeqNum,
   do_steer = ((SeqNum % Steerer_connection.steer_interval) == 0);
   do_steer = (do_steer && ReG_SteeringActive);
 
-  /* Deal with automatic emission/consumption of data - this is done
-     whether or not a steering client is connected */
+  /* Anything that didn't fit last time goes first */
   cmd_count = 0;
   param_count = 0;
+  Take_held_over(&cmd_count, commands, SteerCmdParams,
+		 REG_MAX_NUM_STR_CMDS, &param_count, param_handles,
+		 param_labels, REG_MAX_NUM_STR_PARAMS);
+
+  /* Deal with automatic emission/consumption of data - this is done
+     whether or not a steering client is connected */
   Auto_generate_steer_cmds(SeqNum, &cmd_count, commands,
 			   SteerCmdParams, &param_count,
 			   param_handles, param_labels);
@@ -2610,7 +3521,9 @@ int Steering_control(int     SeqNum,
 			&(SteerCmdParams[cmd_count]),
 			&num_param,
 			&(param_handles[param_count]),
-			&(param_labels[param_count])) != REG_SUCCESS ){
+			&(param_labels[param_count]),
+			REG_MAX_NUM_STR_CMDS - cmd_count,
+			REG_MAX_NUM_STR_PARAMS - param_count) != REG_SUCCESS ){
 
       return_status = REG_FAILURE;
 
@@ -2760,12 +3673,22 @@ int Steering_control(int     SeqNum,
 
   /* Append details of any parameters that were edited while we
      were paused to array holding labels of changed params - pass
-     back strings rather than pointers to strings.   */
-  for(i=(*NumSteerParams); i<((*NumSteerParams)+num_param); i++){
-    if( i>= REG_MAX_NUM_STR_PARAMS)break;
-    strcpy(SteerParamLabels[i], param_labels[i]);
+     back strings rather than pointers to strings.  Any that don't
+     fit are held over to the next call. */
+  for(i=0; i<num_param; i++){
+
+    if(*NumSteerParams < REG_MAX_NUM_STR_PARAMS){
+      strcpy(SteerParamLabels[(*NumSteerParams)++], param_labels[i]);
+    }
+    else if(Hold_over_param(param_handles[i]) == REG_SUCCESS){
+      num_held++;
+    }
+  }
+  if(num_held > 0){
+    fprintf(stderr, "STEER: WARNING: Steering_control: more than %d "
+	    "params steered - holding %d over to the next call\n",
+	    REG_MAX_NUM_STR_PARAMS, num_held);
   }
-  *NumSteerParams = i;
   /* Record how many commands we're going to pass back to caller */
   *NumSteerCommands = cmd_count;
 
@@ -2813,6 +3736,8 @@ int Auto_generate_steer_cmds(int    SeqNum,
   int    i;
   int    return_status = REG_SUCCESS;
   int    cmd_count, param_count;
+  int    num_held      = 0;
+  char  *dirn;
 
   struct msg_store_struct *previous = NULL;
   struct msg_store_struct *toDelete  = NULL;
@@ -2827,34 +3752,35 @@ int Auto_generate_steer_cmds(int    SeqNum,
 
     if((SeqNum % IOTypes_table.io_def[i].frequency) != 0)continue;
 
-    if( *posn >= REG_MAX_NUM_STR_CMDS ){
-      fprintf(stderr, "STEER: WARNING: Auto_generate_steer_cmds: discarding "
-	      "steering cmds as max number (%d) exceeded\n",
-	      REG_MAX_NUM_STR_CMDS);
-
-      return_status = REG_FAILURE;
-      break;
-    }
-
-    /* Add command to list to send back to caller */
-    SteerCommands[*posn]  = IOTypes_table.io_def[i].handle;
-
     switch(IOTypes_table.io_def[i].direction){
 
     case REG_IO_IN:
-      sprintf(SteerCmdParams[*posn], "IN");
+      dirn = "IN";
       break;
 
     case REG_IO_OUT:
     case REG_IO_INOUT:
-      sprintf(SteerCmdParams[*posn], "OUT");
+      dirn = "OUT";
       break;
 
     default:
-      sprintf(SteerCmdParams[*posn], " ");
+      dirn = " ";
       break;
     }
-    (*posn)++;
+
+    /* Add command to list to send back to caller */
+    if( *posn < REG_MAX_NUM_STR_CMDS ){
+      SteerCommands[*posn] = IOTypes_table.io_def[i].handle;
+      strcpy(SteerCmdParams[*posn], dirn);
+      (*posn)++;
+    }
+    else if(Hold_over_cmd(IOTypes_table.io_def[i].handle,
+			  dirn) == REG_SUCCESS){
+      num_held++;
+    }
+    else{
+      return_status = REG_FAILURE;
+    }
   }
 
   /* Repeat for Chk types */
@@ -2865,22 +3791,27 @@ int Auto_generate_steer_cmds(int    SeqNum,
 
     if( (SeqNum % ChkTypes_table.io_def[i].frequency) != 0)continue;
 
-    if( *posn >= REG_MAX_NUM_STR_CMDS ){
-      fprintf(stderr, "STEER: WARNING: Auto_generate_steer_cmds: discarding "
-	      "steering cmds as max number (%d) exceeded\n",
-	      REG_MAX_NUM_STR_CMDS);
-
+    /* Add command to list to send back to caller.  We only ever
+       instruct the app. to emit checkpoints since to consume a
+       checkpoint implies a restart */
+    if( *posn < REG_MAX_NUM_STR_CMDS ){
+      SteerCommands[*posn] = ChkTypes_table.io_def[i].handle;
+      sprintf(SteerCmdParams[*posn], "OUT");
+      (*posn)++;
+    }
+    else if(Hold_over_cmd(ChkTypes_table.io_def[i].handle,
+			  "OUT") == REG_SUCCESS){
+      num_held++;
+    }
+    else{
       return_status = REG_FAILURE;
-      break;
     }
+  }
 
-    /* Add command to list to send back to caller */
-    SteerCommands[*posn]  = ChkTypes_table.io_def[i].handle;
-
-    /* We only ever instruct the app. to emit checkpoints since to consume
-       a checkpoint implies a restart */
-    sprintf(SteerCmdParams[*posn], "OUT");
-    (*posn)++;
+  if(num_held > 0){
+    fprintf(stderr, "STEER: WARNING: Auto_generate_steer_cmds: more than "
+	    "%d steering cmds - holding %d over to the next call\n",
+	    REG_MAX_NUM_STR_CMDS, num_held);
   }
 
   cmd_count   = 0;
@@ -2902,7 +3833,9 @@ int Auto_generate_steer_cmds(int    SeqNum,
 			   SteerCmdParams+(*posn),
 			   &param_count,
 			   SteerParamHandles+(*paramPosn),
-			   SteerParamLabels+(*paramPosn));
+			   SteerParamLabels+(*paramPosn),
+			   REG_MAX_NUM_STR_CMDS - (*posn),
+			   REG_MAX_NUM_STR_PARAMS - (*paramPosn));
 
 	*posn += cmd_count;
 	*paramPosn += param_count;
@@ -2949,6 +3882,8 @@ int Steering_pause(int   *NumSteerParams,
   int    param_handles[REG_MAX_NUM_STR_PARAMS];
   char*  param_labels[REG_MAX_NUM_STR_PARAMS];
   int    tot_num_params = 0;
+  int    num_params;
+  int    num_held       = 0;
 
   /* Can only call this function if steering lib initialised */
 
@@ -2957,7 +3892,7 @@ int Steering_pause(int   *NumSteerParams,
   /* Get the current Sequence Number of the simulation */
   index = Param_index_from_handle(&(Params_table), REG_SEQ_NUM_HANDLE);
   if(index != -1){
-    sscanf(Params_table.param[index].value, "%d", &seqnum);
+    seqnum = Params_table.param[index].value.i;
   }
   else{
     seqnum = -1;
@@ -2971,14 +3906,26 @@ int Steering_pause(int   *NumSteerParams,
 
     sleep(1);
 
+    /* Commands held over from earlier (e.g. a resume that arrived
+       with more commands than would fit) come first.  Held-over
+       params are left for Steering_control to report. */
+    num_commands = 0;
+    num_params   = 0;
+    Take_held_over(&num_commands, commands, SteerCmdParams,
+		   REG_MAX_NUM_STR_CMDS, &num_params, param_handles,
+		   param_labels, 0);
+    j = num_commands;
+
     /* Read anything that the steerer has sent to us */
 
     if( Consume_control(&num_commands,
-			commands,
-			SteerCmdParams,
-			NumSteerParams,
+			&(commands[j]),
+			&(SteerCmdParams[j]),
+			&num_params,
 			param_handles,
-			param_labels) != REG_SUCCESS ){
+			param_labels,
+			REG_MAX_NUM_STR_CMDS - j,
+			REG_MAX_NUM_STR_PARAMS) != REG_SUCCESS ){
 
       return_status = REG_FAILURE;
       paused = REG_FALSE;
@@ -2988,27 +3935,26 @@ int Steering_pause(int   *NumSteerParams,
     }
     else{
 
+      num_commands += j;
+
 #ifdef REG_DEBUG
       fprintf(stderr,"STEER: Steering_pause: got %d cmds and %d params\n",
 	      num_commands,
-	      *NumSteerParams);
+	      num_params);
 #endif
 
       /* Add to array holding labels of changed params - pass back
-	 strings rather than pointers */
+	 strings rather than pointers.  Any that don't fit are held
+	 over to the next call of Steering_control. */
 
-      for(j=0; j<(*NumSteerParams); j++){
+      for(j=0; j<num_params; j++){
 
 	if(tot_num_params < REG_MAX_NUM_STR_PARAMS){
 	  strcpy(SteerParamLabels[tot_num_params], param_labels[j]);
 	  tot_num_params++;
 	}
-	else{
-
-	  fprintf(stderr, "STEER: Steering_pause: no. of parameters edited "
-	          "exceeds %d\n", REG_MAX_NUM_STR_PARAMS);
-	  fprintf(stderr, "                Only returning the first %d\n",
-		  REG_MAX_NUM_STR_PARAMS);
+	else if(Hold_over_param(param_handles[j]) == REG_SUCCESS){
+	  num_held++;
         }
       }
 
@@ -3056,7 +4002,7 @@ int Steering_pause(int   *NumSteerParams,
 
 	  index = Param_index_from_handle(&(Params_table), REG_SEQ_NUM_HANDLE);
 	  if(index != -1){
-	    sscanf(Params_table.param[index].value, "%d", &seqnum);
+	    seqnum = Params_table.param[index].value.i;
 	  }
 	  else{
 	    seqnum = -1;
@@ -3071,479 +4017,321 @@ int Steering_pause(int   *NumSteerParams,
 	}
       }
     }
-  }
-
-  /* Return the total no. of parameters that have been edited
-     while the application was paused */
-  *NumSteerParams = tot_num_params;
-
-  return return_status;
-}
-
-/*----------------------------------------------------------------
-              Low-level steering routines
-----------------------------------------------------------------*/
-
-int Emit_param_defs()
-{
-  char *buf;
-  char *pbuf;
-  char *dum_ptr;
-  int   nbytes;
-  int   bytes_left;
-  int   i = 0;
-  int   more_space = 0;
-  int   buf_size = REG_MAX_MSG_SIZE;
-  char *plast_param;
-
-  /* Check to see that we do actually have something to emit */
-  if (Params_table.num_registered == 0) return REG_SUCCESS;
-
-  if( !(buf=(char *)malloc(buf_size)) ){
-
-    fprintf(stderr,"STEER: Emit_param_defs: malloc failed\n");
-    return REG_FAILURE;
-  }
-
-  pbuf = buf;
-  bytes_left = buf_size;
-
-  /* Assume header and following line fit comfortably within
-     REG_MAX_MSG_SIZE so don't check for truncation yet */
-  Write_xml_header(&pbuf, &bytes_left);
-
-  nbytes = sprintf(pbuf, "<Param_defs>\n");
-  pbuf += nbytes;
-  bytes_left -= nbytes;
-  plast_param = pbuf;
-
-  /* Emit all currently registered parameters  */
-  while (i < Params_table.max_entries) {
-
-    /* Check handle because if a parameter is deleted then this is
-       flagged by unsetting its handle */
-
-    if(Params_table.param[i].handle != REG_PARAM_HANDLE_NOTSET){
-
-      /* We ran out of space */
-      if(more_space){
-	buf_size += REG_MAX_MSG_SIZE;
-	/* Adjust amount of remaining space to allow for return to
-	   last complete param entry as well as realloc */
-	bytes_left += REG_MAX_MSG_SIZE + (int)(pbuf - plast_param);
-
-	if(!(dum_ptr = (char *)realloc(buf, buf_size)) ){
-
-	  free(buf);
-	  buf = NULL;
-	  fprintf(stderr, "STEER: Emit_param_defs: realloc failed for %d "
-		  "bytes\n", buf_size);
-	  return REG_FAILURE;
-	}
-	/* realloc can return a ptr to a different chunk of memory */
-	plast_param += (dum_ptr - buf);
-	buf = dum_ptr;
-	more_space = 0;
-
-	/* Move back to last complete param entry */
-	pbuf = plast_param;
-      }
-
-      /* Update the 'value' part of this parameter's table entry */
-      if(Get_ptr_value(&(Params_table.param[i])) == REG_SUCCESS){
-
-	if(Params_table.param[i].type == REG_BIN){
-
-	  nbytes = snprintf(pbuf, bytes_left, "<Param>\n"
-			    "<Label>%s</Label>\n"
-			    "<Steerable>%d</Steerable>\n"
-			    "<Type>%d</Type>\n"
-			    "<Handle>%d</Handle>\n"
-			    "<Value>",
-			    Params_table.param[i].label,
-			    Params_table.param[i].steerable,
-			    Params_table.param[i].type,
-			    Params_table.param[i].handle);
-
-	  /* Check for truncation */
-	  if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-	    more_space = 1;
-	    continue;
-	  }
-	  bytes_left -= nbytes;
-	  pbuf += nbytes;
-
-	  /* Copy the Base64-encoded data in the buffer pointed to by ptr_raw
-	     into the 'Value' element of the message */
-	  if(bytes_left > Params_table.param[i].raw_buf_size){
-	    memcpy(pbuf, Params_table.param[i].ptr_raw,
-		   Params_table.param[i].raw_buf_size);
-	    pbuf += Params_table.param[i].raw_buf_size;
-	    bytes_left -= Params_table.param[i].raw_buf_size;
-	  }
-	  /* Free the memory malloc'd during the Base64 encode */
-	  free(Params_table.param[i].ptr_raw);
-	  Params_table.param[i].ptr_raw = NULL;
-
-	  nbytes = snprintf(pbuf, bytes_left, "</Value>\n");
-	}
-	else{
-	  nbytes = snprintf(pbuf, bytes_left, "<Param>\n"
-			    "<Label>%s</Label>\n"
-			    "<Steerable>%d</Steerable>\n"
-			    "<Type>%d</Type>\n"
-			    "<Handle>%d</Handle>\n"
-			    "<Value>%s</Value>\n",
-			    Params_table.param[i].label,
-			    Params_table.param[i].steerable,
-			    Params_table.param[i].type,
-			    Params_table.param[i].handle,
-			    Params_table.param[i].value);
-	}
-
-
-	/* Check for truncation */
-	if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-	  more_space = 1;
-	  continue;
-	}
-	bytes_left -= nbytes;
-	pbuf += nbytes;
-
-	if(Params_table.param[i].is_internal == REG_TRUE){
-
-	  nbytes = snprintf(pbuf, bytes_left,
-			    "<Is_internal>TRUE</Is_internal>\n");
-	}
-	else{
-
-	  nbytes = snprintf(pbuf, bytes_left,
-			    "<Is_internal>FALSE</Is_internal>\n");
-	}
+  }
 
-	/* Check for truncation */
-	if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-	  more_space = 1;
-	  continue;
-	}
-	bytes_left -= nbytes;
-	pbuf += nbytes;
+  /* Return the total no. of parameters that have been edited
+     while the application was paused */
+  *NumSteerParams = tot_num_params;
 
-	if(Params_table.param[i].min_val_valid==REG_TRUE &&
-	   Params_table.param[i].max_val_valid==REG_TRUE){
+  if(num_held > 0){
+    fprintf(stderr, "STEER: WARNING: Steering_pause: more than %d params "
+	    "edited while paused - holding %d over to the next call\n",
+	    REG_MAX_NUM_STR_PARAMS, num_held);
+  }
 
-	  nbytes = snprintf(pbuf, bytes_left, "<Min_value>%s</Min_value>"
-			    "<Max_value>%s</Max_value>\n"
-			    "</Param>\n",
-			    Params_table.param[i].min_val,
-			    Params_table.param[i].max_val);
-	}
-	else if(Params_table.param[i].min_val_valid==REG_TRUE){
-	  nbytes = snprintf(pbuf, bytes_left,
-			    "<Min_value>%s</Min_value>\n"
-			    "</Param>\n",
-			    Params_table.param[i].min_val);
-	}
-	else if(Params_table.param[i].max_val_valid==REG_TRUE){
-	  nbytes = snprintf(pbuf, bytes_left,
-			    "<Max_value>%s</Max_value>\n"
-			    "</Param>\n",
-			    Params_table.param[i].max_val);
-	}
-	else{
-	  nbytes = snprintf(pbuf, bytes_left, "</Param>\n");
-	}
+  return return_status;
+}
 
-	/* Check for truncation */
-	if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-	  more_space = 1;
-	  continue;
-	}
+/*----------------------------------------------------------------
+              Low-level steering routines
+----------------------------------------------------------------*/
 
-	bytes_left -= nbytes;
-	pbuf += nbytes;
+int Emit_param_defs()
+{
+  int             i;
+  int             status;
+  int             limit_type;
+  param_entry    *param;
+  Msg_writer_type msg;
 
-	/* Try and predict whether we'll hit truncation problems
-	   for the next param def - allow 5/4 the length of
-	   last param def. */
-	if( bytes_left < (int)(1.25*(pbuf - plast_param))){
-	  more_space = 1;
-	  continue;
-	}
-	plast_param = pbuf;
-      }
-    }
+  /* Check to see that we do actually have something to emit */
+  if (Params_table.num_registered == 0) return REG_SUCCESS;
 
-    i++;
+  if(Init_msg_writer(&msg, REG_MAX_MSG_SIZE,
+		     Steerer_connection.wire_format) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+  status = Msg_writer_header(&msg);
+  if(status == REG_SUCCESS){
+    status = Msg_writer_begin(&msg, MSG_TAG_PARAM_DEFS);
   }
 
-  nbytes = snprintf(pbuf, bytes_left, "</Param_defs>\n");
+  /* Emit all currently registered parameters  */
+  for(i=0; i<Params_table.max_entries && status == REG_SUCCESS; i++){
+
+    param = &(Params_table.param[i]);
 
-  /* Check for truncation */
-  if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
+    /* Check handle because if a parameter is deleted then this is
+       flagged by unsetting its handle */
+    if(param->handle == REG_PARAM_HANDLE_NOTSET) continue;
 
-    buf_size +=  REG_MAX_MSG_SIZE;
-    bytes_left +=  REG_MAX_MSG_SIZE;
+    /* Update the 'value' part of this parameter's table entry */
+    if(Get_ptr_value(param) != REG_SUCCESS) continue;
+
+    status = Msg_writer_begin(&msg, MSG_TAG_PARAM);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(&msg, MSG_TAG_LABEL, param->label);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(&msg, MSG_TAG_STEERABLE,
+				      param->steerable);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(&msg, MSG_TAG_TYPE, param->type);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(&msg, MSG_TAG_HANDLE, param->handle);
+    }
 
-    if(!(dum_ptr = (char *)realloc(buf, buf_size)) ){
+    if(param->type == REG_BIN){
 
-      free(buf);
-      buf = NULL;
-      fprintf(stderr, "STEER: Emit_param_defs: realloc failed for %d "
-	      "bytes\n", buf_size);
-      return REG_FAILURE;
+      /* Copy the Base64-encoded data in the buffer pointed to by ptr_raw
+	 into the 'Value' element of the message */
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_bytes(&msg, MSG_TAG_VALUE,
+					  (char *)param->ptr_raw,
+					  param->raw_buf_size);
+      }
+      /* Free the memory malloc'd during the Base64 encode */
+      free(param->ptr_raw);
+      param->ptr_raw = NULL;
+    }
+    else if(status == REG_SUCCESS){
+      status = Msg_writer_element_value(&msg, MSG_TAG_VALUE, param->type,
+					&(param->value));
     }
-    /* realloc can return a ptr to a different chunk of memory */
-    pbuf += (dum_ptr - buf);
-    buf = dum_ptr;
 
-    nbytes = snprintf(pbuf, bytes_left, "</Param_defs>\n");
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(&msg, MSG_TAG_IS_INTERNAL,
+			  (param->is_internal == REG_TRUE) ? "TRUE" : "FALSE");
+    }
+    limit_type = Param_limit_type(param->type);
+    if(status == REG_SUCCESS && param->min_val_valid == REG_TRUE){
+      status = Msg_writer_element_value(&msg, MSG_TAG_MIN_VALUE,
+					limit_type, &(param->min_val));
+    }
+    if(status == REG_SUCCESS && param->max_val_valid == REG_TRUE){
+      status = Msg_writer_element_value(&msg, MSG_TAG_MAX_VALUE,
+					limit_type, &(param->max_val));
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(&msg, MSG_TAG_PARAM);
+    }
   }
 
-  bytes_left -= nbytes;
-  pbuf += nbytes;
+  if(status == REG_SUCCESS){
+    status = Msg_writer_end(&msg, MSG_TAG_PARAM_DEFS);
+  }
+  if(status == REG_SUCCESS){
+    status = Msg_writer_footer(&msg);
+  }
 
-  if(Write_xml_footer(&pbuf, bytes_left) == REG_SUCCESS){
+  if(status == REG_SUCCESS){
 
     /* Physically send the message */
-    Send_status_msg(buf);
-
-    free(buf);
-    buf = NULL;
-    return REG_SUCCESS;
+    Send_status_msg(msg.buf);
   }
   else{
-    fprintf(stderr, "STEER: Emit_param_defs: ran out of space for footer\n");
-    free(buf);
-    buf = NULL;
-    return REG_FAILURE;
+    fprintf(stderr, "STEER: Emit_param_defs: failed to build message\n");
   }
+  Delete_msg_writer(&msg);
+
+  return status;
 }
 
 /*----------------------------------------------------------------*/
 
 int Emit_IOType_defs(){
 
-  int   i;
-  char  buf[REG_MAX_MSG_SIZE];
-  char *pbuf;
-  int   nbytes, bytes_left;
+  int             i;
+  int             status;
+  char           *pbuf;
+  int             bytes_left;
+  Msg_writer_type msg;
 
   /* Check that we do actually have something to emit */
   if (IOTypes_table.num_registered == 0) return REG_SUCCESS;
 
   /* Emit all currently registered IOTypes */
 
-  bytes_left = REG_MAX_MSG_SIZE;
-  pbuf = buf;
-  Write_xml_header(&pbuf, &bytes_left);
-
-  nbytes = sprintf(pbuf, "<IOType_defs>\n");
-
-  pbuf += nbytes;
-  bytes_left -= nbytes;
-
-  for(i=0; i<IOTypes_table.max_entries; i++){
-
-    if(IOTypes_table.io_def[i].handle != REG_IODEF_HANDLE_NOTSET){
-
-      /* We don't want to actually change the label that the app
-	 has supplied to us but we don't want to publish it
-	 with trailing white space */
-      strncpy((char *)Steer_lib_config.scratch_buffer,
-	      IOTypes_table.io_def[i].label,
-	      REG_SCRATCH_BUFFER_SIZE);
-
-      nbytes = snprintf(pbuf, bytes_left, "<IOType>\n"
-			"<Label>%s</Label>\n"
-			"<Handle>%d</Handle>\n",
-			trimWhiteSpace((char *)Steer_lib_config.scratch_buffer),
-			IOTypes_table.io_def[i].handle);
-
-#ifdef REG_DEBUG
-      /* Check for truncation */
-      if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-
-	fprintf(stderr, "STEER: Emit_IOType_defs: message exceeds max. "
-		"msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-	return REG_FAILURE;
-      }
-#endif
-      pbuf += nbytes;
-      bytes_left -= nbytes;
-
-      switch(IOTypes_table.io_def[i].direction){
+  if(Init_msg_writer(&msg, REG_MAX_MSG_SIZE,
+		     Steerer_connection.wire_format) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+  status = Msg_writer_header(&msg);
+  if(status == REG_SUCCESS){
+    status = Msg_writer_begin(&msg, MSG_TAG_IOTYPE_DEFS);
+  }
 
-      case REG_IO_IN:
-        nbytes = snprintf(pbuf, bytes_left, "<Direction>IN</Direction>\n");
-	break;
+  for(i=0; i<IOTypes_table.max_entries && status == REG_SUCCESS; i++){
 
-      case REG_IO_OUT:
-        nbytes = snprintf(pbuf, bytes_left, "<Direction>OUT</Direction>\n");
-	break;
+    if(IOTypes_table.io_def[i].handle == REG_IODEF_HANDLE_NOTSET) continue;
 
-      default:
+    if(IOTypes_table.io_def[i].direction != REG_IO_IN &&
+       IOTypes_table.io_def[i].direction != REG_IO_OUT){
 #ifdef REG_DEBUG
-	fprintf(stderr,
-		"STEER: Emit_IOType_defs: Unrecognised IOType direction\n");
+      fprintf(stderr,
+	      "STEER: Emit_IOType_defs: Unrecognised IOType direction\n");
 #endif
-	return REG_FAILURE;
-      }
-      pbuf += nbytes;
-      bytes_left -= nbytes;
-
-
-      nbytes = snprintf(pbuf, bytes_left, "<Freq_handle>%d</Freq_handle>\n",
-			IOTypes_table.io_def[i].freq_param_handle);
-#ifdef REG_DEBUG
-      /* Check for truncation */
-      if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
+      status = REG_FAILURE;
+      break;
+    }
 
-	fprintf(stderr, "STEER: Emit_IOType_defs: message exceeds max. "
-		"msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-	return REG_FAILURE;
+    /* We don't want to actually change the label that the app
+       has supplied to us but we don't want to publish it
+       with trailing white space */
+    strncpy((char *)Steer_lib_config.scratch_buffer,
+	    IOTypes_table.io_def[i].label,
+	    REG_SCRATCH_BUFFER_SIZE);
+
+    status = Msg_writer_begin(&msg, MSG_TAG_IOTYPE);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(&msg, MSG_TAG_LABEL,
+		      trimWhiteSpace((char *)Steer_lib_config.scratch_buffer));
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(&msg, MSG_TAG_HANDLE,
+				      IOTypes_table.io_def[i].handle);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(&msg, MSG_TAG_DIRECTION,
+	      (IOTypes_table.io_def[i].direction == REG_IO_IN) ? "IN" : "OUT");
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(&msg, MSG_TAG_FREQ_HANDLE,
+				    IOTypes_table.io_def[i].freq_param_handle);
+    }
+
+    /* The samples transport adds the address of the IOType (if any)
+       as xml. Only clients that read the xml document (e.g. from a
+       steering web service) look at it so it isn't needed in the
+       binary format. */
+    if(status == REG_SUCCESS && msg.format == REG_WIRE_XML){
+      status = Msg_writer_reserve(&msg, 4*REG_MAX_STRING_LENGTH);
+      if(status == REG_SUCCESS){
+	pbuf = msg.pos;
+	bytes_left = msg.size - (int)(msg.pos - msg.buf);
+	status = Get_IOType_address_impl(i, &pbuf, &bytes_left);
+	msg.pos = pbuf;
       }
-#endif
-      pbuf += nbytes;
-      bytes_left -= nbytes;
-
-      Get_IOType_address_impl(i, &pbuf, &bytes_left);
+    }
 
-      nbytes = snprintf(pbuf, bytes_left, "</IOType>\n");
-      pbuf += nbytes;
-      bytes_left -= nbytes;
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(&msg, MSG_TAG_IOTYPE);
     }
   }
 
-  nbytes = snprintf(pbuf, bytes_left, "</IOType_defs>\n");
-  pbuf += nbytes;
-  bytes_left -= nbytes;
+  if(status == REG_SUCCESS){
+    status = Msg_writer_end(&msg, MSG_TAG_IOTYPE_DEFS);
+  }
+  if(status == REG_SUCCESS){
+    status = Msg_writer_footer(&msg);
+  }
 
-  if(Write_xml_footer(&pbuf, bytes_left) == REG_SUCCESS){
+  if(status == REG_SUCCESS){
 
     /* Physically send message */
-    return Send_status_msg(buf);
+    status = Send_status_msg(msg.buf);
+  }
+  else{
+    fprintf(stderr, "STEER: Emit_IOType_defs: failed to build message\n");
   }
+  Delete_msg_writer(&msg);
 
-  fprintf(stderr, "STEER: Emit_IOType_defs: ran out of space for footer\n");
-  return REG_FAILURE;
+  return status;
 }
 
 /*----------------------------------------------------------------*/
 
 int Emit_ChkType_defs(){
 
-  int   i;
-  char  buf[REG_MAX_MSG_SIZE];
-  char *pbuf;
-  int   nbytes, bytes_left;
+  int             i;
+  int             status;
+  const char     *direction;
+  Msg_writer_type msg;
 
   /* Check that we do actually have something to emit */
   if (ChkTypes_table.num_registered == 0) return REG_SUCCESS;
 
   /* Emit all currently registered ChkTypes */
 
-  bytes_left = REG_MAX_MSG_SIZE;
-  pbuf = buf;
-  Write_xml_header(&pbuf, &bytes_left);
-
-  nbytes = sprintf(pbuf, "<ChkType_defs>\n");
-
-  pbuf += nbytes;
-  bytes_left -= nbytes;
-
-  for(i=0; i<ChkTypes_table.max_entries; i++){
-
-    if(ChkTypes_table.io_def[i].handle != REG_IODEF_HANDLE_NOTSET){
-
-      nbytes = snprintf(pbuf, bytes_left, "<ChkType>\n"
-		       "<Label>%s</Label>\n"
-		       "<Handle>%d</Handle>\n",
-		       ChkTypes_table.io_def[i].label,
-		       ChkTypes_table.io_def[i].handle);
-#ifdef REG_DEBUG
-      /* Check for truncation */
-      if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-
-	fprintf(stderr, "STEER: Emit_ChkType_defs: message exceeds max. "
-		"msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-	return REG_FAILURE;
-      }
-#endif /* REG_DEBUG */
-      pbuf += nbytes;
-      bytes_left -= nbytes;
+  if(Init_msg_writer(&msg, REG_MAX_MSG_SIZE,
+		     Steerer_connection.wire_format) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+  status = Msg_writer_header(&msg);
+  if(status == REG_SUCCESS){
+    status = Msg_writer_begin(&msg, MSG_TAG_CHKTYPE_DEFS);
+  }
 
+  for(i=0; i<ChkTypes_table.max_entries && status == REG_SUCCESS; i++){
 
-      switch(ChkTypes_table.io_def[i].direction){
+    if(ChkTypes_table.io_def[i].handle == REG_IODEF_HANDLE_NOTSET) continue;
 
-      case REG_IO_IN:
-        nbytes = snprintf(pbuf,bytes_left,"<Direction>IN</Direction>\n");
-	break;
+    switch(ChkTypes_table.io_def[i].direction){
 
-      case REG_IO_OUT:
-        nbytes = snprintf(pbuf,bytes_left,"<Direction>OUT</Direction>\n");
-	break;
+    case REG_IO_IN:
+      direction = "IN";
+      break;
 
-      case REG_IO_INOUT:
-	nbytes = snprintf(pbuf,bytes_left,"<Direction>INOUT</Direction>\n");
-	break;
+    case REG_IO_OUT:
+      direction = "OUT";
+      break;
 
-      default:
-#ifdef REG_DEBUG
+    case REG_IO_INOUT:
+      direction = "INOUT";
+      break;
 
-	fprintf(stderr,
-		"STEER: Emit_ChkType_defs: Unrecognised ChkType direction\n");
-#endif /* REG_DEBUG */
-	return REG_FAILURE;
-      }
+    default:
 #ifdef REG_DEBUG
-      /* Check for truncation */
-      if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-
-	fprintf(stderr, "STEER: Emit_ChkType_defs: message exceeds max. "
-		"msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-	return REG_FAILURE;
-      }
+      fprintf(stderr,
+	      "STEER: Emit_ChkType_defs: Unrecognised ChkType direction\n");
 #endif /* REG_DEBUG */
-      pbuf += nbytes;
-      bytes_left -= nbytes;
-
+      direction = NULL;
+      status = REG_FAILURE;
+      break;
+    }
+    if(status != REG_SUCCESS) break;
 
-      nbytes = snprintf(pbuf,bytes_left,"<Freq_handle>%d</Freq_handle>\n"
-			"</ChkType>\n",
-			ChkTypes_table.io_def[i].freq_param_handle);
-#ifdef REG_DEBUG
-      /* Check for truncation */
-      if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-	fprintf(stderr, "STEER: Emit_ChkType_defs: message exceeds max. "
-		"msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-	return REG_FAILURE;
-      }
-#endif /* REG_DEBUG */
-      pbuf += nbytes;
-      bytes_left -= nbytes;
+    status = Msg_writer_begin(&msg, MSG_TAG_CHKTYPE);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(&msg, MSG_TAG_LABEL,
+					 ChkTypes_table.io_def[i].label);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(&msg, MSG_TAG_HANDLE,
+				      ChkTypes_table.io_def[i].handle);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(&msg, MSG_TAG_DIRECTION, direction);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(&msg, MSG_TAG_FREQ_HANDLE,
+				   ChkTypes_table.io_def[i].freq_param_handle);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(&msg, MSG_TAG_CHKTYPE);
     }
   }
 
-  nbytes = snprintf(pbuf,bytes_left,"</ChkType_defs>\n");
-#ifdef REG_DEBUG
-  /* Check for truncation */
-  if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-    fprintf(stderr, "STEER: Emit_ChkType_defs: message exceeds max. "
-	    "msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-    return REG_FAILURE;
+  if(status == REG_SUCCESS){
+    status = Msg_writer_end(&msg, MSG_TAG_CHKTYPE_DEFS);
+  }
+  if(status == REG_SUCCESS){
+    status = Msg_writer_footer(&msg);
   }
-#endif /* REG_DEBUG */
-  pbuf += nbytes;
-  bytes_left -= nbytes;
 
-  if(Write_xml_footer(&pbuf, bytes_left) == REG_SUCCESS){
+  if(status == REG_SUCCESS){
 
     /* Physically send message */
-    return Send_status_msg(buf);
+    status = Send_status_msg(msg.buf);
   }
-  fprintf(stderr, "STEER: Emit_ChkType_defs: ran out of space for footer\n");
-  return REG_FAILURE;
+  else{
+    fprintf(stderr, "STEER: Emit_ChkType_defs: failed to build message\n");
+  }
+  Delete_msg_writer(&msg);
+
+  return status;
 }
 
 /*----------------------------------------------------------------*/
@@ -3553,10 +4341,10 @@ int Consume_control(int    *NumCommands,
 		    char  **CommandParams,
 		    int    *NumSteerParams,
 		    int    *SteerParamHandles,
-		    char  **SteerParamLabels)
+		    char  **SteerParamLabels,
+		    int     MaxCommands,
+		    int     MaxSteerParams)
 {
-  int                  cmd_count = 0;
-  int                  param_count = 0;
   struct msg_struct   *msg;
   int                  return_status = REG_SUCCESS;
 
@@ -3594,11 +4382,13 @@ int Consume_control(int    *NumCommands,
 #endif
       Unpack_control_msg(msg->control,
 			 NumCommands,
-			 Commands+cmd_count,
-			 CommandParams+cmd_count,
+			 Commands,
+			 CommandParams,
 			 NumSteerParams,
-			 SteerParamHandles+param_count,
-			 SteerParamLabels+param_count);
+			 SteerParamHandles,
+			 SteerParamLabels,
+			 MaxCommands,
+			 MaxSteerParams);
     }
     else{
       fprintf(stderr, "STEER: ERROR: Consume_control: no control data in msg\n");
@@ -3627,11 +4417,17 @@ int Unpack_control_msg(struct control_struct *ctrl,
 		       char  **CommandParams,
 		       int    *NumSteerParams,
 		       int    *SteerParamHandles,
-		       char  **SteerParamLabels)
+		       char  **SteerParamLabels,
+		       int     MaxCommands,
+		       int     MaxSteerParams)
 {
   int                  j;
   int                  count, log_count;
+  int                  num_held_cmds, num_held_params;
   int                  handle;
+  int                  id;
+  char                 held_params[REG_MAX_STRING_LENGTH];
+  char                *cmd_params;
   struct cmd_struct   *cmd;
   struct param_struct *param;
   char                *ptr;
@@ -3639,27 +4435,41 @@ int Unpack_control_msg(struct control_struct *ctrl,
 
   if(!ctrl)return REG_FAILURE;
 
+  /* Make sure the log can take everything in this message */
+  count = 0;
+  for(param = ctrl->first_param; param; param = param->next) count++;
+  log_count = 0;
+  for(cmd = ctrl->first_cmd; cmd; cmd = cmd->next) log_count++;
+
+  if(Realloc_steer_log(&Steer_log, count, log_count) != REG_SUCCESS){
+    *NumCommands = 0;
+    *NumSteerParams = 0;
+    return REG_FAILURE;
+  }
+
   cmd   = ctrl->first_cmd;
   count = 0;
+  log_count = 0;
+  num_held_cmds = 0;
 
   while(cmd){
 
     if(cmd->id){
-      sscanf((char *)(cmd->id), "%d", &(Commands[count]));
+      sscanf((char *)(cmd->id), "%d", &id);
     }
     else if(cmd->name){
 
       if(!xmlStrcmp(cmd->name, (const xmlChar *)"STOP")){
-	Commands[count] = REG_STR_STOP;
+	id = REG_STR_STOP;
       }
       else if(!xmlStrcmp(cmd->name, (const xmlChar *)"PAUSE")){
-	Commands[count] = REG_STR_PAUSE;
+	id = REG_STR_PAUSE;
       }
       else if(!xmlStrcmp(cmd->name, (const xmlChar *)"DETACH")){
-	Commands[count] = REG_STR_DETACH;
+	id = REG_STR_DETACH;
       }
       else if(!xmlStrcmp(cmd->name, (const xmlChar *)"RESUME")){
-	Commands[count] = REG_STR_RESUME;
+	id = REG_STR_RESUME;
       }
       else{
 	fprintf(stderr, "STEER: Unpack_control_msg: unrecognised cmd name: %s\n",
@@ -3667,9 +4477,6 @@ int Unpack_control_msg(struct control_struct *ctrl,
 	cmd = cmd->next;
 	continue;
       }
-
-      /* Log this command */
-      Steer_log.cmd[count].id = Commands[count];
     }
     else{
       fprintf(stderr, "STEER: Unpack_control_msg: error - skipping cmd because "
@@ -3678,10 +4485,13 @@ int Unpack_control_msg(struct control_struct *ctrl,
       continue;
     }
 
+    /* Commands that don't fit in the caller's arrays are held over */
+    cmd_params = (count < MaxCommands) ? CommandParams[count] : held_params;
+
     if(cmd->first_param){
 
       param = cmd->first_param;
-      ptr   = CommandParams[count];
+      ptr   = cmd_params;
 
       while(param){
 
@@ -3696,25 +4506,29 @@ int Unpack_control_msg(struct control_struct *ctrl,
     }
     else{
 
-      sprintf(CommandParams[count], " ");
+      sprintf(cmd_params, " ");
     }
 
-    /* Log this cmd parameter */
-    strcpy(Steer_log.cmd[count].params, CommandParams[count]);
+    /* Log this command */
+    Steer_log.cmd[log_count].id = id;
+    strcpy(Steer_log.cmd[log_count].params, cmd_params);
+    log_count++;
 
 #ifdef REG_DEBUG
     fprintf(stderr, "STEER: Unpack_control_msg: cmd[%d] = %d\n", count,
-	    Commands[count]);
+	    id);
     fprintf(stderr, "                           params  = %s\n",
-	    CommandParams[count]);
+	    cmd_params);
 #endif
-    count++;
 
-    if(count >= REG_MAX_NUM_STR_CMDS){
-
-      fprintf(stderr,
-	      "STEER: Unpack_control_msg: WARNING: truncating list of commands\n");
-      break;
+    if(count < MaxCommands){
+      Commands[count++] = id;
+    }
+    else if(Hold_over_cmd(id, held_params) == REG_SUCCESS){
+      num_held_cmds++;
+    }
+    else{
+      return_status = REG_FAILURE;
     }
 
     cmd = cmd->next;
@@ -3722,7 +4536,7 @@ int Unpack_control_msg(struct control_struct *ctrl,
 
   /* Record how many cmds we've just received */
   *NumCommands = count;
-  Steer_log.num_cmds = count;
+  Steer_log.num_cmds = log_count;
 
 
 #ifdef REG_DEBUG
@@ -3733,17 +4547,15 @@ int Unpack_control_msg(struct control_struct *ctrl,
   param = ctrl->first_param;
   count = 0;
   log_count = 0;
+  num_held_params = 0;
 
   while(param){
 
     sscanf((char *)(param->handle), "%d", &handle);
 
-    for(j=0; j<Params_table.max_entries; j++){
-
-      if (Params_table.param[j].handle == handle) break;
-    }
+    j = Param_index_from_handle(&Params_table, handle);
 
-    if(j == Params_table.max_entries){
+    if(j == -1){
 
       fprintf(stderr, "STEER: Unpack_control_msg: failed to match param "
 	      "handles\n");
@@ -3751,49 +4563,223 @@ int Unpack_control_msg(struct control_struct *ctrl,
     }
     else{
 
-      /* Store char representation of new parameter value */
+      /* Store new parameter value */
       if(param->value){
 
-	strcpy(Params_table.param[j].value, (char *)(param->value));
+	if(Param_value_from_string(Params_table.param[j].type,
+				   (char *)(param->value),
+				   &(Params_table.param[j].value)) !=
+	   REG_SUCCESS){
+	  fprintf(stderr, "STEER: Unpack_control_msg: failed to read value "
+		  "of param %d: %s\n", handle, (char *)(param->value));
+	  param = param->next;
+	  continue;
+	}
+
+	/* Update value associated with pointer */
+	Update_ptr_value(&(Params_table.param[j]));
+
+	if( !(Params_table.param[j].is_internal) ){
+
+	  if(count < MaxSteerParams){
+	    SteerParamHandles[count] = handle;
+	    SteerParamLabels[count]  = Params_table.param[j].label;
+	    count++;
+	  }
+	  else if(Hold_over_param(handle) == REG_SUCCESS){
+	    num_held_params++;
+	  }
+	  else{
+	    return_status = REG_FAILURE;
+	  }
+	}
+
+	/* Log new parameter value */
+	if(Set_log_param_value(&(Steer_log.param[log_count]), handle,
+			       Params_table.param[j].type,
+			       &(Params_table.param[j].value)) ==
+	   REG_SUCCESS){
+	  log_count++;
+	}
+      }
+      else{
+	fprintf(stderr, "STEER: Unpack_control_msg: empty parameter value "
+		"field\n");
+      }
+    }
+
+    param = param->next;
+  }
+
+  /* Record no. of param. changes in this log entry */
+  Steer_log.num_params = log_count;
+
+  if(num_held_cmds > 0 || num_held_params > 0){
+    fprintf(stderr, "STEER: Unpack_control_msg: WARNING: %d commands and "
+	    "%d steered params don't fit in the caller's arrays - holding "
+	    "them over to the next call of Steering_control\n",
+	    num_held_cmds, num_held_params);
+  }
+
+  /* Update the number of parameters received to allow for fact that
+     some may be internal and are not passed up to the calling routine */
+  *NumSteerParams = count;
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: Unpack_control_msg: received %d params\n",
+	  *NumSteerParams);
+#endif
+
+  return return_status;
+}
+
+/*----------------------------------------------------------------*/
+
+int Realloc_steer_log(Steer_log_type *log,
+		      int             num_params,
+		      int             num_cmds)
+{
+  void *dum_ptr;
+
+  if(num_params > log->max_params){
+
+    if( !(dum_ptr = realloc(log->param,
+			    num_params*sizeof(Param_log_entry_type))) ){
+
+      fprintf(stderr, "STEER: Realloc_steer_log: realloc failed\n");
+      return REG_FAILURE;
+    }
+    log->param = (Param_log_entry_type *)dum_ptr;
+
+    /* New slots hold no strings */
+    for(; log->max_params < num_params; log->max_params++){
+      log->param[log->max_params].type = REG_INT;
+    }
+  }
+
+  if(num_cmds > log->max_cmds){
+
+    if( !(dum_ptr = realloc(log->cmd,
+			    num_cmds*sizeof(Cmd_log_entry_type))) ){
+
+      fprintf(stderr, "STEER: Realloc_steer_log: realloc failed\n");
+      return REG_FAILURE;
+    }
+    log->cmd = (Cmd_log_entry_type *)dum_ptr;
+    log->max_cmds = num_cmds;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Hold_over_cmd(int         Id,
+		  const char *Params)
+{
+  int   i;
+  void *dum_ptr;
+
+  for(i=0; i<Held_over.num_cmds; i++){
+    if(Held_over.cmd[i].id == Id &&
+       !strcmp(Held_over.cmd[i].params, Params)) return REG_SUCCESS;
+  }
+
+  if(Held_over.num_cmds == Held_over.max_cmds){
+
+    if( !(dum_ptr = realloc(Held_over.cmd,
+			    (Held_over.max_cmds + REG_MAX_NUM_STR_CMDS)*
+			    sizeof(Cmd_log_entry_type))) ){
+
+      fprintf(stderr, "STEER: Hold_over_cmd: realloc failed - "
+	      "discarding cmd %d\n", Id);
+      return REG_FAILURE;
+    }
+    Held_over.cmd = (Cmd_log_entry_type *)dum_ptr;
+    Held_over.max_cmds += REG_MAX_NUM_STR_CMDS;
+  }
+
+  Held_over.cmd[Held_over.num_cmds].id = Id;
+  strncpy(Held_over.cmd[Held_over.num_cmds].params, Params,
+	  REG_MAX_STRING_LENGTH);
+  Held_over.cmd[Held_over.num_cmds].params[REG_MAX_STRING_LENGTH-1] = '\0';
+  Held_over.num_cmds++;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Hold_over_param(int Handle)
+{
+  int   i;
+  void *dum_ptr;
+
+  for(i=0; i<Held_over.num_params; i++){
+    if(Held_over.param_handles[i] == Handle) return REG_SUCCESS;
+  }
+
+  if(Held_over.num_params == Held_over.max_params){
+
+    if( !(dum_ptr = realloc(Held_over.param_handles,
+			    (Held_over.max_params + REG_MAX_NUM_STR_PARAMS)*
+			    sizeof(int))) ){
+
+      fprintf(stderr, "STEER: Hold_over_param: realloc failed - "
+	      "discarding param %d\n", Handle);
+      return REG_FAILURE;
+    }
+    Held_over.param_handles = (int *)dum_ptr;
+    Held_over.max_params += REG_MAX_NUM_STR_PARAMS;
+  }
+
+  Held_over.param_handles[Held_over.num_params++] = Handle;
 
-	/* Update value associated with pointer */
-	Update_ptr_value(&(Params_table.param[j]));
+  return REG_SUCCESS;
+}
 
-	if( !(Params_table.param[j].is_internal) ){
+/*----------------------------------------------------------------*/
 
-	  SteerParamHandles[count] = handle;
-	  SteerParamLabels[count]  = Params_table.param[j].label;
-	  count++;
-	}
+void Take_held_over(int    *NumCommands,
+		    int    *Commands,
+		    char  **CommandParams,
+		    int     MaxCommands,
+		    int    *NumSteerParams,
+		    int    *SteerParamHandles,
+		    char  **SteerParamLabels,
+		    int     MaxSteerParams)
+{
+  int i, j, n;
 
-	/* Log new parameter value */
-	Steer_log.param[log_count].handle = handle;
-	strcpy(Steer_log.param[log_count].value,
-	       Params_table.param[j].value);
-	log_count++;
-      }
-      else{
-	fprintf(stderr, "STEER: Unpack_control_msg: empty parameter value "
-		"field\n");
-      }
-    }
+  /* Commands, oldest first */
+  for(n=0; n<Held_over.num_cmds && *NumCommands < MaxCommands; n++){
 
-    param = param->next;
+    Commands[*NumCommands] = Held_over.cmd[n].id;
+    strcpy(CommandParams[*NumCommands], Held_over.cmd[n].params);
+    (*NumCommands)++;
+  }
+  if(n > 0){
+    Held_over.num_cmds -= n;
+    memmove(Held_over.cmd, &(Held_over.cmd[n]),
+	    Held_over.num_cmds*sizeof(Cmd_log_entry_type));
   }
 
-  /* Record no. of param. changes in this log entry */
-  Steer_log.num_params = log_count;
-
-  /* Update the number of parameters received to allow for fact that
-     some may be internal and are not passed up to the calling routine */
-  *NumSteerParams = count;
+  /* Steered params - skip any that have since been unregistered */
+  for(n=0; n<Held_over.num_params && *NumSteerParams < MaxSteerParams;
+      n++){
 
-#ifdef REG_DEBUG
-  fprintf(stderr, "STEER: Unpack_control_msg: received %d params\n",
-	  *NumSteerParams);
-#endif
+    i = Held_over.param_handles[n];
+    if( (j = Param_index_from_handle(&Params_table, i)) == -1) continue;
 
-  return return_status;
+    SteerParamHandles[*NumSteerParams] = i;
+    SteerParamLabels[*NumSteerParams]  = Params_table.param[j].label;
+    (*NumSteerParams)++;
+  }
+  if(n > 0){
+    Held_over.num_params -= n;
+    memmove(Held_over.param_handles, &(Held_over.param_handles[n]),
+	    Held_over.num_params*sizeof(int));
+  }
 }
 
 /*----------------------------------------------------------------*/
@@ -3834,7 +4820,7 @@ int Detach_from_steerer()
 /*   Param_log.send_all         = REG_TRUE; */
 /* #endif */
 /* #endif */ /* REG_DIRECT_TCP_STEERING */
-  for(i=0; i<REG_MAX_NUM_STR_PARAMS; i++){
+  for(i=0; i<Param_log.num_param_send_all; i++){
     Param_log.param_send_all[i] = REG_TRUE;
   }
   Param_log.emit_in_progress = REG_FALSE;
@@ -3854,230 +4840,206 @@ int Emit_status(int   SeqNum,
 		int   NumCommands,
 		int  *Commands)
 {
-  int   i;
-  int   pcount = 0;
-  int   tot_pcount = 0;
-  int   ccount = 0;
-  int   num_param;
-  int   cmddone   = REG_FALSE;
-  int   paramdone = REG_FALSE;
-  char  buf[REG_MAX_MSG_SIZE];
-  char *pbuf;
-  int   nbytes, bytes_left;
-
-  /* Emit a status report - this is complicated because we must ensure we
-     don't write too many params or commands to a single file (self-imposed
-     limits to make it easier for user to supply arrays to receive results) */
+  int             i, j;
+  int             status;
+  int             num_param = 0;
+  int             full;
+  Msg_writer_type msg;
 
-  /* Count how many monitoring parameters there are */
-
-  for(i=0; i<Params_table.max_entries; i++){
-    /* Want to output ALL params, irrespective of steered/monitored */
-    if(Params_table.param[i].handle != REG_PARAM_HANDLE_NOTSET)pcount++;
-  }
-  num_param = pcount;
-  pcount = 0;
+  /* Emit a status report - every parameter value and command goes
+     into a single message, which grows to whatever size is needed */
 
   /* If we are sending a 'detach' command then don't send any
      parameter values */
-  if(NumCommands > 0){
+  full = REG_TRUE;
+  if(NumCommands > 0 && Commands[0] == REG_STR_DETACH){
 
-    if(Commands[0] == REG_STR_DETACH){
-
-      paramdone = REG_TRUE;
-    }
+    full = REG_FALSE;
   }
   else{
-    cmddone = REG_TRUE;
-  }
-
-  if(num_param == 0) paramdone = REG_TRUE;
-
-  /* Loop until all params and commands have been emitted */
-
-  while(!paramdone || !cmddone){
 
-    pbuf = buf;
-    bytes_left = REG_MAX_MSG_SIZE;
+    /* Send every parameter in this report or only those that have
+       changed since the last one? */
+    if(ReG_StatusFullEvery > 0){
 
-    Write_xml_header(&pbuf, &bytes_left);
-    nbytes = sprintf(pbuf, "<App_status>\n");
-
-    bytes_left -= nbytes;
-    pbuf += nbytes;
-
-    /* Parameter values section */
-
-    if(!paramdone){
-
-      /* Loop over max. no. of params to write to any given file */
-
-      for(i=0; i<REG_MAX_NUM_STR_PARAMS; i++){
+      if(ReG_StatusUntilFull > 0){
+	full = REG_FALSE;
+      }
+      else{
+	ReG_StatusUntilFull = ReG_StatusFullEvery;
+      }
+      ReG_StatusUntilFull--;
+    }
 
-    	/* Handle value used to indicate whether entry is valid */
-    	if(Params_table.param[tot_pcount].handle != REG_PARAM_HANDLE_NOTSET){
+    /* Flag the parameters that are due to be sent */
+    for(i=0; i<Params_table.num_live; i++){
 
- 	  /* Update the 'value' part of this parameter's table entry
-	     - Get_ptr_value checks to make sure parameter is not library-
-	     controlled (& hence has valid ptr to get value from) */
-	  if(Get_ptr_value(&(Params_table.param[tot_pcount]))
-	     != REG_SUCCESS)continue;
+      /* Want to output ALL params, irrespective of steered/monitored */
+      j = Params_table.live[i];
+      Params_table.param[j].status_due = REG_FALSE;
 
-	  if(Params_table.param[tot_pcount].type == REG_BIN){
+      if(Param_changed_since_status(&(Params_table.param[j])) ||
+	 full){
+	Params_table.param[j].status_due = REG_TRUE;
+	num_param++;
+      }
+    }
+  }
 
-	    nbytes = snprintf(pbuf, bytes_left, "<Param>\n<Handle>%d</Handle>\n"
-			      "<Value>", Params_table.param[tot_pcount].handle);
-	    /* Check for truncation */
-	    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
+  /* Nothing to report */
+  if(num_param == 0 && NumCommands < 1) return REG_SUCCESS;
 
-	      fprintf(stderr, "STEER: Emit_status: message exceeds max. "
-		      "msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-	      return REG_FAILURE;
-	    }
-	    pbuf += nbytes; bytes_left -= nbytes;
+  if(Init_msg_writer(&msg, REG_MAX_MSG_SIZE,
+		     Steerer_connection.wire_format) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+  status = Msg_writer_header(&msg);
+  if(status == REG_SUCCESS){
+    status = Msg_writer_begin(&msg, MSG_TAG_APP_STATUS);
+  }
 
-	    /* Copy the Base64-encoded data in the buffer pointed to by ptr_raw
-	       into the 'Value' element of the message */
-	    if(bytes_left > Params_table.param[tot_pcount].raw_buf_size){
-	      memcpy(pbuf, Params_table.param[tot_pcount].ptr_raw,
-		     Params_table.param[tot_pcount].raw_buf_size);
-	      pbuf += Params_table.param[tot_pcount].raw_buf_size;
-	      bytes_left -= Params_table.param[tot_pcount].raw_buf_size;
-	    }
-	    /* Free the memory that was malloc'd during the Base64 encode */
-	    free(Params_table.param[tot_pcount].ptr_raw);
-	    Params_table.param[tot_pcount].ptr_raw = NULL;
+  /* Parameter values section */
 
-	    nbytes = snprintf(pbuf, bytes_left, "</Value>\n</Param>\n");
-	  }
-	  else{
+  for(i=0; i<Params_table.num_live && num_param > 0 &&
+	status == REG_SUCCESS; i++){
 
-	    nbytes = snprintf(pbuf, bytes_left, "<Param>\n"
-			      "<Handle>%d</Handle>\n"
-			      "<Value>%s</Value>\n</Param>\n",
-			      Params_table.param[tot_pcount].handle,
-			      Params_table.param[tot_pcount].value);
-	  }
+    j = Params_table.live[i];
 
-	  /* Check for truncation */
-	  if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
+    /* Only entries that are due to be sent */
+    if(!Params_table.param[j].status_due) continue;
 
-	    fprintf(stderr, "STEER: Emit_status: message exceeds max. "
-		    "msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-	    return REG_FAILURE;
-	  }
-	  pbuf += nbytes;
-	  bytes_left -= nbytes;
+    /* Update the 'value' part of this parameter's table entry
+       - Get_ptr_value checks to make sure parameter is not library-
+       controlled (& hence has valid ptr to get value from) */
+    if(Get_ptr_value(&(Params_table.param[j])) != REG_SUCCESS){
+      Params_table.param[j].status_due = REG_FALSE;
+      continue;
+    }
 
-	  pcount++;
-	}
+    status = Msg_writer_begin(&msg, MSG_TAG_PARAM);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(&msg, MSG_TAG_HANDLE,
+				      Params_table.param[j].handle);
+    }
 
-	/* Cumulative counter to move us through param table */
-	tot_pcount++;
+    if(Params_table.param[j].type == REG_BIN){
 
-	if(pcount >= num_param){
-	  paramdone = REG_TRUE;
-	  break;
-	}
+      /* Copy the Base64-encoded data in the buffer pointed to by ptr_raw
+	 into the 'Value' element of the message */
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_bytes(&msg, MSG_TAG_VALUE,
+				  (char *)Params_table.param[j].ptr_raw,
+				  Params_table.param[j].raw_buf_size);
       }
+      /* Free the memory that was malloc'd during the Base64 encode */
+      free(Params_table.param[j].ptr_raw);
+      Params_table.param[j].ptr_raw = NULL;
+    }
+    else if(status == REG_SUCCESS){
+
+      status = Msg_writer_element_value(&msg, MSG_TAG_VALUE,
+					Params_table.param[j].type,
+					&(Params_table.param[j].value));
     }
 
-    /* Commands section */
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(&msg, MSG_TAG_PARAM);
+    }
+  }
 
-    if(!cmddone){
+  /* Commands section */
 
 #ifdef REG_DEBUG
-      fprintf(stderr, "STEER: Emit_status: NumCommands = %d, ccount = %d\n",
-	      NumCommands, ccount);
+  fprintf(stderr, "STEER: Emit_status: NumCommands = %d\n", NumCommands);
 #endif
 
-      for(i=0; i<REG_MAX_NUM_STR_CMDS; i++){
-
-    	nbytes = snprintf(pbuf, bytes_left, "<Command>\n"
-			  "<Cmd_id>%d</Cmd_id>\n</Command>\n",
-			  Commands[ccount]);
-
-	/* Check for truncation */
-	if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-
-	  fprintf(stderr, "STEER: Emit_status: message exceeds max. "
-		  "msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-	  return REG_FAILURE;
-	}
-	pbuf += nbytes;
-	bytes_left -= nbytes;
+  for(i=0; i<NumCommands && status == REG_SUCCESS; i++){
 
-    	ccount++;
-
-    	if(ccount >= NumCommands){
- 	  cmddone = REG_TRUE;
- 	  break;
-    	}
-      }
+    status = Msg_writer_begin(&msg, MSG_TAG_COMMAND);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(&msg, MSG_TAG_CMD_ID, Commands[i]);
     }
-
-    nbytes = snprintf(pbuf, bytes_left, "</App_status>\n");
-
-    /* Check for truncation */
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-
-      fprintf(stderr, "STEER: Emit_status: message exceeds max. "
-	      "msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
-      return REG_FAILURE;
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(&msg, MSG_TAG_COMMAND);
     }
+  }
 
-    pbuf += nbytes;
-    bytes_left -= nbytes;
+  if(status == REG_SUCCESS){
+    status = Msg_writer_end(&msg, MSG_TAG_APP_STATUS);
+  }
+  if(status == REG_SUCCESS){
+    status = Msg_writer_footer(&msg);
+  }
 
-    if(Write_xml_footer(&pbuf, bytes_left) == REG_SUCCESS){
+  if(status == REG_SUCCESS){
 
-      /* Physically send the status message */
-      Send_status_msg(buf);
+    /* Physically send the status message */
+    if((status = Send_status_msg(msg.buf)) != REG_SUCCESS){
+      fprintf(stderr, "STEER: Emit_status: failed to send status message\n");
     }
-    else{
-      fprintf(stderr, "STEER: Emit_status: failed to write footer\n");
+  }
+  else{
+    fprintf(stderr, "STEER: Emit_status: failed to build status message\n");
+  }
+  Delete_msg_writer(&msg);
+
+  /* Later reports only leave out values the steerer has actually
+     been sent. If this one didn't get there, keep comparing with the
+     last that did and make the next report a full one. */
+  if(status == REG_SUCCESS){
+    for(i=0; i<Params_table.num_live && num_param > 0; i++){
+      j = Params_table.live[i];
+      if(!Params_table.param[j].status_due) continue;
+      Params_table.param[j].status_bits =
+	Params_table.param[j].status_due_bits;
+      Params_table.param[j].status_sent = REG_TRUE;
     }
-  }  /* end of while(!paramdone || !cmddone){ */
+  }
+  else{
+    ReG_StatusUntilFull = 0;
+  }
 
-  return REG_SUCCESS;
+  return status;
 }
 
 /*----------------------------------------------------------------*/
 
 int Update_ptr_value(param_entry *param)
 {
+  const char *str;
+
   if (!param->ptr) return REG_SUCCESS;
 
   switch(param->type){
 
   case REG_INT:
-    sscanf(param->value, "%d", (int *)(param->ptr));
+    *((int *)(param->ptr)) = param->value.i;
     break;
 
   case REG_LONG:
-    sscanf(param->value, "%ld", (long *)(param->ptr));
+    *((long *)(param->ptr)) = param->value.l;
     break;
 
   case REG_FLOAT:
-    sscanf(param->value, "%f", (float *)(param->ptr));
+    *((float *)(param->ptr)) = param->value.f;
     break;
 
   case REG_DBL:
-    sscanf(param->value, "%lg", (double *)(param->ptr));
+    *((double *)(param->ptr)) = param->value.d;
     break;
 
   case REG_CHAR:
+    str = param->value.s ? param->value.s : "";
     if(ReG_CalledFromF90 == REG_TRUE){
       /* Avoid terminating with '\0' if calling code
 	 is F90 */
-      strncpy((char *)(param->ptr), param->value,
-	      strlen(param->value));
+      strncpy((char *)(param->ptr), str, strlen(str));
       /* Blank the remainder of the string */
-      memset((char *)(param->ptr) + strlen(param->value), ' ',
-	     atoi(param->max_val)-strlen(param->value));
+      memset((char *)(param->ptr) + strlen(str), ' ',
+	     param->max_val.i-strlen(str));
     }
     else{
-      strcpy((char *)(param->ptr), param->value);
+      strcpy((char *)(param->ptr), str);
     }
     break;
 
@@ -4099,8 +5061,8 @@ int Get_ptr_value(param_entry *param)
   int return_status;
 
   /* Retrieve the value of the variable pointed to by this parameter's
-     registered pointer and store it in the 'value' character string
-     of the table entry */
+     registered pointer and store it in the 'value' of the table
+     entry */
 
   return_status = REG_SUCCESS;
 
@@ -4113,19 +5075,19 @@ int Get_ptr_value(param_entry *param)
   switch(param->type){
 
   case REG_INT:
-    sprintf(param->value,"%d", *((int *)(param->ptr)));
+    param->value.i = *((int *)(param->ptr));
     break;
 
   case REG_LONG:
-    sprintf(param->value,"%ld", *((long *)(param->ptr)));
+    param->value.l = *((long *)(param->ptr));
     break;
 
   case REG_FLOAT:
-    sprintf(param->value,"%.20g", *((float *)(param->ptr)));
+    param->value.f = *((float *)(param->ptr));
     break;
 
   case REG_DBL:
-    sprintf(param->value,"%.20g", *((double *)(param->ptr)));
+    param->value.d = *((double *)(param->ptr));
     break;
 
   case REG_CHAR:
@@ -4133,18 +5095,20 @@ int Get_ptr_value(param_entry *param)
       /* We've got a ptr to a F90 string here and they aren't
 	 terminated with a '\0'.  We know how long it is though
 	 because we save that information when it was registered. */
-      strncpy(param->value, (char *)(param->ptr), atoi(param->max_val));
-      param->value[atoi(param->max_val)-1] = '\0';
+      return_status = Param_value_set_string(&(param->value),
+					     (char *)(param->ptr),
+					     param->max_val.i - 1);
     }
     else{
-      strcpy(param->value, (char *)(param->ptr));
+      return_status = Param_value_set_string(&(param->value),
+					     (char *)(param->ptr), -1);
     }
     break;
 
   case REG_BIN:
 
     return_status = Base64_encode(param->ptr,
-				  atoi(param->max_val),
+				  param->max_val.i,
 				  (char **)&(param->ptr_raw),
 				  &(param->raw_buf_size));
 
@@ -4165,6 +5129,63 @@ int Get_ptr_value(param_entry *param)
 
 /*----------------------------------------------------------------*/
 
+int Param_changed_since_status(param_entry *param)
+{
+  unsigned long long   bits = 0;
+  const unsigned char *p;
+  size_t               i, n;
+
+  /* The library's own parameters have no pointer to compare and are
+     always sent */
+  if(param->handle < REG_MIN_PARAM_HANDLE || !param->ptr) return REG_TRUE;
+
+  switch(param->type){
+
+  case REG_INT:
+    memcpy(&bits, param->ptr, sizeof(int));
+    break;
+
+  case REG_LONG:
+    memcpy(&bits, param->ptr, sizeof(long));
+    break;
+
+  case REG_FLOAT:
+    memcpy(&bits, param->ptr, sizeof(float));
+    break;
+
+  case REG_DBL:
+    memcpy(&bits, param->ptr, sizeof(double));
+    break;
+
+  case REG_CHAR:
+  case REG_BIN:
+    /* Too long to keep a copy of, so compare an FNV-1a hash instead */
+    p = (const unsigned char *)(param->ptr);
+    if(param->type == REG_BIN ||
+       (ReG_CalledFromF90 == REG_TRUE && param->max_val_valid)){
+      n = (size_t)param->max_val.i;
+    }
+    else{
+      n = strlen((const char *)p);
+    }
+    bits = 14695981039346656037ULL;
+    for(i = 0; i < n; i++){
+      bits = (bits ^ p[i])*1099511628211ULL;
+    }
+    break;
+
+  default:
+    return REG_TRUE;
+  }
+
+  if(param->status_sent && bits == param->status_bits) return REG_FALSE;
+
+  param->status_due_bits = bits;
+  return REG_TRUE;
+}
+
+/*----------------------------------------------------------------*/
+
 void Steering_signal_handler(int aSignal)
 {
   Common_signal_handler(aSignal);
@@ -4596,72 +5617,74 @@ int Finalize_steering_connection()
 }
 /*---------------------------------------------------*/
 
-int Make_supp_cmds_msg(int   NumSupportedCmds,
-		       int  *SupportedCmds,
-                       char *msg,
-		       int   max_msg_size)
+int Make_supp_cmds_msg(int              NumSupportedCmds,
+		       int             *SupportedCmds,
+		       Msg_writer_type *msg,
+		       const char      *WireFormats)
 {
-  char *pchar;
-  int   i;
-  int   nbytes, bytes_left;
-  int   pause_supported = REG_FALSE;
+  /* All applications support detach and the ability to emit the
+     parameter history log by default.  If the app supports pause
+     then it also supports resume by default. */
+  int default_cmds[3] = {REG_STR_EMIT_PARAM_LOG, REG_STR_DETACH,
+			 REG_STR_RESUME};
+  int num_default_cmds = 2;
+  int i;
+  int status;
 
-  bytes_left = max_msg_size;
-  pchar = msg;
+  /* Always xml - the steerer has yet to tell us what it can read */
+  if(Init_msg_writer(msg, 0, REG_WIRE_XML) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
 
-  Write_xml_header(&pchar, &bytes_left);
+  status = Msg_writer_header(msg);
+  if(status == REG_SUCCESS){
+    status = Msg_writer_begin(msg, MSG_TAG_SUPP_CMDS);
+  }
 
-  nbytes = sprintf(pchar, "<Supported_commands>\n");
-  pchar += nbytes;
-  bytes_left -= nbytes;
+  for(i=0; i<NumSupportedCmds && status == REG_SUCCESS; i++){
 
-  for(i=0; i<NumSupportedCmds; i++){
-    nbytes = snprintf(pchar,  bytes_left, "<Command>\n"
-		      "<Cmd_id>%d</Cmd_id>\n"
-		      "</Command>\n", SupportedCmds[i]);
-    /* Check for truncation */
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-      fprintf(stderr, "STEER: Make_supp_cmds_msg: supplied buffer of "
-	      "%d bytes is too small!\n", max_msg_size);
-      return REG_FAILURE;
+    status = Msg_writer_begin(msg, MSG_TAG_COMMAND);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(msg, MSG_TAG_CMD_ID, SupportedCmds[i]);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(msg, MSG_TAG_COMMAND);
     }
-    bytes_left -= nbytes;
-    pchar += nbytes;
 
-    if(SupportedCmds[i] == REG_STR_PAUSE){
-      pause_supported = REG_TRUE;
+    if(SupportedCmds[i] == REG_STR_PAUSE) num_default_cmds = 3;
+  }
+
+  for(i=0; i<num_default_cmds && status == REG_SUCCESS; i++){
+
+    status = Msg_writer_begin(msg, MSG_TAG_COMMAND);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(msg, MSG_TAG_CMD_ID, default_cmds[i]);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(msg, MSG_TAG_COMMAND);
     }
   }
 
-  /* All applications support detach and the ability to emit the
-     parameter history log by default.  If the app supports pause
-     then it also supports resume by default. */
+  /* Tell the steerer which other wire formats we can receive - it
+     then chooses whether to use one of them */
+  if(status == REG_SUCCESS && WireFormats){
+    status = Msg_writer_element_string(msg, MSG_TAG_WIRE_FORMAT,
+				       WireFormats);
+  }
 
-  if(pause_supported == REG_TRUE){
-    nbytes = snprintf(pchar,  bytes_left,
-		      "<Command><Cmd_id>%d</Cmd_id></Command>\n"
-		      "<Command><Cmd_id>%d</Cmd_id></Command>\n"
-		      "<Command><Cmd_id>%d</Cmd_id></Command>\n"
-		      "</Supported_commands>\n",
-		      REG_STR_EMIT_PARAM_LOG, REG_STR_DETACH,
-		      REG_STR_RESUME);
+  if(status == REG_SUCCESS){
+    status = Msg_writer_end(msg, MSG_TAG_SUPP_CMDS);
   }
-  else{
-    nbytes = snprintf(pchar,  bytes_left,
-		      "<Command><Cmd_id>%d</Cmd_id></Command>\n"
-		      "<Command><Cmd_id>%d</Cmd_id></Command>\n"
-		      "</Supported_commands>\n",
-		      REG_STR_EMIT_PARAM_LOG, REG_STR_DETACH);
-  }
-  if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-    fprintf(stderr, "STEER: Make_supp_cmds_msg: supplied buffer of "
-	      "%d bytes is too small!\n", max_msg_size);
-    return REG_FAILURE;
+  if(status == REG_SUCCESS){
+    status = Msg_writer_footer(msg);
+  }
+
+  if(status != REG_SUCCESS){
+    fprintf(stderr, "STEER: Make_supp_cmds_msg: failed to build "
+	    "message\n");
   }
-  bytes_left -= nbytes;
-  pchar += nbytes;
 
-  return Write_xml_footer(&pchar, bytes_left);
+  return status;
 }
 
 /*---------------------------------------------------*/
@@ -4815,9 +5838,11 @@ int Emit_iotype_msg_header(int IOTypeIndex,
 			   int NumBytes,
 			   int IsFortranArray)
 {
-  char  buffer[7*REG_PACKET_SIZE];
-  char  tmp_buffer[REG_PACKET_SIZE];
-  char *pchar;
+  char      buffer[8*REG_PACKET_SIZE];
+  char      tmp_buffer[REG_PACKET_SIZE];
+  char     *pchar;
+  Roi_type *roi;
+  Lod_type *lod;
 
   pchar = buffer;
   pchar += sprintf(pchar, REG_PACKET_FORMAT, "<ReG_data_slice_header>");
@@ -4840,6 +5865,22 @@ int Emit_iotype_msg_header(int IOTypeIndex,
   }
   pchar += sprintf(pchar, REG_PACKET_FORMAT, tmp_buffer);
   *(pchar-1) = '\0';
+  /* Say which part of the array this is if it isn't all of it */
+  roi = &(IOTypes_table.io_def[IOTypeIndex].slice_roi);
+  if(roi->is_set){
+    sprintf(tmp_buffer, REG_SLICE_ROI_FORMAT, roi->sx, roi->sy, roi->sz,
+	    roi->nx, roi->ny, roi->nz, roi->dx, roi->dy, roi->dz);
+    pchar += sprintf(pchar, REG_PACKET_FORMAT, tmp_buffer);
+    *(pchar-1) = '\0';
+  }
+  /* ...and which level of detail */
+  lod = &(IOTypes_table.io_def[IOTypeIndex].slice_lod);
+  if(lod->num_levels > 0){
+    sprintf(tmp_buffer, REG_SLICE_LOD_FORMAT, lod->level, lod->num_levels,
+	    lod->nx, lod->ny, lod->nz);
+    pchar += sprintf(pchar, REG_PACKET_FORMAT, tmp_buffer);
+    *(pchar-1) = '\0';
+  }
   pchar += sprintf(pchar, REG_PACKET_FORMAT, "</ReG_data_slice_header>");
   *(pchar-1) = '\0';
 
@@ -4849,6 +5890,230 @@ int Emit_iotype_msg_header(int IOTypeIndex,
 
 /*----------------------------------------------------------------*/
 
+int Extract_data_slice_roi(int          IOTypeIndex,
+			   int          DataType,
+			   int         *Count,
+			   const void **pData)
+{
+  IOdef_entry *io = &(IOTypes_table.io_def[IOTypeIndex]);
+  Roi_type     roi;
+  size_t       size;
+  size_t       num_bytes;
+  void        *ptr;
+  int          count;
+
+  io->slice_roi.is_set = REG_FALSE;
+
+  /* Only whole arrays of known shape can be cut down */
+  if(!io->roi.is_set || io->array.totx < 1 || io->array.toty < 1 ||
+     io->array.totz < 1 ||
+     *Count != io->array.totx*io->array.toty*io->array.totz) {
+    return REG_SUCCESS;
+  }
+
+  switch(DataType){
+  case REG_INT:
+    size = sizeof(int);
+    break;
+  case REG_LONG:
+    size = sizeof(long);
+    break;
+  case REG_FLOAT:
+    size = sizeof(float);
+    break;
+  case REG_DBL:
+    size = sizeof(double);
+    break;
+  case REG_CHAR:
+    size = sizeof(char);
+    break;
+  default:
+    return REG_SUCCESS;
+  }
+
+  roi = io->roi;
+  if((count = Clip_array_roi(&(io->array), &roi)) == 0) {
+    /* Nothing of the array is wanted - send it all rather than none
+       so that the consumer can tell something is wrong */
+    return REG_SUCCESS;
+  }
+
+  num_bytes = count*size;
+  if(num_bytes > io->roi_buffer_bytes) {
+    if(!(ptr = Pool_realloc(io->roi_buffer, num_bytes))) {
+      fprintf(stderr, "STEER: ERROR: Emit_data_slice: failed to allocate "
+	      "%d bytes for region of interest\n", (int)num_bytes);
+      return REG_FAILURE;
+    }
+    io->roi_buffer = ptr;
+    io->roi_buffer_bytes = Pool_block_size(ptr);
+  }
+
+  Gather_array_roi(&(io->array), &roi, size, *pData, io->roi_buffer);
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: Emit_data_slice: sending %d of %d elements "
+	  "from (%d,%d,%d)\n", count, *Count, roi.sx, roi.sy, roi.sz);
+#endif
+
+  io->slice_roi = roi;
+  io->slice_roi.is_set = REG_TRUE;
+  *Count = count;
+  *pData = io->roi_buffer;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Emit_data_slice_lod(int         IOTypeIndex,
+			int         DataType,
+			int         Count,
+			const void *pData,
+			int        *Done)
+{
+  IOdef_entry *io = &(IOTypes_table.io_def[IOTypeIndex]);
+  size_t       size;
+  size_t       offset[REG_MAX_LOD_LEVELS];
+  size_t       total;
+  int          n[REG_MAX_LOD_LEVELS][3];
+  int          num_levels;
+  int          num_to_send;
+  int          level;
+  int          i;
+  const void  *pIn;
+  void        *ptr;
+
+  io->slice_lod.num_levels = 0;
+  *Done = REG_FALSE;
+
+  if(io->lod_levels < 2 ||
+     (DataType != REG_FLOAT && DataType != REG_DBL)) return REG_SUCCESS;
+
+  /* Shape of what we're sending - the whole array or the part of it
+     the consumer asked for */
+  if(io->slice_roi.is_set) {
+    n[0][0] = (io->slice_roi.nx + io->slice_roi.dx - 1)/io->slice_roi.dx;
+    n[0][1] = (io->slice_roi.ny + io->slice_roi.dy - 1)/io->slice_roi.dy;
+    n[0][2] = (io->slice_roi.nz + io->slice_roi.dz - 1)/io->slice_roi.dz;
+  }
+  else {
+    n[0][0] = io->array.totx;
+    n[0][1] = io->array.toty;
+    n[0][2] = io->array.totz;
+  }
+  if(n[0][0] < 1 || n[0][1] < 1 || n[0][2] < 1 ||
+     Count != n[0][0]*n[0][1]*n[0][2]) return REG_SUCCESS;
+
+  num_levels = io->lod_levels;
+  if(num_levels > REG_MAX_LOD_LEVELS) num_levels = REG_MAX_LOD_LEVELS;
+
+  /* Work out the shape of each coarser level (n[i] here is i levels
+     below full resolution) and stop once there is a single element */
+  size = (DataType == REG_FLOAT) ? sizeof(float) : sizeof(double);
+  total = 0;
+  for(i = 1; i < num_levels; i++) {
+    if(n[i-1][0] == 1 && n[i-1][1] == 1 && n[i-1][2] == 1) break;
+    n[i][0] = (n[i-1][0] + 1)/2;
+    n[i][1] = (n[i-1][1] + 1)/2;
+    n[i][2] = (n[i-1][2] + 1)/2;
+    offset[i] = total;
+    total += (size_t)n[i][0]*n[i][1]*n[i][2]*size;
+  }
+  num_levels = i;
+  if(num_levels < 2) return REG_SUCCESS;
+
+  /* The consumer may not want the finer levels */
+  num_to_send = num_levels;
+  if(io->lod_limit > 0 && io->lod_limit < num_levels) {
+    num_to_send = io->lod_limit;
+  }
+
+  if(total > io->lod_buffer_bytes) {
+    if(!(ptr = Pool_realloc(io->lod_buffer, total))) {
+      fprintf(stderr, "STEER: ERROR: Emit_data_slice: failed to allocate "
+	      "%d bytes for levels of detail\n", (int)total);
+      return REG_FAILURE;
+    }
+    io->lod_buffer = ptr;
+    io->lod_buffer_bytes = Pool_block_size(ptr);
+  }
+
+  /* Each level is made from the one above it so the full array is
+     only read once */
+  pIn = pData;
+  for(i = 1; i < num_levels; i++) {
+    ptr = (char *)io->lod_buffer + offset[i];
+    if(Coarsen_array(n[i-1], DataType, pIn, ptr) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+    pIn = ptr;
+  }
+
+  /* Coarsest first */
+  io->slice_lod.num_levels = num_levels;
+  for(level = 0; level < num_levels - 1 && level < num_to_send; level++) {
+    i = num_levels - 1 - level;
+    io->slice_lod.level = level;
+    io->slice_lod.nx = n[i][0];
+    io->slice_lod.ny = n[i][1];
+    io->slice_lod.nz = n[i][2];
+
+    if(Send_data_slice(IOTypeIndex, DataType, n[i][0]*n[i][1]*n[i][2],
+		       (char *)io->lod_buffer + offset[i]) != REG_SUCCESS) {
+      io->slice_lod.num_levels = 0;
+      return REG_FAILURE;
+    }
+  }
+
+  /* Leave things set up for the full resolution slice */
+  io->slice_lod.level = num_levels - 1;
+  io->slice_lod.nx = n[0][0];
+  io->slice_lod.ny = n[0][1];
+  io->slice_lod.nz = n[0][2];
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: Emit_data_slice: sent %d of %d levels of "
+	  "detail\n", level, num_levels);
+#endif
+  *Done = (num_to_send < num_levels) ? REG_TRUE : REG_FALSE;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int IOType_owns_buffer(int         IOTypeIndex,
+		       const void *pData)
+{
+  IOdef_entry *io = &(IOTypes_table.io_def[IOTypeIndex]);
+  const char  *p = (const char *)pData;
+
+  if(pData == io->buffer || pData == io->roi_buffer) return REG_TRUE;
+
+  if(io->lod_buffer && p >= (const char *)io->lod_buffer &&
+     p < (const char *)io->lod_buffer + io->lod_buffer_bytes) {
+    return REG_TRUE;
+  }
+
+  return REG_FALSE;
+}
+
+/*----------------------------------------------------------------*/
+
+void Release_iotype_buffer(int index)
+{
+  IOdef_entry *io = &(IOTypes_table.io_def[index]);
+
+  if(io->buffer != io->user_buffer) Pool_free(io->buffer);
+
+  io->buffer = io->user_buffer;
+  io->buffer_bytes = 0;
+  io->buffer_max_bytes = (int)io->user_buffer_bytes;
+}
+
+/*----------------------------------------------------------------*/
+
 int Realloc_iotype_buffer(int index,
 			  int num_bytes) {
   return Realloc_IOdef_entry_buffer(&(IOTypes_table.io_def[index]),
@@ -4883,35 +6148,32 @@ int Realloc_IOdef_entry_buffer(IOdef_entry *iodef,
   }
 #endif
 
-  if(iodef->buffer){
-
-    if(!(dum_ptr = realloc(iodef->buffer,
-			 (size_t)num_bytes))){
-
-      free(iodef->buffer);
-      iodef->buffer = NULL;
-      iodef->buffer_bytes = 0;
-      iodef->buffer_max_bytes = 0;
-
-      fprintf(stderr, "STEER: Realloc_IOdef_entry_buffer: realloc "
-	      "failed for %d bytes\n", num_bytes);
-      return REG_FAILURE;
-    }
-
-    iodef->buffer = dum_ptr;
+  /* Buffers come from the pool so that they're reused from one data
+     set (and IOType) to the next. The application's own buffer isn't
+     ours to resize, so one from the pool stands in for it until
+     Release_iotype_buffer(). */
+  if(iodef->buffer && iodef->buffer == iodef->user_buffer){
+    dum_ptr = Pool_alloc((size_t)num_bytes);
   }
   else{
-    if(!(iodef->buffer = malloc(num_bytes))){
+    dum_ptr = Pool_realloc(iodef->buffer, (size_t)num_bytes);
+  }
 
-      iodef->buffer_max_bytes = 0;
+  if(!dum_ptr){
 
-      fprintf(stderr, "STEER: Realloc_IOdef_entry_buffer: malloc "
-	      "failed for %d bytes\n", num_bytes);
-      return REG_FAILURE;
-    }
+    /* Fall back to the application's buffer (if any) */
+    if(iodef->buffer != iodef->user_buffer) Pool_free(iodef->buffer);
+    iodef->buffer = iodef->user_buffer;
+    iodef->buffer_bytes = 0;
+    iodef->buffer_max_bytes = (int)iodef->user_buffer_bytes;
+
+    fprintf(stderr, "STEER: Realloc_IOdef_entry_buffer: allocation "
+	    "failed for %d bytes\n", num_bytes);
+    return REG_FAILURE;
   }
 
-  iodef->buffer_max_bytes = num_bytes;
+  iodef->buffer = dum_ptr;
+  iodef->buffer_max_bytes = (int)Pool_block_size(dum_ptr);
 
   return REG_SUCCESS;
 }
@@ -5184,8 +6446,8 @@ int Control_msg_now_valid(struct msg_struct *msg){
   /* Msg must be valid if it has no valid_after field */
   if( !(msg->control->valid_after) )return 1;
 
-  if(sscanf((char *)(msg->control->valid_after), "%lg",
-	    &(valid_time)) != 1){
+  if(Parse_double((char *)(msg->control->valid_after),
+		  &(valid_time)) != REG_SUCCESS){
     return 1;
   }
 
@@ -0,0 +1,270 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+/** @internal
+    @file ReG_Steer_Buffer_Pool.c
+    @brief Source file for the pool of buffers shared by all IOTypes.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_Config.h"
+#include "ReG_Steer_types.h"
+#include "ReG_Steer_Buffer_Pool.h"
+
+#if REG_HAS_MADV_HUGEPAGE
+#include <sys/mman.h>
+#endif
+
+/** Blocks at least this big start on a huge page boundary and fill
+    whole huge pages, so they may be backed by huge pages */
+#define REG_POOL_HUGE_BLOCK (2UL << 20)
+
+/** No. of size classes, REG_POOL_MIN_BLOCK to REG_POOL_MAX_BLOCK */
+#define REG_POOL_NUM_CLASSES 25
+
+/** Marks the header of a block from the pool */
+#define REG_POOL_MAGIC 0x52654750
+
+/** @internal Header kept in front of each block */
+typedef struct pool_block {
+  /** Next block on the same free list */
+  struct pool_block* next;
+  /** No. of bytes that may be used in the block */
+  size_t             size;
+  /** Size class of the block, -1 if it is too big to pool */
+  int                size_class;
+  /** REG_POOL_MAGIC */
+  unsigned int       magic;
+  /** Start of the allocation holding the block, to be freed */
+  void*              base;
+} pool_block_type;
+
+/** The header takes up one alignment unit so the block stays aligned */
+#define REG_POOL_HEADER REG_BUFFER_ALIGNMENT
+
+/** @internal State of the pool */
+static struct {
+  /** Whether the limit on cached bytes has been read */
+  int             initialized;
+  /** Free blocks in each size class */
+  pool_block_type* free_list[REG_POOL_NUM_CLASSES];
+  /** Bytes in blocks handed out */
+  size_t          in_use;
+  /** Most that @p in_use has been */
+  size_t          peak;
+  /** Bytes in blocks on the free lists */
+  size_t          cached;
+  /** Limit on @p cached */
+  size_t          max_cached;
+  /** No. of blocks obtained from the system */
+  unsigned long   num_allocs;
+} pool;
+
+/*---------------------------------------------------*/
+
+static void pool_init() {
+  char* pchar;
+
+  pool.max_cached = REG_POOL_MAX_CACHED;
+  if((pchar = getenv("REG_POOL_MAX_CACHED"))) {
+    pool.max_cached = (size_t) strtoul(pchar, NULL, 10);
+  }
+  pool.initialized = REG_TRUE;
+}
+
+/*---------------------------------------------------*/
+
+static pool_block_type* pool_header(const void* ptr) {
+  return (pool_block_type*) ((char*) ptr - REG_POOL_HEADER);
+}
+
+/*---------------------------------------------------*/
+
+void* Pool_alloc(const size_t nbytes) {
+  pool_block_type* block = NULL;
+  void*            base;
+  char*            data;
+  size_t           size;
+  size_t           alignment = REG_BUFFER_ALIGNMENT;
+  size_t           padding = REG_POOL_HEADER;
+  int              size_class;
+
+  if(!pool.initialized) pool_init();
+
+  if(nbytes > REG_POOL_MAX_BLOCK) {
+    size_class = -1;
+    size = (nbytes + REG_POOL_HUGE_BLOCK - 1) &
+      ~((size_t) REG_POOL_HUGE_BLOCK - 1);
+  }
+  else {
+    size_class = 0;
+    size = REG_POOL_MIN_BLOCK;
+    while(size < nbytes) {
+      size <<= 1;
+      size_class++;
+    }
+
+    /* Reuse a block of the same class if there is one */
+    if((block = pool.free_list[size_class])) {
+      pool.free_list[size_class] = block->next;
+      pool.cached -= size;
+    }
+  }
+
+  if(!block) {
+    /* Huge blocks are whole huge pages, so a page of padding holds
+       the header and keeps it out of them */
+    if(size >= REG_POOL_HUGE_BLOCK) {
+      alignment = REG_POOL_HUGE_BLOCK;
+      padding = REG_POOL_HUGE_BLOCK;
+    }
+
+    if(posix_memalign(&base, alignment, padding + size)) {
+      fprintf(stderr, "STEER: Pool_alloc: failed to allocate %lu bytes\n",
+	      (unsigned long) size);
+      return NULL;
+    }
+    pool.num_allocs++;
+    data = (char*) base + padding;
+
+#if REG_HAS_MADV_HUGEPAGE
+    if(size >= REG_POOL_HUGE_BLOCK) {
+      madvise(data, size, MADV_HUGEPAGE);
+    }
+#endif
+
+    block = pool_header(data);
+    block->base = base;
+    block->size = size;
+    block->size_class = size_class;
+    block->magic = REG_POOL_MAGIC;
+  }
+
+  block->next = NULL;
+  pool.in_use += size;
+  if(pool.in_use > pool.peak) pool.peak = pool.in_use;
+
+  return (char*) block + REG_POOL_HEADER;
+}
+
+/*---------------------------------------------------*/
+
+void* Pool_realloc(void* ptr, const size_t nbytes) {
+  void* new_ptr;
+
+  if(!ptr) return Pool_alloc(nbytes);
+
+  if(Pool_block_size(ptr) >= nbytes) return ptr;
+
+  if(!(new_ptr = Pool_alloc(nbytes))) return NULL;
+  memcpy(new_ptr, ptr, Pool_block_size(ptr));
+  Pool_free(ptr);
+
+  return new_ptr;
+}
+
+/*---------------------------------------------------*/
+
+void Pool_free(void* ptr) {
+  pool_block_type* block;
+
+  if(!ptr) return;
+
+  block = pool_header(ptr);
+  if(block->magic != REG_POOL_MAGIC) {
+    fprintf(stderr, "STEER: Pool_free: %p did not come from the buffer "
+	    "pool\n", ptr);
+    return;
+  }
+
+  pool.in_use -= block->size;
+
+  if(block->size_class < 0 ||
+     pool.cached + block->size > pool.max_cached) {
+    block->magic = 0;
+    free(block->base);
+    return;
+  }
+
+  block->next = pool.free_list[block->size_class];
+  pool.free_list[block->size_class] = block;
+  pool.cached += block->size;
+}
+
+/*---------------------------------------------------*/
+
+size_t Pool_block_size(const void* ptr) {
+  return ptr ? pool_header(ptr)->size : 0;
+}
+
+/*---------------------------------------------------*/
+
+void Pool_usage(size_t*        in_use,
+		size_t*        cached,
+		size_t*        peak,
+		unsigned long* num_allocs) {
+  *in_use = pool.in_use;
+  *cached = pool.cached;
+  *peak = pool.peak;
+  *num_allocs = pool.num_allocs;
+}
+
+/*---------------------------------------------------*/
+
+void Pool_trim() {
+  pool_block_type* block;
+  int              i;
+
+  for(i = 0; i < REG_POOL_NUM_CLASSES; i++) {
+    while((block = pool.free_list[i])) {
+      pool.free_list[i] = block->next;
+      block->magic = 0;
+      free(block->base);
+    }
+  }
+  pool.cached = 0;
+}
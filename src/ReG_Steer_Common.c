@@ -61,10 +61,20 @@
 #include "ReG_Steer_Config.h"
 #include "ReG_Steer_types.h"
 #include "ReG_Steer_Common.h"
+#include "ReG_Steer_Number.h"
+#include "ReG_Steer_Buffer_Pool.h"
 
 /** Basic library config. Declared here as used by all. */
 Steer_lib_config_type Steer_lib_config;
 
+/** Buffers of messages that have been sent, ready to be reused by
+    Init_msg_writer() */
+static char *Free_msg_bufs[REG_MAX_FREE_MSG_BUFS];
+/** Sizes of the buffers in Free_msg_bufs */
+static int   Free_msg_buf_sizes[REG_MAX_FREE_MSG_BUFS];
+/** No. of buffers in Free_msg_bufs */
+static int   Num_free_msg_bufs = 0;
+
 /*----------------------------------------------------------*/
 
 int Get_message_type(const char *name)
@@ -139,9 +149,11 @@ int Next_free_param_index(Param_table_type *table)
   void *dum_ptr;
 
   /* Look for first free entry in table - i.e. one that has an
-     unset handle.  If none found then extends the size of the table. */
+     unset handle.  If none found then extends the size of the table.
+     Entries are only ever freed all at once, so in an indexed table
+     there's no point looking at the first num_live of them. */
 
-  for(i=0; i<table->max_entries; i++){
+  for(i=table->num_live; i<table->max_entries; i++){
 
     if(table->param[i].handle == REG_PARAM_HANDLE_NOTSET){
 
@@ -184,21 +196,361 @@ void Init_param_entry(param_entry *param)
     param->log_size = 0;
     param->ptr_raw  = NULL;
     param->raw_buf_size = 0;
+    param->status_sent = REG_FALSE;
+    param->status_due = REG_FALSE;
+    memset(&(param->value), 0, sizeof(Param_value_type));
+    memset(&(param->min_val), 0, sizeof(Param_value_type));
+    memset(&(param->max_val), 0, sizeof(Param_value_type));
+    param->value_set = REG_FALSE;
     return;
 }
 
 /*--------------------------------------------------------------------*/
 
+int Param_value_set_string(Param_value_type *value, const char *str,
+			   int len)
+{
+  if(!value->s){
+    if( !(value->s = (char *)malloc(REG_MAX_STRING_LENGTH)) ){
+      fprintf(stderr, "STEER: Param_value_set_string: malloc failed\n");
+      return REG_FAILURE;
+    }
+  }
+
+  if(len < 0) len = (int)strlen(str);
+  if(len > REG_MAX_STRING_LENGTH - 1) len = REG_MAX_STRING_LENGTH - 1;
+
+  memcpy(value->s, str, (size_t)len);
+  value->s[len] = '\0';
+
+  return REG_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+
+int Param_value_from_string(int type, const char *str,
+			    Param_value_type *value)
+{
+  char *end;
+
+  switch(type){
+
+  case REG_INT:
+    value->i = (int)strtol(str, &end, 10);
+    return (end == str) ? REG_FAILURE : REG_SUCCESS;
+
+  case REG_LONG:
+    value->l = strtol(str, &end, 10);
+    return (end == str) ? REG_FAILURE : REG_SUCCESS;
+
+  case REG_FLOAT:
+    return Parse_float(str, &(value->f));
+
+  case REG_DBL:
+    return Parse_double(str, &(value->d));
+
+  case REG_CHAR:
+    return Param_value_set_string(value, str, -1);
+
+  case REG_BIN:
+    return REG_SUCCESS;
+
+  default:
+    return REG_FAILURE;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *Param_value_to_string(int type, const Param_value_type *value,
+				  char *buf)
+{
+  switch(type){
+
+  case REG_INT:
+    sprintf(buf, "%d", value->i);
+    break;
+
+  case REG_LONG:
+    sprintf(buf, "%ld", value->l);
+    break;
+
+  case REG_FLOAT:
+    Format_float(value->f, buf);
+    break;
+
+  case REG_DBL:
+    Format_double(value->d, buf);
+    break;
+
+  case REG_CHAR:
+    return value->s ? value->s : "";
+
+  default:
+    /* REG_BIN values go in messages Base64-encoded, not from here */
+    buf[0] = '\0';
+    break;
+  }
+
+  return buf;
+}
+
+/*--------------------------------------------------------------------*/
+
+double Param_value_to_double(int type, const Param_value_type *value)
+{
+  double d = 0.0;
+
+  switch(type){
+
+  case REG_INT:
+    return (double)value->i;
+
+  case REG_LONG:
+    return (double)value->l;
+
+  case REG_FLOAT:
+    return (double)value->f;
+
+  case REG_DBL:
+    return value->d;
+
+  case REG_CHAR:
+    if(value->s) Parse_double(value->s, &d);
+    return d;
+
+  default:
+    return 0.0;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+int Param_limit_type(int type)
+{
+  return (type == REG_CHAR || type == REG_BIN) ? REG_INT : type;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Free_param_value(int type, Param_value_type *value)
+{
+  if(type == REG_CHAR && value->s){
+    free(value->s);
+    value->s = NULL;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+void Free_param_entry_values(param_entry *param)
+{
+  /* Limits of strings are lengths, so only the value can hold one */
+  Free_param_value(param->type, &(param->value));
+  param->value_set = REG_FALSE;
+}
+
+/*--------------------------------------------------------------------*/
+
+int Set_log_param_value(Param_log_entry_type *entry, int handle, int type,
+			const Param_value_type *value)
+{
+  entry->handle = handle;
+
+  if(type != REG_CHAR){
+    Free_param_value(entry->type, &(entry->value));
+    entry->type = type;
+    entry->value = *value;
+    return REG_SUCCESS;
+  }
+
+  /* Keep any string buffer the entry already has */
+  if(entry->type != REG_CHAR){
+    entry->type = REG_CHAR;
+    entry->value.s = NULL;
+  }
+  return Param_value_set_string(&(entry->value),
+				value->s ? value->s : "", -1);
+}
+
+/*--------------------------------------------------------------------*/
+
+void Free_log_param_values(Param_log_entry_type *params, int num_params)
+{
+  int i;
+
+  for(i=0; i<num_params; i++){
+    Free_param_value(params[i].type, &(params[i].value));
+    params[i].type = REG_INT;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+unsigned int Hash_param_handle(int handle)
+{
+  unsigned int h = (unsigned int)handle;
+
+  /* Handles are mostly consecutive - mix the bits so that they
+     don't cluster */
+  h ^= h >> 16;
+  h *= 0x45d9f3bU;
+  h ^= h >> 16;
+  return h;
+}
+
+/*--------------------------------------------------------------------*/
+
+unsigned int Hash_param_label(const char *label)
+{
+  unsigned int h = 2166136261U;
+
+  while(*label){
+    h = (h ^ (unsigned char)(*label++))*16777619U;
+  }
+  return h;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Init_param_table_index(Param_table_type *table)
+{
+  table->live      = NULL;
+  table->num_live  = 0;
+  table->max_live  = 0;
+  table->by_handle = NULL;
+  table->by_label  = NULL;
+  table->hash_size = 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+void Delete_param_table_index(Param_table_type *table)
+{
+  free(table->live);
+  free(table->by_handle);
+  free(table->by_label);
+  Init_param_table_index(table);
+}
+
+/*--------------------------------------------------------------------*/
+
+void Hash_param_entry(Param_table_type *table, int index)
+{
+  int mask = table->hash_size - 1;
+  int i;
+
+  for(i = Hash_param_handle(table->param[index].handle) & mask;
+      table->by_handle[i] != -1; i = (i + 1) & mask);
+  table->by_handle[i] = index;
+
+  for(i = Hash_param_label(table->param[index].label) & mask;
+      table->by_label[i] != -1; i = (i + 1) & mask);
+  table->by_label[i] = index;
+}
+
+/*--------------------------------------------------------------------*/
+
+int Param_table_index_add(Param_table_type *table, int index)
+{
+  void *dum_ptr;
+  int  *by_handle;
+  int  *by_label;
+  int   new_size;
+  int   i;
+
+  if(table->num_live == table->max_live){
+
+    new_size = table->max_live ? 2*table->max_live : REG_INITIAL_NUM_PARAMS;
+    if(!(dum_ptr = realloc(table->live, new_size*sizeof(int)))){
+      fprintf(stderr, "STEER: Param_table_index_add: failed to allocate "
+	      "memory\n");
+      return REG_FAILURE;
+    }
+    table->live = (int *)dum_ptr;
+    table->max_live = new_size;
+  }
+  table->live[table->num_live++] = index;
+
+  /* Keep the hashes no more than half full, rebuilding them from the
+     list of live entries when they grow */
+  if(2*table->num_live <= table->hash_size){
+    Hash_param_entry(table, index);
+    return REG_SUCCESS;
+  }
+
+  new_size = table->hash_size ? 2*table->hash_size : 64;
+  while(2*table->num_live > new_size) new_size *= 2;
+
+  by_handle = (int *)malloc(new_size*sizeof(int));
+  by_label  = (int *)malloc(new_size*sizeof(int));
+  if(!by_handle || !by_label){
+    fprintf(stderr, "STEER: Param_table_index_add: failed to allocate "
+	    "memory\n");
+    free(by_handle);
+    free(by_label);
+    table->num_live--;
+    return REG_FAILURE;
+  }
+  memset(by_handle, -1, new_size*sizeof(int));
+  memset(by_label,  -1, new_size*sizeof(int));
+
+  free(table->by_handle);
+  free(table->by_label);
+  table->by_handle = by_handle;
+  table->by_label  = by_label;
+  table->hash_size = new_size;
+
+  for(i = 0; i < table->num_live; i++){
+    Hash_param_entry(table, table->live[i]);
+  }
+
+  return REG_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+
+int Param_index_from_label(Param_table_type *table, const char *Label)
+{
+  int mask;
+  int i;
+
+  if(table->hash_size == 0 || !Label) return -1;
+
+  mask = table->hash_size - 1;
+  for(i = Hash_param_label(Label) & mask;
+      table->by_label[i] != -1; i = (i + 1) & mask){
+    if(!strcmp(table->param[table->by_label[i]].label, Label)){
+      return table->by_label[i];
+    }
+  }
+  return -1;
+}
+
+/*--------------------------------------------------------------------*/
+
 int Param_index_from_handle(Param_table_type *table, int ParamHandle)
 {
   int i;
   int index = -1;
+  int mask;
 
   if(ParamHandle == REG_PARAM_HANDLE_NOTSET) return -1;
 
   /* Finds entry in a table of parameters that has handle == ParamHandle
      Returns -1 if no match found */
 
+  if(table->hash_size > 0){
+    mask = table->hash_size - 1;
+    for(i = Hash_param_handle(ParamHandle) & mask;
+	table->by_handle[i] != -1; i = (i + 1) & mask){
+      if(table->param[table->by_handle[i]].handle == ParamHandle){
+	return table->by_handle[i];
+      }
+    }
+    return -1;
+  }
+
   for(i=0; i<table->max_entries; i++){
 
     if(table->param[i].handle == ParamHandle){
@@ -239,6 +591,7 @@ int Increment_param_registered(Param_table_type *table)
 	table->param[i].handle = REG_PARAM_HANDLE_NOTSET;
 	table->param[i].min_val_valid = REG_FALSE;
 	table->param[i].max_val_valid = REG_FALSE;
+	memset(&(table->param[i].value), 0, sizeof(Param_value_type));
       }
     }
     else{
@@ -328,117 +681,596 @@ int Increment_iodef_registered(IOdef_table_type *table)
 
 int Increment_log_entry(Chk_log_type *log)
 {
-  int   i, j;
   int   new_size;
   void *dum_ptr;
   int   return_status = REG_SUCCESS;
 
-  if (!log) return REG_FAILURE;
+  if (!log) return REG_FAILURE;
+
+  /* Increment count of how many entries table has and allocate
+     more memory if required */
+  if(++log->num_entries >= log->max_entries){
+
+    new_size = log->max_entries + REG_INITIAL_CHK_LOG_SIZE;
+
+    if( (dum_ptr = realloc(log->entry,
+			   new_size*sizeof(Chk_log_entry_type))) ){
+
+      log->entry = (Chk_log_entry_type *)dum_ptr;
+      log->max_entries = new_size;
+
+      /* Initialise the new storage space */
+      Init_log_entries(log, log->max_entries - REG_INITIAL_CHK_LOG_SIZE);
+    }
+    else{
+      fprintf(stderr, "STEER: Increment_log_entry: failed to allocate more "
+	      "memory\n");
+      log->num_entries--;
+      return_status = REG_FAILURE;
+    }
+  }
+
+  return return_status;
+}
+
+/*------------------------------------------------------------------*/
+
+void Init_log_entries(Chk_log_type *log, int first)
+{
+  int i;
+
+  for(i=first; i<log->max_entries; i++){
+
+    log->entry[i].num_param = 0;
+    log->entry[i].max_param = 0;
+    log->entry[i].param     = NULL;
+  }
+}
+
+/*------------------------------------------------------------------*/
+
+void Delete_log_entries(Chk_log_type *log)
+{
+  int i;
+
+  if(!log->entry) return;
+
+  for(i=0; i<log->max_entries; i++){
+
+    if(log->entry[i].param){
+      Free_log_param_values(log->entry[i].param, log->entry[i].max_param);
+      free(log->entry[i].param);
+    }
+  }
+  free(log->entry);
+  log->entry = NULL;
+}
+
+/*------------------------------------------------------------------*/
+
+int Realloc_log_entry_params(Chk_log_entry_type *entry, int num_param)
+{
+  int   new_size;
+  void *dum_ptr;
+
+  if(num_param <= entry->max_param) return REG_SUCCESS;
+
+  /* Grow geometrically so that filling an entry one parameter at a
+     time stays cheap */
+  new_size = 2*entry->max_param;
+  if(new_size < num_param) new_size = num_param;
+
+  if( !(dum_ptr = realloc(entry->param,
+			  new_size*sizeof(Param_log_entry_type))) ){
+
+    fprintf(stderr, "STEER: Realloc_log_entry_params: failed to allocate "
+	    "storage for %d parameter values\n", new_size);
+    return REG_FAILURE;
+  }
+  entry->param = (Param_log_entry_type *)dum_ptr;
+
+  /* New slots hold no strings */
+  for(; entry->max_param < new_size; entry->max_param++){
+    entry->param[entry->max_param].type = REG_INT;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*------------------------------------------------------------------*/
+
+int IOdef_index_from_handle(IOdef_table_type *table, int IOdefHandle)
+{
+  int i;
+  int index = REG_IODEF_HANDLE_NOTSET;
+
+  /* Finds entry in a table of IOdefs that has handle == IOdefHandle
+     Returns REG_IODEF_HANDLE_NOTSET if no match found */
+
+  for(i=0; i<table->max_entries; i++){
+
+    if(table->io_def[i].handle == IOdefHandle){
+
+      index = i;
+      break;
+    }
+  }
+
+  return index;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Init_msg_writer(Msg_writer_type *writer, int size, int format)
+{
+  if(size < 1) size = REG_MAX_MSG_SIZE;
+
+  writer->format = format;
+  writer->depth = 0;
+  writer->buf = NULL;
+  writer->size = 0;
+
+  /* Reuse the buffer of a message that has already been sent if
+     there is one */
+  if(Num_free_msg_bufs > 0){
+    Num_free_msg_bufs--;
+    writer->buf = Free_msg_bufs[Num_free_msg_bufs];
+    writer->size = Free_msg_buf_sizes[Num_free_msg_bufs];
+  }
+  writer->pos = writer->buf;
+
+  if(Msg_writer_reserve(writer, size) != REG_SUCCESS){
+
+    fprintf(stderr, "STEER: Init_msg_writer: malloc of %d bytes failed\n",
+	    size);
+    Delete_msg_writer(writer);
+    return REG_FAILURE;
+  }
+  writer->buf[0] = '\0';
+
+  return REG_SUCCESS;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_reserve(Msg_writer_type *writer, int num_bytes)
+{
+  int   used;
+  int   new_size;
+  void *dum_ptr;
+
+  used = (int)(writer->pos - writer->buf);
+  if(num_bytes <= (writer->size - used)) return REG_SUCCESS;
+
+  new_size = 2*writer->size;
+  if(new_size < (used + num_bytes)) new_size = used + num_bytes;
+
+  if( !(dum_ptr = realloc(writer->buf, new_size)) ){
+
+    fprintf(stderr, "STEER: Msg_writer_reserve: realloc to %d bytes "
+	    "failed\n", new_size);
+    return REG_FAILURE;
+  }
+  writer->buf = (char *)dum_ptr;
+  writer->pos = writer->buf + used;
+  writer->size = new_size;
+
+  return REG_SUCCESS;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_printf(Msg_writer_type *writer, const char *format, ...)
+{
+  va_list args;
+  int     status;
+
+  va_start(args, format);
+  status = Msg_writer_vprintf(writer, format, args);
+  va_end(args);
+
+  return status;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_vprintf(Msg_writer_type *writer, const char *format,
+		       va_list args)
+{
+  va_list args_copy;
+  int     nbytes;
+  int     bytes_left;
+
+  bytes_left = writer->size - (int)(writer->pos - writer->buf);
+
+  /* Keep a copy of the arguments in case we have to format again */
+  va_copy(args_copy, args);
+  nbytes = vsnprintf(writer->pos, bytes_left, format, args);
+
+  if(nbytes < 0){
+    va_end(args_copy);
+    fprintf(stderr, "STEER: Msg_writer_vprintf: formatting failed\n");
+    return REG_FAILURE;
+  }
+
+  /* Didn't fit - grow the buffer and format again */
+  if(nbytes >= bytes_left){
+
+    if(Msg_writer_reserve(writer, nbytes + 1) != REG_SUCCESS){
+      va_end(args_copy);
+      *(writer->pos) = '\0';
+      return REG_FAILURE;
+    }
+    vsnprintf(writer->pos, nbytes + 1, format, args_copy);
+  }
+  va_end(args_copy);
+  writer->pos += nbytes;
+
+  return REG_SUCCESS;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_write(Msg_writer_type *writer, const char *data,
+		     int num_bytes)
+{
+  if(Msg_writer_reserve(writer, num_bytes + 1) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+  memcpy(writer->pos, data, num_bytes);
+  writer->pos += num_bytes;
+  *(writer->pos) = '\0';
+
+  return REG_SUCCESS;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_string(Msg_writer_type *writer, const char *str, int len)
+{
+  const char *start;
+  const char *end;
+  const char *entity;
+  int         entity_len;
+
+  if(!str) return REG_SUCCESS;
+  if(len < 0) len = (int)strlen(str);
+
+  /* Only xml needs its markup characters escaping */
+  if(writer->format == REG_WIRE_TLV) return Msg_writer_write(writer, str, len);
+
+  /* Copy runs of ordinary characters in one go */
+  start = str;
+  end = str + len;
+  while(str < end){
+
+    switch(*str){
+    case '&':
+      entity = "&amp;";
+      entity_len = 5;
+      break;
+    case '<':
+      entity = "&lt;";
+      entity_len = 4;
+      break;
+    case '>':
+      entity = "&gt;";
+      entity_len = 4;
+      break;
+    default:
+      str++;
+      continue;
+    }
+
+    if(Msg_writer_write(writer, start, (int)(str - start)) != REG_SUCCESS ||
+       Msg_writer_write(writer, entity, entity_len) != REG_SUCCESS){
+      return REG_FAILURE;
+    }
+    start = ++str;
+  }
+
+  return Msg_writer_write(writer, start, (int)(end - start));
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_int(Msg_writer_type *writer, int value)
+{
+  /* Big enough for any 64-bit int */
+  char          digits[24];
+  char         *pchar = digits + sizeof(digits);
+  unsigned int  uvalue;
+
+  /* Negate as unsigned so that INT_MIN comes out right */
+  uvalue = (value < 0) ? 0U - (unsigned int)value : (unsigned int)value;
+
+  do{
+    *(--pchar) = (char)('0' + uvalue%10);
+    uvalue /= 10;
+  } while(uvalue);
+
+  if(value < 0) *(--pchar) = '-';
+
+  return Msg_writer_write(writer, pchar,
+			  (int)(digits + sizeof(digits) - pchar));
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_tag(Msg_writer_type *writer, int tag, int closing,
+		   int newline)
+{
+  const char *name = Msg_tag_name(tag);
+  int         len = (int)strlen(name);
+
+  /* Room for "</" + name + ">\n" + '\0' */
+  if(Msg_writer_reserve(writer, len + 5) != REG_SUCCESS) return REG_FAILURE;
+
+  *(writer->pos++) = '<';
+  if(closing) *(writer->pos++) = '/';
+  memcpy(writer->pos, name, len);
+  writer->pos += len;
+  *(writer->pos++) = '>';
+  if(newline) *(writer->pos++) = '\n';
+  *(writer->pos) = '\0';
+
+  return REG_SUCCESS;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_header(Msg_writer_type *writer)
+{
+  static const char xml_header[] =
+    "<ReG_steer_message xmlns=\"" REG_STEER_NAMESPACE "\">\n";
+
+  if(writer->format == REG_WIRE_TLV){
+
+    if(Msg_writer_reserve(writer, 3) != REG_SUCCESS) return REG_FAILURE;
+    *(writer->pos++) = (char)REG_TLV_MAGIC;
+    *(writer->pos++) = (char)REG_TLV_VERSION;
+    *(writer->pos) = '\0';
+
+    return Msg_writer_begin(writer, MSG_TAG_STEER_MESSAGE);
+  }
+
+  /* The root element carries the namespace so is opened by hand */
+  writer->depth++;
+  return Msg_writer_write(writer, xml_header, (int)sizeof(xml_header) - 1);
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_footer(Msg_writer_type *writer)
+{
+  return Msg_writer_end(writer, MSG_TAG_STEER_MESSAGE);
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_begin(Msg_writer_type *writer, int tag)
+{
+  if(writer->depth == REG_MAX_MSG_DEPTH){
+
+    fprintf(stderr, "STEER: Msg_writer_begin: elements nested deeper "
+	    "than %d\n", REG_MAX_MSG_DEPTH);
+    return REG_FAILURE;
+  }
+
+  if(writer->format == REG_WIRE_TLV){
+
+    if(Msg_writer_reserve(writer, REG_TLV_ELEMENT_HDR + 1) != REG_SUCCESS){
+      return REG_FAILURE;
+    }
+    *(writer->pos++) = (char)tag;
+
+    /* Length is filled in by Msg_writer_end */
+    writer->open[writer->depth++] = (int)(writer->pos - writer->buf);
+    writer->pos += REG_TLV_ELEMENT_HDR - 1;
+    *(writer->pos) = '\0';
+
+    return REG_SUCCESS;
+  }
+
+  writer->depth++;
+  return Msg_writer_tag(writer, tag, REG_FALSE, REG_TRUE);
+}
+
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_end(Msg_writer_type *writer, int tag)
+{
+  unsigned char *plen;
+  unsigned int   len;
+
+  if(writer->depth == 0){
+
+    fprintf(stderr, "STEER: Msg_writer_end: no open element to close\n");
+    return REG_FAILURE;
+  }
+  writer->depth--;
+
+  if(writer->format == REG_WIRE_TLV){
 
-  /* Increment count of how many entries table has and allocate
-     more memory if required */
-  if(++log->num_entries >= log->max_entries){
+    plen = (unsigned char *)(writer->buf + writer->open[writer->depth]);
+    len = (unsigned int)((unsigned char *)writer->pos - plen) -
+      (REG_TLV_ELEMENT_HDR - 1);
+    plen[0] = (unsigned char)(len >> 24);
+    plen[1] = (unsigned char)(len >> 16);
+    plen[2] = (unsigned char)(len >> 8);
+    plen[3] = (unsigned char)len;
 
-    new_size = log->max_entries + REG_INITIAL_CHK_LOG_SIZE;
+    return REG_SUCCESS;
+  }
 
-    if( (dum_ptr = realloc(log->entry,
-			   new_size*sizeof(Chk_log_entry_type))) ){
+  return Msg_writer_tag(writer, tag, REG_TRUE, REG_TRUE);
+}
 
-      log->entry = (Chk_log_entry_type *)dum_ptr;
-      log->max_entries = new_size;
+/*-----------------------------------------------------------------*/
 
-      /* Initialise the new storage space */
-      for(i=log->num_entries; i<log->max_entries; i++){
+int Msg_writer_element_string(Msg_writer_type *writer, int tag,
+			      const char *value)
+{
+  return Msg_writer_element_bytes(writer, tag, value, -1);
+}
 
-	for(j=0; j<REG_MAX_NUM_STR_PARAMS; j++){
-	  log->entry[i].param[j].handle = REG_PARAM_HANDLE_NOTSET;
-	}
-      }
-    }
-    else{
-      fprintf(stderr, "STEER: Increment_log_entry: failed to allocate more "
-	      "memory\n");
-      log->num_entries--;
-      return_status = REG_FAILURE;
+/*-----------------------------------------------------------------*/
+
+int Msg_writer_element_int(Msg_writer_type *writer, int tag, int value)
+{
+  if(writer->format == REG_WIRE_TLV){
+
+    if(Msg_writer_begin(writer, tag) != REG_SUCCESS ||
+       Msg_writer_int(writer, value) != REG_SUCCESS){
+      return REG_FAILURE;
     }
+    return Msg_writer_end(writer, tag);
   }
 
-  return return_status;
+  if(Msg_writer_tag(writer, tag, REG_FALSE, REG_FALSE) != REG_SUCCESS ||
+     Msg_writer_int(writer, value) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+  return Msg_writer_tag(writer, tag, REG_TRUE, REG_TRUE);
 }
 
-/*------------------------------------------------------------------*/
+/*-----------------------------------------------------------------*/
 
-int IOdef_index_from_handle(IOdef_table_type *table, int IOdefHandle)
+int Msg_writer_element_value(Msg_writer_type *writer, int tag, int type,
+			     const Param_value_type *value)
 {
-  int i;
-  int index = REG_IODEF_HANDLE_NOTSET;
+  char buf[REG_NUM_BUF_LEN];
 
-  /* Finds entry in a table of IOdefs that has handle == IOdefHandle
-     Returns REG_IODEF_HANDLE_NOTSET if no match found */
+  if(type == REG_INT){
+    return Msg_writer_element_int(writer, tag, value->i);
+  }
 
-  for(i=0; i<table->max_entries; i++){
+  return Msg_writer_element_string(writer, tag,
+				   Param_value_to_string(type, value, buf));
+}
 
-    if(table->io_def[i].handle == IOdefHandle){
+/*-----------------------------------------------------------------*/
 
-      index = i;
-      break;
+int Msg_writer_element_bytes(Msg_writer_type *writer, int tag,
+			     const char *data, int num_bytes)
+{
+  /* In the binary format the element's value goes straight into
+     place between its header and the next element */
+  if(writer->format == REG_WIRE_TLV){
+
+    if(Msg_writer_begin(writer, tag) != REG_SUCCESS ||
+       Msg_writer_string(writer, data, num_bytes) != REG_SUCCESS){
+      return REG_FAILURE;
     }
+    return Msg_writer_end(writer, tag);
   }
 
-  return index;
+  if(Msg_writer_tag(writer, tag, REG_FALSE, REG_FALSE) != REG_SUCCESS ||
+     Msg_writer_string(writer, data, num_bytes) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+  return Msg_writer_tag(writer, tag, REG_TRUE, REG_TRUE);
 }
 
-/*--------------------------------------------------------------------*/
-int Write_xml_header(char** buf, int* bytes_free)
+/*-----------------------------------------------------------------*/
+
+const char *Msg_tag_name(int tag)
 {
-  int return_status = REG_SUCCESS;
-  int written;
+  /* Indexed by msg_tag_type */
+  static const char *names[MSG_NUM_TAGS] = {
+    "",
+    "ReG_steer_message",
+    "App_status",
+    "Steer_control",
+    "Param_defs",
+    "IOType_defs",
+    "ChkType_defs",
+    "Steer_log",
+    "Supported_commands",
+    "Param",
+    "Handle",
+    "Label",
+    "Value",
+    "Steerable",
+    "Type",
+    "Is_internal",
+    "Min_value",
+    "Max_value",
+    "Command",
+    "Cmd_id",
+    "Cmd_name",
+    "Cmd_param",
+    "Valid_after",
+    "IOType",
+    "ChkType",
+    "Direction",
+    "Freq_handle",
+    "Log_entry",
+    "Key",
+    "Chk_log_entry",
+    "Chk_handle",
+    "Chk_tag",
+    "Wire_format"
+  };
+
+  if(tag <= MSG_TAG_NOTSET || tag >= MSG_NUM_TAGS) return "";
+
+  return names[tag];
+}
 
-  if(buf) {
-    written = snprintf(*buf, *bytes_free,
-		       "<ReG_steer_message xmlns=\"%s\">\n",
-		       REG_STEER_NAMESPACE);
+/*-----------------------------------------------------------------*/
 
-    if(written >= *bytes_free) {
-      /* truncated */
-      return_status = REG_FAILURE;
+void Delete_msg_writer(Msg_writer_type *writer)
+{
+  /* Keep the buffer for the next message unless we already have
+     enough of them or it has grown unreasonably large */
+  if(writer->buf){
+    if(Num_free_msg_bufs < REG_MAX_FREE_MSG_BUFS &&
+       writer->size <= REG_MSG_BUF_MAX_RETAINED){
+      Free_msg_bufs[Num_free_msg_bufs] = writer->buf;
+      Free_msg_buf_sizes[Num_free_msg_bufs] = writer->size;
+      Num_free_msg_bufs++;
     }
-    else {
-      *buf += written;
-      *bytes_free -= written;
+    else{
+      free(writer->buf);
     }
   }
-  else {
-    return_status = REG_FAILURE;
-  }
+  writer->buf = NULL;
+  writer->pos = NULL;
+  writer->size = 0;
+}
 
-  return return_status;
+/*-----------------------------------------------------------------*/
+
+void Msg_writer_reset(Msg_writer_type *writer)
+{
+  writer->pos = writer->buf;
+  writer->depth = 0;
+  if(writer->buf) writer->buf[0] = '\0';
 }
 
-/*--------------------------------------------------------------------*/
+/*-----------------------------------------------------------------*/
 
-int Write_xml_footer(char **buf, int bytes_free)
+char *Msg_writer_take_buf(Msg_writer_type *writer)
 {
-  int return_status = REG_SUCCESS;
-  int n;
-  /* Write end of ReG steering message */
+  char *buf = writer->buf;
 
-  if(*buf){
-    n = snprintf(*buf, bytes_free, "</ReG_steer_message>\n");
+  writer->buf = NULL;
+  writer->pos = NULL;
+  writer->size = 0;
 
-    if(n >= (bytes_free-1) || (n < 1)){
+  return buf;
+}
 
-      return_status = REG_FAILURE;
-    }
-    else{
-      *buf += n;
-    }
-  }
-  else{
-    return_status = REG_FAILURE;
-  }
+/*-----------------------------------------------------------------*/
 
-  return return_status;
+void Free_msg_writer_bufs()
+{
+  while(Num_free_msg_bufs > 0){
+    Num_free_msg_bufs--;
+    free(Free_msg_bufs[Num_free_msg_bufs]);
+    Free_msg_bufs[Num_free_msg_bufs] = NULL;
+  }
 }
 
 /*-----------------------------------------------------------------*/
@@ -1073,6 +1905,498 @@ int Reorder_decode_array(IOdef_entry *io,
 
 /*------------------------------------------------------------------*/
 
+size_t Convert_xdr_in_place(int   type,
+			    int   count,
+			    void *pData,
+			    int   encode)
+{
+  unsigned char      *p = (unsigned char *)pData;
+  unsigned int        u;
+  unsigned long long  w;
+  long                l;
+  int                 i;
+
+  /* XDR is big-endian, so building each value up a byte at a time
+     works whatever the byte order here */
+  switch(type){
+
+  case REG_INT:
+  case REG_FLOAT:
+    for(i = 0; i < count; i++, p += 4){
+      if(encode){
+	memcpy(&u, p, 4);
+	p[0] = (unsigned char)(u >> 24);
+	p[1] = (unsigned char)(u >> 16);
+	p[2] = (unsigned char)(u >> 8);
+	p[3] = (unsigned char)u;
+      }
+      else{
+	u = ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) |
+	  ((unsigned int)p[2] << 8) | (unsigned int)p[3];
+	memcpy(p, &u, 4);
+      }
+    }
+    return (size_t)count*4;
+
+  case REG_DBL:
+    for(i = 0; i < count; i++, p += 8){
+      if(encode){
+	memcpy(&w, p, 8);
+	for(u = 0; u < 8; u++) p[u] = (unsigned char)(w >> (56 - 8*u));
+      }
+      else{
+	w = 0;
+	for(u = 0; u < 8; u++) w = (w << 8) | p[u];
+	memcpy(p, &w, 8);
+      }
+    }
+    return (size_t)count*8;
+
+  case REG_LONG:
+    /* Work forwards when shrinking and backwards when growing so that
+       nothing is overwritten before it has been read */
+    if(encode){
+      for(i = 0; i < count; i++){
+	memcpy(&l, p + i*sizeof(long), sizeof(long));
+	u = (unsigned int)l;
+	p[4*i]     = (unsigned char)(u >> 24);
+	p[4*i + 1] = (unsigned char)(u >> 16);
+	p[4*i + 2] = (unsigned char)(u >> 8);
+	p[4*i + 3] = (unsigned char)u;
+      }
+    }
+    else{
+      for(i = count - 1; i >= 0; i--){
+	u = ((unsigned int)p[4*i] << 24) | ((unsigned int)p[4*i + 1] << 16) |
+	  ((unsigned int)p[4*i + 2] << 8) | (unsigned int)p[4*i + 3];
+	l = (long)(int)u;
+	memcpy(p + i*sizeof(long), &l, sizeof(long));
+      }
+    }
+    return (size_t)count*4;
+
+  default:
+    break;
+  }
+
+  return 0;
+}
+
+/*------------------------------------------------------------------*/
+
+int Clip_array_roi(const Array_type *array,
+		   Roi_type         *roi)
+{
+  int tot[3];
+  int *start[3];
+  int *extent[3];
+  int *stride[3];
+  int  count = 1;
+  int  i;
+
+  tot[0] = array->totx; start[0] = &(roi->sx);
+  tot[1] = array->toty; start[1] = &(roi->sy);
+  tot[2] = array->totz; start[2] = &(roi->sz);
+  extent[0] = &(roi->nx); stride[0] = &(roi->dx);
+  extent[1] = &(roi->ny); stride[1] = &(roi->dy);
+  extent[2] = &(roi->nz); stride[2] = &(roi->dz);
+
+  for(i = 0; i < 3; i++) {
+    if(*(stride[i]) < 1) *(stride[i]) = 1;
+
+    if(*(start[i]) < 0) {
+      *(extent[i]) += *(start[i]);
+      *(start[i]) = 0;
+    }
+    if(*(start[i]) + *(extent[i]) > tot[i]) {
+      *(extent[i]) = tot[i] - *(start[i]);
+    }
+    if(*(extent[i]) <= 0) return 0;
+
+    /* No. of elements picked out in this direction */
+    count *= (*(extent[i]) + *(stride[i]) - 1) / *(stride[i]);
+  }
+
+  return count;
+}
+
+/*------------------------------------------------------------------*/
+
+void Gather_array_roi(const Array_type *array,
+		      const Roi_type   *roi,
+		      size_t            size,
+		      const void       *pIn,
+		      void             *pOut)
+{
+  const char *row;
+  char       *out = (char *)pOut;
+  size_t      nrow  = (size_t)array->totx;
+  size_t      nslab = (size_t)array->totx*array->toty;
+  int         nx = (roi->nx + roi->dx - 1)/roi->dx;
+  int         i, j, k;
+
+  for(k = roi->sz; k < roi->sz + roi->nz; k += roi->dz){
+    for(j = roi->sy; j < roi->sy + roi->ny; j += roi->dy){
+
+      row = (const char *)pIn + (k*nslab + j*nrow + roi->sx)*size;
+
+      /* Whole rows can be copied in one go */
+      if(roi->dx == 1){
+	memcpy(out, row, nx*size);
+	out += nx*size;
+	continue;
+      }
+
+      /* Fixed-size copies so that the compiler turns each into a
+	 single load and store (and leaves the bits alone - they may
+	 not be floating-point values) */
+      switch(size){
+
+      case 8:
+	for(i = 0; i < nx; i++){
+	  memcpy(out + i*8, row + i*roi->dx*8, 8);
+	}
+	break;
+
+      case 4:
+	for(i = 0; i < nx; i++){
+	  memcpy(out + i*4, row + i*roi->dx*4, 4);
+	}
+	break;
+
+      case 1:
+	for(i = 0; i < nx; i++){
+	  out[i] = row[i*roi->dx];
+	}
+	break;
+
+      default:
+	for(i = 0; i < nx; i++){
+	  memcpy(out + i*size, row + i*roi->dx*size, size);
+	}
+	break;
+      }
+      out += nx*size;
+    }
+  }
+}
+
+/*------------------------------------------------------------------*/
+
+int Layout_is_contiguous(int         ndims,
+			 const int  *extent,
+			 const long *stride,
+			 size_t      size)
+{
+  long expect = (long)size;
+  int  d;
+
+  for(d = 0; d < ndims; d++){
+    /* Strides don't matter in directions only one element long */
+    if(extent[d] > 1 && stride[d] != expect) return REG_FALSE;
+    expect *= extent[d];
+  }
+  return REG_TRUE;
+}
+
+/*------------------------------------------------------------------*/
+
+void Copy_strided_row(char       *out,
+		      long        out_stride,
+		      const char *in,
+		      long        in_stride,
+		      int         n,
+		      size_t      size)
+{
+  int i;
+
+  if(out_stride == (long)size && in_stride == (long)size){
+    memcpy(out, in, n*size);
+    return;
+  }
+
+  /* Fixed-size copies so that the compiler turns each into a single
+     load and store (and can vectorise the loop) without touching the
+     bits - they may not be floating-point values */
+  switch(size){
+
+  case 8:
+    for(i = 0; i < n; i++){
+      memcpy(out + i*out_stride, in + i*in_stride, 8);
+    }
+    break;
+
+  case 4:
+    for(i = 0; i < n; i++){
+      memcpy(out + i*out_stride, in + i*in_stride, 4);
+    }
+    break;
+
+  case 1:
+    for(i = 0; i < n; i++){
+      out[i*out_stride] = in[i*in_stride];
+    }
+    break;
+
+  default:
+    for(i = 0; i < n; i++){
+      memcpy(out + i*out_stride, in + i*in_stride, size);
+    }
+    break;
+  }
+}
+
+/*------------------------------------------------------------------*/
+
+void Copy_array_layout(int         ndims,
+		       const int  *extent,
+		       const long *stride,
+		       size_t      size,
+		       void       *pStrided,
+		       void       *pPacked,
+		       int         gather)
+{
+  int   idx[REG_MAX_LAYOUT_DIMS];
+  char *row    = (char *)pStrided;
+  char *packed = (char *)pPacked;
+  int   nx = extent[0];
+  int   d;
+
+  for(d = 0; d < ndims; d++){
+    if(extent[d] < 1) return;
+    idx[d] = 0;
+  }
+
+  /* Walk the rows (runs along the first dimension) in order, like an
+     odometer over the remaining dimensions */
+  d = 1;
+  while(d > 0){
+
+    if(gather){
+      Copy_strided_row(packed, (long)size, row, stride[0], nx, size);
+    }
+    else{
+      Copy_strided_row(row, stride[0], packed, (long)size, nx, size);
+    }
+    packed += nx*size;
+
+    for(d = 1; d < ndims; d++){
+      row += stride[d];
+      if(++idx[d] < extent[d]) break;
+      row -= extent[d]*stride[d];
+      idx[d] = 0;
+    }
+    if(d == ndims) d = 0;
+  }
+}
+
+/*------------------------------------------------------------------*/
+
+int Coarsen_array(const int  *n,
+		  int         DataType,
+		  const void *pIn,
+		  void       *pOut)
+{
+  double *sum;
+  double  scale;
+  size_t  nrow  = (size_t)n[0];
+  size_t  nslab = (size_t)n[0]*n[1];
+  size_t  offset;
+  size_t  out;
+  int     m[3];
+  int     rows;
+  int     i, j, k, jj, kk;
+
+  if(DataType != REG_FLOAT && DataType != REG_DBL) return REG_FAILURE;
+
+  for(i = 0; i < 3; i++) m[i] = (n[i] + 1)/2;
+
+  if(!(sum = (double *)Pool_alloc(nrow*sizeof(double)))) {
+    fprintf(stderr, "STEER: Coarsen_array: failed to allocate memory\n");
+    return REG_FAILURE;
+  }
+
+  out = 0;
+  for(k = 0; k < m[2]; k++){
+    for(j = 0; j < m[1]; j++){
+
+      /* Add up the (up to four) rows of the input that are averaged
+	 into this row of the output */
+      for(i = 0; i < n[0]; i++) sum[i] = 0.0;
+      rows = 0;
+
+      for(kk = 2*k; kk < 2*k + 2 && kk < n[2]; kk++){
+	for(jj = 2*j; jj < 2*j + 2 && jj < n[1]; jj++){
+	  offset = kk*nslab + jj*nrow;
+
+	  if(DataType == REG_FLOAT){
+	    const float *row = (const float *)pIn + offset;
+	    for(i = 0; i < n[0]; i++) sum[i] += row[i];
+	  }
+	  else{
+	    const double *row = (const double *)pIn + offset;
+	    for(i = 0; i < n[0]; i++) sum[i] += row[i];
+	  }
+	  rows++;
+	}
+      }
+
+      /* Then pairs of elements along the row */
+      scale = 0.5/rows;
+      if(DataType == REG_FLOAT){
+	float *row = (float *)pOut + out;
+	for(i = 0; i < n[0]/2; i++){
+	  row[i] = (float)((sum[2*i] + sum[2*i+1])*scale);
+	}
+	if(n[0] % 2) row[i] = (float)(sum[2*i]/rows);
+      }
+      else{
+	double *row = (double *)pOut + out;
+	for(i = 0; i < n[0]/2; i++){
+	  row[i] = (sum[2*i] + sum[2*i+1])*scale;
+	}
+	if(n[0] % 2) row[i] = sum[2*i]/rows;
+      }
+      out += m[0];
+    }
+  }
+
+  Pool_free(sum);
+
+  return REG_SUCCESS;
+}
+
+/*------------------------------------------------------------------*/
+
+int History_init(History_type *history,
+		 int           depth)
+{
+  History_free(history);
+
+  if(depth <= 0) return REG_SUCCESS;
+  if(depth > REG_MAX_HISTORY_DEPTH) {
+    fprintf(stderr, "STEER: History_init: can keep at most %d data "
+	    "sets, not %d\n", REG_MAX_HISTORY_DEPTH, depth);
+    return REG_FAILURE;
+  }
+
+  history->datasets = (History_dataset_type *)
+    calloc(depth, sizeof(History_dataset_type));
+  if(!history->datasets) {
+    fprintf(stderr, "STEER: History_init: failed to allocate memory\n");
+    return REG_FAILURE;
+  }
+  history->depth = depth;
+  history->current = -1;
+  history->next_seqnum = 0;
+
+  for(depth = 0; depth < history->depth; depth++) {
+    history->datasets[depth].seqnum = -1;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*------------------------------------------------------------------*/
+
+void History_free(History_type *history)
+{
+  History_dataset_type *dataset;
+  int                   i, j;
+
+  for(i = 0; i < history->depth; i++) {
+    dataset = &(history->datasets[i]);
+    for(j = 0; j < dataset->max_slices; j++) {
+      Pool_free(dataset->slices[j].data);
+    }
+    free(dataset->slices);
+  }
+  free(history->datasets);
+
+  history->datasets = NULL;
+  history->depth = 0;
+  history->current = -1;
+  history->next_seqnum = 0;
+}
+
+/*------------------------------------------------------------------*/
+
+void History_begin_dataset(History_type *history)
+{
+  if(history->depth == 0) return;
+
+  history->current = (history->current + 1) % history->depth;
+  history->datasets[history->current].seqnum = history->next_seqnum++;
+  history->datasets[history->current].num_slices = 0;
+}
+
+/*------------------------------------------------------------------*/
+
+void *History_add_slice(History_type *history,
+			int           type,
+			int           count,
+			size_t        nbytes)
+{
+  History_dataset_type *dataset;
+  History_slice_type   *slice;
+  void                 *ptr;
+  int                   n;
+
+  if(history->current < 0) return NULL;
+  dataset = &(history->datasets[history->current]);
+
+  if(dataset->num_slices == dataset->max_slices) {
+    n = dataset->max_slices ? 2*dataset->max_slices : 8;
+    if(!(ptr = realloc(dataset->slices, n*sizeof(History_slice_type)))) {
+      fprintf(stderr, "STEER: History_add_slice: failed to allocate "
+	      "memory\n");
+      return NULL;
+    }
+    dataset->slices = (History_slice_type *)ptr;
+    memset(&(dataset->slices[dataset->max_slices]), 0,
+	   (n - dataset->max_slices)*sizeof(History_slice_type));
+    dataset->max_slices = n;
+  }
+  slice = &(dataset->slices[dataset->num_slices]);
+
+  /* Only reallocate if the last data set to use this slot had a
+     smaller slice here - they're usually the same shape */
+  if(nbytes > slice->max_bytes || !slice->data) {
+    Pool_free(slice->data);
+    slice->max_bytes = 0;
+    if(!(slice->data = Pool_alloc(nbytes))) return NULL;
+    slice->max_bytes = Pool_block_size(slice->data);
+  }
+
+  slice->type = type;
+  slice->count = count;
+  dataset->num_slices++;
+
+  return slice->data;
+}
+
+/*------------------------------------------------------------------*/
+
+History_dataset_type *History_find_dataset(History_type *history,
+					   int           seqnum)
+{
+  int age;
+  int slot;
+
+  if(history->current < 0) return NULL;
+
+  /* Data sets go round the ring in order */
+  age = history->next_seqnum - 1 - seqnum;
+  if(age < 0 || age >= history->depth) return NULL;
+  slot = (history->current - age + history->depth) % history->depth;
+
+  if(history->datasets[slot].seqnum != seqnum) return NULL;
+
+  return &(history->datasets[slot]);
+}
+
+/*------------------------------------------------------------------*/
+
 char *Get_current_time_string()
 {
   time_t current_time;
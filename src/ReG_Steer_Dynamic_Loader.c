@@ -104,6 +104,8 @@ int Load_samples_transport_api() {
   Load_symbol("Emit_ack", env, mod_handle, (void*) &Emit_ack_impl);
   Load_symbol("Consume_ack", env, mod_handle, (void*) &Consume_ack_impl);
   Load_symbol("Get_IOType_address", env, mod_handle, (void*) &Get_IOType_address_impl);
+  Load_symbol("Release_data", env, mod_handle, (void*) &Release_data_impl);
+  Load_symbol("Poll_IOType", env, mod_handle, (void*) &Poll_IOType_impl);
   Load_symbol("Emit_start", env, mod_handle, (void*) &Emit_start_impl);
   Load_symbol("Emit_stop", env, mod_handle, (void*) &Emit_stop_impl);
   Load_symbol("Consume_stop", env, mod_handle, (void*) &Consume_stop_impl);
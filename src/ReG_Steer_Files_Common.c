@@ -76,6 +76,26 @@ int file_info_table_init(file_info_table_type* table,
 
   for(i = 0; i < max_entries; i++) {
     table->file_info[i].fp = NULL;
+    table->file_info[i].offset = 0;
+    table->file_info[i].alignment = 0;
+    table->file_info[i].seqnum = 0;
+    table->file_info[i].slices = NULL;
+    table->file_info[i].num_slices = 0;
+    table->file_info[i].max_slices = 0;
+    table->file_info[i].writer = NULL;
+    table->file_info[i].writer_open = 0;
+    table->file_info[i].write_queue_depth = 0;
+    table->file_info[i].write_mbps = 0.0;
+    table->file_info[i].group = NULL;
+    table->file_info[i].num_directories = 0;
+    table->file_info[i].directories = NULL;
+    table->file_info[i].stripe_mode = REG_STRIPE_NONE;
+    table->file_info[i].stripe_policy = REG_STRIPE_ROUNDROBIN;
+    table->file_info[i].stripes = NULL;
+    table->file_info[i].max_stripes = 0;
+    table->file_info[i].num_stripes = 0;
+    table->file_info[i].current_stripe = -1;
+    table->file_info[i].uring = NULL;
   }
 
   return REG_SUCCESS;
@@ -0,0 +1,577 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+/** @internal
+    @file ReG_Steer_Files_Writer.c
+    @brief Source file for the write-behind file writer.
+    @author Robert Haines
+  */
+
+/* O_DIRECT is only visible with this defined */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "ReG_Steer_Config.h"
+#include "ReG_Steer_types.h"
+#include "ReG_Steer_Files_Common.h"
+#include "ReG_Steer_Files_Writer.h"
+
+/* Types of request */
+#define REG_WRITER_OPEN  0
+#define REG_WRITER_DATA  1
+#define REG_WRITER_CLOSE 2
+
+#if REG_HAS_PTHREADS
+
+/*---------------------------------------------------*/
+
+static double writer_time_now() {
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return (double)(tv.tv_sec) + 1.0e-6*(double)(tv.tv_usec);
+}
+
+/*---------------------------------------------------*/
+
+/* Flag that the current file could not be written. The caller
+   learns of this from File_writer_write(). */
+static void writer_set_error(file_writer_type* writer) {
+  writer->error = 1;
+
+  pthread_mutex_lock(&(writer->mutex));
+  writer->failed_file = writer->file_id;
+  pthread_mutex_unlock(&(writer->mutex));
+}
+
+/*---------------------------------------------------*/
+
+static void writer_do_open(file_writer_type* writer,
+			   file_writer_request_type* req) {
+  int flags = O_WRONLY | O_CREAT | O_TRUNC;
+
+  writer->error = 0;
+  writer->file_id = req->file_id;
+  writer->fd_direct = 0;
+  writer->bytes_written = 0.0;
+  writer->start_time = writer_time_now();
+
+#if REG_HAS_O_DIRECT
+  if(writer->flags & REG_WRITER_DIRECT_IO) {
+    writer->fd = open(req->filename, flags | O_DIRECT, 0644);
+    if(writer->fd >= 0) {
+      writer->fd_direct = 1;
+      return;
+    }
+    /* Not all file systems support O_DIRECT - fall back */
+#ifdef REG_DEBUG
+    fprintf(stderr, "STEER: File_writer: O_DIRECT open of %s failed, "
+	    "using buffered I/O\n", req->filename);
+#endif
+  }
+#endif /* REG_HAS_O_DIRECT */
+
+  if((writer->fd = open(req->filename, flags, 0644)) < 0) {
+    fprintf(stderr, "STEER: File_writer: failed to open %s: %s\n",
+	    req->filename, strerror(errno));
+    writer_set_error(writer);
+  }
+}
+
+/*---------------------------------------------------*/
+
+static void writer_do_write(file_writer_type* writer,
+			    file_writer_request_type* req) {
+  char*   pchar = req->block;
+  size_t  nbytes = req->num_bytes;
+  ssize_t n;
+
+  if(writer->fd < 0 || writer->error) return;
+
+#if REG_HAS_O_DIRECT
+  /* A partly-filled block can't be written with O_DIRECT */
+  if(writer->fd_direct && (nbytes % REG_WRITER_ALIGNMENT)) {
+    fcntl(writer->fd, F_SETFL, fcntl(writer->fd, F_GETFL) & ~O_DIRECT);
+    writer->fd_direct = 0;
+  }
+#endif
+
+  while(nbytes > 0) {
+    n = write(writer->fd, pchar, nbytes);
+    if(n < 0) {
+      if(errno == EINTR) continue;
+      fprintf(stderr, "STEER: File_writer: write failed: %s\n",
+	      strerror(errno));
+      writer_set_error(writer);
+      return;
+    }
+    pchar += n;
+    nbytes -= (size_t)n;
+  }
+
+  writer->bytes_written += (double)req->num_bytes;
+}
+
+/*---------------------------------------------------*/
+
+static void writer_do_close(file_writer_type* writer,
+			    file_writer_request_type* req) {
+  double elapsed;
+  int    last;
+
+  if(writer->fd < 0) {
+    writer_set_error(writer);
+  }
+  else {
+    /* Make sure the data is on disk before anyone can see the file */
+#if REG_HAS_FDATASYNC
+    if(fdatasync(writer->fd) != 0) writer_set_error(writer);
+#else
+    if(fsync(writer->fd) != 0) writer_set_error(writer);
+#endif
+
+#if REG_HAS_POSIX_FADVISE
+    if(writer->flags & REG_WRITER_FADVISE) {
+      posix_fadvise(writer->fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+#endif
+
+    if(close(writer->fd) != 0) writer_set_error(writer);
+    writer->fd = -1;
+  }
+
+  if(writer->error) {
+    fprintf(stderr, "STEER: File_writer: failed to write %s - "
+	    "discarding it\n", req->filename);
+    remove(req->filename);
+  }
+  else {
+    elapsed = writer_time_now() - writer->start_time;
+    if(elapsed > 0.0) {
+      pthread_mutex_lock(&(writer->mutex));
+      writer->mbps = (float)(writer->bytes_written/(1048576.0*elapsed));
+      pthread_mutex_unlock(&(writer->mutex));
+    }
+  }
+
+  if(!req->group) {
+    if(!writer->error) create_lock_file(req->filename);
+    return;
+  }
+
+  /* The last file of a group to reach the disk publishes it */
+  pthread_mutex_lock(&(req->group->mutex));
+  if(writer->error) req->group->error = 1;
+  last = (--(req->group->remaining) == 0);
+  pthread_mutex_unlock(&(req->group->mutex));
+
+  if(last) {
+    if(!req->group->error) {
+      create_lock_file(req->group->filename);
+    }
+    else {
+      fprintf(stderr, "STEER: File_writer: not publishing %s as part of "
+	      "it could not be written\n", req->group->filename);
+    }
+    File_writer_group_free(req->group);
+  }
+  req->group = NULL;
+}
+
+/*---------------------------------------------------*/
+
+static void* writer_thread(void* arg) {
+  file_writer_type*         writer = (file_writer_type*)arg;
+  file_writer_request_type* req;
+
+  pthread_mutex_lock(&(writer->mutex));
+
+  while(1) {
+    while(writer->num_requests == 0 && writer->running) {
+      pthread_cond_wait(&(writer->cond), &(writer->mutex));
+    }
+    if(writer->num_requests == 0) break;
+
+    /* Request stays in the ring (so can't be overwritten) until
+       we've finished with it */
+    req = &(writer->requests[writer->head]);
+    pthread_mutex_unlock(&(writer->mutex));
+
+    switch(req->type) {
+    case REG_WRITER_OPEN:
+      writer_do_open(writer, req);
+      break;
+    case REG_WRITER_DATA:
+      writer_do_write(writer, req);
+      break;
+    case REG_WRITER_CLOSE:
+      writer_do_close(writer, req);
+      break;
+    }
+
+    pthread_mutex_lock(&(writer->mutex));
+    if(req->type == REG_WRITER_DATA) {
+      writer->free_blocks[writer->num_free++] = req->block;
+    }
+    writer->head = (writer->head + 1) % writer->max_requests;
+    writer->num_requests--;
+    pthread_cond_broadcast(&(writer->cond));
+  }
+
+  pthread_mutex_unlock(&(writer->mutex));
+  return NULL;
+}
+
+/*---------------------------------------------------*/
+
+/* Add a request to the ring, waiting for space. Must be called
+   with the mutex held. */
+static file_writer_request_type* writer_push(file_writer_type* writer,
+					     const int type) {
+  file_writer_request_type* req;
+
+  while(writer->num_requests == writer->max_requests) {
+    pthread_cond_wait(&(writer->cond), &(writer->mutex));
+  }
+
+  req = &(writer->requests[(writer->head + writer->num_requests) %
+			   writer->max_requests]);
+  req->type = type;
+  req->block = NULL;
+  req->num_bytes = 0;
+  req->filename[0] = '\0';
+  req->group = NULL;
+
+  return req;
+}
+
+/*---------------------------------------------------*/
+
+/* Queue the current block. Must be called with the mutex held. */
+static void writer_queue_block(file_writer_type* writer) {
+  file_writer_request_type* req;
+
+  if(!writer->block || writer->block_used == 0) return;
+
+  req = writer_push(writer, REG_WRITER_DATA);
+  req->block = writer->block;
+  req->num_bytes = writer->block_used;
+  writer->num_requests++;
+  pthread_cond_broadcast(&(writer->cond));
+
+  writer->block = NULL;
+  writer->block_used = 0;
+}
+
+/*---------------------------------------------------*/
+
+int File_writer_init(file_writer_type* writer,
+		     const int         queue_depth,
+		     const size_t      block_size,
+		     const int         flags) {
+  void* ptr;
+  int   i;
+
+  memset(writer, 0, sizeof(file_writer_type));
+  writer->fd = -1;
+  writer->flags = flags;
+  writer->queue_depth = (queue_depth > 0) ? queue_depth : 1;
+  writer->block_size = block_size ? block_size : REG_WRITER_BLOCK_SIZE;
+  writer->block_size = REG_WRITER_ALIGNMENT *
+    ((writer->block_size + REG_WRITER_ALIGNMENT - 1)/REG_WRITER_ALIGNMENT);
+
+  /* Each queued block may be accompanied by an open and a close */
+  writer->max_requests = 2*writer->queue_depth + 2;
+  writer->requests = (file_writer_request_type*)
+    malloc(writer->max_requests*sizeof(file_writer_request_type));
+
+  /* One more block than the queue depth - the one being filled */
+  writer->free_blocks = (char**)
+    malloc((writer->queue_depth + 1)*sizeof(char*));
+
+  if(!writer->requests || !writer->free_blocks) {
+    fprintf(stderr, "STEER: File_writer_init: failed to allocate memory\n");
+    File_writer_finalize(writer);
+    return REG_FAILURE;
+  }
+
+  for(i = 0; i <= writer->queue_depth; i++) {
+    if(posix_memalign(&ptr, REG_WRITER_ALIGNMENT, writer->block_size)) {
+      fprintf(stderr, "STEER: File_writer_init: failed to allocate "
+	      "%d byte block\n", (int)writer->block_size);
+      File_writer_finalize(writer);
+      return REG_FAILURE;
+    }
+    writer->free_blocks[writer->num_free++] = (char*)ptr;
+  }
+
+  pthread_mutex_init(&(writer->mutex), NULL);
+  pthread_cond_init(&(writer->cond), NULL);
+  writer->running = 1;
+
+  if(pthread_create(&(writer->thread), NULL, writer_thread, writer)) {
+    fprintf(stderr, "STEER: File_writer_init: failed to start thread\n");
+    writer->running = 0;
+    pthread_mutex_destroy(&(writer->mutex));
+    pthread_cond_destroy(&(writer->cond));
+    File_writer_finalize(writer);
+    return REG_FAILURE;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+void File_writer_finalize(file_writer_type* writer) {
+  int i;
+
+  if(writer->running) {
+    pthread_mutex_lock(&(writer->mutex));
+    writer_queue_block(writer);
+    writer->running = 0;
+    pthread_cond_broadcast(&(writer->cond));
+    pthread_mutex_unlock(&(writer->mutex));
+
+    pthread_join(writer->thread, NULL);
+    pthread_mutex_destroy(&(writer->mutex));
+    pthread_cond_destroy(&(writer->cond));
+  }
+
+  if(writer->block) {
+    free(writer->block);
+    writer->block = NULL;
+  }
+  if(writer->free_blocks) {
+    for(i = 0; i < writer->num_free; i++) {
+      free(writer->free_blocks[i]);
+    }
+    free(writer->free_blocks);
+    writer->free_blocks = NULL;
+  }
+  writer->num_free = 0;
+
+  if(writer->requests) {
+    free(writer->requests);
+    writer->requests = NULL;
+  }
+}
+
+/*---------------------------------------------------*/
+
+int File_writer_open(file_writer_type* writer,
+		     const char*       filename) {
+  file_writer_request_type* req;
+
+  pthread_mutex_lock(&(writer->mutex));
+  req = writer_push(writer, REG_WRITER_OPEN);
+  strncpy(req->filename, filename, REG_MAX_STRING_LENGTH - 1);
+  req->filename[REG_MAX_STRING_LENGTH - 1] = '\0';
+  req->file_id = ++(writer->num_opened);
+  writer->num_requests++;
+  pthread_cond_broadcast(&(writer->cond));
+  pthread_mutex_unlock(&(writer->mutex));
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+int File_writer_write(file_writer_type* writer,
+		      const void*       data,
+		      const size_t      num_bytes) {
+  const char* pchar = (const char*)data;
+  size_t      remaining = num_bytes;
+  size_t      n;
+  int         failed;
+
+  while(remaining > 0) {
+
+    if(!writer->block) {
+      /* Wait for the writer thread to hand back a block */
+      pthread_mutex_lock(&(writer->mutex));
+      while(writer->num_free == 0) {
+	pthread_cond_wait(&(writer->cond), &(writer->mutex));
+      }
+      writer->block = writer->free_blocks[--writer->num_free];
+      writer->block_used = 0;
+      pthread_mutex_unlock(&(writer->mutex));
+    }
+
+    n = writer->block_size - writer->block_used;
+    if(n > remaining) n = remaining;
+
+    memcpy(writer->block + writer->block_used, pchar, n);
+    writer->block_used += n;
+    pchar += n;
+    remaining -= n;
+
+    if(writer->block_used == writer->block_size) {
+      pthread_mutex_lock(&(writer->mutex));
+      writer_queue_block(writer);
+      pthread_mutex_unlock(&(writer->mutex));
+    }
+  }
+
+  /* Only failures of the file being written now concern the caller
+     - earlier ones have already been discarded */
+  pthread_mutex_lock(&(writer->mutex));
+  failed = (writer->failed_file == writer->num_opened);
+  pthread_mutex_unlock(&(writer->mutex));
+
+  return failed ? REG_FAILURE : REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+int File_writer_close(file_writer_type*       writer,
+		      const char*             filename,
+		      file_writer_group_type* group) {
+  file_writer_request_type* req;
+
+  pthread_mutex_lock(&(writer->mutex));
+  writer_queue_block(writer);
+  req = writer_push(writer, REG_WRITER_CLOSE);
+  strncpy(req->filename, filename, REG_MAX_STRING_LENGTH - 1);
+  req->filename[REG_MAX_STRING_LENGTH - 1] = '\0';
+  req->group = group;
+  writer->num_requests++;
+  pthread_cond_broadcast(&(writer->cond));
+  pthread_mutex_unlock(&(writer->mutex));
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+file_writer_group_type* File_writer_group_create(const char* filename,
+						 const int   num_files) {
+  file_writer_group_type* group;
+
+  if(!(group = (file_writer_group_type*)
+       malloc(sizeof(file_writer_group_type)))) {
+    return NULL;
+  }
+
+  group->remaining = num_files;
+  group->error = 0;
+  strncpy(group->filename, filename, REG_MAX_STRING_LENGTH - 1);
+  group->filename[REG_MAX_STRING_LENGTH - 1] = '\0';
+  pthread_mutex_init(&(group->mutex), NULL);
+
+  return group;
+}
+
+/*---------------------------------------------------*/
+
+void File_writer_group_free(file_writer_group_type* group) {
+  if(!group) return;
+
+  pthread_mutex_destroy(&(group->mutex));
+  free(group);
+}
+
+/*---------------------------------------------------*/
+
+void File_writer_stats(file_writer_type* writer,
+		       int*              queue_depth,
+		       float*            mbps) {
+  pthread_mutex_lock(&(writer->mutex));
+  *queue_depth = writer->queue_depth + 1 - writer->num_free -
+    (writer->block ? 1 : 0);
+  *mbps = writer->mbps;
+  pthread_mutex_unlock(&(writer->mutex));
+}
+
+/*---------------------------------------------------*/
+
+#else /* REG_HAS_PTHREADS */
+
+int File_writer_init(file_writer_type* writer,
+		     const int         queue_depth,
+		     const size_t      block_size,
+		     const int         flags) {
+  fprintf(stderr, "STEER: File_writer_init: write-behind is not "
+	  "available on this platform\n");
+  return REG_FAILURE;
+}
+
+void File_writer_finalize(file_writer_type* writer) {}
+
+int File_writer_open(file_writer_type* writer,
+		     const char*       filename) {
+  return REG_FAILURE;
+}
+
+int File_writer_write(file_writer_type* writer,
+		      const void*       data,
+		      const size_t      num_bytes) {
+  return REG_FAILURE;
+}
+
+int File_writer_close(file_writer_type*       writer,
+		      const char*             filename,
+		      file_writer_group_type* group) {
+  return REG_FAILURE;
+}
+
+file_writer_group_type* File_writer_group_create(const char* filename,
+						 const int   num_files) {
+  return NULL;
+}
+
+void File_writer_group_free(file_writer_group_type* group) {}
+
+void File_writer_stats(file_writer_type* writer,
+		       int*              queue_depth,
+		       float*            mbps) {
+  *queue_depth = 0;
+  *mbps = 0.0;
+}
+
+#endif /* REG_HAS_PTHREADS */
@@ -58,6 +58,7 @@
 #include "ReG_Steer_Config.h"
 #include "ReG_Steer_types.h"
 #include "ReG_Steer_Common.h"
+#include "ReG_Steer_Number.h"
 #include "ReG_Steer_Logging.h"
 #include "ReG_Steer_Appside_internal.h"
 #include "ReG_Steer_Steering_Transport_API.h"
@@ -82,7 +83,7 @@ extern int ReG_SteeringActive;
 
 int Initialize_log(Chk_log_type *log, log_type_type log_type)
 {
-  int i, j;
+  int i;
 
   log->log_type         = log_type;
   log->num_entries 	= 0;
@@ -91,10 +92,9 @@ int Initialize_log(Chk_log_type *log, log_type_type log_type)
   log->emit_in_progress = REG_FALSE;
   log->file_content     = NULL;
   log->send_all    	= REG_TRUE;
+  log->param_send_all   = NULL;
+  log->num_param_send_all = 0;
   if(log->log_type == PARAM){
-    for(i=0; i<REG_MAX_NUM_STR_PARAMS; i++){
-      log->param_send_all[i] = REG_TRUE;
-    }
 
     Initialize_log_impl(log);
 
@@ -113,28 +113,19 @@ int Initialize_log(Chk_log_type *log, log_type_type log_type)
   log->entry = (Chk_log_entry_type *)malloc(Chk_log.max_entries
 					  *sizeof(Chk_log_entry_type));
 
-  log->pSteer_cmds = (char *)malloc(REG_MAX_MSG_SIZE*sizeof(char));
-  log->steer_cmds_bytes = REG_MAX_MSG_SIZE;
-
-  if(!(log->entry) || !(log->pSteer_cmds) ){
+  if(!(log->entry) ||
+     Init_msg_writer(&(log->steer_cmds), BUFSIZ,
+		     REG_WIRE_XML) != REG_SUCCESS){
 
     fprintf(stderr, "STEER: Initialize_log: failed to allocate memory "
 	    "for checkpoint logging\n");
     return REG_FAILURE;
   }
 
-  log->pSteer_cmds[0] = '\0';
-  /* pSteer_cmds_slot points to next free space in the buffer */
-  log->pSteer_cmds_slot = log->pSteer_cmds;
-
+  Init_log_entries(log, 0);
   for(i=0; i<log->max_entries; i++){
 
     log->entry[i].sent_to_steerer = REG_TRUE;
-    log->entry[i].num_param       = 0;
-
-    for(j=0; j<REG_MAX_NUM_STR_PARAMS; j++){
-      log->entry[i].param[j].handle = REG_PARAM_HANDLE_NOTSET;
-    }
   }
   return REG_SUCCESS;
 }
@@ -143,17 +134,14 @@ int Initialize_log(Chk_log_type *log, log_type_type log_type)
 
 int Finalize_log(Chk_log_type *log)
 {
-  if(log->entry != NULL){
-
-    free(log->entry);
-    log->entry = NULL;
-  }
+  Delete_log_entries(log);
   log->num_entries = 0;
   log->max_entries = REG_INITIAL_CHK_LOG_SIZE;
   /* Buffer for logged commands */
-  free(log->pSteer_cmds);
-  log->pSteer_cmds = NULL;
-  log->steer_cmds_bytes = 0;
+  Delete_msg_writer(&(log->steer_cmds));
+  if(log->param_send_all) free(log->param_send_all);
+  log->param_send_all = NULL;
+  log->num_param_send_all = 0;
 
   return REG_SUCCESS;
 }
@@ -257,257 +245,161 @@ int Save_log(Chk_log_type *log)
 int Log_to_xml(Chk_log_type *log, int handle, char **pchar,
 	       int *count, const int not_sent_only)
 {
-  int   size = BUFSIZ;
+  int             status;
+  Msg_writer_type msg;
 
-  if( !(*pchar = (char *)malloc(size*sizeof(char))) ){
+  *pchar = NULL;
+  *count = 0;
+
+  if(Init_msg_writer(&msg, BUFSIZ, REG_WIRE_XML) != REG_SUCCESS){
 
     fprintf(stderr, "STEER: Log_to_xml: malloc failed\n");
     return REG_FAILURE;
   }
 
-  *count = 0;
-
   if(log->log_type == PARAM){
-    return Param_log_to_xml(log, handle, pchar, count, not_sent_only);
+    status = Param_log_to_xml(log, handle, &msg, not_sent_only);
   }
   else if(log->log_type == CHKPT){
-    return Chk_log_to_xml(log, pchar, count, not_sent_only);
+    status = Chk_log_to_xml(log, &msg, not_sent_only);
   }
   else{
-    free(*pchar);
-    *pchar = NULL;
     fprintf(stderr, "STEER: ERROR: Log_to_xml: unknown log type\n");
+    status = REG_FAILURE;
+  }
+
+  if(status != REG_SUCCESS){
+    Delete_msg_writer(&msg);
     return REG_FAILURE;
   }
+
+  *count = (int)(msg.pos - msg.buf);
+  *pchar = Msg_writer_take_buf(&msg);
+
+  return REG_SUCCESS;
 }
 
 /*----------------------------------------------------------------*/
 
-int Chk_log_to_xml(Chk_log_type *log, char **pchar, int *count,
+int Chk_log_to_xml(Chk_log_type *log, Msg_writer_type *msg,
 		   const int not_sent_only)
 {
-  int   i, j, len;
-  char  entry[BUFSIZ];
-  char *pentry;
-  char *pbuf;
-  void *ptr;
-  int   size = BUFSIZ;
-  int   nbytes = 0;
-  int   bytes_left;
-
-  pbuf = *pchar;
+  int i, j;
+  int status = REG_SUCCESS;
 
-  for(i=0; i<log->num_entries; i++){
+  for(i=0; i<log->num_entries && status == REG_SUCCESS; i++){
 
     /* Check to see whether steerer already has this entry */
     if (not_sent_only && (log->entry[i].sent_to_steerer == REG_TRUE)) continue;
 
-    bytes_left = BUFSIZ;
-    pentry = entry;
-    nbytes = snprintf(pentry, bytes_left, "<Log_entry>\n"
-		      "<Key>%d</Key>\n"
-		      "<Chk_log_entry>"
-		      "<Chk_handle>%d</Chk_handle>\n"
-		      "<Chk_tag>%s</Chk_tag>\n",
-		      log->entry[i].key,
-		      log->entry[i].chk_handle,
-		      log->entry[i].chk_tag);
-
-#ifdef REG_DEBUG
-    /* Check for truncation of message */
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-      fprintf(stderr, "STEER: Chk_log_to_xml: message size exceeds BUFSIZ (%d)\n",
-	      BUFSIZ);
-      free(*pchar);
-      *pchar = NULL;
-      return REG_FAILURE;
+    status = Msg_writer_begin(msg, MSG_TAG_LOG_ENTRY);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(msg, MSG_TAG_KEY, log->entry[i].key);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_begin(msg, MSG_TAG_CHK_LOG_ENTRY);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(msg, MSG_TAG_CHK_HANDLE,
+				      log->entry[i].chk_handle);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(msg, MSG_TAG_CHK_TAG,
+					 log->entry[i].chk_tag);
     }
-#endif
-    bytes_left -= nbytes;
-    pentry += nbytes;
 
     /* Associated parameters are stored contiguously so need only
        loop over the no. of params that this entry has */
-    for(j=0; j<log->entry[i].num_param; j++){
-
-      nbytes = snprintf(pentry, bytes_left, "<Param>\n"
-			"<Handle>%d</Handle>\n"
-			"<Value>%s</Value>\n"
-			"</Param>\n",
-		        log->entry[i].param[j].handle,
-		        log->entry[i].param[j].value);
+    for(j=0; j<log->entry[i].num_param && status == REG_SUCCESS; j++){
 
-#ifdef REG_DEBUG
-      /* Check for truncation of message */
-      if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-	fprintf(stderr, "STEER: Chk_log_to_xml: message size exceeds BUFSIZ (%d)\n",
-		BUFSIZ);
-	free(*pchar);
-	*pchar = NULL;
-	return REG_FAILURE;
+      status = Msg_writer_begin(msg, MSG_TAG_PARAM);
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_int(msg, MSG_TAG_HANDLE,
+					log->entry[i].param[j].handle);
+      }
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_value(msg, MSG_TAG_VALUE,
+					  log->entry[i].param[j].type,
+					  &(log->entry[i].param[j].value));
+      }
+      if(status == REG_SUCCESS){
+	status = Msg_writer_end(msg, MSG_TAG_PARAM);
       }
-#endif
-      bytes_left -= nbytes;
-      pentry += nbytes;
     }
 
-    nbytes = snprintf(pentry, bytes_left, "</Chk_log_entry>\n"
-		                          "</Log_entry>\n");
-#ifdef REG_DEBUG
-    /* Check for truncation of message */
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-      fprintf(stderr, "STEER: Chk_log_to_xml: message size exceeds BUFSIZ (%d)\n",
-	      BUFSIZ);
-      free(*pchar);
-      *pchar = NULL;
-      return REG_FAILURE;
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(msg, MSG_TAG_CHK_LOG_ENTRY);
     }
-#endif
-    bytes_left -= nbytes;
-    pentry += nbytes;
-
-    len = strlen(entry);
-
-    if( (size - *count) < len){
-
-      size += ((len/BUFSIZ) + 1)*BUFSIZ;
-      if( !(ptr = realloc(*pchar, size*sizeof(char))) ){
-
-	fprintf(stderr, "STEER: Chk_log_to_xml: realloc failed\n");
-	free(*pchar);
-	*pchar = NULL;
-	return REG_FAILURE;
-      }
-
-      *pchar = (char *)ptr;
-      pbuf = &((*pchar)[*count]);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(msg, MSG_TAG_LOG_ENTRY);
     }
 
-    strncpy(pbuf, entry, len);
-    pbuf += len;
-    *count += len;
-
     /* Flag this entry as having been sent to steerer */
-    log->entry[i].sent_to_steerer = REG_TRUE;
+    if(status == REG_SUCCESS) log->entry[i].sent_to_steerer = REG_TRUE;
   }
 
-  *pbuf = 0;
+  if(status != REG_SUCCESS){
+    fprintf(stderr, "STEER: Chk_log_to_xml: failed to build log message\n");
+  }
 
-  return REG_SUCCESS;
+  return status;
 }
 
 /*----------------------------------------------------------------*/
 
-int Param_log_to_xml(Chk_log_type *log, int handle, char **pchar,
-		     int *count, const int not_sent_only)
+int Param_log_to_xml(Chk_log_type *log, int handle, Msg_writer_type *msg,
+		     const int not_sent_only)
 {
-  int   i, j, len;
-  char  entry[BUFSIZ];
-  char *pentry;
-  char *pbuf;
-  void *ptr;
-  int   size = BUFSIZ;
-  int   nbytes = 0;
-  int   bytes_left;
-
-  pbuf = *pchar;
+  int i, j;
+  int status = REG_SUCCESS;
 
-  for(i=0; i<log->num_entries; i++){
+  for(i=0; i<log->num_entries && status == REG_SUCCESS; i++){
 
     /* Check to see whether steerer already has this entry */
     if (not_sent_only && (log->entry[i].sent_to_steerer == REG_TRUE)) continue;
 
-    bytes_left = BUFSIZ;
-    pentry = entry;
-    nbytes = snprintf(pentry, bytes_left, "<Log_entry>\n"
-		      "<Key>%d</Key>\n",
-		      log->entry[i].key);
-
-#ifdef REG_DEBUG
-    /* Check for truncation of message */
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-      fprintf(stderr, "STEER: Param_log_to_xml: message size exceeds BUFSIZ (%d)\n",
-	      BUFSIZ);
-      free(*pchar);
-      *pchar = NULL;
-      return REG_FAILURE;
+    status = Msg_writer_begin(msg, MSG_TAG_LOG_ENTRY);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_int(msg, MSG_TAG_KEY, log->entry[i].key);
     }
-#endif
-    bytes_left -= nbytes;
-    pentry += nbytes;
 
     /* Associated parameters are stored contiguously so need only
        loop over the no. of params that this entry has */
-    for(j=0; j<log->entry[i].num_param; j++){
+    for(j=0; j<log->entry[i].num_param && status == REG_SUCCESS; j++){
 
-      if(log->entry[i].param[j].handle == handle){
+      /* We only want the parameter with the specified handle */
+      if(log->entry[i].param[j].handle != handle) continue;
 
-	nbytes = snprintf(pentry, bytes_left, "<Param>"
-			  "<Handle>%d</Handle><Value>%s</Value>"
-			  "</Param>\n",
-			  log->entry[i].param[j].handle,
-			  log->entry[i].param[j].value);
-
-#ifdef REG_DEBUG
-	/* Check for truncation of message */
-	if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-	  fprintf(stderr, "STEER: Param_log_to_xml: message size "
-		  "exceeds BUFSIZ (%d)\n", BUFSIZ);
-	  free(*pchar);
-	  *pchar = NULL;
-	  return REG_FAILURE;
-	}
-#endif
-	bytes_left -= nbytes;
-	pentry += nbytes;
-
-	/* We only want the parameter with the specified handle */
-	break;
+      status = Msg_writer_begin(msg, MSG_TAG_PARAM);
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_int(msg, MSG_TAG_HANDLE,
+					log->entry[i].param[j].handle);
       }
-    }
-
-    nbytes = snprintf(pentry, bytes_left, "</Log_entry>\n");
-#ifdef REG_DEBUG
-    /* Check for truncation of message */
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-      fprintf(stderr, "STEER: Param_log_to_xml: message size "
-	      "exceeds BUFSIZ (%d)\n", BUFSIZ);
-      free(*pchar);
-      *pchar = NULL;
-      return REG_FAILURE;
-    }
-#endif
-    bytes_left -= nbytes;
-    pentry += nbytes;
-
-    len = strlen(entry);
-
-    if( (size - *count) < len){
-
-      size += ((len/BUFSIZ) + 1)*BUFSIZ;
-      if( !(ptr = realloc(*pchar, size*sizeof(char))) ){
-
-	fprintf(stderr, "STEER: Param_log_to_xml: realloc failed\n");
-	free(*pchar);
-	*pchar = NULL;
-	return REG_FAILURE;
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_value(msg, MSG_TAG_VALUE,
+					  log->entry[i].param[j].type,
+					  &(log->entry[i].param[j].value));
       }
-
-      *pchar = (char *)ptr;
-      pbuf = &((*pchar)[*count]);
+      if(status == REG_SUCCESS){
+	status = Msg_writer_end(msg, MSG_TAG_PARAM);
+      }
+      break;
     }
 
-    strncpy(pbuf, entry, len);
-    pbuf += len;
-    *count += len;
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(msg, MSG_TAG_LOG_ENTRY);
+    }
 
     /* Flag this entry as having been sent to steerer */
-    log->entry[i].sent_to_steerer = REG_TRUE;
+    if(status == REG_SUCCESS) log->entry[i].sent_to_steerer = REG_TRUE;
   }
 
-  *pbuf = 0;
+  if(status != REG_SUCCESS){
+    fprintf(stderr, "STEER: Param_log_to_xml: failed to build log "
+	    "message\n");
+  }
 
-  return REG_SUCCESS;
+  return status;
 }
 
 /*----------------------------------------------------------------*/
@@ -515,106 +407,61 @@ int Param_log_to_xml(Chk_log_type *log, int handle, char **pchar,
 int Log_to_columns(Chk_log_type *log, char **pchar, int *count,
 		   const int not_sent_only)
 {
-  int   i, j, len;
-  int   size = BUFSIZ;
-  int   bytes_left;
-  int   nbytes;
-  char *pentry;
-  char *pbuf;
-  char  entry[BUFSIZ];
-  void *ptr;
+  int             i, j;
+  int             status;
+  Msg_writer_type msg;
+  const char     *value;
+  char            buf[REG_NUM_BUF_LEN];
+
+  *pchar = NULL;
+  *count = 0;
 
-  if( !(*pchar = (char *)malloc(size*sizeof(char))) ){
+  if(Init_msg_writer(&msg, BUFSIZ, REG_WIRE_XML) != REG_SUCCESS){
 
     fprintf(stderr, "STEER: Log_to_columns: malloc failed\n");
     return REG_FAILURE;
   }
+  status = REG_SUCCESS;
 
-  *count = 0;
-  pbuf = *pchar;
-
-  for(i=0; i<log->num_entries; i++){
+  for(i=0; i<log->num_entries && status == REG_SUCCESS; i++){
 
     /* Check to see whether steerer already has this entry */
     if (not_sent_only && (log->entry[i].sent_to_steerer == REG_TRUE)) continue;
-    bytes_left = BUFSIZ;
-    pentry = entry;
-    nbytes = snprintf(pentry, bytes_left, "%d", log->entry[i].key);
 
-#ifdef REG_DEBUG
-    /* Check for truncation of message */
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-      fprintf(stderr, "STEER: Log_to_columns: message size exceeds BUFSIZ (%d)\n",
-	      BUFSIZ);
-      free(*pchar);
-      *pchar = NULL;
-      return REG_FAILURE;
-    }
-#endif
-    bytes_left -= nbytes;
-    pentry += nbytes;
+    status = Msg_writer_int(&msg, log->entry[i].key);
 
     /* Associated parameters are stored contiguously so need only
        loop over the no. of params that this entry has */
-    for(j=0; j<log->entry[i].num_param; j++){
-
-      nbytes = snprintf(pentry, bytes_left, " %d %s",
-		        log->entry[i].param[j].handle,
-		        log->entry[i].param[j].value);
+    for(j=0; j<log->entry[i].num_param && status == REG_SUCCESS; j++){
 
-#ifdef REG_DEBUG
-      /* Check for truncation of message */
-      if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-	fprintf(stderr, "STEER: Log_to_columns: message size exceeds BUFSIZ (%d)\n",
-		BUFSIZ);
-	free(*pchar);
-	*pchar = NULL;
-	return REG_FAILURE;
+      status = Msg_writer_write(&msg, " ", 1);
+      if(status == REG_SUCCESS){
+	status = Msg_writer_int(&msg, log->entry[i].param[j].handle);
       }
-#endif
-      bytes_left -= nbytes;
-      pentry += nbytes;
-    }
-
-    nbytes = snprintf(pentry, bytes_left, "\n");
-#ifdef REG_DEBUG
-    /* Check for truncation of message */
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-      fprintf(stderr, "STEER: Log_to_columns: message size exceeds BUFSIZ (%d)\n",
-	      BUFSIZ);
-      free(*pchar);
-      *pchar = NULL;
-      return REG_FAILURE;
-    }
-#endif
-    bytes_left -= nbytes;
-    pentry += nbytes;
-
-    len = strlen(entry);
-
-    if( (size - *count) < len){
-
-      size += ((len/BUFSIZ) + 1)*BUFSIZ;
-      if( !(ptr = realloc(*pchar, size*sizeof(char))) ){
-
-	fprintf(stderr, "STEER: Log_to_columns: realloc failed\n");
-	free(*pchar);
-	*pchar = NULL;
-	return REG_FAILURE;
+      if(status == REG_SUCCESS){
+	status = Msg_writer_write(&msg, " ", 1);
+      }
+      if(status == REG_SUCCESS){
+	value = Param_value_to_string(log->entry[i].param[j].type,
+				      &(log->entry[i].param[j].value), buf);
+	status = Msg_writer_write(&msg, value, (int)strlen(value));
       }
-
-      *pchar = (char *)ptr;
-      pbuf = &((*pchar)[*count]);
     }
 
-    strncpy(pbuf, entry, len);
-    pbuf += len;
-    *count += len;
+    if(status == REG_SUCCESS) status = Msg_writer_write(&msg, "\n", 1);
 
     /* Flag this entry as having been sent to steerer */
-    log->entry[i].sent_to_steerer = REG_TRUE;
+    if(status == REG_SUCCESS) log->entry[i].sent_to_steerer = REG_TRUE;
+  }
+
+  if(status != REG_SUCCESS){
+    fprintf(stderr, "STEER: Log_to_columns: failed to build log\n");
+    Delete_msg_writer(&msg);
+    return REG_FAILURE;
   }
-  *pbuf = 0;
+
+  *count = (int)(msg.pos - msg.buf);
+  *pchar = Msg_writer_take_buf(&msg);
 
   return REG_SUCCESS;
 }
@@ -705,8 +552,10 @@ int Set_log_primary_key(Chk_log_type *log)
 
 int Log_param_values()
 {
+  int i;
   int index;
   int count;
+  Chk_log_entry_type *entry;
 
   if(Params_table.log_all == REG_FALSE)return REG_SUCCESS;
 
@@ -731,10 +580,16 @@ int Log_param_values()
   Param_log.entry[Param_log.num_entries].chk_handle = -99;
   count = 0;
 
-  for(index = 0; index<Params_table.max_entries; index++){
+  /* Make room for every parameter we might log */
+  if(Realloc_log_entry_params(&(Param_log.entry[Param_log.num_entries]),
+			      Params_table.num_live) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+  entry = &(Param_log.entry[Param_log.num_entries]);
+
+  for(i = 0; i<Params_table.num_live; i++){
 
-    if(Params_table.param[index].handle == REG_PARAM_HANDLE_NOTSET)
-      continue;
+    index = Params_table.live[i];
 
     if(Params_table.param[index].is_internal == REG_TRUE)continue;
 
@@ -743,19 +598,17 @@ int Log_param_values()
     /* We do not log 'raw binary' parameters */
     if(Params_table.param[index].type == REG_BIN)continue;
 
-    /* This is one we want - store its handle and current value */
-    Param_log.entry[Param_log.num_entries].param[count].handle =
-                                           Params_table.param[index].handle;
-
-    /* Update value associated with pointer */
+    /* This is one we want - update value associated with pointer */
     Get_ptr_value(&(Params_table.param[index]));
 
-    /* Save this value */
-    strcpy(Param_log.entry[Param_log.num_entries].param[count].value,
-           Params_table.param[index].value);
-
-    /* Storage for params associated with log entry is static */
-    if(++count >= REG_MAX_NUM_STR_PARAMS)break;
+    /* Save its handle and value */
+    if(Set_log_param_value(&(entry->param[count]),
+			   Params_table.param[index].handle,
+			   Params_table.param[index].type,
+			   &(Params_table.param[index].value)) != REG_SUCCESS){
+      return REG_FAILURE;
+    }
+    count++;
   }
 
   /* Store the no. of params this entry has */
@@ -776,6 +629,31 @@ int Log_param_values()
 
 /*----------------------------------------------------------------*/
 
+int Realloc_param_send_all(Chk_log_type *log, int num_param)
+{
+  int   i;
+  void *dum_ptr;
+
+  if(num_param <= log->num_param_send_all) return REG_SUCCESS;
+
+  if( !(dum_ptr = realloc(log->param_send_all, num_param*sizeof(int))) ){
+
+    fprintf(stderr, "STEER: Realloc_param_send_all: realloc failed\n");
+    return REG_FAILURE;
+  }
+  log->param_send_all = (int *)dum_ptr;
+
+  /* Logs of newly-registered parameters have not been sent yet */
+  for(i=log->num_param_send_all; i<num_param; i++){
+    log->param_send_all[i] = REG_TRUE;
+  }
+  log->num_param_send_all = num_param;
+
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
 int Emit_log(Chk_log_type *log, int handle)
 {
   int   size = 0;
@@ -785,6 +663,12 @@ int Emit_log(Chk_log_type *log, int handle)
   if(log->log_type == PARAM){
     index = Param_index_from_handle(&Params_table, handle);
     if(index == REG_PARAM_HANDLE_NOTSET)return REG_FAILURE;
+
+    /* One flag per slot in the table of parameters */
+    if((index >= log->num_param_send_all) &&
+       (Realloc_param_send_all(log, Params_table.max_entries) != REG_SUCCESS)){
+      return REG_FAILURE;
+    }
   }
 
   if(log->emit_in_progress == REG_TRUE){
@@ -901,11 +785,10 @@ int Emit_log(Chk_log_type *log, int handle)
 #endif
 
   /* Send log of steering commands */
-  if(strlen(log->pSteer_cmds) > 0){
+  if(log->steer_cmds.pos > log->steer_cmds.buf){
 
-    Emit_log_entries(log, log->pSteer_cmds, handle);
-    log->pSteer_cmds[0]='\0';
-    log->pSteer_cmds_slot = log->pSteer_cmds;
+    Emit_log_entries(log, log->steer_cmds.buf, handle);
+    Msg_writer_reset(&(log->steer_cmds));
   }
 
   if(return_status == REG_SUCCESS){
@@ -922,9 +805,10 @@ int Emit_log(Chk_log_type *log, int handle)
 
 int Emit_log_entries(Chk_log_type *log, char *buf, int handle)
 {
-  static char *pXmlBuf = NULL;
-  static char *pmsg_buf = NULL;
-  int          status;
+  static char    *pXmlBuf = NULL;
+  static char    *pmsg_buf = NULL;
+  int             status;
+  Msg_writer_type xml_entries;
 
   /* Zero the count of messages sent this time around */
   log->num_sent = 0;
@@ -947,12 +831,18 @@ int Emit_log_entries(Chk_log_type *log, char *buf, int handle)
 
   if(!strstr(pmsg_buf, "<Log_entry>")){
 
+    if(Init_msg_writer(&xml_entries, REG_SCRATCH_BUFFER_SIZE,
+		       REG_WIRE_XML) != REG_SUCCESS){
+      return REG_FAILURE;
+    }
+
     while(1){
-      pXmlBuf = Steer_lib_config.scratch_buffer;
+      Msg_writer_reset(&xml_entries);
 
-      status = Log_columns_to_xml(&pmsg_buf, Steer_lib_config.scratch_buffer,
+      status = Log_columns_to_xml(&pmsg_buf, &xml_entries,
 				  REG_SCRATCH_BUFFER_SIZE, handle);
       if(status == REG_FAILURE){
+	Delete_msg_writer(&xml_entries);
 	return REG_FAILURE;
       }
       else if(status == REG_EOD){
@@ -960,6 +850,7 @@ int Emit_log_entries(Chk_log_type *log, char *buf, int handle)
 	pmsg_buf = NULL;
       }
 
+      pXmlBuf = xml_entries.buf;
       while(Pack_send_log_entries(&pXmlBuf, &(log->num_sent))
 	    == REG_UNFINISHED){
 	log->num_sent = 0;
@@ -969,6 +860,7 @@ int Emit_log_entries(Chk_log_type *log, char *buf, int handle)
       log->num_sent = 0;
       if(status == REG_EOD) break;
     }
+    Delete_msg_writer(&xml_entries);
   }
   else{
     Pack_send_log_entries(&pmsg_buf, &(log->num_sent));
@@ -981,296 +873,206 @@ int Emit_log_entries(Chk_log_type *log, char *buf, int handle)
 
 int Pack_send_log_entries(char **pBuf, int *msg_count)
 {
-  char *msg_buf, *pmsg_buf;
-  char *plast = NULL;
-  char *pbuf1 = NULL;
-  char *pbuf2 = NULL;
-  char *pbuf3 = NULL;
-  void *pdum;
-  int   msg_buf_size;
-  int   tot_len = 0;
-  int   len;
-  int   nbytes;
-  int   rewind;
-  int   return_status = REG_SUCCESS;
-  int   bytes_left;
-
-  msg_buf_size = REG_MAX_MSG_SIZE;
-  if(!(msg_buf = (char *)malloc(msg_buf_size))){
-
-    fprintf(stderr, "STEER: Pack_send_log_entries: malloc failed\n");
+  Msg_writer_type msg;
+  char           *pentry;
+  char           *pend;
+  char           *pfirst = NULL;
+  int             num_in_msg = 0;
+  int             status = REG_SUCCESS;
+
+  if(Init_msg_writer(&msg, 0, REG_WIRE_XML) != REG_SUCCESS){
     return REG_FAILURE;
   }
 
   /* Pull each log entry out of the buffer and pack them into
      messages to the steerer */
-  pbuf1 = strstr(*pBuf, "<Log_entry>");
-  pbuf2 = pbuf1;
-  if(pbuf2){
-    if( (pbuf3 = strstr(pbuf2, "</Log_entry>")) ){
-      /* Increment ptr so as to include all of the "</Log_entry>" */
-      pbuf3 += 12;
-    }
-  }
+  pentry = strstr(*pBuf, "<Log_entry>");
 
-  while(pbuf3){
+  while(pentry && (pend = strstr(pentry, "</Log_entry>"))){
 
-    if(*msg_count > REG_MAX_NUM_LOG_MSG){
-      *pBuf = pbuf3;
-      free(msg_buf);
-      msg_buf = NULL;
-      return REG_UNFINISHED;
-    }
+    /* Include all of the "</Log_entry>" */
+    pend += 12;
 
-    if(tot_len == 0){
-      /* Begin the first message */
-      bytes_left = msg_buf_size;
-      pmsg_buf = msg_buf;
-      Write_xml_header(&pmsg_buf, &bytes_left);
-      pmsg_buf += sprintf(pmsg_buf, "<Steer_log>\n");
-      tot_len = (int)(pmsg_buf - msg_buf);
-    }
-    len = (int)(pbuf3 - pbuf2);
-
-    /* 35 = strlen("</Steer_log>\n</ReG_steer_message>\n"); */
-    if((tot_len + len) < (msg_buf_size - 35)){
-
-      /* Buffer has enough free space so add this entry to it */
-      plast = pmsg_buf;
-      strncpy(pmsg_buf, pbuf2, len);
-      pmsg_buf += len;
-      tot_len += len;
-    }
-    else if(!plast){
+    /* Send the message so far if this entry won't fit in it too -
+       35 = strlen("</Steer_log>\n</ReG_steer_message>\n") + 1 */
+    if(num_in_msg > 0 &&
+       ((int)(msg.pos - msg.buf) + (int)(pend - pentry) + 35) >
+       REG_MAX_MSG_SIZE){
 
-      /* We've not managed to fit a single entry into the buffer
-	 - time for a realloc... */
-      msg_buf_size *= 2;
-      if( !(pdum = realloc(msg_buf, msg_buf_size)) ){
-
-	free(msg_buf);
-	msg_buf = NULL;
-	fprintf(stderr, "STEER: Pack_send_log_entries: realloc failed\n");
-	return REG_FAILURE;
-      }
-      /* Allow for fact that realloc can return a ptr to a diff't
-	 chunk of memory (with any content intact though) */
-      pmsg_buf += (char *)pdum - msg_buf;
-      msg_buf = (char *)pdum;
-      continue;
+      if((status = Send_log_msg(&msg)) != REG_SUCCESS) break;
+      (*msg_count)++;
+      num_in_msg = 0;
     }
-    else{
-      /* Complete the xml message */
-      nbytes = snprintf(pmsg_buf, (msg_buf_size-tot_len),
-			"</Steer_log>\n");
-
-      rewind = (nbytes >= (msg_buf_size-tot_len-1) || (nbytes < 1));
-
-      if(!rewind){
-	pmsg_buf += nbytes;
-	tot_len += nbytes;
 
-	if(Write_xml_footer(&pmsg_buf, (msg_buf_size-tot_len))
-	                                             != REG_SUCCESS){
-	  rewind = 1;
-	}
-      }
-
-      if(rewind){
-
-	/* Can't fit the footer in remaining space in buffer - go
-	   back to last complete entry */
-	if(*plast == '\n')plast++;
-	tot_len = (int)(plast - msg_buf);
-	pmsg_buf = plast;
-	pmsg_buf += sprintf(pmsg_buf, "</Steer_log>\n");
-	tot_len = (int)(pmsg_buf - msg_buf);
-	pbuf3 = pbuf2;
-	pbuf2 = pbuf1;
-	len = (int)(pbuf3 - pbuf2);
-
-	if(Write_xml_footer(&pmsg_buf, (msg_buf_size-tot_len))
-	                                             != REG_SUCCESS){
-	  fprintf(stderr, "STEER: Pack_send_log_entries: error writing footer\n");
-	  free(msg_buf);
-	  msg_buf = NULL;
-	  return REG_FAILURE;
-	}
-      }
+    if(num_in_msg == 0){
 
-      if(Send_status_msg(msg_buf) != REG_SUCCESS){
-	*pBuf = pbuf2;
-	free(msg_buf);
-	msg_buf = NULL;
+      /* Sent enough for now - pick up from here next time */
+      if(*msg_count > REG_MAX_NUM_LOG_MSG){
+	*pBuf = pentry;
+	Delete_msg_writer(&msg);
 	return REG_UNFINISHED;
       }
-      (*msg_count)++;
 
       /* Begin the next message */
-      plast = NULL;
-      pmsg_buf = msg_buf;
-      bytes_left = msg_buf_size;
-      Write_xml_header(&pmsg_buf, &bytes_left);
-      pmsg_buf += sprintf(pmsg_buf, "<Steer_log>\n");
-
-      strncpy(pmsg_buf, pbuf2, len);
-      pmsg_buf += len;
-      tot_len = (int)(pmsg_buf - msg_buf);
+      Msg_writer_reset(&msg);
+      pfirst = pentry;
+      status = Msg_writer_header(&msg);
+      if(status == REG_SUCCESS){
+	status = Msg_writer_begin(&msg, MSG_TAG_STEER_LOG);
+      }
+      if(status != REG_SUCCESS) break;
     }
 
-    /* Look for next entry */
-    if(*pbuf3 == '\n')pbuf3++;
-    pbuf1 = pbuf2;
-    pbuf2 = pbuf3;
-    if( (pbuf3 = strstr(pbuf2, "</Log_entry>")) ){
-      /* Increment ptr so as to include all of the "</Log_entry>" */
-      pbuf3 += 12;
+    if(Msg_writer_write(&msg, pentry, (int)(pend - pentry)) != REG_SUCCESS ||
+       Msg_writer_write(&msg, "\n", 1) != REG_SUCCESS){
+      status = REG_FAILURE;
+      break;
     }
+    num_in_msg++;
+
+    /* Look for next entry */
+    pentry = strstr(pend, "<Log_entry>");
   }
 
-  /* Complete the xml message */
-  if(tot_len > 0){
-    pmsg_buf += sprintf(pmsg_buf, "</Steer_log>\n");
-    tot_len = (int)(pmsg_buf - msg_buf);
+  /* Complete the last message */
+  if(status == REG_SUCCESS && num_in_msg > 0){
+    if((status = Send_log_msg(&msg)) == REG_SUCCESS) (*msg_count)++;
+  }
+  Delete_msg_writer(&msg);
 
-    if(Write_xml_footer(&pmsg_buf, (msg_buf_size-tot_len))
-                                                   == REG_SUCCESS){
+  /* Couldn't send - try again from the first entry of the message
+     that failed */
+  if(status == REG_UNFINISHED){
+    *pBuf = pfirst;
+  }
+  else if(status != REG_SUCCESS){
+    fprintf(stderr, "STEER: Pack_send_log_entries: failed to build "
+	    "log message\n");
+  }
 
-      return_status = Send_status_msg(msg_buf);
-      if(return_status != REG_SUCCESS){
-	/* pbuf3 is NULL here 'cos we've broken out of while loop*/
-	*pBuf = pbuf1;
-	free(msg_buf);
-	msg_buf = NULL;
-	return REG_UNFINISHED;
-      }
-      (*msg_count)++;
-    }
-    else{
-      fprintf(stderr, "STEER: Pack_send_log_entries: error writing final footer\n");
-      return_status = REG_FAILURE;
-    }
+  return status;
+}
+
+/*----------------------------------------------------------------*/
+
+int Send_log_msg(Msg_writer_type *msg)
+{
+  if(Msg_writer_end(msg, MSG_TAG_STEER_LOG) != REG_SUCCESS ||
+     Msg_writer_footer(msg) != REG_SUCCESS){
+    return REG_FAILURE;
   }
 
-  free(msg_buf);
-  msg_buf = NULL;
-  return return_status;
+  if(Send_status_msg(msg->buf) != REG_SUCCESS){
+    return REG_UNFINISHED;
+  }
+
+  return REG_SUCCESS;
 }
 
 /*----------------------------------------------------------------*/
 
-int Log_columns_to_xml(char **buf, char* out_buf, int out_buf_size,
+int Log_columns_to_xml(char **buf, Msg_writer_type *msg, int max_bytes,
 		       int handle)
 {
   /* We have contents of log file as:
      key   <handle 0> <value 0> <handle 1> <value 1>... \n
      key++ <handle 0> <value 0> <handle 1> <value 1>... \n
      etc.
-  */
-  /* '2*' to allow for handle & value of each parameter and '+1'
-     for key of each log entry */
-#define max_num_fields  (2*REG_MAX_NUM_STR_PARAMS + 1)
+     Lines are scanned field by field so that there is no limit on
+     how many parameters a log entry holds. */
 #define max_field_length  32
-  char *fields[max_num_fields];
-  char *pbuf;
+  char  key[max_field_length+1];
+  char  value[max_field_length+1];
   char *ptr1;
   char *ptr2;
   char *ptr3;
   char *ptr4;
-  int   i, count;
-  int   nbytes = 0;
-  int   bytes_left = out_buf_size;
+  int   i, field;
+  int   matched, have_value;
+  int   status;
   char  handle_str[16];
 
-  if(!out_buf){
-    fprintf(stderr, "STEER: Log_columns_to_xml: ERROR: supplied ptr to "
-	    "output buffer is NULL\n");
-    return REG_FAILURE;
-  }
-
   sprintf(handle_str, "%d", handle);
 
-  fields[0] = malloc(max_num_fields*max_field_length*sizeof(char));
-  if(!fields[0]){
-    return REG_FAILURE;
-  }
-
-  for(i=1;i<max_num_fields;i++){
-    fields[i] = (char *)(fields[0] + i*max_field_length);
-  }
-
-  /* Set pointer to buffer to take output. ASSUME that this is
-     pre-allocated by caller and has room for out_buf_size bytes. */
-  pbuf = out_buf;
-
   ptr1 = *buf;
   while( (ptr2 = strstr(ptr1, "\n")) ){
 
+    /* Got as much as the caller wants this time round */
+    if((int)(msg->pos - msg->buf) >= max_bytes){
+      *buf = ptr1;
+      return REG_SUCCESS;
+    }
+
     ptr3 = ptr1;
-    count = 0;
-    while( (count < max_num_fields) &&
-	   ((ptr4 = strstr(ptr3, " ")) && ((void*)ptr4 < (void*)ptr2)) ){
+    field = 0;
+    matched = REG_FALSE;
+    have_value = REG_FALSE;
+    key[0] = '\0';
+
+    while(ptr3 < ptr2 && !have_value){
+
+      /* Find the end of this field */
+      ptr4 = ptr3;
+      while(ptr4 < ptr2 && *ptr4 != ' ') ptr4++;
+
       if( (i = (int)(ptr4 - ptr3)) > max_field_length){
 	/* So we can output the problematic field */
-	strncpy(fields[0], ptr3, i);
-	fields[0][i] = '\0';
+	memcpy(value, ptr3, max_field_length);
+	value[max_field_length] = '\0';
 	fprintf(stderr, "STEER: Log_columns_to_xml: ERROR: field "
-		">>%s<< exceeds maximum width of %d characters\n",
-		 fields[0], max_field_length);
-	free(fields[0]);
+		">>%s...<< exceeds maximum width of %d characters\n",
+		 value, max_field_length);
 	return REG_FAILURE;
       }
-      memcpy(fields[count], ptr3, i);
-      (fields[count])[i] = '\0';
+
+      if(field == 0){
+	memcpy(key, ptr3, i);
+	key[i] = '\0';
+      }
+      else if(field % 2){
+	/* Only pull out the parameter with the requested handle */
+	matched = ((i == (int)strlen(handle_str)) &&
+		   !strncmp(ptr3, handle_str, i));
+      }
+      else if(matched){
+	memcpy(value, ptr3, i);
+	value[i] = '\0';
+	have_value = REG_TRUE;
+      }
+      field++;
+
       ptr3 = ptr4;
-      while(*(++ptr3) == ' '){}/* Cope with multiple blank spaces */
-      count++;
+      while(ptr3 < ptr2 && *ptr3 == ' ') ptr3++; /* Cope with multiple
+						      blank spaces */
     }
-    memcpy(fields[count], ptr3, ptr2-ptr3);
-    (fields[count])[ptr2-ptr3] = '\0';
-    count++;
 
-    nbytes = snprintf(pbuf, bytes_left, "<Log_entry><Key>%s</Key><Param>",
-		      fields[0]);
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-      *buf = ptr1;
-      free(fields[0]);
-      return REG_SUCCESS;
+    status = Msg_writer_begin(msg, MSG_TAG_LOG_ENTRY);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(msg, MSG_TAG_KEY, key);
     }
-    pbuf += nbytes;
-    bytes_left -= nbytes;
-
-    for(i=1;i<count;i+=2){
-      /* Only pull out the parameter with the requested handle */
-      if(strcmp(handle_str, fields[i]) == 0){
-	nbytes = snprintf(pbuf, bytes_left,
-			  "<Handle>%s</Handle><Value>%s</Value>",
-			  fields[i], fields[i+1]);
-	if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-	  *buf = ptr1;
-	  free(fields[0]);
-	  return REG_SUCCESS;
-	}
-	pbuf += nbytes;
-	bytes_left -= nbytes;
-	break;
+    if(status == REG_SUCCESS){
+      status = Msg_writer_begin(msg, MSG_TAG_PARAM);
+    }
+    if(status == REG_SUCCESS && have_value){
+      status = Msg_writer_element_string(msg, MSG_TAG_HANDLE, handle_str);
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_string(msg, MSG_TAG_VALUE, value);
       }
     }
-    nbytes = snprintf(pbuf, bytes_left, "</Param></Log_entry>\n");
-    if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
-      *buf = ptr1;
-      free(fields[0]);
-      return REG_SUCCESS;
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(msg, MSG_TAG_PARAM);
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(msg, MSG_TAG_LOG_ENTRY);
+    }
+    if(status != REG_SUCCESS){
+      fprintf(stderr, "STEER: Log_columns_to_xml: failed to build log\n");
+      return REG_FAILURE;
     }
-    pbuf += nbytes;
-    bytes_left -= nbytes;
 
     ptr1 = ptr2 + 1;
   }
 
-  pbuf = '\0';
-  free(fields[0]);
-
   return REG_EOD;
 }
 
@@ -1278,11 +1080,10 @@ int Log_columns_to_xml(char **buf, char* out_buf, int out_buf_size,
 
 int Log_control_msg(struct control_struct *control)
 {
-  char      *pbuf;
-  static int seq_num_index   = -1;
-  int        nbytes;
-  int        bytes_free;
-  void      *pdum;
+  static int           seq_num_index = -1;
+  Msg_writer_type     *msg = &(Chk_log.steer_cmds);
+  int                  start;
+  int                  status;
   struct cmd_struct   *ctrl;
   struct param_struct *param;
 
@@ -1298,91 +1099,91 @@ int Log_control_msg(struct control_struct *control)
     }
   }
 
-  pbuf = Chk_log.pSteer_cmds_slot;
-  bytes_free = Chk_log.steer_cmds_bytes - (int)(pbuf - Chk_log.pSteer_cmds);
+  /* So we can back out a partly-written entry */
+  start = (int)(msg->pos - msg->buf);
 
-  nbytes = snprintf(pbuf, bytes_free, "<Log_entry>\n"
-		    "<Seq_num>%s</Seq_num>\n"
-		    "<Steer_log_entry>\n",
-		    Params_table.param[seq_num_index].value);
-
-  if(nbytes >= (REG_MAX_STRING_LENGTH-1) || (nbytes < 1)){
+  status = Msg_writer_begin(msg, MSG_TAG_LOG_ENTRY);
+  if(status == REG_SUCCESS){
+    status = Msg_writer_write(msg, "<Seq_num>", 9);
+  }
+  if(status == REG_SUCCESS){
+    status = Msg_writer_int(msg, Params_table.param[seq_num_index].value.i);
+  }
+  if(status == REG_SUCCESS){
+    status = Msg_writer_write(msg, "</Seq_num>\n<Steer_log_entry>\n", 29);
+  }
 
-    if(!(pdum = realloc(Chk_log.pSteer_cmds, 2*Chk_log.steer_cmds_bytes))){
+  for(ctrl = control->first_cmd; ctrl && status == REG_SUCCESS;
+      ctrl = ctrl->next){
 
-      fprintf(stderr, "STEER: Log_control_msg: failed to realloc log buffer\n");
-      /* Terminate buffer at end of last complete entry */
-      *(Chk_log.pSteer_cmds_slot) = '\0';
-      return REG_FAILURE;
+    status = Msg_writer_begin(msg, MSG_TAG_COMMAND);
+    if(status == REG_SUCCESS && ctrl->id){
+      status = Msg_writer_element_string(msg, MSG_TAG_CMD_ID,
+					 (char *)(ctrl->id));
+    }
+    else if(status == REG_SUCCESS && ctrl->name){
+      status = Msg_writer_element_string(msg, MSG_TAG_CMD_NAME,
+					 (char *)(ctrl->name));
     }
-    else{
 
-      Chk_log.steer_cmds_bytes *= 2;
-      bytes_free += Chk_log.steer_cmds_bytes;
-      Chk_log.pSteer_cmds = (char *)pdum;
-      pbuf = Chk_log.pSteer_cmds_slot;
+    for(param = ctrl->first_param; param && status == REG_SUCCESS;
+	param = param->next){
 
-      nbytes = snprintf(pbuf, bytes_free, "<Log_entry>\n"
-			"<Seq_num>%s</Seq_num>\n"
-			"<Steer_log_entry>\n",
-			Params_table.param[seq_num_index].value);
-    }
-  }
-  pbuf += nbytes;
-  bytes_free -= nbytes;
-
-  if(control->first_cmd){
-    ctrl = control->first_cmd;
-    while(ctrl){
-      if(ctrl->id){
-	nbytes = snprintf(pbuf, bytes_free, "<Command><Cmd_id>%s</Cmd_id>",
-			  (char*)(ctrl->id));
-	pbuf += nbytes;
-	bytes_free -= nbytes;
+      status = Msg_writer_begin(msg, MSG_TAG_CMD_PARAM);
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_string(msg, MSG_TAG_HANDLE,
+					   (char *)(param->handle));
       }
-      else if(ctrl->name){
-	nbytes = snprintf(pbuf, bytes_free, "<Command><Cmd_name>%s</Cmd_name>",
-			  (char*)(ctrl->name));
-	pbuf += nbytes;
-	bytes_free -= nbytes;
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_string(msg, MSG_TAG_VALUE,
+					   (char *)(param->value));
       }
-      if(ctrl->first_param){
-	param = ctrl->first_param;
-        while(param){
-	   nbytes = snprintf(pbuf, bytes_free, "<Cmd_param><Handle>"
-			     "%s</Handle><Value>%s</Value></Cmd_param>",
-			     (char*)(param->handle),
-			     (char*)(param->value));
-	   pbuf += nbytes;
-	   bytes_free -= nbytes;
-	   /* ARPDBG - check for buffer overrun */
-	   param = param->next;
-	}
+      if(status == REG_SUCCESS){
+	status = Msg_writer_end(msg, MSG_TAG_CMD_PARAM);
       }
-      nbytes = snprintf(pbuf, bytes_free, "</Command>");
-      pbuf += nbytes;
-      bytes_free -= nbytes;
-      ctrl = ctrl->next;
+    }
+
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(msg, MSG_TAG_COMMAND);
     }
   }
 
-  if(control->first_param){
-    param = control->first_param;
-    while(param){
-      nbytes = snprintf(pbuf, bytes_free, "<Param><Handle>"
-			"%s</Handle><Value>%s</Value></Param>",
-			(char*)(param->handle), (char*)(param->value));
-      bytes_free -= nbytes;
-      pbuf += nbytes;
-      param = param->next;
+  for(param = control->first_param; param && status == REG_SUCCESS;
+      param = param->next){
+
+    status = Msg_writer_begin(msg, MSG_TAG_PARAM);
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(msg, MSG_TAG_HANDLE,
+					 (char *)(param->handle));
+    }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_element_string(msg, MSG_TAG_VALUE,
+					 (char *)(param->value));
     }
+    if(status == REG_SUCCESS){
+      status = Msg_writer_end(msg, MSG_TAG_PARAM);
+    }
+  }
+
+  if(status == REG_SUCCESS){
+    status = Msg_writer_write(msg, "</Steer_log_entry>\n", 19);
+  }
+  if(status == REG_SUCCESS){
+    status = Msg_writer_end(msg, MSG_TAG_LOG_ENTRY);
   }
 
-  pbuf += sprintf(pbuf, "</Steer_log_entry>\n"
-		  "</Log_entry>\n");
+  if(status != REG_SUCCESS){
 
-  /* Point to next free space in buffer */
-  Chk_log.pSteer_cmds_slot = pbuf;
+    fprintf(stderr, "STEER: Log_control_msg: failed to log control "
+	    "message\n");
+    /* Terminate buffer at end of last complete entry */
+    if(msg->buf){
+      msg->pos = msg->buf + start;
+      *(msg->pos) = '\0';
+    }
+    msg->depth = 0;
+    return REG_FAILURE;
+  }
 
   return REG_SUCCESS;
 }
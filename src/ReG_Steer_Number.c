@@ -0,0 +1,744 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+/** @internal
+    @file ReG_Steer_Number.c
+    @brief Source file for converting floating point parameter values
+    to and from text.
+
+    The formatting follows Florian Loitsch's Grisu2 algorithm ("Printing
+    Floating-Point Numbers Quickly and Accurately with Integers", PLDI
+    2010): the value and the two halfway points to its neighbours are
+    scaled by a cached power of ten into 64-bit integers and then as few
+    digits as possible are generated that lie strictly between the
+    halfway points. Parsing uses Clinger's fast path, which is exact
+    whenever both the decimal significand and the power of ten are
+    exactly representable.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_Config.h"
+#include "ReG_Steer_types.h"
+#include "ReG_Steer_Number.h"
+
+#include <ctype.h>
+#include <float.h>
+#include <string.h>
+#include <stdlib.h>
+
+/** @internal A floating point value as an unsigned 64-bit significand
+    and a binary exponent: f*2^e */
+typedef struct {
+  unsigned long long f;
+  int                e;
+} diy_fp;
+
+/** @internal Normalized powers of ten from 10^-348 to 10^340 in steps
+    of 8, each rounded to 64 bits */
+static const diy_fp Cached_powers[] = {
+  {0xfa8fd5a0081c0288ULL, -1220},
+  {0xbaaee17fa23ebf76ULL, -1193},
+  {0x8b16fb203055ac76ULL, -1166},
+  {0xcf42894a5dce35eaULL, -1140},
+  {0x9a6bb0aa55653b2dULL, -1113},
+  {0xe61acf033d1a45dfULL, -1087},
+  {0xab70fe17c79ac6caULL, -1060},
+  {0xff77b1fcbebcdc4fULL, -1034},
+  {0xbe5691ef416bd60cULL, -1007},
+  {0x8dd01fad907ffc3cULL, -980},
+  {0xd3515c2831559a83ULL, -954},
+  {0x9d71ac8fada6c9b5ULL, -927},
+  {0xea9c227723ee8bcbULL, -901},
+  {0xaecc49914078536dULL, -874},
+  {0x823c12795db6ce57ULL, -847},
+  {0xc21094364dfb5637ULL, -821},
+  {0x9096ea6f3848984fULL, -794},
+  {0xd77485cb25823ac7ULL, -768},
+  {0xa086cfcd97bf97f4ULL, -741},
+  {0xef340a98172aace5ULL, -715},
+  {0xb23867fb2a35b28eULL, -688},
+  {0x84c8d4dfd2c63f3bULL, -661},
+  {0xc5dd44271ad3cdbaULL, -635},
+  {0x936b9fcebb25c996ULL, -608},
+  {0xdbac6c247d62a584ULL, -582},
+  {0xa3ab66580d5fdaf6ULL, -555},
+  {0xf3e2f893dec3f126ULL, -529},
+  {0xb5b5ada8aaff80b8ULL, -502},
+  {0x87625f056c7c4a8bULL, -475},
+  {0xc9bcff6034c13053ULL, -449},
+  {0x964e858c91ba2655ULL, -422},
+  {0xdff9772470297ebdULL, -396},
+  {0xa6dfbd9fb8e5b88fULL, -369},
+  {0xf8a95fcf88747d94ULL, -343},
+  {0xb94470938fa89bcfULL, -316},
+  {0x8a08f0f8bf0f156bULL, -289},
+  {0xcdb02555653131b6ULL, -263},
+  {0x993fe2c6d07b7facULL, -236},
+  {0xe45c10c42a2b3b06ULL, -210},
+  {0xaa242499697392d3ULL, -183},
+  {0xfd87b5f28300ca0eULL, -157},
+  {0xbce5086492111aebULL, -130},
+  {0x8cbccc096f5088ccULL, -103},
+  {0xd1b71758e219652cULL, -77},
+  {0x9c40000000000000ULL, -50},
+  {0xe8d4a51000000000ULL, -24},
+  {0xad78ebc5ac620000ULL, 3},
+  {0x813f3978f8940984ULL, 30},
+  {0xc097ce7bc90715b3ULL, 56},
+  {0x8f7e32ce7bea5c70ULL, 83},
+  {0xd5d238a4abe98068ULL, 109},
+  {0x9f4f2726179a2245ULL, 136},
+  {0xed63a231d4c4fb27ULL, 162},
+  {0xb0de65388cc8ada8ULL, 189},
+  {0x83c7088e1aab65dbULL, 216},
+  {0xc45d1df942711d9aULL, 242},
+  {0x924d692ca61be758ULL, 269},
+  {0xda01ee641a708deaULL, 295},
+  {0xa26da3999aef774aULL, 322},
+  {0xf209787bb47d6b85ULL, 348},
+  {0xb454e4a179dd1877ULL, 375},
+  {0x865b86925b9bc5c2ULL, 402},
+  {0xc83553c5c8965d3dULL, 428},
+  {0x952ab45cfa97a0b3ULL, 455},
+  {0xde469fbd99a05fe3ULL, 481},
+  {0xa59bc234db398c25ULL, 508},
+  {0xf6c69a72a3989f5cULL, 534},
+  {0xb7dcbf5354e9beceULL, 561},
+  {0x88fcf317f22241e2ULL, 588},
+  {0xcc20ce9bd35c78a5ULL, 614},
+  {0x98165af37b2153dfULL, 641},
+  {0xe2a0b5dc971f303aULL, 667},
+  {0xa8d9d1535ce3b396ULL, 694},
+  {0xfb9b7cd9a4a7443cULL, 720},
+  {0xbb764c4ca7a44410ULL, 747},
+  {0x8bab8eefb6409c1aULL, 774},
+  {0xd01fef10a657842cULL, 800},
+  {0x9b10a4e5e9913129ULL, 827},
+  {0xe7109bfba19c0c9dULL, 853},
+  {0xac2820d9623bf429ULL, 880},
+  {0x80444b5e7aa7cf85ULL, 907},
+  {0xbf21e44003acdd2dULL, 933},
+  {0x8e679c2f5e44ff8fULL, 960},
+  {0xd433179d9c8cb841ULL, 986},
+  {0x9e19db92b4e31ba9ULL, 1013},
+  {0xeb96bf6ebadf77d9ULL, 1039},
+  {0xaf87023b9bf0ee6bULL, 1066}};
+
+/** @internal Exponent of the first entry of Cached_powers */
+#define REG_CACHED_POWERS_MIN_EXP10 (-348)
+
+static const unsigned int Pow10_32[] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000,
+  1000000000
+};
+
+/** @internal Number of entries in Pow10_64 */
+#define REG_NUM_POW10_64 20
+
+static const unsigned long long Pow10_64[REG_NUM_POW10_64] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+  10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+  100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+  100000000000000000ULL, 1000000000000000000ULL,
+  10000000000000000000ULL
+};
+
+/** @internal Powers of ten that are exactly representable as a
+    double */
+static const double Exact_pow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** @internal Powers of ten that are exactly representable as a
+    float */
+static const float Exact_pow10_flt[] = {
+  1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+/* The fast paths rely on each multiplication or division being
+   rounded only once, which is not the case on targets (such as x87)
+   that evaluate in extended precision */
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0 || FLT_EVAL_METHOD == 1)
+#define REG_EXACT_DBL_ARITHMETIC 1
+#else
+#define REG_EXACT_DBL_ARITHMETIC 0
+#endif
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#define REG_EXACT_FLT_ARITHMETIC 1
+#else
+#define REG_EXACT_FLT_ARITHMETIC 0
+#endif
+
+/** @internal Most significant decimal digits that are accumulated when
+    parsing; 10^19 still fits in an unsigned long long */
+#define REG_MAX_PARSE_DIGITS 19
+
+/*----------------------------------------------------------------*/
+
+static diy_fp Diy_fp_normalize(diy_fp x)
+{
+  while(!(x.f & 0xffc0000000000000ULL)){
+    x.f <<= 10;
+    x.e -= 10;
+  }
+  while(!(x.f & 0x8000000000000000ULL)){
+    x.f <<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+/*----------------------------------------------------------------*/
+
+static diy_fp Diy_fp_multiply(diy_fp x, diy_fp y)
+{
+  diy_fp             r;
+  unsigned long long a = x.f >> 32, b = x.f & 0xffffffffULL;
+  unsigned long long c = y.f >> 32, d = y.f & 0xffffffffULL;
+  unsigned long long ac = a*c, bc = b*c, ad = a*d, bd = b*d;
+  unsigned long long tmp;
+
+  tmp = (bd >> 32) + (ad & 0xffffffffULL) + (bc & 0xffffffffULL);
+  /* Round to nearest */
+  tmp += 1ULL << 31;
+
+  r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  r.e = x.e + y.e + 64;
+  return r;
+}
+
+/*----------------------------------------------------------------*/
+
+/** @internal
+    @param e Binary exponent of the (normalized) upper boundary
+    @param K On exit, the decimal exponent of the power returned,
+    negated
+
+    Pick the cached power of ten c that brings the product of the
+    upper boundary and c into the range used by Grisu_digits. */
+static diy_fp Cached_power(int e, int *K)
+{
+  double dk = (-61 - e)*0.30102999566398114 + 347;
+  int    k = (int)dk;
+  int    index;
+
+  if(dk - k > 0.0) k++;
+
+  index = (k >> 3) + 1;
+  *K = -(REG_CACHED_POWERS_MIN_EXP10 + index*8);
+
+  return Cached_powers[index];
+}
+
+/*----------------------------------------------------------------*/
+
+static void Grisu_round(char *buf, int len, unsigned long long delta,
+			unsigned long long rest,
+			unsigned long long ten_kappa,
+			unsigned long long wp_w)
+{
+  /* Move the last digit down while that brings it closer to the
+     value and keeps it within the boundaries */
+  while(rest < wp_w && delta - rest >= ten_kappa &&
+	(rest + ten_kappa < wp_w ||
+	 wp_w - rest > rest + ten_kappa - wp_w)){
+    buf[len - 1]--;
+    rest += ten_kappa;
+  }
+}
+
+/*----------------------------------------------------------------*/
+
+/** @internal
+    @param W The scaled value
+    @param Mp The scaled upper boundary
+    @param delta Distance between the scaled boundaries
+    @param buf Buffer for the digits (not terminated)
+    @param K Decimal exponent, updated so that the digits times
+    10^K are the value
+
+    Generate the shortest run of digits lying between the boundaries.
+    @return The number of digits generated */
+static int Grisu_digits(diy_fp W, diy_fp Mp, unsigned long long delta,
+			char *buf, int *K)
+{
+  unsigned long long one_f = 1ULL << -Mp.e;
+  unsigned long long wp_w = Mp.f - W.f;
+  unsigned int       p1 = (unsigned int)(Mp.f >> -Mp.e);
+  unsigned long long p2 = Mp.f & (one_f - 1);
+  unsigned long long tmp;
+  unsigned int       d;
+  int                kappa = 1;
+  int                len = 0;
+
+  while(kappa < 10 && p1 >= Pow10_32[kappa]) kappa++;
+
+  /* Integral part */
+  while(kappa > 0){
+    d = p1/Pow10_32[kappa - 1];
+    p1 %= Pow10_32[kappa - 1];
+    if(d || len) buf[len++] = (char)('0' + d);
+    kappa--;
+
+    tmp = ((unsigned long long)p1 << -Mp.e) + p2;
+    if(tmp <= delta){
+      *K += kappa;
+      Grisu_round(buf, len, delta, tmp,
+		  (unsigned long long)Pow10_32[kappa] << -Mp.e, wp_w);
+      return len;
+    }
+  }
+
+  /* Fractional part */
+  for(;;){
+    p2 *= 10;
+    delta *= 10;
+    d = (unsigned int)(p2 >> -Mp.e);
+    if(d || len) buf[len++] = (char)('0' + d);
+    p2 &= one_f - 1;
+    kappa--;
+
+    if(p2 < delta){
+      *K += kappa;
+      Grisu_round(buf, len, delta, p2, one_f,
+		  -kappa < REG_NUM_POW10_64 ? wp_w*Pow10_64[-kappa] : 0);
+      return len;
+    }
+  }
+}
+
+/*----------------------------------------------------------------*/
+
+/** @internal
+    @param v The value, not normalized
+    @param lower_closer Whether the next value down is closer than
+    the next value up (@p v is an exact power of two)
+    @param buf Buffer for the digits
+    @param K On exit the decimal exponent of the digits
+
+    Run Grisu2 on a value that has already been taken apart into a
+    significand and exponent.
+    @return The number of digits */
+static int Grisu2(diy_fp v, int lower_closer, char *buf, int *K)
+{
+  diy_fp w, w_m, w_p, c_mk;
+
+  /* Halfway points to the neighbouring values */
+  w_p.f = (v.f << 1) + 1;
+  w_p.e = v.e - 1;
+  w_p = Diy_fp_normalize(w_p);
+
+  if(lower_closer){
+    w_m.f = (v.f << 2) - 1;
+    w_m.e = v.e - 2;
+  }
+  else{
+    w_m.f = (v.f << 1) - 1;
+    w_m.e = v.e - 1;
+  }
+  w_m.f <<= w_m.e - w_p.e;
+  w_m.e = w_p.e;
+
+  w = Diy_fp_normalize(v);
+
+  c_mk = Cached_power(w_p.e, K);
+  w = Diy_fp_multiply(w, c_mk);
+  w_p = Diy_fp_multiply(w_p, c_mk);
+  w_m = Diy_fp_multiply(w_m, c_mk);
+
+  /* Shrink the interval to allow for the rounding in the products */
+  w_m.f++;
+  w_p.f--;
+
+  return Grisu_digits(w, w_p, w_p.f - w_m.f, buf, K);
+}
+
+/*----------------------------------------------------------------*/
+
+/** @internal
+    @param buf Buffer holding @p len digits (and space after them)
+    @param len Number of digits
+    @param k Decimal exponent of the digits
+
+    Lay the digits out as a plain number for moderate exponents and
+    with an exponent otherwise, in the manner of "%g".
+    @return Length of the resulting string */
+static int Place_digits(char *buf, int len, int k)
+{
+  int kk = len + k; /* 10^(kk-1) <= value < 10^kk */
+  int i, exp10;
+
+  if(len <= kk && kk <= 21){
+    /* Integer: 1234e2 -> 123400 */
+    for(i = len; i < kk; i++) buf[i] = '0';
+    len = kk;
+  }
+  else if(0 < kk && kk <= 21){
+    /* 1234e-2 -> 12.34 */
+    memmove(&buf[kk + 1], &buf[kk], (size_t)(len - kk));
+    buf[kk] = '.';
+    len++;
+  }
+  else if(-6 < kk && kk <= 0){
+    /* 1234e-6 -> 0.001234 */
+    memmove(&buf[2 - kk], buf, (size_t)len);
+    buf[0] = '0';
+    buf[1] = '.';
+    for(i = 2; i < 2 - kk; i++) buf[i] = '0';
+    len += 2 - kk;
+  }
+  else{
+    /* 1234e30 -> 1.234e+33 */
+    if(len > 1){
+      memmove(&buf[2], &buf[1], (size_t)(len - 1));
+      buf[1] = '.';
+      len++;
+    }
+    buf[len++] = 'e';
+    exp10 = kk - 1;
+    if(exp10 < 0){
+      buf[len++] = '-';
+      exp10 = -exp10;
+    }
+    else{
+      buf[len++] = '+';
+    }
+    if(exp10 >= 100){
+      buf[len++] = (char)('0' + exp10/100);
+      exp10 %= 100;
+      buf[len++] = (char)('0' + exp10/10);
+    }
+    else if(exp10 >= 10){
+      buf[len++] = (char)('0' + exp10/10);
+    }
+    buf[len++] = (char)('0' + exp10%10);
+  }
+
+  buf[len] = '\0';
+  return len;
+}
+
+/*----------------------------------------------------------------*/
+
+/** @internal
+    @param v Significand and exponent of the value
+    @param lower_closer Whether the next value down is closer than
+    the next value up
+    @param negative Whether the value is negative
+    @param buf Output buffer
+
+    Common tail of Format_double() and Format_float() for finite
+    values. */
+static int Format_fp(diy_fp v, int lower_closer, int negative,
+		     char *buf)
+{
+  int len, K;
+
+  if(v.f == 0){
+    len = 0;
+    if(negative) buf[len++] = '-';
+    buf[len++] = '0';
+    buf[len] = '\0';
+    return len;
+  }
+
+  if(negative){
+    buf[0] = '-';
+    buf++;
+  }
+
+  len = Grisu2(v, lower_closer, buf, &K);
+  return Place_digits(buf, len, K) + (negative ? 1 : 0);
+}
+
+/*----------------------------------------------------------------*/
+
+/** @internal Write "nan", "inf" or "-inf" into @p buf */
+static int Format_special(int is_nan, int negative, char *buf)
+{
+  if(is_nan){
+    strcpy(buf, "nan");
+  }
+  else{
+    strcpy(buf, negative ? "-inf" : "inf");
+  }
+  return (int)strlen(buf);
+}
+
+/*----------------------------------------------------------------*/
+
+int Format_double(double value, char *buf)
+{
+  unsigned long long bits;
+  int                biased_exp;
+  diy_fp             v;
+
+  memcpy(&bits, &value, sizeof(double));
+
+  biased_exp = (int)((bits >> 52) & 0x7ff);
+  v.f = bits & 0x000fffffffffffffULL;
+
+  if(biased_exp == 0x7ff){
+    return Format_special(v.f != 0, (int)(bits >> 63), buf);
+  }
+
+  if(biased_exp != 0){
+    v.f += 0x0010000000000000ULL;
+    v.e = biased_exp - 1075;
+  }
+  else{
+    /* Subnormal */
+    v.e = -1074;
+  }
+
+  return Format_fp(v, v.f == 0x0010000000000000ULL && biased_exp > 1,
+		   (int)(bits >> 63), buf);
+}
+
+/*----------------------------------------------------------------*/
+
+int Format_float(float value, char *buf)
+{
+  unsigned int bits;
+  int          biased_exp;
+  diy_fp       v;
+
+  memcpy(&bits, &value, sizeof(float));
+
+  biased_exp = (int)((bits >> 23) & 0xff);
+  v.f = bits & 0x007fffff;
+
+  if(biased_exp == 0xff){
+    return Format_special(v.f != 0, (int)(bits >> 31), buf);
+  }
+
+  if(biased_exp != 0){
+    v.f += 0x00800000;
+    v.e = biased_exp - 150;
+  }
+  else{
+    v.e = -149;
+  }
+
+  return Format_fp(v, v.f == 0x00800000 && biased_exp > 1,
+		   (int)(bits >> 31), buf);
+}
+
+/*----------------------------------------------------------------*/
+
+/** @internal
+    @param str The string to read
+    @param significand On exit, up to REG_MAX_PARSE_DIGITS leading
+    significant digits
+    @param ndigits On exit, the number of significant digits held in
+    @p significand
+    @param exp10 On exit, the decimal exponent to apply to
+    @p significand
+    @param negative On exit, whether there was a minus sign
+
+    Split a plain decimal number into its significand and exponent.
+    @return REG_SUCCESS if @p str held a plain decimal number whose
+    digits all fit into @p significand, REG_FAILURE otherwise (it may
+    still be a number that the C library can read) */
+static int Split_decimal(const char *str, unsigned long long *significand,
+			 int *ndigits, int *exp10, int *negative)
+{
+  const char        *p = str;
+  unsigned long long m = 0;
+  int                n = 0, e = 0, exp_val = 0, exp_neg = 0;
+  int                seen_digit = 0;
+
+  while(isspace((unsigned char)*p)) p++;
+
+  *negative = 0;
+  if(*p == '-' || *p == '+'){
+    *negative = (*p == '-');
+    p++;
+  }
+
+  for(; *p >= '0' && *p <= '9'; p++){
+    seen_digit = 1;
+    if(m == 0 && *p == '0') continue;
+    if(n < REG_MAX_PARSE_DIGITS){
+      m = m*10 + (unsigned long long)(*p - '0');
+      n++;
+    }
+    else{
+      /* Digits we cannot hold only matter if they are not zero */
+      if(*p != '0') return REG_FAILURE;
+      e++;
+    }
+  }
+
+  if(*p == '.'){
+    for(p++; *p >= '0' && *p <= '9'; p++){
+      seen_digit = 1;
+      if(m == 0 && *p == '0'){
+	e--;
+	continue;
+      }
+      if(n < REG_MAX_PARSE_DIGITS){
+	m = m*10 + (unsigned long long)(*p - '0');
+	n++;
+	e--;
+      }
+      else if(*p != '0'){
+	return REG_FAILURE;
+      }
+    }
+  }
+
+  /* Leave hexadecimal numbers to the C library */
+  if(!seen_digit || *p == 'x' || *p == 'X') return REG_FAILURE;
+
+  if(*p == 'e' || *p == 'E'){
+    p++;
+    if(*p == '-' || *p == '+'){
+      exp_neg = (*p == '-');
+      p++;
+    }
+    /* An 'e' that is not followed by digits is not part of the
+       number, as with strtod */
+    for(; *p >= '0' && *p <= '9'; p++){
+      if(exp_val < 100000) exp_val = exp_val*10 + (*p - '0');
+    }
+    e += exp_neg ? -exp_val : exp_val;
+  }
+
+  *significand = m;
+  *ndigits = n;
+  *exp10 = e;
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Parse_double(const char *str, double *value)
+{
+  unsigned long long m;
+  int                n, e, negative;
+  double             d;
+  char              *end;
+
+  if(Split_decimal(str, &m, &n, &e, &negative) == REG_SUCCESS){
+
+    if(m == 0){
+      *value = negative ? -0.0 : 0.0;
+      return REG_SUCCESS;
+    }
+
+#if REG_EXACT_DBL_ARITHMETIC
+    /* Clinger's fast path: both m and 10^|e| are exact doubles so the
+       result is correctly rounded. Powers of ten beyond 10^22 can be
+       used while the excess can be moved into m exactly. */
+    if(m <= (1ULL << 53) && e > 22 && e <= 22 + 15){
+      while(e > 22 && m <= (1ULL << 53)/10){
+	m *= 10;
+	e--;
+      }
+    }
+    if(m <= (1ULL << 53) && e >= -22 && e <= 22){
+      d = (double)m;
+      if(e < 0){
+	d /= Exact_pow10[-e];
+      }
+      else{
+	d *= Exact_pow10[e];
+      }
+      *value = negative ? -d : d;
+      return REG_SUCCESS;
+    }
+#endif
+  }
+
+  d = strtod(str, &end);
+  if(end == str) return REG_FAILURE;
+
+  *value = d;
+  return REG_SUCCESS;
+}
+
+/*----------------------------------------------------------------*/
+
+int Parse_float(const char *str, float *value)
+{
+  unsigned long long m;
+  int                n, e, negative;
+  float              f;
+  char              *end;
+
+  if(Split_decimal(str, &m, &n, &e, &negative) == REG_SUCCESS){
+
+    if(m == 0){
+      *value = negative ? -0.0f : 0.0f;
+      return REG_SUCCESS;
+    }
+
+#if REG_EXACT_FLT_ARITHMETIC
+    if(m <= (1ULL << 24) && e >= -10 && e <= 10){
+      f = (float)m;
+      if(e < 0){
+	f /= Exact_pow10_flt[-e];
+      }
+      else{
+	f *= Exact_pow10_flt[e];
+      }
+      *value = negative ? -f : f;
+      return REG_SUCCESS;
+    }
+#endif
+  }
+
+  f = strtof(str, &end);
+  if(end == str) return REG_FAILURE;
+
+  *value = f;
+  return REG_SUCCESS;
+}
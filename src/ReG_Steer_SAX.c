@@ -0,0 +1,662 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+/** @internal
+    @file ReG_Steer_SAX.c
+    @brief Source file for the single pass (SAX) steering message
+    parser.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_Config.h"
+#include "ReG_Steer_types.h"
+#include "ReG_Steer_Common.h"
+#include "ReG_Steer_SAX.h"
+
+/** Declared in ReG_Steer_Appside.c */
+extern struct msg_uid_history_struct Msg_uid_store;
+
+/** The parser shared by every message. Like the rest of the
+    library's state it is not protected against use from more than
+    one thread at a time. */
+static Sax_parser_type Sax_parser = {NULL};
+
+/*-----------------------------------------------------------------*/
+
+int Parse_sax_buf(const char* buf, int size, struct msg_struct* msg,
+		  Sim_entry_type* sim) {
+
+  xmlDocPtr doc;
+  int       options = 0;
+
+  if(!buf || !msg) {
+    fprintf(stderr, "STEER: Parse_sax_buf: ptr to buffer or message "
+	    "is NULL\n");
+    return REG_FAILURE;
+  }
+
+  if(Sax_start_msg(&Sax_parser, msg, sim) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+#ifndef REG_DEBUG_FULL
+  options = XML_PARSE_NOWARNING | XML_PARSE_NOERROR;
+#endif
+
+  /* With no startDocument callback no tree is built */
+  doc = xmlCtxtReadMemory(Sax_parser.ctxt, buf, size,
+			  "http://www.realitygrid.org", NULL, options);
+  if(doc) xmlFreeDoc(doc);
+
+  return Sax_end_msg(&Sax_parser);
+}
+
+/*-----------------------------------------------------------------*/
+
+int Parse_sax_file(const char* filename, struct msg_struct* msg,
+		   Sim_entry_type* sim) {
+
+  xmlDocPtr doc;
+  int       options = 0;
+
+  if(!filename || !msg) {
+    fprintf(stderr, "STEER: Parse_sax_file: ptr to filename or message "
+	    "is NULL\n");
+    return REG_FAILURE;
+  }
+
+  if(Sax_start_msg(&Sax_parser, msg, sim) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+#ifndef REG_DEBUG_FULL
+  options = XML_PARSE_NOWARNING | XML_PARSE_NOERROR;
+#endif
+
+  doc = xmlCtxtReadFile(Sax_parser.ctxt, filename, NULL, options);
+  if(doc) xmlFreeDoc(doc);
+
+  return Sax_end_msg(&Sax_parser);
+}
+
+/*-----------------------------------------------------------------*/
+
+void Cleanup_sax_parser() {
+
+  if(Sax_parser.ctxt) {
+    xmlFreeParserCtxt(Sax_parser.ctxt);
+    Sax_parser.ctxt = NULL;
+  }
+  Sax_parser.dict = NULL;
+
+  if(Sax_parser.text) {
+    free(Sax_parser.text);
+    Sax_parser.text = NULL;
+  }
+  Sax_parser.text_size = 0;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Sax_start_msg(Sax_parser_type* sax, struct msg_struct* msg,
+		  Sim_entry_type* sim) {
+
+  int i;
+
+  if(!sax->ctxt) {
+    if(!(sax->ctxt = xmlNewParserCtxt())) {
+      fprintf(stderr, "STEER: Sax_start_msg: failed to create parser "
+	      "context\n");
+      return REG_FAILURE;
+    }
+
+    /* Replace the tree-building handlers with our own */
+    memset(sax->ctxt->sax, 0, sizeof(xmlSAXHandler));
+    sax->ctxt->sax->initialized         = XML_SAX2_MAGIC;
+    sax->ctxt->sax->startElementNs      = Sax_start_element;
+    sax->ctxt->sax->endElementNs        = Sax_end_element;
+    sax->ctxt->sax->characters          = Sax_characters;
+    sax->ctxt->sax->ignorableWhitespace = Sax_characters;
+    sax->ctxt->sax->cdataBlock          = Sax_characters;
+#ifndef REG_DEBUG_FULL
+    sax->ctxt->sax->serror              = Sax_error;
+#endif
+  }
+
+  /* Element names are only ever looked up once in the dictionary */
+  if(sax->dict != sax->ctxt->dict) {
+    sax->dict = sax->ctxt->dict;
+    for(i = 0; i < MSG_NUM_TAGS; i++) {
+      sax->names[i] = xmlDictLookup(sax->dict,
+				    (const xmlChar*) Msg_tag_name(i), -1);
+    }
+  }
+
+  if(!sax->text) {
+    sax->text_size = REG_MAX_STRING_LENGTH;
+    if(!(sax->text = (char*) malloc(sax->text_size))) {
+      fprintf(stderr, "STEER: Sax_start_msg: malloc failed\n");
+      sax->text_size = 0;
+      return REG_FAILURE;
+    }
+  }
+
+  /* If we've been called by a steering client then must store
+     any message UIDs in a structure associated with the simulation
+     being steered as may be one of many */
+  sax->uid_store = sim ? &(sim->Msg_uid_store) : &Msg_uid_store;
+  sax->msg = msg;
+  sax->depth = 0;
+  sax->have_type = REG_FALSE;
+  sax->status = REG_SUCCESS;
+  sax->text_len = 0;
+
+  return REG_SUCCESS;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Sax_end_msg(Sax_parser_type* sax) {
+
+  int status = sax->status;
+
+  if(status == REG_SUCCESS) {
+    if(!sax->ctxt->wellFormed) {
+      fprintf(stderr, "STEER: Parse_sax_buf: Hit error parsing message\n");
+      status = REG_FAILURE;
+    }
+    else if(!sax->have_type) {
+      fprintf(stderr, "STEER: Parse_sax_buf: empty message\n");
+      status = REG_FAILURE;
+    }
+  }
+
+#ifdef REG_DEBUG_FULL
+  if(status == REG_SUCCESS && sax->msg->msg_type != MSG_NOTSET) {
+    fprintf(stderr, "STEER: Parse_sax_buf: Calling Print_msg...\n");
+    Print_msg(sax->msg);
+  }
+#endif
+
+  sax->msg = NULL;
+
+  /* Element names that are not part of the protocol are added to the
+     dictionary too, so start again should it get too big */
+  if(xmlDictSize(sax->dict) > REG_SAX_MAX_DICT_SIZE) {
+    xmlFreeParserCtxt(sax->ctxt);
+    sax->ctxt = NULL;
+    sax->dict = NULL;
+  }
+
+  return status;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Sax_lookup_tag(Sax_parser_type* sax, const xmlChar* name) {
+
+  int i;
+
+  for(i = 1; i < MSG_NUM_TAGS; i++) {
+    if(name == sax->names[i]) return i;
+  }
+
+  /* In case libxml2 handed us a name that is not in its dictionary */
+  for(i = 1; i < MSG_NUM_TAGS; i++) {
+    if(xmlStrEqual(name, sax->names[i])) return i;
+  }
+
+  return MSG_TAG_NOTSET;
+}
+
+/*-----------------------------------------------------------------*/
+
+void Sax_open_frame(Sax_parser_type* sax, sax_frame_kind kind,
+		    void* obj) {
+
+  sax->frames[sax->depth - 1].kind = kind;
+  sax->frames[sax->depth - 1].obj = obj;
+}
+
+/*-----------------------------------------------------------------*/
+
+struct param_struct* Sax_append_param(Msg_arena_type* arena,
+				      struct param_struct** first,
+				      struct param_struct** cur) {
+
+  if(!*first) {
+    *first = New_param_struct(arena);
+    *cur = *first;
+  }
+  else {
+    (*cur)->next = New_param_struct(arena);
+    *cur = (*cur)->next;
+  }
+
+  return *cur;
+}
+
+/*-----------------------------------------------------------------*/
+
+struct cmd_struct* Sax_append_cmd(Msg_arena_type* arena,
+				  struct cmd_struct** first,
+				  struct cmd_struct** cur) {
+
+  if(!*first) {
+    *first = New_cmd_struct(arena);
+    *cur = *first;
+  }
+  else {
+    (*cur)->next = New_cmd_struct(arena);
+    *cur = (*cur)->next;
+  }
+
+  return *cur;
+}
+
+/*-----------------------------------------------------------------*/
+
+void Sax_start_element(void* ctx, const xmlChar* localname,
+		       const xmlChar* prefix, const xmlChar* URI,
+		       int nb_namespaces, const xmlChar** namespaces,
+		       int nb_attributes, int nb_defaulted,
+		       const xmlChar** attributes) {
+
+  Sax_parser_type*             sax = &Sax_parser;
+  struct msg_struct*           msg = sax->msg;
+  Msg_arena_type*              arena = msg->arena;
+  Sax_frame_type*              parent;
+  struct status_struct*        status;
+  struct control_struct*       ctrl;
+  struct supp_cmd_struct*      supp_cmd;
+  struct io_def_struct*        io_def;
+  struct io_struct*            io;
+  struct log_struct*           log;
+  struct log_entry_struct*     entry;
+  struct chk_log_entry_struct* chk_entry;
+  struct param_struct*         param;
+  struct cmd_struct*           cmd;
+  int tag;
+  int i;
+
+  sax->depth++;
+  sax->text_len = 0;
+
+  /* Elements nested too deeply to be part of a message are skipped */
+  if(sax->depth > REG_MAX_MSG_DEPTH) return;
+  Sax_open_frame(sax, SAX_IGNORE, NULL);
+
+  tag = Sax_lookup_tag(sax, localname);
+
+  if(sax->depth == 1) {
+
+    if(tag != MSG_TAG_STEER_MESSAGE) {
+      /* Leave it for the DOM parser */
+      sax->status = REG_UNFINISHED;
+      xmlStopParser(sax->ctxt);
+      return;
+    }
+    Sax_open_frame(sax, SAX_ROOT, msg);
+
+    /* Get the msg UID if present */
+    for(i = 0; i < nb_attributes; i++) {
+      if(attributes[5*i + 2] ||
+	 !xmlStrEqual(attributes[5*i], (const xmlChar*) "UID")) continue;
+
+      msg->msg_uid = Msg_arena_strndup(arena, attributes[5*i + 3],
+				       (int) (attributes[5*i + 4] -
+					      attributes[5*i + 3]));
+
+      /* Check that we haven't already seen this message */
+      if(Msg_already_received((char*) (msg->msg_uid), sax->uid_store)) {
+#ifdef REG_DEBUG_FULL
+	fprintf(stderr, "STEER: INFO: Sax_start_element: msg with UID %s "
+		"has been seen before\n", (char*) (msg->msg_uid));
+#endif
+	/* We have - skip this one */
+	msg->msg_type = MSG_NOTSET;
+	sax->status = REG_FAILURE;
+	xmlStopParser(sax->ctxt);
+	return;
+      }
+    }
+    return;
+  }
+
+  parent = &(sax->frames[sax->depth - 2]);
+
+  switch(parent->kind) {
+
+  case SAX_ROOT:
+    /* The type of the message is given by the first element within
+       the root */
+    if(sax->have_type) break;
+    sax->have_type = REG_TRUE;
+    msg->msg_type = Get_message_type((const char*) localname);
+
+    switch(msg->msg_type) {
+
+    case STATUS:
+    case PARAM_DEFS:
+      /* Use code for 'status' messages because one
+	 encapsulates the other */
+      msg->status = New_status_struct(arena);
+      Sax_open_frame(sax, SAX_STATUS, msg->status);
+      break;
+
+    case CONTROL:
+      msg->control = New_control_struct(arena);
+      Sax_open_frame(sax, SAX_CONTROL, msg->control);
+      break;
+
+    case SUPP_CMDS:
+      msg->supp_cmd = New_supp_cmd_struct(arena);
+      Sax_open_frame(sax, SAX_SUPP_CMD, msg->supp_cmd);
+      break;
+
+    case IO_DEFS:
+      msg->io_def = New_io_def_struct(arena);
+      Sax_open_frame(sax, SAX_IO_DEFS, msg->io_def);
+      break;
+
+    case CHK_DEFS:
+      msg->chk_def = New_io_def_struct(arena);
+      Sax_open_frame(sax, SAX_CHK_DEFS, msg->chk_def);
+      break;
+
+    case STEER_LOG:
+      msg->log = New_log_struct(arena);
+      Sax_open_frame(sax, SAX_LOG, msg->log);
+      break;
+
+    default:
+      fprintf(stderr, "STEER: INFO: Sax_start_element: Unrecognised "
+	      "message type %d for message name >>%s<<\n",
+	      msg->msg_type, (const char*) localname);
+      break;
+    }
+    break;
+
+  case SAX_STATUS:
+    status = (struct status_struct*) parent->obj;
+    if(tag == MSG_TAG_PARAM) {
+      param = Sax_append_param(arena, &(status->first_param), &(status->param));
+      Sax_open_frame(sax, SAX_PARAM, param);
+    }
+    else if(tag == MSG_TAG_COMMAND) {
+      cmd = Sax_append_cmd(arena, &(status->first_cmd), &(status->cmd));
+      Sax_open_frame(sax, SAX_CMD, cmd);
+    }
+    break;
+
+  case SAX_CONTROL:
+    ctrl = (struct control_struct*) parent->obj;
+    if(tag == MSG_TAG_VALID_AFTER) {
+      Sax_open_frame(sax, SAX_LEAF, &(ctrl->valid_after));
+    }
+    else if(tag == MSG_TAG_PARAM) {
+      param = Sax_append_param(arena, &(ctrl->first_param), &(ctrl->param));
+      Sax_open_frame(sax, SAX_PARAM, param);
+    }
+    else if(tag == MSG_TAG_COMMAND) {
+      cmd = Sax_append_cmd(arena, &(ctrl->first_cmd), &(ctrl->cmd));
+      Sax_open_frame(sax, SAX_CMD, cmd);
+    }
+    break;
+
+  case SAX_SUPP_CMD:
+    supp_cmd = (struct supp_cmd_struct*) parent->obj;
+    if(tag == MSG_TAG_COMMAND) {
+      cmd = Sax_append_cmd(arena, &(supp_cmd->first_cmd), &(supp_cmd->cmd));
+      Sax_open_frame(sax, SAX_CMD, cmd);
+    }
+    else if(tag == MSG_TAG_WIRE_FORMAT) {
+      Sax_open_frame(sax, SAX_LEAF, &(supp_cmd->wire_format));
+    }
+    break;
+
+  case SAX_IO_DEFS:
+  case SAX_CHK_DEFS:
+    io_def = (struct io_def_struct*) parent->obj;
+    if((parent->kind == SAX_IO_DEFS && tag == MSG_TAG_IOTYPE) ||
+       (parent->kind == SAX_CHK_DEFS && tag == MSG_TAG_CHKTYPE)) {
+      if(!io_def->first_io) {
+	io_def->first_io = New_io_struct(arena);
+	io_def->io = io_def->first_io;
+      }
+      else {
+	io_def->io->next = New_io_struct(arena);
+	io_def->io = io_def->io->next;
+      }
+      Sax_open_frame(sax, SAX_IO, io_def->io);
+    }
+    break;
+
+  case SAX_IO:
+    io = (struct io_struct*) parent->obj;
+    switch(tag) {
+    case MSG_TAG_HANDLE:
+      Sax_open_frame(sax, SAX_LEAF, &(io->handle));
+      break;
+    case MSG_TAG_LABEL:
+      Sax_open_frame(sax, SAX_LEAF, &(io->label));
+      break;
+    case MSG_TAG_DIRECTION:
+      Sax_open_frame(sax, SAX_LEAF, &(io->direction));
+      break;
+    case MSG_TAG_FREQ_HANDLE:
+      Sax_open_frame(sax, SAX_LEAF, &(io->freq_handle));
+      break;
+    default:
+      break;
+    }
+    break;
+
+  case SAX_LOG:
+    log = (struct log_struct*) parent->obj;
+    if(tag == MSG_TAG_LOG_ENTRY) {
+      if(!log->first_entry) {
+	log->first_entry = New_log_entry_struct(arena);
+	log->entry = log->first_entry;
+      }
+      else {
+	log->entry->next = New_log_entry_struct(arena);
+	log->entry = log->entry->next;
+      }
+      Sax_open_frame(sax, SAX_LOG_ENTRY, log->entry);
+    }
+    break;
+
+  case SAX_LOG_ENTRY:
+    entry = (struct log_entry_struct*) parent->obj;
+    if(tag == MSG_TAG_KEY) {
+      Sax_open_frame(sax, SAX_LEAF, &(entry->key));
+    }
+    else if(tag == MSG_TAG_CHK_LOG_ENTRY) {
+      if(!entry->first_chk_log) {
+	entry->first_chk_log = New_chk_log_entry_struct(arena);
+	entry->chk_log = entry->first_chk_log;
+      }
+      else {
+	entry->chk_log->next = New_chk_log_entry_struct(arena);
+	entry->chk_log = entry->chk_log->next;
+      }
+      Sax_open_frame(sax, SAX_CHK_LOG_ENTRY, entry->chk_log);
+    }
+    else if(tag == MSG_TAG_PARAM) {
+      param = Sax_append_param(arena, &(entry->first_param_log),
+			       &(entry->param_log));
+      Sax_open_frame(sax, SAX_PARAM, param);
+    }
+    break;
+
+  case SAX_CHK_LOG_ENTRY:
+    chk_entry = (struct chk_log_entry_struct*) parent->obj;
+    if(tag == MSG_TAG_CHK_HANDLE) {
+      Sax_open_frame(sax, SAX_LEAF, &(chk_entry->chk_handle));
+    }
+    else if(tag == MSG_TAG_CHK_TAG) {
+      Sax_open_frame(sax, SAX_LEAF, &(chk_entry->chk_tag));
+    }
+    else if(tag == MSG_TAG_PARAM) {
+      param = Sax_append_param(arena, &(chk_entry->first_param),
+			       &(chk_entry->param));
+      Sax_open_frame(sax, SAX_PARAM, param);
+    }
+    break;
+
+  case SAX_PARAM:
+    param = (struct param_struct*) parent->obj;
+    switch(tag) {
+    case MSG_TAG_HANDLE:
+      Sax_open_frame(sax, SAX_LEAF, &(param->handle));
+      break;
+    case MSG_TAG_LABEL:
+      Sax_open_frame(sax, SAX_LEAF, &(param->label));
+      break;
+    case MSG_TAG_VALUE:
+      Sax_open_frame(sax, SAX_LEAF, &(param->value));
+      break;
+    case MSG_TAG_STEERABLE:
+      Sax_open_frame(sax, SAX_LEAF, &(param->steerable));
+      break;
+    case MSG_TAG_TYPE:
+      Sax_open_frame(sax, SAX_LEAF, &(param->type));
+      break;
+    case MSG_TAG_IS_INTERNAL:
+      Sax_open_frame(sax, SAX_LEAF, &(param->is_internal));
+      break;
+    case MSG_TAG_MIN_VALUE:
+      Sax_open_frame(sax, SAX_LEAF, &(param->min_val));
+      break;
+    case MSG_TAG_MAX_VALUE:
+      Sax_open_frame(sax, SAX_LEAF, &(param->max_val));
+      break;
+    default:
+      break;
+    }
+    break;
+
+  case SAX_CMD:
+    cmd = (struct cmd_struct*) parent->obj;
+    if(tag == MSG_TAG_CMD_ID) {
+      Sax_open_frame(sax, SAX_LEAF, &(cmd->id));
+    }
+    else if(tag == MSG_TAG_CMD_NAME) {
+      Sax_open_frame(sax, SAX_LEAF, &(cmd->name));
+    }
+    else if(tag == MSG_TAG_CMD_PARAM) {
+      param = Sax_append_param(arena, &(cmd->first_param), &(cmd->param));
+      Sax_open_frame(sax, SAX_PARAM, param);
+    }
+    break;
+
+  default:
+    /* Content of a leaf or of an element we don't use */
+    break;
+  }
+}
+
+/*-----------------------------------------------------------------*/
+
+void Sax_end_element(void* ctx, const xmlChar* localname,
+		     const xmlChar* prefix, const xmlChar* URI) {
+
+  Sax_parser_type* sax = &Sax_parser;
+  xmlChar**        dest;
+
+  if(sax->depth <= REG_MAX_MSG_DEPTH &&
+     sax->frames[sax->depth - 1].kind == SAX_LEAF) {
+
+    /* An empty element leaves its string NULL, as with the DOM
+       parser */
+    dest = (xmlChar**) sax->frames[sax->depth - 1].obj;
+    *dest = sax->text_len ? Msg_arena_strndup(sax->msg->arena,
+					      (xmlChar*) sax->text,
+					      sax->text_len) : NULL;
+  }
+
+  sax->depth--;
+  sax->text_len = 0;
+}
+
+/*-----------------------------------------------------------------*/
+
+void Sax_error(void* ctx, xmlErrorPtr error) {
+
+  /* Nothing to do; the caller reports that the parse failed */
+}
+
+/*-----------------------------------------------------------------*/
+
+void Sax_characters(void* ctx, const xmlChar* ch, int len) {
+
+  Sax_parser_type* sax = &Sax_parser;
+  char*            text;
+  int              size;
+
+  /* Only the content of leaf elements is kept */
+  if(sax->depth < 1 || sax->depth > REG_MAX_MSG_DEPTH ||
+     sax->frames[sax->depth - 1].kind != SAX_LEAF) return;
+
+  if(sax->text_len + len > sax->text_size) {
+    size = 2*sax->text_size;
+    while(size < sax->text_len + len) size *= 2;
+
+    if(!(text = (char*) realloc(sax->text, size))) {
+      fprintf(stderr, "STEER: Sax_characters: realloc failed\n");
+      sax->status = REG_FAILURE;
+      xmlStopParser(sax->ctxt);
+      return;
+    }
+    sax->text = text;
+    sax->text_size = size;
+  }
+
+  memcpy(sax->text + sax->text_len, ch, len);
+  sax->text_len += len;
+}
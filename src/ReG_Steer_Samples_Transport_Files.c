@@ -58,6 +58,7 @@
 #include "ReG_Steer_Samples_Transport_API.h"
 #include "ReG_Steer_Files_Common.h"
 #include "ReG_Steer_Common.h"
+#include "ReG_Steer_Appside.h"
 #include "ReG_Steer_Appside_internal.h"
 
 /** Basic library config - declared in ReG_Steer_Common */
@@ -66,9 +67,161 @@ extern Steer_lib_config_type Steer_lib_config;
 /* */
 file_info_table_type file_info_table;
 
+/** Number of slice index entries to allocate at a time */
+#define REG_ARCHIVE_SLICE_BLOCK 16
+
+/** @internal
+    @param index Index of the IOType
+    @param num_bytes Number of bytes to write
+    @param pData Data to write
+
+    Write to the current data file, either directly or via the
+    write-behind writer. */
+static int Write_data_files(const int index,
+			    const size_t num_bytes,
+			    const void* pData);
+
+/** @internal
+    @param index Index of the IOType
+
+    Set up a write-behind writer for this IOType if requested via
+    REG_DATA_WRITE_BEHIND and register its monitored parameters. */
+static int Initialize_writer_files(const int index);
+
+/** @internal
+    @param index Index of the IOType
+
+    Write any alignment padding needed so that the payload of the
+    slice whose header is about to be written starts on an aligned
+    boundary. Padding is '\0' bytes which the consumer skips. */
+static int Emit_alignment_padding_files(const int index,
+					const size_t header_bytes);
+
+/** @internal
+    @param index Index of the IOType
+    @param header Slice header as built by Emit_iotype_msg_header
+    @param header_bytes Length of @p header
+    @param stripe Stripe file holding the payload, -1 for the data file
+    @param data_offset Offset of the payload in that file
+
+    Record an index entry for the slice whose header is about to be
+    written. */
+static int Add_archive_slice_files(const int index,
+				   const char* header,
+				   const size_t header_bytes,
+				   const int stripe,
+				   const unsigned long long data_offset);
+
+/** @internal
+    @param index Index of the IOType
+
+    Write the index of the data set and its slices, followed by the
+    trailer, after the data footer in the current file. */
+static int Emit_archive_index_files(const int index);
+
+/** @internal
+    @param queue_depth Max. no. of blocks to queue
+    @param block_size Size of each block, 0 for the default
+    @param flags Combination of REG_WRITER_DIRECT_IO and REG_WRITER_FADVISE
+    @return The new writer or NULL on failure
+
+    Allocate and start a write-behind writer */
+static file_writer_type* Create_writer_files(const int queue_depth,
+					     const int block_size,
+					     const int flags);
+
+/** @internal
+    @param index Index of the IOType
+    @param d Index into the list of directories
+
+    Return the directory to use for entry @p d of
+    REG_DATA_DIRECTORIES, or the only directory if there is no list. */
+static char* Directory_files(const int index, const int d);
+
+/** @internal
+    @param str String to hash
+
+    FNV-1a hash of a string, used to pick directories and stripes. */
+static unsigned int Hash_files(const char* str);
+
+/** @internal
+    @param index Index of the IOType
+    @param base Filename (without directory) of the data set
+    @param seqnum Sequence number of the data set
+
+    Choose which directory a data set goes to when whole data sets
+    are striped. */
+static int Choose_directory_files(const int index, const char* base,
+				  const int seqnum);
+
+/** @internal
+    @param index Index of the IOType
+    @param slice Number of the slice within the data set
+
+    Choose which stripe file the payload of a slice goes to. */
+static int Choose_stripe_files(const int index, const int slice);
+
+/** @internal
+    @param fp On return, the opened file if @p writer is NULL
+    @param writer Write-behind writer to open the file with, or NULL
+    @param writer_open Set to REG_TRUE if the file is opened via @p writer
+    @param filename Full path of the file
+
+    Open a file for output, either directly or via a writer. */
+static int Open_output_files(FILE**            fp,
+			     file_writer_type* writer,
+			     int*              writer_open,
+			     const char*       filename);
+
+/** @internal
+    @param index Index of the IOType
+    @param num_stripes No. of stripe files needed
+
+    Make sure there are at least @p num_stripes entries in the table
+    of stripe files. */
+static int Allocate_stripes_files(const int index, const int num_stripes);
+
+/** @internal
+    @param index Index of the IOType
+    @param remove_flag Whether to delete the stripe files too
+
+    Close any stripe files that are open for reading or synchronous
+    writing. */
+static void Close_stripes_files(const int index, const int remove_flag);
+
+/** @internal
+    @param index Index of the IOType
+    @param list Directories separated by REG_PATH_LIST_SEPARATOR
+
+    Set up the directories to stripe data over and how to do it
+    (REG_DATA_STRIPE and REG_DATA_STRIPE_POLICY). */
+static int Initialize_directories_files(const int index, const char* list);
+
+/** @internal
+    @param index Index of the IOType
+
+    Read the packet that follows the header of a striped slice and
+    position the stripe file it names at the start of the payload. */
+static int Consume_stripe_packet_files(const int index);
+
+/** @internal
+    @param index Index of the IOType
+
+    Close and delete the data set being consumed after an error. */
+static void Abandon_data_set_files(const int index);
+
+/** @internal
+    @param index Index of the IOType
+
+    Set up an io_uring for this IOType's synchronous writes if
+    requested via REG_IO_URING. Failure is not fatal - stdio is then
+    used. */
+static void Initialize_uring_files(const int index);
+
 /* Need access to these tables which are actually declared in
    ReG_Steer_Appside_internal.h */
 extern IOdef_table_type IOTypes_table;
+extern Param_table_type Params_table;
 
 /*---------------------------------------------------*/
 
@@ -91,6 +244,8 @@ int Samples_transport_function_map() {
   Emit_ack_impl = Emit_ack_files;
   Consume_ack_impl = Consume_ack_files;
   Get_IOType_address_impl = Get_IOType_address_files;
+  Release_data_impl = Release_data_files;
+  Poll_IOType_impl = Poll_IOType_files;
   Emit_start_impl = Emit_start_files;
   Emit_stop_impl = Emit_stop_files;
   Consume_stop_impl = Consume_stop_files;
@@ -116,16 +271,34 @@ int Finalize_samples_transport_files() {
 /*---------------------------------------------------*/
 
 int Emit_start_files(int index, int seqnum) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+  char  base[REG_MAX_STRING_LENGTH];
   char *pchar;
-  int   len;
+  char *dir;
+  int   num_writers = 0;
+  int   k;
 
   /* Currently have no way of looking up what filename to use so
-     hardwire... */
+     hardwire... In the short term, use the label (with spaces
+     replaced by '_'s) as the filename */
+  strncpy(base, IOTypes_table.io_def[index].label, REG_MAX_STRING_LENGTH - 16);
+  base[REG_MAX_STRING_LENGTH - 16] = '\0';
 
-  len = strlen(file_info_table.file_info[index].directory) +
-    strlen(IOTypes_table.io_def[index].label);
+  /* Remove trailing white space */
+  trimWhiteSpace(base);
 
-  if(len > REG_MAX_STRING_LENGTH){
+  /* Replace any spaces with '_' */
+  pchar = strchr(base, ' ');
+  while(pchar) {
+    *pchar = '_';
+    pchar = strchr(++pchar, ' ');
+  }
+  sprintf(base + strlen(base), "_%d", seqnum);
+
+  dir = Directory_files(index, Choose_directory_files(index, base, seqnum));
+
+  /* Leave room for stripe and lock suffixes */
+  if(strlen(dir) + strlen(base) + 16 > REG_MAX_STRING_LENGTH){
 
     fprintf(stderr, "STEER: Emit_start: combination of filename + "
 	    "directory path exceeds %d characters: increase "
@@ -133,46 +306,143 @@ int Emit_start_files(int index, int seqnum) {
     return REG_FAILURE;
   }
 
-  /* In the short term, use the label as the filename */
-  sprintf(file_info_table.file_info[index].filename,
-	  "%s%s", file_info_table.file_info[index].directory,
-	  IOTypes_table.io_def[index].label);
-
-  /* Remove trailing white space */
-  trimWhiteSpace(file_info_table.file_info[index].filename);
-  len = strlen(file_info_table.file_info[index].filename);
+  sprintf(info->filename, "%s%s", dir, base);
 
-  /* Replace any spaces with '_' */
-  pchar = strchr(file_info_table.file_info[index].filename, ' ');
-  while( pchar && ((pchar - file_info_table.file_info[index].filename + 1) < len) ){
-    *pchar = '_';
-    pchar = strchr(++pchar,' ');
+  if(Open_output_files(&(info->fp), info->writer, &(info->writer_open),
+		       info->filename) != REG_SUCCESS) {
+    fprintf(stderr, "STEER: Emit_start: failed to open file %s\n",
+	    info->filename);
+    return REG_FAILURE;
+  }
+  if(info->writer_open) num_writers++;
+
+  /* Slices go to one stripe file in each directory */
+  info->num_stripes = 0;
+  info->current_stripe = -1;
+  if(info->stripe_mode == REG_STRIPE_SLICE) {
+    for(k = 0; k < info->num_directories; k++) {
+      info->stripes[k].offset = 0;
+
+      /* Other directories may have longer paths than the one checked
+	 above */
+      if(snprintf(info->stripes[k].filename, REG_MAX_STRING_LENGTH,
+		  "%s%s%s%d", info->directories[k], base, REG_STRIPE_SUFFIX,
+		  k) >= REG_MAX_STRING_LENGTH) {
+	fprintf(stderr, "STEER: Emit_start: name of stripe file in %s "
+		"exceeds %d characters: increase REG_MAX_STRING_LENGTH\n",
+		info->directories[k], REG_MAX_STRING_LENGTH);
+	info->num_stripes = k;
+	Close_stripes_files(index, REG_TRUE);
+	return REG_FAILURE;
+      }
+
+      if(Open_output_files(&(info->stripes[k].fp), info->stripes[k].writer,
+			   &(info->stripes[k].writer_open),
+			   info->stripes[k].filename) != REG_SUCCESS) {
+	fprintf(stderr, "STEER: Emit_start: failed to open file %s\n",
+		info->stripes[k].filename);
+	info->num_stripes = k;
+	Close_stripes_files(index, REG_TRUE);
+	return REG_FAILURE;
+      }
+      if(info->stripes[k].writer_open) num_writers++;
+    }
+    info->num_stripes = info->num_directories;
   }
 
-  pchar = file_info_table.file_info[index].filename;
-  pchar += strlen(file_info_table.file_info[index].filename);
+  /* Files written by writer threads are published together once they
+     are all on disk - get the group now so it can't fail later */
+  if(num_writers > 0 && !info->group) {
+    if(!(info->group = File_writer_group_create(info->filename,
+						num_writers))) {
+      fprintf(stderr, "STEER: Emit_start: failed to allocate memory\n");
+      return REG_FAILURE;
+    }
+  }
 
-  sprintf(pchar, "_%d", seqnum);
-  if( !(file_info_table.file_info[index].fp =
-	fopen(file_info_table.file_info[index].filename, "w")) ){
+  info->offset = 0;
+  info->seqnum = seqnum;
+  info->num_slices = 0;
 
-    fprintf(stderr, "STEER: Emit_start: failed to open file %s\n",
-	    file_info_table.file_info[index].filename);
-    return REG_FAILURE;
-  }
   return REG_SUCCESS;
 }
 
 /*---------------------------------------------------*/
 
 int Emit_stop_files(int index) {
-  if(file_info_table.file_info[index].fp){
-    fclose(file_info_table.file_info[index].fp);
-    file_info_table.file_info[index].fp = NULL;
+  file_info_type*         info = &(file_info_table.file_info[index]);
+  file_writer_group_type* group;
+  int                     num_writers;
+  int                     depth;
+  float                   mbps;
+  int                     k;
+
+  if(info->fp || info->writer_open){
+    /* The footer has already been written so the index goes after
+       it where it is invisible to the packet-based reader */
+    info->current_stripe = -1;
+    if(Emit_archive_index_files(index) != REG_SUCCESS) {
+      fprintf(stderr, "STEER: Emit_stop: failed to write index to %s\n",
+	      info->filename);
+    }
+  }
+
+  /* Anything still staged in the ring must reach the files before
+     they are closed */
+  if(info->uring && Uring_flush(info->uring) != REG_SUCCESS) {
+    fprintf(stderr, "STEER: Emit_stop: failed to write to %s\n",
+	    info->filename);
+  }
+
+  /* Close everything written synchronously first */
+  if(info->fp){
+    fclose(info->fp);
+    info->fp = NULL;
+  }
+  num_writers = info->writer_open ? 1 : 0;
+  for(k = 0; k < info->num_stripes; k++) {
+    if(info->stripes[k].fp) {
+      fclose(info->stripes[k].fp);
+      info->stripes[k].fp = NULL;
+    }
+    if(info->stripes[k].writer_open) num_writers++;
   }
-  /* Create lock file for this data file to prevent race
-     conditions */
-  create_lock_file(file_info_table.file_info[index].filename);
+
+  if(num_writers == 0) {
+    /* Create lock file for this data file to prevent race
+       conditions */
+    create_lock_file(info->filename);
+    info->num_stripes = 0;
+    return REG_SUCCESS;
+  }
+
+  /* The last writer to get its file on disk creates the lock file */
+  group = info->group;
+  info->group = NULL;
+  group->remaining = num_writers;
+  strcpy(group->filename, info->filename);
+
+  info->write_queue_depth = 0;
+  info->write_mbps = 0.0;
+
+  if(info->writer_open) {
+    info->writer_open = REG_FALSE;
+    File_writer_close(info->writer, info->filename, group);
+    File_writer_stats(info->writer, &depth, &mbps);
+    info->write_queue_depth += depth;
+    info->write_mbps += mbps;
+  }
+  for(k = 0; k < info->num_stripes; k++) {
+    if(info->stripes[k].writer_open) {
+      info->stripes[k].writer_open = REG_FALSE;
+      File_writer_close(info->stripes[k].writer,
+			info->stripes[k].filename, group);
+      File_writer_stats(info->stripes[k].writer, &depth, &mbps);
+      info->write_queue_depth += depth;
+      info->write_mbps += mbps;
+    }
+  }
+  info->num_stripes = 0;
 
   return REG_SUCCESS;
 }
@@ -186,6 +456,7 @@ int Consume_stop_files(int index) {
     file_info_table.file_info[index].fp = NULL;
     remove(file_info_table.file_info[index].filename);
   }
+  Close_stripes_files(index, REG_TRUE);
 
   return REG_SUCCESS;
 }
@@ -193,12 +464,35 @@ int Consume_stop_files(int index) {
 /*---------------------------------------------------*/
 
 int Initialize_IOType_transport_files(const int direction, const int index) {
+  file_info_type* info = &(file_info_table.file_info[index]);
   char *pchar;
   int   len;
 
-  /* This is only simple - we use the same directory for every
-     IOType, irrespective of label or direction (input/output). */
-  if((pchar = getenv("REG_DATA_DIRECTORY"))) {
+  info->alignment = 0;
+  if(direction == REG_IO_OUT && (pchar = getenv("REG_DATA_ALIGNMENT"))) {
+    len = atoi(pchar);
+
+    /* Must be a power of two */
+    if(len > 0 && (len & (len - 1)) == 0) {
+      info->alignment = len;
+    }
+    else {
+      fprintf(stderr, "STEER: Initialize_IOType_transport_file: ignoring "
+	      "REG_DATA_ALIGNMENT (%s) - must be a power of two\n", pchar);
+    }
+  }
+
+  /* A list of directories (e.g. one per local disk) to spread the
+     data over takes precedence over a single directory. We use the
+     same directories for every IOType, irrespective of label or
+     direction (input/output). */
+  if((pchar = getenv("REG_DATA_DIRECTORIES"))) {
+    if(Initialize_directories_files(index, pchar) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+    strcpy(info->directory, info->directories[0]);
+  }
+  else if((pchar = getenv("REG_DATA_DIRECTORY"))) {
 
     len = strlen(pchar);
     if(len > REG_MAX_STRING_LENGTH) {
@@ -212,19 +506,19 @@ int Initialize_IOType_transport_files(const int direction, const int index) {
    /* Check that path ends in '/' - if not then add one */
     if(pchar[len-1] != '/') {
 
-      sprintf(file_info_table.file_info[index].directory, "%s/", pchar);
+      sprintf(info->directory, "%s/", pchar);
     }
     else {
-      strcpy(file_info_table.file_info[index].directory, pchar);
+      strcpy(info->directory, pchar);
     }
 #ifdef REG_DEBUG
     fprintf(stderr, "STEER: Initialize_IOType_transport_file: will use following"
 	    " directory for data files: %s\n",
-	    file_info_table.file_info[index].directory);
+	    info->directory);
 #endif
   }
   else {
-    snprintf(file_info_table.file_info[index].directory, REG_MAX_STRING_LENGTH,
+    snprintf(info->directory, REG_MAX_STRING_LENGTH,
 	     "%s/", Steer_lib_config.working_dir);
 #ifdef REG_DEBUG
     fprintf(stderr, "STEER: Initialize_IOType_transport_file: will use current"
@@ -232,12 +526,70 @@ int Initialize_IOType_transport_files(const int direction, const int index) {
 #endif
   }
 
+  if(direction == REG_IO_OUT) {
+    if(Initialize_writer_files(index) != REG_SUCCESS) return REG_FAILURE;
+
+    /* A write-behind writer already takes writes off the caller */
+    if(!info->writer) Initialize_uring_files(index);
+  }
+
   return REG_SUCCESS;
 }
 
 /*---------------------------------------------------*/
 
-void Finalize_IOType_transport_files() {}
+void Finalize_IOType_transport_files() {
+  file_info_type* info;
+  int             i;
+  int             k;
+
+  for(i = 0; i < file_info_table.max_entries; i++) {
+    info = &(file_info_table.file_info[i]);
+
+    /* Waits for any outstanding writes to complete */
+    if(info->writer) {
+      File_writer_finalize(info->writer);
+      free(info->writer);
+      info->writer = NULL;
+      info->writer_open = REG_FALSE;
+    }
+    if(info->stripes) {
+      for(k = 0; k < info->max_stripes; k++) {
+	if(info->stripes[k].writer) {
+	  File_writer_finalize(info->stripes[k].writer);
+	  free(info->stripes[k].writer);
+	}
+      }
+      free(info->stripes);
+      info->stripes = NULL;
+    }
+    info->max_stripes = 0;
+    info->num_stripes = 0;
+    if(info->directories) {
+      for(k = 0; k < info->num_directories; k++) {
+	free(info->directories[k]);
+      }
+      free(info->directories);
+      info->directories = NULL;
+    }
+    info->num_directories = 0;
+    if(info->group) {
+      File_writer_group_free(info->group);
+      info->group = NULL;
+    }
+    if(info->uring) {
+      Uring_finalize(info->uring);
+      free(info->uring);
+      info->uring = NULL;
+    }
+    if(info->slices) {
+      free(info->slices);
+      info->slices = NULL;
+    }
+    info->num_slices = 0;
+    info->max_slices = 0;
+  }
+}
 
 /*----------------------------------------------------------------*/
 
@@ -245,9 +597,16 @@ int Consume_data_read_files(const int index,
 			    const int datatype,
 			    const int num_bytes_to_read,
 			    void*     pData) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+  FILE*  fp = info->fp;
   size_t nbytes;
 
-  if(!file_info_table.file_info[index].fp) {
+  /* Payload of a striped slice is in a stripe file */
+  if(info->current_stripe >= 0) {
+    fp = info->stripes[info->current_stripe].fp;
+  }
+
+  if(!fp) {
 
     fprintf(stderr, "STEER: ERROR: Consume_data_read_file: null file pointer\n");
     return REG_FAILURE;
@@ -259,19 +618,24 @@ int Consume_data_read_files(const int index,
     nbytes = fread((void *)IOTypes_table.io_def[index].buffer,
 		   1,
 		   (size_t)num_bytes_to_read,
-		   file_info_table.file_info[index].fp);
+		   fp);
   }
   else {
     nbytes = fread(pData,
 		   1,
 		   (size_t)num_bytes_to_read,
-		   file_info_table.file_info[index].fp);
+		   fp);
   }
 #ifdef REG_DEBUG
   fprintf(stderr, "STEER: Consume_data_read_file: read %d bytes\n",
 	  (int) nbytes);
 #endif /* REG_DEBUG */
 
+  if(info->current_stripe >= 0) {
+    info->stripes[info->current_stripe].offset += nbytes;
+    info->current_stripe = -1;
+  }
+
   if((int)nbytes != num_bytes_to_read) {
 
     fprintf(stderr, "STEER: Consume_data_read_file: failed to read expected "
@@ -279,9 +643,7 @@ int Consume_data_read_files(const int index,
     /* Reset use_xdr flag set as only valid on a per-slice basis */
     IOTypes_table.io_def[index].use_xdr = REG_FALSE;
 
-    fclose(file_info_table.file_info[index].fp);
-    file_info_table.file_info[index].fp = NULL;
-    remove(file_info_table.file_info[index].filename);
+    Abandon_data_set_files(index);
     return REG_FAILURE;
   }
 
@@ -338,8 +700,17 @@ int Consume_ack_files(const int index) {
 
 int Emit_header_files(const int index) {
   char buffer[REG_PACKET_SIZE];
+  char tmp_buffer[REG_PACKET_SIZE];
 
-  snprintf(buffer, REG_PACKET_SIZE, REG_PACKET_FORMAT, REG_DATA_HEADER);
+  if(file_info_table.file_info[index].num_stripes > 0) {
+    /* Tell the consumer that payloads are in stripe files */
+    snprintf(tmp_buffer, REG_PACKET_SIZE, "%s " REG_STRIPES_FORMAT,
+	     REG_DATA_HEADER, file_info_table.file_info[index].num_stripes);
+    snprintf(buffer, REG_PACKET_SIZE, REG_PACKET_FORMAT, tmp_buffer);
+  }
+  else {
+    snprintf(buffer, REG_PACKET_SIZE, REG_PACKET_FORMAT, REG_DATA_HEADER);
+  }
 
 #ifdef REG_DEBUG
   fprintf(stderr, "STEER: Emit_header: Sending >>%s<<\n", buffer);
@@ -365,22 +736,21 @@ int Emit_data_non_blocking_files(const int index, const int size,
 int Emit_data_files(const int	index,
 		    const size_t	num_bytes_to_send,
 		    void*        pData) {
-  int n_written;
+  int status;
 
-  if(file_info_table.file_info[index].fp) {
-    n_written = (int) fwrite(pData, (int)num_bytes_to_send, 1,
-			     file_info_table.file_info[index].fp);
+  status = Write_data_files(index, num_bytes_to_send, pData);
 
-    if(n_written == 1)
-      return REG_SUCCESS;
-  }
-  return REG_FAILURE;
+  /* Anything after a striped payload goes back to the main file */
+  file_info_table.file_info[index].current_stripe = -1;
+
+  return status;
 }
 
 /*---------------------------------------------------*/
 
 int Get_communication_status_files(const int index) {
-  if(file_info_table.file_info[index].fp) {
+  if(file_info_table.file_info[index].fp ||
+     file_info_table.file_info[index].writer_open) {
     return REG_SUCCESS;
   }
   else {
@@ -393,12 +763,56 @@ int Get_communication_status_files(const int index) {
 int Emit_msg_header_files(const int    index,
 			  const size_t num_bytes_to_send,
 			  void*        pData) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+  char            buffer[REG_PACKET_SIZE];
+  char            tmp_buffer[REG_PACKET_SIZE];
+  int             stripe;
 
-  if(fwrite(pData, sizeof(char), num_bytes_to_send,
-	    file_info_table.file_info[index].fp) == num_bytes_to_send) {
-    return REG_SUCCESS;
+  if(info->num_stripes == 0) {
+    if(Emit_alignment_padding_files(index, num_bytes_to_send) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+
+    if(Add_archive_slice_files(index, (char*)pData, num_bytes_to_send, -1,
+			       info->offset + num_bytes_to_send)
+       != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+
+    return Write_data_files(index, num_bytes_to_send, pData);
   }
-  return REG_FAILURE;
+
+  /* Striped - header goes to the main file followed by a packet
+     saying where the payload is. Padding goes in the stripe file. */
+  stripe = Choose_stripe_files(index, info->num_slices);
+
+  info->current_stripe = stripe;
+  if(Emit_alignment_padding_files(index, 0) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+  info->current_stripe = -1;
+
+  if(Add_archive_slice_files(index, (char*)pData, num_bytes_to_send, stripe,
+			     info->stripes[stripe].offset) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  if(Write_data_files(index, num_bytes_to_send, pData) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  snprintf(tmp_buffer, REG_PACKET_SIZE, REG_STRIPE_FORMAT, stripe,
+	   info->stripes[stripe].offset);
+  snprintf(buffer, REG_PACKET_SIZE, REG_PACKET_FORMAT, tmp_buffer);
+
+  if(Write_data_files(index, REG_PACKET_SIZE, buffer) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  /* The payload follows */
+  info->current_stripe = stripe;
+
+  return REG_SUCCESS;
 }
 
 /*----------------------------------------------------------------*/
@@ -408,13 +822,27 @@ int Consume_msg_header_files(int  index,
 			     int* Count,
 			     int* NumBytes,
 			     int* IsFortranArray) {
-  char buffer[REG_PACKET_SIZE];
+  char      buffer[REG_PACKET_SIZE];
+  int       c;
+  Roi_type* roi;
+  Lod_type* lod;
 
   if(!file_info_table.file_info[index].fp) {
     fprintf(stderr, "STEER: Consume_iotype_msg_header: file pointer is null\n");
     return REG_FAILURE;
   }
 
+  /* Whole array unless the header says otherwise */
+  IOTypes_table.io_def[index].slice_roi.is_set = REG_FALSE;
+  IOTypes_table.io_def[index].slice_lod.num_levels = 0;
+
+  /* Skip any alignment padding inserted before the slice header by
+     the emitter - headers always start with '<' */
+  while((c = getc(file_info_table.file_info[index].fp)) == '\0');
+  if(c != EOF) {
+    ungetc(c, file_info_table.file_info[index].fp);
+  }
+
   if(fread(buffer, 1, REG_PACKET_SIZE, file_info_table.file_info[index].fp)
      != (size_t)REG_PACKET_SIZE) {
 
@@ -583,6 +1011,37 @@ int Consume_msg_header_files(int  index,
 	  buffer);
 #endif
 
+  /* Optional packets saying which part of the array, or which level
+     of detail, the slice holds */
+  while(!strncmp(buffer, "<Array_roi>", 11) ||
+	!strncmp(buffer, "<Array_lod>", 11)) {
+    if(!strncmp(buffer, "<Array_roi>", 11)) {
+      roi = &(IOTypes_table.io_def[index].slice_roi);
+      roi->is_set = (sscanf(buffer, REG_SLICE_ROI_FORMAT, &(roi->sx),
+			    &(roi->sy), &(roi->sz), &(roi->nx), &(roi->ny),
+			    &(roi->nz), &(roi->dx), &(roi->dy),
+			    &(roi->dz)) == 9) ? REG_TRUE : REG_FALSE;
+    }
+    else {
+      lod = &(IOTypes_table.io_def[index].slice_lod);
+      if(sscanf(buffer, REG_SLICE_LOD_FORMAT, &(lod->level),
+		&(lod->num_levels), &(lod->nx), &(lod->ny),
+		&(lod->nz)) != 5) {
+	lod->num_levels = 0;
+      }
+    }
+
+    if(fread(buffer, 1, REG_PACKET_SIZE, file_info_table.file_info[index].fp)
+       != (size_t)REG_PACKET_SIZE) {
+
+      fprintf(stderr, "STEER: Consume_iotype_msg_header: fread failed for header end\n");
+      fclose(file_info_table.file_info[index].fp);
+      file_info_table.file_info[index].fp = NULL;
+      remove(file_info_table.file_info[index].filename);
+      return REG_FAILURE;
+    }
+  }
+
   if(strncmp(buffer, END_SLICE_HEADER, strlen(END_SLICE_HEADER))) {
     fprintf(stderr, "STEER: Consume_msg_header: failed to find "
 	    "end of header\n");
@@ -592,6 +1051,12 @@ int Consume_msg_header_files(int  index,
     return REG_FAILURE;
   }
 
+  /*--- Location of payload if striped ---*/
+
+  if(file_info_table.file_info[index].num_stripes > 0) {
+    return Consume_stripe_packet_files(index);
+  }
+
   return REG_SUCCESS;
 }
 
@@ -615,18 +1080,42 @@ int Get_IOType_address_files(int index, char** pbuf, int* bytes_left) {
 
 /*---------------------------------------------------*/
 
+int Release_data_files(const int index, const void* pData,
+		       const int block) {
+  /* Data is always written or copied before Emit_data returns */
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+int Poll_IOType_files(const int index) {
+  /* Consumers find the last data set on disk */
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
 int Consume_start_data_check_files(const int index) {
 
+  file_info_type* info = &(file_info_table.file_info[index]);
   int    i;
+  int    d;
+  int    k;
   int    nfiles;
+  int    num_dirs;
+  int    seqnum;
+  int    len;
+  int    best_seqnum = -1;
   char  *pchar;
+  char  *dir;
   char** filenames;
   char buffer[REG_MAX_STRING_LENGTH];
   char* tags[2];
 
   /* In the short term, use the label (with spaces replaced by
      '_'s) as the filename */
-  tags[0] = (char*) malloc(strlen(IOTypes_table.io_def[index].label) * sizeof(char));
+  tags[0] = (char*) malloc((strlen(IOTypes_table.io_def[index].label) + 1) *
+			   sizeof(char));
   strcpy(tags[0], IOTypes_table.io_def[index].label);
 
   /* Remove trailing white space */
@@ -646,26 +1135,41 @@ int Consume_start_data_check_files(const int index) {
 
   tags[1] = ".lock";
 
-  filenames = NULL;
-  if(Get_file_list(file_info_table.file_info[index].directory, 2, tags,
-		   &nfiles, &filenames) != REG_SUCCESS || nfiles == 0) {
-    return REG_FAILURE;
-  }
+  /* Data sets may be in any of the directories - take the one with
+     the lowest sequence number */
+  info->filename[0] = '\0';
+  num_dirs = (info->num_directories > 0) ? info->num_directories : 1;
+  for(d = 0; d < num_dirs; d++) {
+    dir = Directory_files(index, d);
 
-  sprintf(file_info_table.file_info[index].filename, "%s%s",
-	  file_info_table.file_info[index].directory, filenames[0]);
+    filenames = NULL;
+    if(Get_file_list(dir, 2, tags, &nfiles, &filenames) != REG_SUCCESS) {
+      continue;
+    }
 
-  for(i=0; i<nfiles; i++){
-    free(filenames[i]);
+    for(i=0; i<nfiles; i++){
+      pchar = strrchr(filenames[i], '_');
+      seqnum = pchar ? atoi(pchar + 1) : 0;
+      if(info->filename[0] == '\0' || seqnum < best_seqnum) {
+	best_seqnum = seqnum;
+	snprintf(info->filename, REG_MAX_STRING_LENGTH, "%s%s",
+		 dir, filenames[i]);
+      }
+      free(filenames[i]);
+    }
+    free(filenames);
   }
-  free(filenames);
   free(tags[0]);
 
+  if(info->filename[0] == '\0') {
+    return REG_FAILURE;
+  }
+
   /* Remove the lock file to take ownership of the data file */
-  remove(file_info_table.file_info[index].filename);
+  remove(info->filename);
 
   /* Remove the '.lock' from the filename */
-  pchar = (char*) strstr(file_info_table.file_info[index].filename, ".lock");
+  pchar = (char*) strstr(info->filename, ".lock");
 
   if(!pchar) {
     fprintf(stderr, "STEER: Consume_start_data_check_file: failed to strip .lock!\n");
@@ -673,11 +1177,10 @@ int Consume_start_data_check_files(const int index) {
   }
 
   *pchar = '\0';
-  if(!(file_info_table.file_info[index].fp =
-	fopen(file_info_table.file_info[index].filename, "r"))) {
+  if(!(info->fp = fopen(info->filename, "r"))) {
 
     fprintf(stderr, "STEER: Consume_start_data_check_file: failed to open file: %s\n",
-	    file_info_table.file_info[index].filename);
+	    info->filename);
     return REG_FAILURE;
   }
 
@@ -685,23 +1188,691 @@ int Consume_start_data_check_files(const int index) {
   if(fread((void *)buffer,
 	   (size_t)1,
 	   REG_PACKET_SIZE,
-	   file_info_table.file_info[index].fp) != (size_t)REG_PACKET_SIZE) {
+	   info->fp) != (size_t)REG_PACKET_SIZE) {
     fprintf(stderr, "STEER: Consume_start_data_check_file: failed to read "
 	    "header from file: %s\n",
-	    file_info_table.file_info[index].filename);
-    remove(file_info_table.file_info[index].filename);
+	    info->filename);
+    remove(info->filename);
     return REG_FAILURE;
   }
 
   if(!strstr(buffer, REG_DATA_HEADER)) {
     fprintf(stderr, "STEER: Consume_start_data_check_file: wrong "
 	    "header from file: %s\n",
-	    file_info_table.file_info[index].filename);
-    remove(file_info_table.file_info[index].filename);
+	    info->filename);
+    remove(info->filename);
     return REG_FAILURE;
   }
 
+  /* Are the payloads held in stripe files? */
+  info->num_stripes = 0;
+  info->current_stripe = -1;
+  buffer[REG_PACKET_SIZE - 1] = '\0';
+  if((pchar = strstr(buffer, "<Stripes>"))) {
+    if(sscanf(pchar, REG_STRIPES_FORMAT, &k) != 1 || k <= 0 ||
+       Allocate_stripes_files(index, k) != REG_SUCCESS) {
+      fprintf(stderr, "STEER: Consume_start_data_check_file: bad stripe "
+	      "count in file: %s\n", info->filename);
+      remove(info->filename);
+      return REG_FAILURE;
+    }
+
+    /* Stripe k is in directory k, as long as we've been given the
+       same directories as the emitter. Otherwise look alongside the
+       main file. */
+    pchar = strrchr(info->filename, '/');
+    pchar = pchar ? pchar + 1 : info->filename;
+    for(i = 0; i < k; i++) {
+      len = REG_MAX_STRING_LENGTH;
+      if(i < info->num_directories) {
+	len = snprintf(info->stripes[i].filename, REG_MAX_STRING_LENGTH,
+		       "%s%s%s%d", info->directories[i], pchar,
+		       REG_STRIPE_SUFFIX, i);
+      }
+      if(len >= REG_MAX_STRING_LENGTH ||
+	 access(info->stripes[i].filename, R_OK) != 0) {
+	len = snprintf(info->stripes[i].filename, REG_MAX_STRING_LENGTH,
+		       "%s%s%d", info->filename, REG_STRIPE_SUFFIX, i);
+      }
+      /* Never open a truncated name - it could be another stripe */
+      if(len >= REG_MAX_STRING_LENGTH) {
+	fprintf(stderr, "STEER: Consume_start_data_check_file: name of "
+		"stripe %d of %s exceeds %d characters\n", i,
+		info->filename, REG_MAX_STRING_LENGTH);
+	remove(info->filename);
+	return REG_FAILURE;
+      }
+      info->stripes[i].fp = NULL;
+      info->stripes[i].offset = 0;
+    }
+    info->num_stripes = k;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+static int Emit_alignment_padding_files(const int index,
+					const size_t header_bytes) {
+  static const char zeros[REG_PACKET_SIZE] = {0};
+  file_info_type* info = &(file_info_table.file_info[index]);
+  unsigned long long offset = info->offset;
+  size_t pad;
+  size_t nbytes;
+
+  if(info->alignment <= 0) return REG_SUCCESS;
+
+  if(info->current_stripe >= 0) {
+    offset = info->stripes[info->current_stripe].offset;
+  }
+
+  /* Pad so that header + payload boundary falls on the alignment */
+  pad = (size_t)((info->alignment -
+		  (offset + header_bytes) % info->alignment) %
+		 info->alignment);
+
+  while(pad > 0) {
+    nbytes = (pad > REG_PACKET_SIZE) ? REG_PACKET_SIZE : pad;
+    if(Write_data_files(index, nbytes, zeros) != REG_SUCCESS) {
+      fprintf(stderr, "STEER: Emit_msg_header: failed to write "
+	      "alignment padding\n");
+      return REG_FAILURE;
+    }
+    pad -= nbytes;
+  }
+
   return REG_SUCCESS;
 }
 
 /*---------------------------------------------------*/
+
+static int Add_archive_slice_files(const int index,
+				   const char* header,
+				   const size_t header_bytes,
+				   const int stripe,
+				   const unsigned long long data_offset) {
+  file_info_type*         info = &(file_info_table.file_info[index]);
+  Array_type*             array = &(IOTypes_table.io_def[index].array);
+  REG_archive_slice_type* slice;
+  void*                   ptr;
+  int                     num_bytes;
+
+  /* Header consists of six packets - see Emit_iotype_msg_header */
+  if(header_bytes < 6*REG_PACKET_SIZE) return REG_FAILURE;
+
+  if(info->num_slices == info->max_slices) {
+    ptr = realloc(info->slices, (info->max_slices + REG_ARCHIVE_SLICE_BLOCK)
+		  * sizeof(REG_archive_slice_type));
+    if(!ptr) {
+      fprintf(stderr, "STEER: Emit_msg_header: failed to allocate memory "
+	      "for slice index\n");
+      return REG_FAILURE;
+    }
+    info->slices = (REG_archive_slice_type*) ptr;
+    info->max_slices += REG_ARCHIVE_SLICE_BLOCK;
+  }
+
+  slice = &(info->slices[info->num_slices]);
+  memset(slice, 0, sizeof(REG_archive_slice_type));
+
+  if(sscanf(&header[REG_PACKET_SIZE], "<Data_type>%d</Data_type>",
+	    &(slice->type)) != 1 ||
+     sscanf(&header[2*REG_PACKET_SIZE], "<Num_objects>%d</Num_objects>",
+	    &(slice->count)) != 1 ||
+     sscanf(&header[3*REG_PACKET_SIZE], "<Num_bytes>%d</Num_bytes>",
+	    &num_bytes) != 1) {
+    fprintf(stderr, "STEER: Emit_msg_header: failed to parse slice header\n");
+    return REG_FAILURE;
+  }
+  slice->num_bytes = (unsigned long long)num_bytes;
+  slice->is_fortran = strstr(&header[4*REG_PACKET_SIZE], "FORTRAN") ?
+    REG_TRUE : REG_FALSE;
+
+  slice->tot[0] = array->totx;
+  slice->tot[1] = array->toty;
+  slice->tot[2] = array->totz;
+  slice->n[0] = array->nx;
+  slice->n[1] = array->ny;
+  slice->n[2] = array->nz;
+  slice->start[0] = array->sx;
+  slice->start[1] = array->sy;
+  slice->start[2] = array->sz;
+
+  slice->header_offset = info->offset;
+  slice->data_offset = data_offset;
+  slice->stripe = stripe;
+
+  info->num_slices++;
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+static int Emit_archive_index_files(const int index) {
+  file_info_type*         info = &(file_info_table.file_info[index]);
+  REG_archive_slice_type* slice;
+  unsigned char           record[REG_ARCHIVE_DATASET_SIZE];
+  unsigned char           trailer[REG_ARCHIVE_TRAILER_SIZE];
+  char                    path[REG_ARCHIVE_PATH_LEN];
+  unsigned long long      index_offset;
+  int                     i;
+  int                     j;
+
+  index_offset = info->offset;
+
+  /* Data set record - one data set per file with this transport */
+  memset(record, 0, REG_ARCHIVE_DATASET_SIZE);
+  REG_ARCHIVE_PUT32(&record[0], info->seqnum);
+  REG_ARCHIVE_PUT32(&record[4], info->num_slices);
+  REG_ARCHIVE_PUT64(&record[8], 0);
+  strncpy((char*)&record[16], IOTypes_table.io_def[index].label,
+	  REG_ARCHIVE_LABEL_LEN - 1);
+  trimWhiteSpace((char*)&record[16]);
+  REG_ARCHIVE_PUT32(&record[16 + REG_ARCHIVE_LABEL_LEN], info->num_stripes);
+
+  if(Write_data_files(index, REG_ARCHIVE_DATASET_SIZE,
+		      record) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  for(i = 0; i < info->num_slices; i++) {
+    slice = &(info->slices[i]);
+
+    memset(record, 0, REG_ARCHIVE_SLICE_SIZE);
+    REG_ARCHIVE_PUT32(&record[0], slice->type);
+    REG_ARCHIVE_PUT32(&record[4], slice->count);
+    REG_ARCHIVE_PUT64(&record[8], slice->num_bytes);
+    REG_ARCHIVE_PUT32(&record[16], slice->is_fortran);
+    for(j = 0; j < 3; j++) {
+      REG_ARCHIVE_PUT32(&record[20 + 4*j], slice->tot[j]);
+      REG_ARCHIVE_PUT32(&record[32 + 4*j], slice->n[j]);
+      REG_ARCHIVE_PUT32(&record[44 + 4*j], slice->start[j]);
+    }
+    REG_ARCHIVE_PUT64(&record[56], slice->header_offset);
+    REG_ARCHIVE_PUT64(&record[64], slice->data_offset);
+    REG_ARCHIVE_PUT32(&record[72], slice->stripe);
+
+    if(Write_data_files(index, REG_ARCHIVE_SLICE_SIZE,
+			record) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+  }
+
+  /* Full paths of the stripe files, in stripe order */
+  for(i = 0; i < info->num_stripes; i++) {
+    memset(path, 0, REG_ARCHIVE_PATH_LEN);
+    strncpy(path, info->stripes[i].filename, REG_ARCHIVE_PATH_LEN - 1);
+
+    if(Write_data_files(index, REG_ARCHIVE_PATH_LEN, path) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+  }
+
+  memcpy(trailer, REG_ARCHIVE_MAGIC, REG_ARCHIVE_MAGIC_LEN);
+  REG_ARCHIVE_PUT32(&trailer[8], REG_ARCHIVE_VERSION);
+  REG_ARCHIVE_PUT32(&trailer[12], 1);
+  REG_ARCHIVE_PUT64(&trailer[16], index_offset);
+  REG_ARCHIVE_PUT32(&trailer[24], REG_ARCHIVE_DATASET_SIZE +
+		    info->num_slices * REG_ARCHIVE_SLICE_SIZE +
+		    info->num_stripes * REG_ARCHIVE_PATH_LEN);
+  REG_ARCHIVE_PUT32(&trailer[28], info->alignment);
+
+  return Write_data_files(index, REG_ARCHIVE_TRAILER_SIZE, trailer);
+}
+
+/*---------------------------------------------------*/
+
+static int Write_data_files(const int index,
+			    const size_t num_bytes,
+			    const void* pData) {
+  file_info_type*     info = &(file_info_table.file_info[index]);
+  FILE*               fp = info->fp;
+  file_writer_type*   writer = info->writer;
+  int                 writer_open = info->writer_open;
+  unsigned long long* offset = &(info->offset);
+
+  /* Payload of a striped slice goes to a stripe file */
+  if(info->current_stripe >= 0) {
+    fp = info->stripes[info->current_stripe].fp;
+    writer = info->stripes[info->current_stripe].writer;
+    writer_open = info->stripes[info->current_stripe].writer_open;
+    offset = &(info->stripes[info->current_stripe].offset);
+  }
+
+  if(writer_open) {
+    if(File_writer_write(writer, pData, num_bytes) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+  }
+  else if(fp && info->uring) {
+    /* Writes go at explicit offsets so the FILE's own position and
+       buffer are never used */
+    if(Uring_write(info->uring, fileno(fp), *offset, pData,
+		   num_bytes) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+  }
+  else if(!fp || fwrite(pData, 1, num_bytes, fp) != num_bytes) {
+    return REG_FAILURE;
+  }
+
+  *offset += num_bytes;
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+static int Initialize_writer_files(const int index) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+  char*           pchar;
+  char            label[REG_MAX_STRING_LENGTH];
+  int             queue_depth;
+  int             block_size = 0;
+  int             flags = 0;
+  int             iparam;
+  int             len;
+  int             k;
+
+  if(!(pchar = getenv("REG_DATA_WRITE_BEHIND")) ||
+     (queue_depth = atoi(pchar)) <= 0) {
+    return REG_SUCCESS;
+  }
+
+  if((pchar = getenv("REG_DATA_WRITE_BLOCK"))) {
+    block_size = atoi(pchar);
+  }
+  if((pchar = getenv("REG_DATA_DIRECT_IO")) && atoi(pchar)) {
+    flags |= REG_WRITER_DIRECT_IO;
+  }
+  if((pchar = getenv("REG_DATA_FADVISE")) && atoi(pchar)) {
+    flags |= REG_WRITER_FADVISE;
+  }
+
+  if(!(info->writer = Create_writer_files(queue_depth, block_size, flags))) {
+    fprintf(stderr, "STEER: Initialize_IOType_transport_file: falling back "
+	    "to synchronous writes\n");
+    return REG_SUCCESS;
+  }
+
+  /* One writer per stripe so that each filesystem is kept busy */
+  if(info->stripe_mode == REG_STRIPE_SLICE) {
+    for(k = 0; k < info->max_stripes; k++) {
+      if(!(info->stripes[k].writer = Create_writer_files(queue_depth,
+							 block_size,
+							 flags))) {
+	fprintf(stderr, "STEER: Initialize_IOType_transport_file: stripe %d "
+		"will be written synchronously\n", k);
+      }
+    }
+  }
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: Initialize_IOType_transport_file: write-behind "
+	  "enabled with %d blocks of %d bytes\n", info->writer->queue_depth,
+	  (int)info->writer->block_size);
+#endif
+
+  /* Report how the writer is doing as monitored parameters that are
+     internal to the steering library */
+  info->write_queue_depth = 0;
+  info->write_mbps = 0.0;
+
+  /* Neither is reported if the IOType's label leaves no room for the
+     suffix */
+  len = snprintf(label, REG_MAX_STRING_LENGTH, "%s: write queue",
+		 IOTypes_table.io_def[index].label);
+  trimWhiteSpace(label);
+  if(len < REG_MAX_STRING_LENGTH &&
+     Register_param(label, REG_FALSE, (void*)&(info->write_queue_depth),
+		    REG_INT, "", "") == REG_SUCCESS) {
+    iparam = Param_index_from_handle(&Params_table,
+				     Params_table.next_handle - 1);
+    if(iparam != -1) Params_table.param[iparam].is_internal = REG_TRUE;
+  }
+
+  len = snprintf(label, REG_MAX_STRING_LENGTH, "%s: write MB/s",
+		 IOTypes_table.io_def[index].label);
+  trimWhiteSpace(label);
+  if(len < REG_MAX_STRING_LENGTH &&
+     Register_param(label, REG_FALSE, (void*)&(info->write_mbps),
+		    REG_FLOAT, "", "") == REG_SUCCESS) {
+    iparam = Param_index_from_handle(&Params_table,
+				     Params_table.next_handle - 1);
+    if(iparam != -1) Params_table.param[iparam].is_internal = REG_TRUE;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+static void Initialize_uring_files(const int index) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+  char*           pchar;
+
+  if(!(pchar = getenv("REG_IO_URING")) || !atoi(pchar)) return;
+
+  if(!(info->uring = (uring_type*) malloc(sizeof(uring_type)))) {
+    fprintf(stderr, "STEER: Initialize_IOType_transport_file: failed to "
+	    "allocate memory\n");
+    return;
+  }
+
+  if(Uring_init(info->uring, 0, 0) != REG_SUCCESS) {
+    fprintf(stderr, "STEER: Initialize_IOType_transport_file: falling back "
+	    "to stdio for writes\n");
+    free(info->uring);
+    info->uring = NULL;
+  }
+}
+
+/*---------------------------------------------------*/
+
+static file_writer_type* Create_writer_files(const int queue_depth,
+					     const int block_size,
+					     const int flags) {
+  file_writer_type* writer;
+
+  if(!(writer = (file_writer_type*) malloc(sizeof(file_writer_type)))) {
+    return NULL;
+  }
+
+  if(File_writer_init(writer, queue_depth,
+		      block_size > 0 ? (size_t)block_size : 0,
+		      flags) != REG_SUCCESS) {
+    free(writer);
+    return NULL;
+  }
+
+  return writer;
+}
+
+/*---------------------------------------------------*/
+
+static char* Directory_files(const int index, const int d) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+
+  if(d < info->num_directories) return info->directories[d];
+
+  return info->directory;
+}
+
+/*---------------------------------------------------*/
+
+static unsigned int Hash_files(const char* str) {
+  /* FNV-1a */
+  unsigned int hash = 2166136261U;
+
+  while(*str) {
+    hash ^= (unsigned char)*str++;
+    hash *= 16777619U;
+  }
+
+  return hash;
+}
+
+/*---------------------------------------------------*/
+
+static int Choose_directory_files(const int index, const char* base,
+				  const int seqnum) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+
+  if(info->stripe_mode != REG_STRIPE_DATASET || info->num_directories < 2) {
+    return 0;
+  }
+
+  if(info->stripe_policy == REG_STRIPE_HASH) {
+    return (int)(Hash_files(base) % (unsigned int)info->num_directories);
+  }
+
+  return abs(seqnum) % info->num_directories;
+}
+
+/*---------------------------------------------------*/
+
+static int Choose_stripe_files(const int index, const int slice) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+  /* Room for the whole filename and any slice no. */
+  char            key[REG_MAX_STRING_LENGTH + 16];
+
+  if(info->stripe_policy == REG_STRIPE_HASH) {
+    snprintf(key, sizeof(key), "%s_%d", info->filename, slice);
+    return (int)(Hash_files(key) % (unsigned int)info->num_stripes);
+  }
+
+  return slice % info->num_stripes;
+}
+
+/*---------------------------------------------------*/
+
+static int Open_output_files(FILE**            fp,
+			     file_writer_type* writer,
+			     int*              writer_open,
+			     const char*       filename) {
+
+  if(writer) {
+    if(File_writer_open(writer, filename) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+    *writer_open = REG_TRUE;
+    return REG_SUCCESS;
+  }
+
+  if(!(*fp = fopen(filename, "w"))) {
+    return REG_FAILURE;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+static int Allocate_stripes_files(const int index, const int num_stripes) {
+  file_info_type*   info = &(file_info_table.file_info[index]);
+  file_stripe_type* ptr;
+  int               k;
+
+  if(num_stripes <= info->max_stripes) return REG_SUCCESS;
+
+  if(!(ptr = (file_stripe_type*) realloc(info->stripes, num_stripes *
+					 sizeof(file_stripe_type)))) {
+    fprintf(stderr, "STEER: Allocate_stripes_files: failed to allocate "
+	    "memory\n");
+    return REG_FAILURE;
+  }
+
+  for(k = info->max_stripes; k < num_stripes; k++) {
+    memset(&(ptr[k]), 0, sizeof(file_stripe_type));
+  }
+  info->stripes = ptr;
+  info->max_stripes = num_stripes;
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+static void Close_stripes_files(const int index, const int remove_flag) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+  int             k;
+
+  for(k = 0; k < info->num_stripes; k++) {
+    if(info->stripes[k].fp) {
+      fclose(info->stripes[k].fp);
+      info->stripes[k].fp = NULL;
+    }
+    if(remove_flag) remove(info->stripes[k].filename);
+  }
+
+  info->num_stripes = 0;
+  info->current_stripe = -1;
+}
+
+/*---------------------------------------------------*/
+
+static int Initialize_directories_files(const int index, const char* list) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+  const char*     start;
+  const char*     end;
+  char*           pchar;
+  int             num;
+  int             len;
+
+  /* Count the entries */
+  num = 1;
+  for(start = list; *start; start++) {
+    if(*start == REG_PATH_LIST_SEPARATOR) num++;
+  }
+
+  if(!(info->directories = (char**) calloc(num, sizeof(char*)))) {
+    fprintf(stderr, "STEER: Initialize_IOType_transport_file: failed to "
+	    "allocate memory\n");
+    return REG_FAILURE;
+  }
+
+  info->num_directories = 0;
+  start = list;
+  while(start) {
+    end = strchr(start, REG_PATH_LIST_SEPARATOR);
+    len = end ? (int)(end - start) : (int)strlen(start);
+
+    if(len > 0) {
+      if(len + 2 > REG_MAX_STRING_LENGTH) {
+	fprintf(stderr, "STEER: Initialize_IOType_transport_file: entry in "
+		"REG_DATA_DIRECTORIES exceeds %d characters - increase "
+		"REG_MAX_STRING_LENGTH\n", REG_MAX_STRING_LENGTH);
+	return REG_FAILURE;
+      }
+
+      pchar = (char*) malloc(len + 2);
+      if(!pchar) return REG_FAILURE;
+      strncpy(pchar, start, len);
+
+      /* Check that path ends in '/' - if not then add one */
+      if(pchar[len - 1] != '/') pchar[len++] = '/';
+      pchar[len] = '\0';
+
+      info->directories[info->num_directories++] = pchar;
+#ifdef REG_DEBUG
+      fprintf(stderr, "STEER: Initialize_IOType_transport_file: will use "
+	      "directory for data files: %s\n", pchar);
+#endif
+    }
+
+    start = end ? end + 1 : NULL;
+  }
+
+  if(info->num_directories == 0) {
+    fprintf(stderr, "STEER: Initialize_IOType_transport_file: "
+	    "REG_DATA_DIRECTORIES contains no directories\n");
+    return REG_FAILURE;
+  }
+
+  /* How to spread the data over them */
+  info->stripe_mode = (info->num_directories > 1) ?
+    REG_STRIPE_DATASET : REG_STRIPE_NONE;
+  if((pchar = getenv("REG_DATA_STRIPE"))) {
+    if(!strcmp(pchar, "slice")) {
+      info->stripe_mode = REG_STRIPE_SLICE;
+    }
+    else if(!strcmp(pchar, "dataset")) {
+      info->stripe_mode = REG_STRIPE_DATASET;
+    }
+    else if(!strcmp(pchar, "none")) {
+      info->stripe_mode = REG_STRIPE_NONE;
+    }
+    else {
+      fprintf(stderr, "STEER: Initialize_IOType_transport_file: ignoring "
+	      "unknown REG_DATA_STRIPE (%s)\n", pchar);
+    }
+  }
+
+  info->stripe_policy = REG_STRIPE_ROUNDROBIN;
+  if((pchar = getenv("REG_DATA_STRIPE_POLICY"))) {
+    if(!strcmp(pchar, "hash")) {
+      info->stripe_policy = REG_STRIPE_HASH;
+    }
+    else if(strcmp(pchar, "roundrobin")) {
+      fprintf(stderr, "STEER: Initialize_IOType_transport_file: ignoring "
+	      "unknown REG_DATA_STRIPE_POLICY (%s)\n", pchar);
+    }
+  }
+
+  if(info->stripe_mode == REG_STRIPE_SLICE) {
+    return Allocate_stripes_files(index, info->num_directories);
+  }
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+static int Consume_stripe_packet_files(const int index) {
+  file_info_type*    info = &(file_info_table.file_info[index]);
+  file_stripe_type*  stripe;
+  char               buffer[REG_PACKET_SIZE];
+  int                k;
+  unsigned long long offset;
+
+  if(fread(buffer, 1, REG_PACKET_SIZE, info->fp) != (size_t)REG_PACKET_SIZE) {
+    fprintf(stderr, "STEER: Consume_msg_header: fread failed for stripe\n");
+    Abandon_data_set_files(index);
+    return REG_FAILURE;
+  }
+  buffer[REG_PACKET_SIZE - 1] = '\0';
+
+  if(sscanf(buffer, REG_STRIPE_FORMAT, &k, &offset) != 2 ||
+     k < 0 || k >= info->num_stripes) {
+    fprintf(stderr, "STEER: Consume_msg_header: bad stripe: %s\n", buffer);
+    Abandon_data_set_files(index);
+    return REG_FAILURE;
+  }
+  stripe = &(info->stripes[k]);
+
+  /* Stripe files are only opened when first needed */
+  if(!stripe->fp) {
+    if(!(stripe->fp = fopen(stripe->filename, "r"))) {
+      fprintf(stderr, "STEER: Consume_msg_header: failed to open stripe "
+	      "file: %s\n", stripe->filename);
+      Abandon_data_set_files(index);
+      return REG_FAILURE;
+    }
+    stripe->offset = 0;
+  }
+
+  /* Skip any alignment padding */
+  if(stripe->offset != offset) {
+#ifdef _MSC_VER
+    if(_fseeki64(stripe->fp, (__int64)offset, SEEK_SET) != 0) {
+#else
+    if(fseeko(stripe->fp, (off_t)offset, SEEK_SET) != 0) {
+#endif
+      fprintf(stderr, "STEER: Consume_msg_header: failed to seek in stripe "
+	      "file: %s\n", stripe->filename);
+      Abandon_data_set_files(index);
+      return REG_FAILURE;
+    }
+    stripe->offset = offset;
+  }
+
+  info->current_stripe = k;
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+static void Abandon_data_set_files(const int index) {
+  file_info_type* info = &(file_info_table.file_info[index]);
+
+  if(info->fp) {
+    fclose(info->fp);
+    info->fp = NULL;
+  }
+  remove(info->filename);
+  Close_stripes_files(index, REG_TRUE);
+}
+
+/*---------------------------------------------------*/
@@ -101,6 +101,8 @@ int Samples_transport_function_map() {
   Emit_ack_impl = Emit_ack_proxy;
   Consume_ack_impl = Consume_ack_proxy;
   Get_IOType_address_impl = Get_IOType_address_proxy;
+  Release_data_impl = Release_data_proxy;
+  Poll_IOType_impl = Poll_IOType_proxy;
   Emit_start_impl = Emit_start_proxy;
   Emit_stop_impl = Emit_stop_proxy;
   Consume_stop_impl = Consume_stop_proxy;
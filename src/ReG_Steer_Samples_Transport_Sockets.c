@@ -100,6 +100,8 @@ int Samples_transport_function_map() {
   Emit_ack_impl = Emit_ack_sockets;
   Consume_ack_impl = Consume_ack_sockets;
   Get_IOType_address_impl = Get_IOType_address_sockets;
+  Release_data_impl = Release_data_sockets;
+  Poll_IOType_impl = Poll_IOType_sockets;
   Emit_start_impl = Emit_start_sockets;
   Emit_stop_impl = Emit_stop_sockets;
   Consume_stop_impl = Consume_stop_sockets;
@@ -151,6 +153,8 @@ int Initialize_IOType_transport_sockets(const int direction, const int index) {
     return_status = REG_FAILURE;
   }
   else {
+    create_uring_samples(index);
+
     if(direction == REG_IO_OUT) {
 
       /* Don't create socket yet if this flag is set */
@@ -174,6 +178,9 @@ int Initialize_IOType_transport_sockets(const int direction, const int index) {
     }
     else if(direction == REG_IO_IN) {
 
+      /* Only emitters have subscribers */
+      socket_info->max_subscribers = 0;
+
       /* Keep a count of how many input channels have been registered and
 	 where this channel is in that list - this is used to map to the
 	 list of data inputs held by our SGS (configured when it was
@@ -213,8 +220,16 @@ int Initialize_IOType_transport_sockets(const int direction, const int index) {
 
 void Finalize_IOType_transport_sockets() {
   int index;
+  socket_info_type* socket_info;
 
   for(index = 0; index < IOTypes_table.num_registered; index++) {
+    socket_info = &(socket_info_table.socket_info[index]);
+    if(socket_info->uring) {
+      Uring_finalize(socket_info->uring);
+      free(socket_info->uring);
+      socket_info->uring = NULL;
+    }
+
     if(IOTypes_table.io_def[index].direction == REG_IO_OUT) {
       /* close sockets */
       cleanup_listener_connection_samples(index);
@@ -281,6 +296,15 @@ int Enable_IOType_sockets(const int index) {
 /*---------------------------------------------------*/
 
 int Get_communication_status_sockets(const int index) {
+  /* Data sets are still built with nobody to send them to, for
+     whoever turns up next */
+  if(socket_info_table.socket_info[index].retain_last) return REG_SUCCESS;
+
+  if(socket_info_table.socket_info[index].max_subscribers > 0) {
+    return socket_info_table.socket_info[index].num_subscribers > 0 ?
+      REG_SUCCESS : REG_FAILURE;
+  }
+
   if(socket_info_table.socket_info[index].comms_status !=
      REG_COMMS_STATUS_CONNECTED)
     return REG_FAILURE;
@@ -318,17 +342,66 @@ int Emit_data_non_blocking_sockets(const int index, const int size,
 
 /*---------------------------------------------------*/
 
+int Emit_subscribers_header_sockets(const int index) {
+
+  char buffer[REG_PACKET_SIZE];
+  socket_info_type* socket_info = &(socket_info_table.socket_info[index]);
+
+  if(socket_info->listener_status != REG_COMMS_STATUS_LISTENING) {
+    create_listener_samples(index);
+  }
+
+  /* Picks up any new subscribers */
+  service_subscribers(socket_info);
+  if(socket_info->num_subscribers == 0 && !socket_info->retain_last) {
+#ifdef REG_DEBUG
+    fprintf(stderr, "STEER: Emit_header: no subscribers, index = %d\n",
+	    index);
+#endif
+    return REG_FAILURE;
+  }
+
+  snprintf(buffer, REG_PACKET_SIZE, REG_PACKET_FORMAT, REG_DATA_HEADER);
+
+  if(begin_dataset(socket_info) != REG_SUCCESS) return REG_FAILURE;
+
+  return append_dataset(socket_info, buffer, REG_PACKET_SIZE);
+}
+
+/*---------------------------------------------------*/
+
 int Emit_header_sockets(const int index) {
 
   char buffer[REG_PACKET_SIZE];
+  char streams[REG_PACKET_SIZE];
   int status;
 
+  /* Data sets for several subscribers are built up and then sent to
+     each of them in turn */
+  if(socket_info_table.socket_info[index].max_subscribers > 0) {
+    return Emit_subscribers_header_sockets(index);
+  }
+
   /* check if socket connection has been made */
   if(socket_info_table.socket_info[index].comms_status !=
      REG_COMMS_STATUS_CONNECTED) {
     attempt_listener_connect_samples(index);
   }
 
+  /* With nobody to send to, just keep the data set for the first
+     consumer to connect */
+  if(socket_info_table.socket_info[index].comms_status !=
+     REG_COMMS_STATUS_CONNECTED &&
+     socket_info_table.socket_info[index].retain_last) {
+    snprintf(buffer, REG_PACKET_SIZE, REG_PACKET_FORMAT, REG_DATA_HEADER);
+    if(begin_dataset(&(socket_info_table.socket_info[index])) !=
+       REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+    return append_dataset(&(socket_info_table.socket_info[index]),
+			  buffer, REG_PACKET_SIZE);
+  }
+
   /* now are we connected? */
   if(socket_info_table.socket_info[index].comms_status ==
      REG_COMMS_STATUS_CONNECTED) {
@@ -336,6 +409,25 @@ int Emit_header_sockets(const int index) {
     fprintf(stderr, "STEER: Emit_header: socket status is connected, index = %d\n", index );
 #endif
 
+    /* Once the consumer's extra connections are all here tell it
+       that we're striping data over them */
+    if(accept_streams_samples(index)) {
+      snprintf(streams, REG_PACKET_SIZE, REG_STREAMS_FORMAT,
+	       socket_info_table.socket_info[index].streams,
+	       (unsigned long) socket_info_table.socket_info[index].stream_chunk);
+      snprintf(buffer, REG_PACKET_SIZE, REG_PACKET_FORMAT, streams);
+      if(Emit_data_sockets(index, REG_PACKET_SIZE,
+			   (void*) buffer) != REG_SUCCESS) {
+	close_streams(&(socket_info_table.socket_info[index]));
+      }
+    }
+
+    /* Keep a copy of everything from here on for consumers that
+       connect after the data set has gone */
+    if(socket_info_table.socket_info[index].retain_last) {
+      begin_dataset(&(socket_info_table.socket_info[index]));
+    }
+
     /* send header */
     snprintf(buffer, REG_PACKET_SIZE, REG_PACKET_FORMAT, REG_DATA_HEADER);
 
@@ -349,6 +441,7 @@ int Emit_header_sockets(const int index) {
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: Emit_header: Sent %d bytes\n", REG_PACKET_SIZE);
 #endif
+      retain_data_sockets(index, REG_PACKET_SIZE, buffer);
       return REG_SUCCESS;
     }
     else if(status == REG_FAILURE) {
@@ -394,7 +487,8 @@ int Emit_data_sockets(const int    index,
   int bytes_left;
   int result;
   char* pchar;
-  int connector = socket_info_table.socket_info[index].connector_handle;
+  socket_info_type* socket_info = &(socket_info_table.socket_info[index]);
+  int connector = socket_info->connector_handle;
 
   if(num_bytes_to_send < 0) {
     fprintf(stderr, "STEER: Emit_data: requested to write < 0 bytes!\n");
@@ -405,6 +499,66 @@ int Emit_data_sockets(const int    index,
     return REG_SUCCESS;
   }
 
+  /* Added to the data set to send to all subscribers at the end */
+  if(socket_info->max_subscribers > 0) {
+    return append_dataset(socket_info, pData, num_bytes_to_send);
+  }
+
+  /* Nobody to send to yet - just keep it */
+  if(socket_info->dataset &&
+     socket_info->comms_status != REG_COMMS_STATUS_CONNECTED) {
+    return append_dataset(socket_info, pData, num_bytes_to_send);
+  }
+
+  retain_data_sockets(index, num_bytes_to_send, pData);
+
+  /* Spread large payloads over all the connections to the consumer */
+  if(socket_info->streams > 1 &&
+     num_bytes_to_send > socket_info->stream_chunk) {
+    if(socket_info->uring &&
+       Uring_send(socket_info->uring, connector, NULL, 0,
+		  REG_FALSE) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+#ifdef REG_DEBUG
+    fprintf(stderr, "STEER: Emit_data: striping %d bytes over %d "
+	    "connections\n", (int) num_bytes_to_send, socket_info->streams);
+#endif
+    return send_striped(socket_info, pData, num_bytes_to_send);
+  }
+
+  /* Send large payloads straight from the caller's buffer if it has
+     promised to wait for Emit_data_slice_release(). The library's own
+     buffers (e.g. XDR) are reused for the next slice so are copied. */
+  if(IOTypes_table.io_def[index].use_zerocopy && !socket_info->is_local &&
+     socket_info->zerocopy_threshold > 0 &&
+     num_bytes_to_send >= socket_info->zerocopy_threshold &&
+     !IOType_owns_buffer(index, pData)) {
+    if(socket_info->uring &&
+       Uring_send(socket_info->uring, connector, NULL, 0,
+		  REG_FALSE) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+#ifdef REG_DEBUG
+    fprintf(stderr, "STEER: Emit_data: sending %d bytes with "
+	    "MSG_ZEROCOPY\n", (int) num_bytes_to_send);
+#endif
+    return send_zerocopy(socket_info, pData, num_bytes_to_send);
+  }
+
+  /* Send anything held back along with the payload in one go */
+  if(socket_info->uring) {
+    if(Uring_send(socket_info->uring, connector, pData,
+		  num_bytes_to_send, REG_FALSE) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+#ifdef REG_DEBUG
+    fprintf(stderr, "STEER: Emit_data: sent %d bytes via io_uring\n",
+	    (int) num_bytes_to_send);
+#endif
+    return REG_SUCCESS;
+  }
+
   bytes_left = num_bytes_to_send;
   pchar = (char*) pData;
 
@@ -444,7 +598,46 @@ int Emit_ack_sockets(const int index){
 
   /* Send a 16-byte acknowledgement message */
   char *ack_msg = "<ACK/>          ";
-  return Emit_data_sockets(index, strlen(ack_msg), (void*)ack_msg);
+  char  buffer[2*REG_PACKET_SIZE + 16];
+  char  tmp_buffer[REG_PACKET_SIZE];
+  char *pchar;
+  IOdef_entry* io = &(IOTypes_table.io_def[index]);
+  Roi_type* roi = &(io->roi);
+
+  if(!roi->pending && !io->lod_pending) {
+    return Emit_data_sockets(index, strlen(ack_msg), (void*)ack_msg);
+  }
+
+  /* Send any requests about what to send ahead of the ack so that the
+     emitter sees them before it starts on the next data set */
+  pchar = buffer;
+  if(roi->pending) {
+    if(roi->is_set) {
+      sprintf(tmp_buffer, REG_ROI_FORMAT, roi->sx, roi->sy, roi->sz,
+	      roi->nx, roi->ny, roi->nz, roi->dx, roi->dy, roi->dz);
+    }
+    else {
+      sprintf(tmp_buffer, REG_ROI_FORMAT, 0, 0, 0, 0, 0, 0, 1, 1, 1);
+    }
+    pchar += sprintf(pchar, REG_PACKET_FORMAT, tmp_buffer);
+    *(pchar-1) = '\0';
+  }
+  if(io->lod_pending) {
+    sprintf(tmp_buffer, REG_LOD_FORMAT, io->lod_levels);
+    pchar += sprintf(pchar, REG_PACKET_FORMAT, tmp_buffer);
+    *(pchar-1) = '\0';
+  }
+  memcpy(pchar, ack_msg, 16);
+  pchar += 16;
+
+  if(Emit_data_sockets(index, (size_t)(pchar - buffer),
+		       (void*)buffer) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+  roi->pending = REG_FALSE;
+  io->lod_pending = REG_FALSE;
+
+  return REG_SUCCESS;
 }
 
 /*---------------------------------------------------*/
@@ -468,6 +661,20 @@ int Get_IOType_address_sockets(int i, char** pbuf, int* bytes_left) {
 #endif /* REG_DEBUG */
       *pbuf += nbytes;
       *bytes_left -= nbytes;
+
+      /* Consumers on this host can use our Unix-domain socket */
+      if(socket_info_table.socket_info[i].local_listener_handle != -1) {
+	nbytes = snprintf(*pbuf, *bytes_left, "<Local_address>%s%s"
+			  "</Local_address>\n", REG_UNIX_ADDRESS_PREFIX,
+			  socket_info_table.socket_info[i].local_path);
+	if((nbytes >= (*bytes_left-1)) || (nbytes < 1)){
+	  fprintf(stderr, "STEER: Emit_IOType_defs: message exceeds max. "
+		  "msg. size of %d bytes\n", REG_MAX_MSG_SIZE);
+	  return REG_FAILURE;
+	}
+	*pbuf += nbytes;
+	*bytes_left -= nbytes;
+      }
     }
   }
 
@@ -478,13 +685,59 @@ int Get_IOType_address_sockets(int i, char** pbuf, int* bytes_left) {
 
 int Emit_msg_header_sockets(const int index,
 			    const size_t num_bytes_to_send, void* pData) {
+  socket_info_type* socket_info = &(socket_info_table.socket_info[index]);
+
+  /* Hold the header back so that it goes out with the payload */
+  if(socket_info->uring && socket_info->max_subscribers == 0 &&
+     socket_info->comms_status == REG_COMMS_STATUS_CONNECTED) {
+    retain_data_sockets(index, num_bytes_to_send, pData);
+    return Uring_send(socket_info->uring, socket_info->connector_handle,
+		      pData, num_bytes_to_send, REG_TRUE);
+  }
+
   return Emit_data_sockets(index, num_bytes_to_send, pData);
 }
 
 /*--------------------- Others ----------------------*/
 
+void retain_data_sockets(const int index, const size_t num_bytes,
+			 const void* pData) {
+  socket_info_type* socket_info = &(socket_info_table.socket_info[index]);
+
+  if(!socket_info->dataset) return;
+
+  /* Not worth failing the emit over - just don't keep this one */
+  if(append_dataset(socket_info, pData, num_bytes) != REG_SUCCESS) {
+    abandon_dataset(socket_info);
+  }
+}
+
+/*---------------------------------------------------*/
+
 int create_connector_samples(const int index) {
 
+  socket_info_type* socket_info = &(socket_info_table.socket_info[index]);
+  int connector;
+
+  if((connector = bind_connector_samples(index)) == REG_SOCKETS_ERROR) {
+    /* couldn't create connector */
+    socket_info->comms_status=REG_COMMS_STATUS_FAILURE;
+    return REG_FAILURE;
+  }
+
+  socket_info->comms_status=REG_COMMS_STATUS_WAITING_TO_CONNECT;
+  socket_info->connector_handle = connector;
+
+  /* might as well try to connect now... */
+  connect_connector_samples(index);
+
+  return REG_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+
+int bind_connector_samples(const int index) {
+
   int i;
   int connector;
   socket_info_type* socket_info = &(socket_info_table.socket_info[index]);
@@ -513,7 +766,7 @@ int create_connector_samples(const int index) {
     status = getaddrinfo(socket_info->tcp_interface, port, &hints, &result);
     if(status != 0) {
       fprintf(stderr, "STEER: getaddrinfo: %s\n", gai_strerror(status));
-      return REG_FAILURE;
+      return REG_SOCKETS_ERROR;
     }
 
     for(rp = result; rp != NULL; rp = rp->ai_next) {
@@ -522,12 +775,11 @@ int create_connector_samples(const int index) {
 	continue;
 
       if(bind(connector, rp->ai_addr, rp->ai_addrlen) == 0) {
-	socket_info->comms_status=REG_COMMS_STATUS_WAITING_TO_CONNECT;
-	socket_info->connector_handle = connector;
 #ifdef REG_DEBUG
 	fprintf(stderr, "bound connector to port %d\n", i);
 #endif
-	break; /* success */
+	freeaddrinfo(result);
+	return connector; /* success */
       }
 
       /* couldn't bind to that port, close connector and start again */
@@ -535,23 +787,9 @@ int create_connector_samples(const int index) {
     }
 
     freeaddrinfo(result);
-
-    if(socket_info->comms_status == REG_COMMS_STATUS_WAITING_TO_CONNECT) {
-      break;
-    }
   }
 
-  if(socket_info->comms_status != REG_COMMS_STATUS_WAITING_TO_CONNECT) {
-    /* couldn't create connector */
-    socket_info->comms_status=REG_COMMS_STATUS_FAILURE;
-    freeaddrinfo(result);
-    return REG_FAILURE;
-  }
-
-  /* might as well try to connect now... */
-  connect_connector_samples(index);
-
-  return REG_SUCCESS;
+  return REG_SOCKETS_ERROR;
 }
 
 /*--------------------------------------------------------------------*/
@@ -579,6 +817,12 @@ int connect_connector_samples(const int index) {
 
   if(return_status == REG_SUCCESS && socket_info->connector_port != 0) {
 
+    /* Same host? */
+    if(connect_local_connector_samples(index) == REG_SUCCESS) {
+      socket_info->comms_status = REG_COMMS_STATUS_CONNECTED;
+      return REG_SUCCESS;
+    }
+
     memset(&hints, 0, sizeof(struct addrinfo));
     hints.ai_family = AF_UNSPEC;
     hints.ai_socktype = SOCK_STREAM;
@@ -607,6 +851,11 @@ int connect_connector_samples(const int index) {
       return REG_FAILURE;
     }
 
+    /* Offer the emitter more connections to stripe data over */
+    if(socket_info->num_streams > 1) {
+      connect_streams_samples(index, rp->ai_addr, rp->ai_addrlen);
+    }
+
     freeaddrinfo(result);
 
     socket_info->comms_status = REG_COMMS_STATUS_CONNECTED;
@@ -620,5 +869,284 @@ int connect_connector_samples(const int index) {
 
 /*--------------------------------------------------------------------*/
 
+int connect_local_connector_samples(const int index) {
+#if REG_HAS_SYS_UN_H
+  socket_info_type*  socket_info = &(socket_info_table.socket_info[index]);
+  struct sockaddr_un addr;
+  char               host[REG_MAX_STRING_LENGTH];
+  char               ip_addr[REG_MAX_STRING_LENGTH];
+  char*              pchar;
+  int                len;
+  int                local;
+  int                connector;
+
+  memset(&addr, 0, sizeof(struct sockaddr_un));
+  addr.sun_family = AF_UNIX;
+
+  len = strlen(REG_UNIX_ADDRESS_PREFIX);
+  if(!strncmp(socket_info->connector_hostname, REG_UNIX_ADDRESS_PREFIX, len)) {
+    /* Explicitly asked for a Unix-domain socket */
+    if(strlen(socket_info->connector_hostname + len) >=
+       sizeof(addr.sun_path)) {
+      fprintf(stderr, "STEER: connect_local_connector: socket path too "
+	      "long: %s\n", socket_info->connector_hostname + len);
+      return REG_FAILURE;
+    }
+    strcpy(addr.sun_path, socket_info->connector_hostname + len);
+  }
+  else {
+    /* Only look for the emitter's Unix-domain socket if it is on this
+       host and we've been told where to look */
+    if(!(pchar = getenv("REG_IO_UNIX_DIRECTORY")) || !(*pchar)) {
+      return REG_FAILURE;
+    }
+
+    local = !strcmp(socket_info->connector_hostname, "localhost");
+    if(!local) {
+      strncpy(host, socket_info->connector_hostname, REG_MAX_STRING_LENGTH);
+      host[REG_MAX_STRING_LENGTH - 1] = '\0';
+      if(dns_lookup(host, ip_addr, 0) == REG_SUCCESS) {
+	local = !strncmp(ip_addr, "127.", 4) || !strcmp(ip_addr, "::1") ||
+	  (socket_info->tcp_interface &&
+	   !strcmp(ip_addr, socket_info->tcp_interface));
+      }
+    }
+    if(!local) return REG_FAILURE;
+
+    if(snprintf(addr.sun_path, sizeof(addr.sun_path), "%s/ReG_%d.sock",
+		pchar, (int) socket_info->connector_port) >=
+       (int) sizeof(addr.sun_path) || access(addr.sun_path, F_OK) != 0) {
+      return REG_FAILURE;
+    }
+  }
+
+  if((connector = socket(AF_UNIX, SOCK_STREAM, 0)) == REG_SOCKETS_ERROR) {
+    perror("socket");
+    return REG_FAILURE;
+  }
+
+  if(connect(connector, (struct sockaddr*) &addr,
+	     sizeof(struct sockaddr_un)) == REG_SOCKETS_ERROR) {
+    fprintf(stderr, "STEER: connect_local_connector: could not connect to "
+	    "%s\n", addr.sun_path);
+    closesocket(connector);
+    return REG_FAILURE;
+  }
+
+  /* The TCP connector is no longer needed */
+  if(socket_info->connector_handle != -1) {
+    closesocket(socket_info->connector_handle);
+  }
+  socket_info->connector_handle = connector;
+  socket_info->is_local = REG_TRUE;
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: connect_local_connector: connected to %s\n",
+	  addr.sun_path);
+#endif
+
+  return REG_SUCCESS;
+#else
+  return REG_FAILURE;
+#endif /* REG_HAS_SYS_UN_H */
+}
+
+/*--------------------------------------------------------------------*/
+
+int connect_streams_samples(const int index, const struct sockaddr* addr,
+			    const socklen_t addrlen) {
+  socket_info_type*       socket_info = &(socket_info_table.socket_info[index]);
+  struct sockaddr_storage local;
+  socklen_t               len = sizeof(local);
+  char                    hello[REG_PACKET_SIZE];
+  char                    buffer[REG_PACKET_SIZE];
+  int                     local_port;
+  int                     connector;
+  int                     i;
+
+  /* The emitter knows which connection they go with from the port we
+     connected out of */
+  if(getsockname(socket_info->connector_handle, (struct sockaddr*) &local,
+		 &len) == REG_SOCKETS_ERROR) {
+    perror("getsockname");
+    return REG_FAILURE;
+  }
+  if(local.ss_family == AF_INET) {
+    local_port = ntohs(((struct sockaddr_in*) &local)->sin_port);
+  }
+  else {
+    local_port = ntohs(((struct sockaddr_in6*) &local)->sin6_port);
+  }
+
+  for(i = 1; i < socket_info->num_streams; i++) {
+    if((connector = bind_connector_samples(index)) == REG_SOCKETS_ERROR) {
+      break;
+    }
+
+    if(connect(connector, addr, addrlen) == REG_SOCKETS_ERROR) {
+      closesocket(connector);
+      break;
+    }
+
+    snprintf(hello, REG_PACKET_SIZE, REG_STREAM_HELLO_FORMAT, local_port,
+	     i, socket_info->num_streams);
+    snprintf(buffer, REG_PACKET_SIZE, REG_PACKET_FORMAT, hello);
+    if(send_no_signal(connector, buffer, REG_PACKET_SIZE, 0) !=
+       REG_PACKET_SIZE) {
+      closesocket(connector);
+      break;
+    }
+
+    socket_info->stream_handles[i - 1] = connector;
+  }
+
+  if(i < socket_info->num_streams) {
+    fprintf(stderr, "STEER: connect_streams: only made %d of %d "
+	    "connections - using one\n", i, socket_info->num_streams);
+    close_streams(socket_info);
+    return REG_FAILURE;
+  }
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: connect_streams: made %d connections\n",
+	  socket_info->num_streams);
+#endif
+
+  return REG_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+
+int accept_streams_samples(const int index) {
+  socket_info_type*       socket_info = &(socket_info_table.socket_info[index]);
+  struct sockaddr_storage addr;
+  socklen_t               len;
+  struct timeval          timeout;
+  fd_set                  sockets;
+  char                    buffer[REG_PACKET_SIZE + 1];
+  char                    host[NI_MAXHOST];
+  char                    peer_host[NI_MAXHOST];
+  char                    port[NI_MAXSERV];
+  char*                   pchar;
+  int                     listener = socket_info->listener_handle;
+  int                     peer_port;
+  int                     stream_port;
+  int                     stream;
+  int                     hello_count;
+  int                     count = 0;
+  int                     new_fd;
+  int                     i;
+
+  if(socket_info->num_streams < 2 || socket_info->streams > 1 ||
+     socket_info->is_local ||
+     socket_info->listener_status != REG_COMMS_STATUS_LISTENING) {
+    return REG_FALSE;
+  }
+
+  /* Who is the consumer on the first connection? */
+  len = sizeof(addr);
+  if(getpeername(socket_info->connector_handle, (struct sockaddr*) &addr,
+		 &len) == REG_SOCKETS_ERROR ||
+     getnameinfo((struct sockaddr*) &addr, len, peer_host, NI_MAXHOST,
+		 port, NI_MAXSERV, NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
+    return REG_FALSE;
+  }
+  peer_port = atoi(port);
+
+  while(REG_TRUE) {
+    timeout.tv_sec  = 0;
+    timeout.tv_usec = 0;
+    FD_ZERO(&sockets);
+    FD_SET(listener, &sockets);
+    if(select(listener + 1, &sockets, NULL, NULL, &timeout) <= 0) break;
+
+    len = sizeof(addr);
+    if((new_fd = accept(listener, (struct sockaddr*) &addr,
+			&len)) == REG_SOCKETS_ERROR) {
+      perror("accept");
+      break;
+    }
+
+    /* The consumer sends its hello as soon as it has connected */
+    timeout.tv_sec  = 1;
+    timeout.tv_usec = 0;
+    FD_ZERO(&sockets);
+    FD_SET(new_fd, &sockets);
+    memset(buffer, '\0', REG_PACKET_SIZE + 1);
+    if(select(new_fd + 1, &sockets, NULL, NULL, &timeout) <= 0 ||
+       recv_wait_all(new_fd, buffer, REG_PACKET_SIZE, 0) != REG_PACKET_SIZE ||
+       !(pchar = strstr(buffer, "<ReG_stream>")) ||
+       sscanf(pchar, REG_STREAM_HELLO_FORMAT, &stream_port, &stream,
+	      &hello_count) != 3 ||
+       getnameinfo((struct sockaddr*) &addr, len, host, NI_MAXHOST,
+		   NULL, 0, NI_NUMERICHOST) != 0) {
+      fprintf(stderr, "STEER: accept_streams: dropping unexpected "
+	      "connection\n");
+      closesocket(new_fd);
+      continue;
+    }
+
+    /* Must belong to the consumer we're talking to */
+    if(stream_port != peer_port || strcmp(host, peer_host) ||
+       stream < 1 || stream >= hello_count ||
+       socket_info->stream_handles[stream - 1] != -1) {
+      fprintf(stderr, "STEER: accept_streams: dropping connection from "
+	      "%s not part of this one\n", host);
+      closesocket(new_fd);
+      continue;
+    }
+
+    if(hello_count > socket_info->num_streams) {
+      fprintf(stderr, "STEER: accept_streams: consumer asked for %d "
+	      "connections, limit is %d - using one\n", hello_count,
+	      socket_info->num_streams);
+      closesocket(new_fd);
+      close_streams(socket_info);
+      return REG_FALSE;
+    }
+
+    socket_info->stream_handles[stream - 1] = new_fd;
+    count = hello_count;
+  }
+
+  /* Use them once they're all here */
+  if(count < 2) return REG_FALSE;
+  for(i = 0; i < count - 1; i++) {
+    if(socket_info->stream_handles[i] == -1) return REG_FALSE;
+  }
+
+  socket_info->streams = count;
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: accept_streams: striping over %d connections\n",
+	  count);
+#endif
+
+  return REG_TRUE;
+}
+
+/*--------------------------------------------------------------------*/
+
+void create_uring_samples(const int index) {
+  socket_info_type* socket_info = &(socket_info_table.socket_info[index]);
+  char* pchar;
+
+  if(!(pchar = getenv("REG_IO_URING")) || !atoi(pchar)) return;
+
+  if(!(socket_info->uring = (uring_type*) malloc(sizeof(uring_type)))) {
+    fprintf(stderr, "STEER: create_uring_samples: failed to allocate "
+	    "memory\n");
+    return;
+  }
+
+  if(Uring_init(socket_info->uring, 0, 0) != REG_SUCCESS) {
+    fprintf(stderr, "STEER: create_uring_samples: falling back to plain "
+	    "sends and receives for IOType %d\n", index);
+    free(socket_info->uring);
+    socket_info->uring = NULL;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
 #define  REG_MODULE sockets
 #include "ReG_Steer_Samples_Transport_Sockets_Shared.c"
@@ -65,12 +65,18 @@ REG_DEFINE_FUNC(int, Consume_msg_header, (int index, int* datatype, int* count,
 
   int nbytes;
   char buffer[REG_PACKET_SIZE];
+  Roi_type *roi;
+  Lod_type *lod;
   socket_info_type  *sock_info;
   sock_info = &(socket_info_table.socket_info[index]);
 
   /* check socket connection has been made */
   if (sock_info->comms_status != REG_COMMS_STATUS_CONNECTED) return REG_FAILURE;
 
+  /* Whole array unless the header says otherwise */
+  IOTypes_table.io_def[index].slice_roi.is_set = REG_FALSE;
+  IOTypes_table.io_def[index].slice_lod.num_levels = 0;
+
   /* Read header */
 #ifdef REG_DEBUG_FULL
   fprintf(stderr, "STEER: Consume_msg_header: calling recv...\n");
@@ -228,7 +234,7 @@ REG_DEFINE_FUNC(int, Consume_msg_header, (int index, int* datatype, int* count,
     *is_fortran_array = REG_FALSE;
   }
 
-  /*--- End of header ---*/
+  /*--- End of header (or part of array, or level of detail, sent) ---*/
   if((nbytes = recv_wait_all(sock_info->connector_handle, buffer,
 			     REG_PACKET_SIZE, 0)) <= 0) {
     if(nbytes == 0) {
@@ -248,6 +254,46 @@ REG_DEFINE_FUNC(int, Consume_msg_header, (int index, int* datatype, int* count,
 	  buffer);
 #endif
 
+  while(!strncmp(buffer, "<Array_roi>", 11) ||
+	!strncmp(buffer, "<Array_lod>", 11)) {
+    if(!strncmp(buffer, "<Array_roi>", 11)) {
+      roi = &(IOTypes_table.io_def[index].slice_roi);
+      if(sscanf(buffer, REG_SLICE_ROI_FORMAT, &(roi->sx), &(roi->sy),
+		&(roi->sz), &(roi->nx), &(roi->ny), &(roi->nz), &(roi->dx),
+		&(roi->dy), &(roi->dz)) != 9) {
+	fprintf(stderr, "STEER: ERROR: Consume_msg_header: failed to "
+		"read Array_roi\n");
+	return REG_FAILURE;
+      }
+      roi->is_set = REG_TRUE;
+    }
+    else {
+      lod = &(IOTypes_table.io_def[index].slice_lod);
+      if(sscanf(buffer, REG_SLICE_LOD_FORMAT, &(lod->level),
+		&(lod->num_levels), &(lod->nx), &(lod->ny),
+		&(lod->nz)) != 5) {
+	lod->num_levels = 0;
+	fprintf(stderr, "STEER: ERROR: Consume_msg_header: failed to "
+		"read Array_lod\n");
+	return REG_FAILURE;
+      }
+    }
+
+    if((nbytes = recv_wait_all(sock_info->connector_handle, buffer,
+			       REG_PACKET_SIZE, 0)) <= 0) {
+      if(nbytes == 0) {
+	/* closed connection */
+	fprintf(stderr, "STEER: Consume_msg_header: hung up!\n");
+      }
+      else {
+	/* error */
+	perror("recv");
+      }
+
+      return REG_FAILURE;
+    }
+  }
+
   if(strncmp(buffer, END_SLICE_HEADER, strlen(END_SLICE_HEADER))) {
     fprintf(stderr, "STEER: ERROR: Consume_msg_header: failed to find "
 	    "end of header\n");
@@ -266,6 +312,8 @@ REG_DEFINE_FUNC(int, Consume_start_data_check, (const int index))
   int nbytes = 0;
   int nbytes1 = 0;
   int attempt_reconnect;
+  int streams;
+  unsigned long chunk;
 
   socket_info_type  *sock_info;
   sock_info = &(socket_info_table.socket_info[index]);
@@ -350,6 +398,28 @@ REG_DEFINE_FUNC(int, Consume_start_data_check, (const int index))
       memset(buffer, '\0', 1);
     }
 
+    /* The emitter has taken up the extra connections we made */
+    else if((pstart = strstr(buffer, "<ReG_streams>")) &&
+	    sscanf(pstart, REG_STREAMS_FORMAT, &streams, &chunk) == 2) {
+      if(streams > 1 && streams <= REG_MAX_STREAMS && chunk > 0 &&
+	 sock_info->stream_handles[streams - 2] != -1) {
+	sock_info->streams = streams;
+	sock_info->stream_chunk = (size_t) chunk;
+#ifdef REG_DEBUG
+	fprintf(stderr, "STEER: Consume_start_data_check: data striped "
+		"over %d connections\n", streams);
+#endif
+      }
+      else {
+	/* Data would be garbled so start again */
+	fprintf(stderr, "STEER: Consume_start_data_check: cannot stripe "
+		"data over %d connections\n", streams);
+	close_connector_handle_samples(index);
+	return REG_FAILURE;
+      }
+      memset(buffer, '\0', 1);
+    }
+
 #ifdef REG_DEBUG
     fprintf(stderr, "!");
 #endif
@@ -391,12 +461,13 @@ REG_DEFINE_FUNC(int, Consume_start_data_check, (const int index))
       }
     }
 
-    IOTypes_table.io_def[index].buffer_max_bytes = REG_IO_BUFSIZE;
-    IOTypes_table.io_def[index].buffer = (void*) malloc(REG_IO_BUFSIZE);
-    if(!IOTypes_table.io_def[index].buffer) {
-      IOTypes_table.io_def[index].buffer_max_bytes = 0;
-      fprintf(stderr, "STEER: ERROR: Consume_start_data_check: malloc "
-	      "of IO buffer failed\n");
+    /* Reuse any buffer still held from the last data set or
+       registered by the application, however small - slices that
+       don't fit get a bigger one */
+    if(!IOTypes_table.io_def[index].buffer &&
+       Realloc_iotype_buffer(index, REG_IO_BUFSIZE) != REG_SUCCESS) {
+      fprintf(stderr, "STEER: ERROR: Consume_start_data_check: "
+	      "allocation of IO buffer failed\n");
       return REG_FAILURE;
     }
 
@@ -434,9 +505,16 @@ REG_DEFINE_FUNC(int, Consume_data_read, (const int index, const int datatype, co
   sock_info = &(socket_info_table.socket_info[index]);
 
   if(IOTypes_table.io_def[index].use_xdr || IOTypes_table.io_def[index].convert_array_order == REG_TRUE) {
-    nbytes = recv_wait_all(sock_info->connector_handle,
-			   IOTypes_table.io_def[index].buffer,
-			   num_bytes_to_read, 0);
+    pData = IOTypes_table.io_def[index].buffer;
+  }
+
+  if(sock_info->streams > 1 &&
+	  (size_t) num_bytes_to_read > sock_info->stream_chunk) {
+    nbytes = recv_striped(sock_info, pData, num_bytes_to_read);
+  }
+  else if(sock_info->uring) {
+    nbytes = Uring_recv(sock_info->uring, sock_info->connector_handle,
+			pData, num_bytes_to_read);
   }
   else {
     nbytes = recv_wait_all(sock_info->connector_handle, pData,
@@ -481,6 +559,32 @@ REG_DEFINE_FUNC(int, Consume_ack, (const int index))
   char *pchar;
   int   nbytes;
 
+  /* Each subscriber has its own acknowledgements - we can go on if
+     any of them is ready */
+  if(socket_info_table.socket_info[index].max_subscribers > 0) {
+    if(service_subscribers(&(socket_info_table.socket_info[index])) ==
+       REG_SUCCESS) {
+      return REG_SUCCESS;
+    }
+    /* ...or if there are none, keep building data sets for later */
+    return (socket_info_table.socket_info[index].retain_last &&
+	    socket_info_table.socket_info[index].num_subscribers == 0) ?
+      REG_SUCCESS : REG_FAILURE;
+  }
+
+  /* Nobody to hear from yet if we're only keeping the data set */
+  if(socket_info_table.socket_info[index].retain_last &&
+     socket_info_table.socket_info[index].comms_status !=
+     REG_COMMS_STATUS_CONNECTED) {
+    IOTypes_table.io_def[index].ack_needed = REG_FALSE;
+    return REG_SUCCESS;
+  }
+
+  /* The consumer may have asked for less than we're sending */
+  if(Consume_consumer_requests(index) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
   /* If no acknowledgement is currently required (e.g. this is the
      first time Emit_start has been called) then return success */
   if(IOTypes_table.io_def[index].ack_needed == REG_FALSE){
@@ -557,6 +661,17 @@ REG_DEFINE_FUNC(int, Emit_start, (int index, int seqnum))
 
 REG_DEFINE_FUNC(int, Emit_stop, (int index))
 {
+  /* The data set is complete so start sending it */
+  if(socket_info_table.socket_info[index].max_subscribers > 0) {
+    publish_dataset(&(socket_info_table.socket_info[index]),
+		    IOTypes_table.io_def[index].use_ack);
+  }
+  else {
+    /* ...or keep it for a consumer that connects later */
+    retain_dataset(&(socket_info_table.socket_info[index]),
+		   IOTypes_table.io_def[index].use_ack);
+  }
+
   return REG_SUCCESS;
 }
 
@@ -567,6 +682,34 @@ REG_DEFINE_FUNC(int, Consume_stop, (int index))
   return REG_SUCCESS;
 }
 
+/*---------------------------------------------------*/
+
+REG_DEFINE_FUNC(int, Release_data, (const int index, const void* pData, const int block))
+{
+  return release_zerocopy(&(socket_info_table.socket_info[index]),
+			  pData, block);
+}
+
+/*---------------------------------------------------*/
+
+REG_DEFINE_FUNC(int, Poll_IOType, (const int index))
+{
+  socket_info_type* socket_info = &(socket_info_table.socket_info[index]);
+
+  /* Only worth looking for new consumers if we've something to give
+     them */
+  if(!socket_info->retained) return REG_SUCCESS;
+
+  if(socket_info->max_subscribers > 0) {
+    service_subscribers(socket_info);
+  }
+  else if(socket_info->comms_status != REG_COMMS_STATUS_CONNECTED) {
+    attempt_listener_connect_samples(index);
+  }
+
+  return REG_SUCCESS;
+}
+
 #undef REG_MODULE
 
 /*--------------------- Others ----------------------*/
@@ -671,12 +814,77 @@ int create_listener_samples(const int index) {
     return REG_FAILURE;
   }
 
+  /* Consumers on this host may use a Unix-domain socket instead */
+  create_local_listener_samples(index);
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+int create_local_listener_samples(const int index) {
+#if REG_HAS_SYS_UN_H
+  socket_info_type*  socket_info = &(socket_info_table.socket_info[index]);
+  struct sockaddr_un addr;
+  char*              pchar;
+  int                listener;
+
+  if(!(pchar = getenv("REG_IO_UNIX_DIRECTORY")) || !(*pchar)) {
+    return REG_SUCCESS;
+  }
+
+  /* Named after the TCP port so that a consumer given our TCP address
+     can find it */
+  memset(&addr, 0, sizeof(struct sockaddr_un));
+  addr.sun_family = AF_UNIX;
+  if(snprintf(addr.sun_path, sizeof(addr.sun_path), "%s/ReG_%d.sock", pchar,
+	      (int) socket_info->listener_port) >= (int) sizeof(addr.sun_path)) {
+    fprintf(stderr, "STEER: create_local_listener: REG_IO_UNIX_DIRECTORY "
+	    "is too long for a socket path\n");
+    return REG_FAILURE;
+  }
+
+  if((listener = socket(AF_UNIX, SOCK_STREAM, 0)) == REG_SOCKETS_ERROR) {
+    perror("socket");
+    return REG_FAILURE;
+  }
+
+  /* Any socket of this name is left over from an earlier run since we
+     have just bound the TCP port */
+  unlink(addr.sun_path);
+  if(bind(listener, (struct sockaddr*) &addr,
+	  sizeof(struct sockaddr_un)) == REG_SOCKETS_ERROR ||
+     listen(listener, 10) == REG_SOCKETS_ERROR) {
+    perror("STEER: create_local_listener");
+    closesocket(listener);
+    return REG_FAILURE;
+  }
+
+  if(!socket_info->local_path) {
+    socket_info->local_path = (char*) malloc(sizeof(addr.sun_path));
+  }
+  if(!socket_info->local_path) {
+    closesocket(listener);
+    unlink(addr.sun_path);
+    return REG_FAILURE;
+  }
+  strcpy(socket_info->local_path, addr.sun_path);
+  socket_info->local_listener_handle = listener;
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: create_local_listener: listening on %s\n",
+	  socket_info->local_path);
+#endif
+#endif /* REG_HAS_SYS_UN_H */
+
   return REG_SUCCESS;
 }
 
 /*---------------------------------------------------*/
 
 void cleanup_listener_connection_samples(const int index) {
+  close_subscribers(&(socket_info_table.socket_info[index]));
+
   if(socket_info_table.socket_info[index].listener_status == REG_COMMS_STATUS_LISTENING) {
     close_listener_handle_samples(index);
   }
@@ -702,6 +910,17 @@ void cleanup_connector_connection_samples(const int index) {
 /*---------------------------------------------------*/
 
 void close_listener_handle_samples(const int index) {
+  socket_info_type* socket_info = &(socket_info_table.socket_info[index]);
+
+  if(socket_info->local_listener_handle != -1) {
+    closesocket(socket_info->local_listener_handle);
+    socket_info->local_listener_handle = -1;
+    if(socket_info->local_path) {
+      unlink(socket_info->local_path);
+      socket_info->local_path[0] = '\0';
+    }
+  }
+
   if(closesocket(socket_info_table.socket_info[index].listener_handle) == REG_SOCKETS_ERROR) {
     perror("close");
     socket_info_table.socket_info[index].listener_status = REG_COMMS_STATUS_FAILURE;
@@ -716,7 +935,82 @@ void close_listener_handle_samples(const int index) {
 
 /*---------------------------------------------------*/
 
+int Consume_consumer_requests(const int index) {
+
+  socket_info_type* sock_info = &(socket_info_table.socket_info[index]);
+  IOdef_entry*      io = &(IOTypes_table.io_def[index]);
+  char              buffer[REG_PACKET_SIZE];
+  Roi_type          req;
+  int               levels;
+  int               nbytes;
+  /* Both tags are the same length */
+  const int         tag_len = strlen("<ReG_roi>");
+
+  if(sock_info->comms_status != REG_COMMS_STATUS_CONNECTED) {
+    return REG_SUCCESS;
+  }
+
+  /* Requests are whole packets sent ahead of an ack so look before
+     we take anything off the socket */
+  while((nbytes = recv_non_block(sock_info->connector_handle, buffer,
+				 tag_len, MSG_PEEK)) > 0 &&
+	(!strncmp(buffer, "<ReG_roi>", nbytes) ||
+	 !strncmp(buffer, "<ReG_lod>", nbytes))) {
+
+    /* Wait for the rest of the tag before deciding what this is */
+    if(nbytes < tag_len) return REG_FAILURE;
+
+    if(recv_wait_all(sock_info->connector_handle, buffer,
+		     REG_PACKET_SIZE, 0) != REG_PACKET_SIZE) {
+      return REG_FAILURE;
+    }
+
+    if(!strncmp(buffer, "<ReG_lod>", tag_len)) {
+      if(sscanf(buffer, REG_LOD_FORMAT, &levels) != 1) {
+	fprintf(stderr, "STEER: WARNING: Consume_ack: ignoring malformed "
+		"level of detail request\n");
+	continue;
+      }
+      io->lod_limit = (levels > 0) ? levels : 0;
+
+#ifdef REG_DEBUG
+      fprintf(stderr, "STEER: Consume_ack: consumer asked for at most %d "
+	      "levels of detail\n", io->lod_limit);
+#endif
+      continue;
+    }
+
+    if(sscanf(buffer, REG_ROI_FORMAT, &(req.sx), &(req.sy), &(req.sz),
+	      &(req.nx), &(req.ny), &(req.nz), &(req.dx), &(req.dy),
+	      &(req.dz)) != 9) {
+      fprintf(stderr, "STEER: WARNING: Consume_ack: ignoring malformed "
+	      "region of interest request\n");
+      continue;
+    }
+
+    /* Zero extent asks for the whole array again */
+    req.is_set = (req.nx > 0 && req.ny > 0 && req.nz > 0) ?
+      REG_TRUE : REG_FALSE;
+    req.pending = REG_FALSE;
+    io->roi = req;
+
+#ifdef REG_DEBUG
+    fprintf(stderr, "STEER: Consume_ack: consumer asked for %s\n",
+	    io->roi.is_set ? "part of each array" : "whole arrays");
+#endif
+  }
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
 void close_connector_handle_samples(const int index) {
+  /* The kernel may still be sending from buffers passed with
+     MSG_ZEROCOPY - only it can tell us when it's done */
+  reset_zerocopy(&(socket_info_table.socket_info[index]));
+  close_streams(&(socket_info_table.socket_info[index]));
+
   if(closesocket(socket_info_table.socket_info[index].connector_handle) == REG_SOCKETS_ERROR) {
     perror("close");
     socket_info_table.socket_info[index].comms_status = REG_COMMS_STATUS_FAILURE;
@@ -727,13 +1021,21 @@ void close_connector_handle_samples(const int index) {
 #endif
     socket_info_table.socket_info[index].comms_status = REG_COMMS_STATUS_NULL;
   }
+  socket_info_table.socket_info[index].is_local = REG_FALSE;
+
+  /* Nothing held back for this connection may go down the next one */
+  if(socket_info_table.socket_info[index].uring) {
+    Uring_discard(socket_info_table.socket_info[index].uring);
+  }
 }
 
 /*---------------------------------------------------*/
 
 void attempt_listener_connect_samples(const int index) {
   socket_info_type *socket_info;
+  int               was_connected;
   socket_info = &(socket_info_table.socket_info[index]);
+  was_connected = (socket_info->comms_status == REG_COMMS_STATUS_CONNECTED);
 
   if(socket_info->listener_status != REG_COMMS_STATUS_LISTENING) {
 #ifdef REG_DEBUG
@@ -764,6 +1066,19 @@ void attempt_listener_connect_samples(const int index) {
       retry_accept_connect_samples(index);
     }
   }
+
+  /* Give a consumer that has just turned up the last data set
+     straight away rather than have it wait for the next */
+  if(!was_connected && socket_info->retained &&
+     socket_info->comms_status == REG_COMMS_STATUS_CONNECTED) {
+    if(send_retained_dataset(socket_info,
+			     socket_info->connector_handle) == REG_SUCCESS) {
+      IOTypes_table.io_def[index].ack_needed = socket_info->retained_use_ack;
+    }
+    else {
+      close_connector_handle_samples(index);
+    }
+  }
 }
 
 /*---------------------------------------------------*/
@@ -838,6 +1153,7 @@ void poll_socket_samples(const int index) {
   int fd_max;		/* the max socket number */
 
   int listener = socket_info_table.socket_info[index].listener_handle;
+  int local_listener = socket_info_table.socket_info[index].local_listener_handle;
   int connector = socket_info_table.socket_info[index].connector_handle;
   int direction = IOTypes_table.io_def[index].direction;
 
@@ -854,6 +1170,10 @@ void poll_socket_samples(const int index) {
     if(socket_info_table.socket_info[index].listener_status == REG_COMMS_STATUS_LISTENING) {
       FD_SET(listener, &sockets);
       fd_max = listener;
+      if(local_listener != -1) {
+	FD_SET(local_listener, &sockets);
+	if(local_listener > fd_max) fd_max = local_listener;
+      }
 
       /* poll using select() */
 #ifdef REG_DEBUG
@@ -864,8 +1184,18 @@ void poll_socket_samples(const int index) {
 	return;
       }
 
-      /* see if anything needs doing */
-      if(FD_ISSET(listener, &sockets)) {
+      /* see if anything needs doing - prefer a local connection */
+      if(local_listener != -1 && FD_ISSET(local_listener, &sockets)) {
+	int new_fd = accept(local_listener, NULL, NULL);
+	if(new_fd == REG_SOCKETS_ERROR) {
+	  perror("accept");
+	  return;
+	}
+	socket_info_table.socket_info[index].connector_handle = new_fd;
+	socket_info_table.socket_info[index].is_local = REG_TRUE;
+	socket_info_table.socket_info[index].comms_status=REG_COMMS_STATUS_CONNECTED;
+      }
+      else if(FD_ISSET(listener, &sockets)) {
 	/* new connection */
 	struct sockaddr_in theirAddr;
 #if defined(__sgi)
@@ -51,9 +51,18 @@
     @author Robert Haines
   */
 
+/* MSG_ZEROCOPY needs the GNU extensions */
+#define _GNU_SOURCE
+
 #include "ReG_Steer_Config.h"
 #include "ReG_Steer_Sockets_Common.h"
 #include "ReG_Steer_Common.h"
+#include "ReG_Steer_Buffer_Pool.h"
+
+#if REG_HAS_MSG_ZEROCOPY
+#include <poll.h>
+#include <linux/errqueue.h>
+#endif
 
 /*--------------------------------------------------------------------*/
 
@@ -136,6 +145,79 @@ int socket_info_init(socket_info_type* socket_info) {
 
   socket_info->comms_status = REG_COMMS_STATUS_NULL;
 
+  socket_info->local_listener_handle = -1;
+  socket_info->local_path = NULL;
+  socket_info->is_local = REG_FALSE;
+  socket_info->uring = NULL;
+
+  socket_info->zerocopy_enabled = REG_FALSE;
+  socket_info->zerocopy_next = 0;
+  socket_info->zerocopy_buffers = NULL;
+  socket_info->zerocopy_num = 0;
+  socket_info->zerocopy_max = 0;
+
+  /* how many TCP connections to stripe data over - the consumer asks
+     for them and the emitter accepts up to its own limit */
+  socket_info->num_streams = 1;
+  if((pchar = getenv("REG_IO_STREAMS"))) {
+    min = atoi(pchar);
+    if(min > REG_MAX_STREAMS) {
+      fprintf(stderr, "STEER: socket_info_init: REG_IO_STREAMS limited "
+	      "to %d\n", REG_MAX_STREAMS);
+      min = REG_MAX_STREAMS;
+    }
+    if(min > 1) socket_info->num_streams = min;
+  }
+  socket_info->streams = 1;
+  socket_info->stream_chunk = REG_STREAM_CHUNK;
+  for(min = 0; min < REG_MAX_STREAMS - 1; min++) {
+    socket_info->stream_handles[min] = -1;
+  }
+
+  /* how many consumers an emitter may send each data set to */
+  socket_info->max_subscribers = 0;
+  if((pchar = getenv("REG_IO_SUBSCRIBERS"))) {
+    min = atoi(pchar);
+    if(min > REG_MAX_SUBSCRIBERS) {
+      fprintf(stderr, "STEER: socket_info_init: REG_IO_SUBSCRIBERS "
+	      "limited to %d\n", REG_MAX_SUBSCRIBERS);
+      min = REG_MAX_SUBSCRIBERS;
+    }
+    if(min > 1) socket_info->max_subscribers = min;
+  }
+  socket_info->num_subscribers = 0;
+  socket_info->subscribers = NULL;
+  socket_info->dataset = NULL;
+  socket_info->spare_dataset = NULL;
+
+  /* whether to hand the last data set to consumers that turn up late */
+  socket_info->retain_last = REG_FALSE;
+  if((pchar = getenv("REG_IO_RETAIN_LAST")) && atoi(pchar) > 0) {
+    socket_info->retain_last = REG_TRUE;
+  }
+  socket_info->retained = NULL;
+  socket_info->retained_use_ack = REG_FALSE;
+
+  /* how big a payload has to be before it's worth sending it without
+     copying - only used by IOTypes with zero-copy enabled */
+#if REG_HAS_MSG_ZEROCOPY
+  socket_info->zerocopy_threshold = REG_ZEROCOPY_THRESHOLD;
+  if((pchar = getenv("REG_IO_ZEROCOPY_THRESHOLD"))) {
+    min = atoi(pchar);
+    if(min <= 0) {
+      socket_info->zerocopy_threshold = 0;
+    }
+    else if(min < REG_ZEROCOPY_MIN_THRESHOLD) {
+      socket_info->zerocopy_threshold = REG_ZEROCOPY_MIN_THRESHOLD;
+    }
+    else {
+      socket_info->zerocopy_threshold = (size_t) min;
+    }
+  }
+#else
+  socket_info->zerocopy_threshold = 0;
+#endif
+
   return REG_SUCCESS;
 }
 
@@ -150,6 +232,21 @@ void socket_info_cleanup(socket_info_type* socket_info) {
 
   if(socket_info->connector_hostname)
     free(socket_info->connector_hostname);
+
+  if(socket_info->local_path)
+    free(socket_info->local_path);
+  socket_info->local_path = NULL;
+
+  if(socket_info->zerocopy_buffers)
+    free(socket_info->zerocopy_buffers);
+  socket_info->zerocopy_buffers = NULL;
+  socket_info->zerocopy_num = 0;
+  socket_info->zerocopy_max = 0;
+
+  close_subscribers(socket_info);
+  if(socket_info->subscribers)
+    free(socket_info->subscribers);
+  socket_info->subscribers = NULL;
 }
 
 /*--------------------------------------------------------------------*/
@@ -300,6 +397,819 @@ ssize_t recv_wait_all(int s, void *buf, size_t len, int flags) {
 
 /*--------------------------------------------------------------------*/
 
+#if REG_HAS_MSG_ZEROCOPY
+/* Read all pending completion notifications from the error queue of
+   socket_info's connection and credit them to the buffers they are
+   for. Returns the number read or -1 on error. */
+static int read_zerocopy_notifications(socket_info_type* socket_info) {
+  struct msghdr             msg;
+  struct cmsghdr*           cmsg;
+  struct sock_extended_err* serr;
+  char                      control[128];
+  unsigned int              lo;
+  unsigned int              hi;
+  unsigned int              first;
+  unsigned int              last;
+  int                       count = 0;
+  int                       i;
+
+  while(REG_TRUE) {
+    memset(&msg, 0, sizeof(struct msghdr));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    if(recvmsg(socket_info->connector_handle, &msg,
+	       MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+      if(errno == EAGAIN || errno == EWOULDBLOCK) return count;
+      if(errno == EINTR) continue;
+      perror("recvmsg");
+      return -1;
+    }
+
+    for(cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if(!((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+	   (cmsg->cmsg_level == SOL_IPV6 &&
+	    cmsg->cmsg_type == IPV6_RECVERR))) {
+	continue;
+      }
+
+      serr = (struct sock_extended_err*) CMSG_DATA(cmsg);
+      if(serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+	continue;
+      }
+
+      /* Sends ee_info to ee_data inclusive are complete. The kernel
+	 never reports a send twice so the counts stay exact. */
+      lo = serr->ee_info;
+      hi = serr->ee_data;
+      for(i = 0; i < socket_info->zerocopy_num; i++) {
+	first = socket_info->zerocopy_buffers[i].first;
+	last = socket_info->zerocopy_buffers[i].last;
+	if(lo > last || hi < first) continue;
+	socket_info->zerocopy_buffers[i].completed +=
+	  (hi < last ? hi : last) - (lo > first ? lo : first) + 1;
+      }
+      count++;
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Remember that sends first..zerocopy_next-1 were made from buf. There
+   is always room as send_zerocopy() makes it before sending. */
+static void track_zerocopy(socket_info_type* socket_info, const void* buf,
+			   unsigned int first) {
+  zerocopy_buffer_type* entry;
+
+  if(socket_info->zerocopy_next == first) return;
+
+  entry = &(socket_info->zerocopy_buffers[socket_info->zerocopy_num++]);
+  entry->data = buf;
+  entry->first = first;
+  entry->last = socket_info->zerocopy_next - 1;
+  entry->completed = 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+int send_zerocopy(socket_info_type* socket_info, const void* buf,
+		  size_t len) {
+  zerocopy_buffer_type* entries;
+  const char*           pchar = (const char*) buf;
+  unsigned int          first = socket_info->zerocopy_next;
+  int                   one = 1;
+  int                   flags = MSG_ZEROCOPY;
+  ssize_t               result;
+
+  if(!socket_info->zerocopy_enabled) {
+    if(setsockopt(socket_info->connector_handle, SOL_SOCKET, SO_ZEROCOPY,
+		  &one, sizeof(one)) != 0) {
+      /* Don't try again on any connection */
+      socket_info->zerocopy_threshold = 0;
+      flags = 0;
+    }
+    else {
+      socket_info->zerocopy_enabled = REG_TRUE;
+    }
+  }
+
+  /* Make room to track the buffer before anything is sent from it */
+  if(flags && socket_info->zerocopy_num == socket_info->zerocopy_max) {
+    entries = (zerocopy_buffer_type*)
+      realloc(socket_info->zerocopy_buffers,
+	      (socket_info->zerocopy_max + 8) * sizeof(zerocopy_buffer_type));
+    if(!entries) {
+      flags = 0;
+    }
+    else {
+      socket_info->zerocopy_buffers = entries;
+      socket_info->zerocopy_max += 8;
+    }
+  }
+
+  while(len > 0) {
+    result = send_no_signal(socket_info->connector_handle, pchar, len,
+			    flags);
+    if(result == REG_SOCKETS_ERROR) {
+      if(errno == EINTR) continue;
+
+      /* Too much memory pinned - wait for the kernel to let go of
+	 what has been sent so far, or just copy if nothing has */
+      if(errno == ENOBUFS && flags) {
+	if(socket_info->zerocopy_next == first) {
+	  flags = 0;
+	  continue;
+	}
+	track_zerocopy(socket_info, buf, first);
+	if(release_zerocopy(socket_info, buf, REG_TRUE) != REG_SUCCESS) {
+	  return REG_FAILURE;
+	}
+	first = socket_info->zerocopy_next;
+	continue;
+      }
+
+      perror("send");
+      return REG_FAILURE;
+    }
+
+    if(flags) socket_info->zerocopy_next++;
+    len -= result;
+    pchar += result;
+  }
+
+  if(flags) track_zerocopy(socket_info, buf, first);
+
+  return REG_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+
+int release_zerocopy(socket_info_type* socket_info, const void* buf,
+		     int block) {
+  zerocopy_buffer_type* entry;
+  struct pollfd         pfd;
+  int                   busy;
+  int                   i;
+  int                   j;
+
+  while(REG_TRUE) {
+    if(socket_info->zerocopy_num == 0) return REG_SUCCESS;
+
+    if(read_zerocopy_notifications(socket_info) < 0) return REG_FAILURE;
+
+    /* Forget buffers the kernel has finished with */
+    busy = REG_FALSE;
+    for(i = 0, j = 0; i < socket_info->zerocopy_num; i++) {
+      entry = &(socket_info->zerocopy_buffers[i]);
+      if(entry->completed == entry->last - entry->first + 1) continue;
+
+      if(!buf || entry->data == buf) busy = REG_TRUE;
+      socket_info->zerocopy_buffers[j++] = *entry;
+    }
+    socket_info->zerocopy_num = j;
+
+    if(!busy) return REG_SUCCESS;
+    if(!block) return REG_NOT_READY;
+
+    /* Notifications show up as POLLERR */
+    pfd.fd = socket_info->connector_handle;
+    pfd.events = 0;
+    pfd.revents = 0;
+    if(poll(&pfd, 1, 1000) == -1 && errno != EINTR) {
+      perror("poll");
+      return REG_FAILURE;
+    }
+    /* Connection gone - notifications may never arrive */
+    if(pfd.revents & (POLLHUP | POLLNVAL)) return REG_FAILURE;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+void reset_zerocopy(socket_info_type* socket_info) {
+  struct pollfd pfd;
+  int           tries = 10;
+
+  while(socket_info->zerocopy_num > 0 && tries-- > 0) {
+    if(release_zerocopy(socket_info, NULL, REG_FALSE) != REG_NOT_READY) {
+      break;
+    }
+    pfd.fd = socket_info->connector_handle;
+    pfd.events = 0;
+    poll(&pfd, 1, 100);
+  }
+
+  if(socket_info->zerocopy_num > 0) {
+    fprintf(stderr, "STEER: reset_zerocopy: %d buffer(s) may still be "
+	    "in use by the kernel\n", socket_info->zerocopy_num);
+  }
+
+  socket_info->zerocopy_num = 0;
+  socket_info->zerocopy_next = 0;
+  socket_info->zerocopy_enabled = REG_FALSE;
+}
+
+#else
+
+/*--------------------------------------------------------------------*/
+
+int send_zerocopy(socket_info_type* socket_info, const void* buf,
+		  size_t len) {
+  return REG_FAILURE;
+}
+
+int release_zerocopy(socket_info_type* socket_info, const void* buf,
+		     int block) {
+  return REG_SUCCESS;
+}
+
+void reset_zerocopy(socket_info_type* socket_info) {}
+
+#endif /* REG_HAS_MSG_ZEROCOPY */
+
+/*--------------------------------------------------------------------*/
+
+/** @internal
+    Handle of connection @p i of those that data is striped over */
+static int stream_handle(socket_info_type* socket_info, const int i) {
+  return i == 0 ? socket_info->connector_handle :
+    socket_info->stream_handles[i - 1];
+}
+
+/** @internal
+    Position in a striped transfer of @p len bytes of the next byte
+    for connection @p i, which has carried @p done bytes so far. On
+    return @p n holds how many bytes from there go down that
+    connection in one piece - zero once it has carried all its share. */
+static size_t stream_offset(socket_info_type* socket_info, const int i,
+			    const size_t done, const size_t len, size_t* n) {
+  size_t chunk = socket_info->stream_chunk;
+  size_t offset;
+
+  offset = ((done / chunk) * socket_info->streams + i) * chunk +
+    done % chunk;
+  if(offset >= len) {
+    *n = 0;
+    return len;
+  }
+
+  *n = chunk - done % chunk;
+  if(*n > len - offset) *n = len - offset;
+
+  return offset;
+}
+
+/*--------------------------------------------------------------------*/
+
+int send_striped(socket_info_type* socket_info, const void* buf,
+		 size_t len) {
+  size_t  done[REG_MAX_STREAMS];
+  size_t  offset;
+  size_t  n;
+  ssize_t result;
+  fd_set  sockets;
+  int     fd_max;
+  int     flags = 0;
+  int     i;
+
+#if REG_HAS_MSG_DONTWAIT
+  flags = MSG_DONTWAIT;
+#endif
+
+  memset(done, 0, sizeof(done));
+
+  while(REG_TRUE) {
+    /* Wait for any connection that still has data to go */
+    FD_ZERO(&sockets);
+    fd_max = -1;
+    for(i = 0; i < socket_info->streams; i++) {
+      stream_offset(socket_info, i, done[i], len, &n);
+      if(n == 0) continue;
+      FD_SET(stream_handle(socket_info, i), &sockets);
+      if(stream_handle(socket_info, i) > fd_max) {
+	fd_max = stream_handle(socket_info, i);
+      }
+    }
+    if(fd_max == -1) break;
+
+    if(select(fd_max + 1, NULL, &sockets, NULL, NULL) == -1) {
+      if(errno == EINTR) continue;
+      perror("select");
+      return REG_FAILURE;
+    }
+
+    for(i = 0; i < socket_info->streams; i++) {
+      offset = stream_offset(socket_info, i, done[i], len, &n);
+      if(n == 0 || !FD_ISSET(stream_handle(socket_info, i), &sockets)) {
+	continue;
+      }
+
+      result = send_no_signal(stream_handle(socket_info, i),
+			      (const char*) buf + offset, n, flags);
+      if(result == REG_SOCKETS_ERROR) {
+	if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+	  continue;
+	}
+	perror("send");
+	return REG_FAILURE;
+      }
+      done[i] += result;
+    }
+  }
+
+  return REG_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+
+ssize_t recv_striped(socket_info_type* socket_info, void* buf,
+		     size_t len) {
+  size_t  done[REG_MAX_STREAMS];
+  size_t  offset;
+  size_t  n;
+  ssize_t result;
+  fd_set  sockets;
+  int     fd_max;
+  int     flags = 0;
+  int     i;
+
+#if REG_HAS_MSG_DONTWAIT
+  flags = MSG_DONTWAIT;
+#endif
+
+  memset(done, 0, sizeof(done));
+
+  while(REG_TRUE) {
+    /* Wait for any connection that still has data to come */
+    FD_ZERO(&sockets);
+    fd_max = -1;
+    for(i = 0; i < socket_info->streams; i++) {
+      stream_offset(socket_info, i, done[i], len, &n);
+      if(n == 0) continue;
+      FD_SET(stream_handle(socket_info, i), &sockets);
+      if(stream_handle(socket_info, i) > fd_max) {
+	fd_max = stream_handle(socket_info, i);
+      }
+    }
+    if(fd_max == -1) break;
+
+    if(select(fd_max + 1, &sockets, NULL, NULL, NULL) == -1) {
+      if(errno == EINTR) continue;
+      perror("select");
+      return -1;
+    }
+
+    for(i = 0; i < socket_info->streams; i++) {
+      offset = stream_offset(socket_info, i, done[i], len, &n);
+      if(n == 0 || !FD_ISSET(stream_handle(socket_info, i), &sockets)) {
+	continue;
+      }
+
+      result = recv(stream_handle(socket_info, i), (char*) buf + offset,
+		    n, flags);
+      if(result == 0) {
+	/* closed connection */
+	return 0;
+      }
+      if(result == REG_SOCKETS_ERROR) {
+	if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+	  continue;
+	}
+	return -1;
+      }
+      done[i] += result;
+    }
+  }
+
+  return (ssize_t) len;
+}
+
+/*--------------------------------------------------------------------*/
+
+void close_streams(socket_info_type* socket_info) {
+  int i;
+
+  for(i = 0; i < REG_MAX_STREAMS - 1; i++) {
+    if(socket_info->stream_handles[i] != -1) {
+      closesocket(socket_info->stream_handles[i]);
+      socket_info->stream_handles[i] = -1;
+    }
+  }
+
+  socket_info->streams = 1;
+  socket_info->stream_chunk = REG_STREAM_CHUNK;
+}
+
+/*--------------------------------------------------------------------*/
+
+/** @internal
+    Drop a reference to a data set, keeping the buffer for the next
+    one once nobody is using it */
+static void release_dataset(socket_info_type* socket_info,
+			    dataset_buffer_type* dataset) {
+  if(--(dataset->refs) > 0) return;
+
+  if(!socket_info->spare_dataset) {
+    dataset->size = 0;
+    socket_info->spare_dataset = dataset;
+  }
+  else {
+    Pool_free(dataset->data);
+    Pool_free(dataset);
+  }
+}
+
+/** @internal
+    Disconnect subscriber @p i */
+static void drop_subscriber(socket_info_type* socket_info, const int i) {
+  subscriber_type* sub = &(socket_info->subscribers[i]);
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: drop_subscriber: dropping subscriber on %d "
+	  "which missed %d data sets\n", sub->handle, sub->skipped);
+#endif
+
+  closesocket(sub->handle);
+  if(sub->dataset) release_dataset(socket_info, sub->dataset);
+
+  socket_info->subscribers[i] =
+    socket_info->subscribers[--(socket_info->num_subscribers)];
+}
+
+/** @internal
+    Accept all the subscribers waiting on @p listener, up to the limit */
+static void accept_subscribers(socket_info_type* socket_info,
+			       const int listener) {
+  struct timeval   timeout;
+  fd_set           sockets;
+  subscriber_type* sub;
+  char             peek[12];
+  int              new_fd;
+
+  while(socket_info->num_subscribers < socket_info->max_subscribers) {
+    timeout.tv_sec  = 0;
+    timeout.tv_usec = 0;
+    FD_ZERO(&sockets);
+    FD_SET(listener, &sockets);
+    if(select(listener + 1, &sockets, NULL, NULL, &timeout) <= 0) return;
+
+    if((new_fd = accept(listener, NULL, NULL)) == REG_SOCKETS_ERROR) {
+      perror("accept");
+      return;
+    }
+
+    /* Consumers asking to stripe data over several connections make
+       the extra ones straight away - we only want their first */
+    if(recv_non_block(new_fd, peek, 12, MSG_PEEK) == 12 &&
+       !strncmp(peek, "<ReG_stream>", 12)) {
+      closesocket(new_fd);
+      continue;
+    }
+
+    sub = &(socket_info->subscribers[socket_info->num_subscribers++]);
+    sub->handle = new_fd;
+    sub->dataset = NULL;
+    sub->sent = 0;
+    sub->use_ack = REG_FALSE;
+    sub->ack_needed = REG_FALSE;
+    sub->ack_bytes = 0;
+    sub->skipped = 0;
+
+    /* Start them off with the last data set rather than have them
+       wait for the next */
+    if(socket_info->retained) {
+      sub->dataset = socket_info->retained;
+      sub->use_ack = socket_info->retained_use_ack;
+      socket_info->retained->refs++;
+    }
+
+#ifdef REG_DEBUG
+    fprintf(stderr, "STEER: accept_subscribers: now have %d "
+	    "subscriber(s)\n", socket_info->num_subscribers);
+#endif
+  }
+}
+
+/** @internal
+    Read whatever acknowledgement @p sub has sent
+    @return REG_FAILURE if the subscriber has gone away */
+static int read_subscriber_ack(subscriber_type* sub) {
+  ssize_t nbytes;
+
+  while(REG_TRUE) {
+    nbytes = recv_non_block(sub->handle, &(sub->ack[sub->ack_bytes]),
+			    16 - sub->ack_bytes, 0);
+    if(nbytes == 0) return REG_FAILURE;
+    if(nbytes < 0) {
+      return (errno == EAGAIN || errno == EWOULDBLOCK ||
+	      errno == EINTR) ? REG_SUCCESS : REG_FAILURE;
+    }
+
+    /* Acks are always 16 bytes */
+    sub->ack_bytes += nbytes;
+    if(sub->ack_bytes == 16) {
+      sub->ack[16] = '\0';
+      if(strstr(sub->ack, "<ACK/>")) sub->ack_needed = REG_FALSE;
+      sub->ack_bytes = 0;
+    }
+  }
+}
+
+/** @internal
+    Send as much of @p sub's data set as won't block
+    @return REG_FAILURE if the subscriber has gone away */
+static int send_subscriber_dataset(socket_info_type* socket_info,
+				   subscriber_type* sub) {
+  ssize_t result;
+  int     flags = 0;
+
+#if REG_HAS_MSG_DONTWAIT
+  flags = MSG_DONTWAIT;
+#endif
+
+  while(sub->dataset && sub->sent < sub->dataset->size) {
+    result = send_no_signal(sub->handle, sub->dataset->data + sub->sent,
+			    sub->dataset->size - sub->sent, flags);
+    if(result == REG_SOCKETS_ERROR) {
+      if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+	return REG_SUCCESS;
+      }
+      return REG_FAILURE;
+    }
+    sub->sent += result;
+  }
+
+  /* All sent - now wait for the consumer to say it's done */
+  if(sub->dataset) {
+    release_dataset(socket_info, sub->dataset);
+    sub->dataset = NULL;
+    sub->ack_needed = sub->use_ack;
+  }
+
+  return REG_SUCCESS;
+}
+
+/** @internal
+    Carry on sending to every subscriber that has a data set on the go,
+    dropping any that have gone away */
+static void pump_subscribers(socket_info_type* socket_info) {
+  int i;
+
+  for(i = socket_info->num_subscribers - 1; i >= 0; i--) {
+    if(socket_info->subscribers[i].dataset &&
+       send_subscriber_dataset(socket_info, &(socket_info->subscribers[i]))
+       != REG_SUCCESS) {
+      drop_subscriber(socket_info, i);
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+int service_subscribers(socket_info_type* socket_info) {
+  subscriber_type* sub;
+  int              ready = REG_FALSE;
+  int              i;
+
+  if(!socket_info->subscribers) {
+    socket_info->subscribers = (subscriber_type*)
+      malloc(socket_info->max_subscribers * sizeof(subscriber_type));
+    if(!socket_info->subscribers) {
+      fprintf(stderr, "STEER: service_subscribers: failed to allocate "
+	      "memory for subscribers\n");
+      return REG_FAILURE;
+    }
+  }
+
+  if(socket_info->listener_status == REG_COMMS_STATUS_LISTENING) {
+    if(socket_info->local_listener_handle != -1) {
+      accept_subscribers(socket_info, socket_info->local_listener_handle);
+    }
+    accept_subscribers(socket_info, socket_info->listener_handle);
+  }
+
+  /* Work backwards as dropping a subscriber moves the last one */
+  for(i = socket_info->num_subscribers - 1; i >= 0; i--) {
+    sub = &(socket_info->subscribers[i]);
+    if(read_subscriber_ack(sub) != REG_SUCCESS ||
+       send_subscriber_dataset(socket_info, sub) != REG_SUCCESS) {
+      drop_subscriber(socket_info, i);
+      continue;
+    }
+
+    if(!sub->dataset && !sub->ack_needed) ready = REG_TRUE;
+  }
+
+  return ready ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*--------------------------------------------------------------------*/
+
+int begin_dataset(socket_info_type* socket_info) {
+
+  /* Anything left from a data set that was never finished */
+  if(socket_info->dataset) {
+    release_dataset(socket_info, socket_info->dataset);
+  }
+
+  if(socket_info->spare_dataset) {
+    socket_info->dataset = socket_info->spare_dataset;
+    socket_info->spare_dataset = NULL;
+  }
+  else {
+    socket_info->dataset = (dataset_buffer_type*)
+      Pool_alloc(sizeof(dataset_buffer_type));
+    if(!socket_info->dataset) {
+      fprintf(stderr, "STEER: begin_dataset: failed to allocate memory "
+	      "for data set\n");
+      return REG_FAILURE;
+    }
+    memset(socket_info->dataset, 0, sizeof(dataset_buffer_type));
+  }
+
+  socket_info->dataset->size = 0;
+  socket_info->dataset->refs = 1;
+
+  return REG_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+
+int append_dataset(socket_info_type* socket_info, const void* buf,
+		   size_t len) {
+  dataset_buffer_type* dataset = socket_info->dataset;
+  size_t               max;
+  char*                data;
+
+  if(!dataset) return REG_FAILURE;
+
+  if(dataset->size + len > dataset->max) {
+    max = dataset->max ? dataset->max : REG_IO_BUFSIZE;
+    while(max < dataset->size + len) max *= 2;
+
+    if(!(data = (char*) Pool_realloc(dataset->data, max))) {
+      fprintf(stderr, "STEER: append_dataset: failed to allocate %lu "
+	      "bytes for data set\n", (unsigned long) max);
+      return REG_FAILURE;
+    }
+    dataset->data = data;
+    dataset->max = Pool_block_size(data);
+  }
+
+  memcpy(dataset->data + dataset->size, buf, len);
+  dataset->size += len;
+
+  /* Keep earlier data sets moving while we're here */
+  pump_subscribers(socket_info);
+
+  return REG_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+
+void publish_dataset(socket_info_type* socket_info, const int use_ack) {
+  dataset_buffer_type* dataset = socket_info->dataset;
+  subscriber_type*     sub;
+  int                  i;
+
+  if(!dataset) return;
+  socket_info->dataset = NULL;
+
+  for(i = 0; i < socket_info->num_subscribers; i++) {
+    sub = &(socket_info->subscribers[i]);
+
+    /* A slow subscriber misses out rather than holding up the rest */
+    if(sub->dataset || sub->ack_needed) {
+      sub->skipped++;
+      continue;
+    }
+
+    sub->dataset = dataset;
+    sub->sent = 0;
+    sub->use_ack = use_ack;
+    dataset->refs++;
+  }
+
+  /* Hang on to it for subscribers yet to arrive, or drop the
+     reference held while building it */
+  if(socket_info->retain_last) {
+    if(socket_info->retained) {
+      release_dataset(socket_info, socket_info->retained);
+    }
+    socket_info->retained = dataset;
+    socket_info->retained_use_ack = use_ack;
+  }
+  else {
+    release_dataset(socket_info, dataset);
+  }
+
+  service_subscribers(socket_info);
+}
+
+/*--------------------------------------------------------------------*/
+
+void abandon_dataset(socket_info_type* socket_info) {
+  if(socket_info->dataset) {
+    release_dataset(socket_info, socket_info->dataset);
+    socket_info->dataset = NULL;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+void retain_dataset(socket_info_type* socket_info, const int use_ack) {
+  dataset_buffer_type* dataset = socket_info->dataset;
+
+  if(!dataset) return;
+  socket_info->dataset = NULL;
+
+  if(socket_info->retained) {
+    release_dataset(socket_info, socket_info->retained);
+  }
+  socket_info->retained = dataset;
+  socket_info->retained_use_ack = use_ack;
+}
+
+/*--------------------------------------------------------------------*/
+
+int send_retained_dataset(socket_info_type* socket_info, const int s) {
+  dataset_buffer_type* dataset = socket_info->retained;
+  size_t               sent = 0;
+  ssize_t              result;
+
+  if(!dataset) return REG_SUCCESS;
+
+  while(sent < dataset->size) {
+    result = send_no_signal(s, dataset->data + sent, dataset->size - sent, 0);
+    if(result == REG_SOCKETS_ERROR) {
+      if(errno == EINTR) continue;
+      perror("send");
+      return REG_FAILURE;
+    }
+    sent += result;
+  }
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: send_retained_dataset: sent %lu bytes to new "
+	  "consumer\n", (unsigned long) sent);
+#endif
+
+  return REG_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+
+void close_subscribers(socket_info_type* socket_info) {
+  struct timeval timeout;
+  fd_set         sockets;
+  int            fd_max;
+  int            tries = 100;
+  int            i;
+
+  /* Give data sets already on their way a while to finish */
+  while(tries-- > 0) {
+    FD_ZERO(&sockets);
+    fd_max = -1;
+    for(i = 0; i < socket_info->num_subscribers; i++) {
+      if(!socket_info->subscribers[i].dataset) continue;
+      FD_SET(socket_info->subscribers[i].handle, &sockets);
+      if(socket_info->subscribers[i].handle > fd_max) {
+	fd_max = socket_info->subscribers[i].handle;
+      }
+    }
+    if(fd_max == -1) break;
+
+    timeout.tv_sec  = 0;
+    timeout.tv_usec = 100000;
+    if(select(fd_max + 1, NULL, &sockets, NULL, &timeout) > 0) {
+      pump_subscribers(socket_info);
+    }
+  }
+
+  while(socket_info->num_subscribers > 0) {
+    drop_subscriber(socket_info, socket_info->num_subscribers - 1);
+  }
+
+  if(socket_info->dataset) {
+    release_dataset(socket_info, socket_info->dataset);
+    socket_info->dataset = NULL;
+  }
+
+  if(socket_info->retained) {
+    release_dataset(socket_info, socket_info->retained);
+    socket_info->retained = NULL;
+  }
+
+  if(socket_info->spare_dataset) {
+    Pool_free(socket_info->spare_dataset->data);
+    Pool_free(socket_info->spare_dataset);
+    socket_info->spare_dataset = NULL;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
 int set_tcpnodelay(int s) {
 #ifdef _MSC_VER
   BOOL yes = TRUE;
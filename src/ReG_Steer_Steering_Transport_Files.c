@@ -246,9 +246,9 @@ struct msg_struct *Get_control_msg_files() {
 
 int Initialize_steering_connection_files(const int  NumSupportedCmds,
 					 int *SupportedCmds) {
-  FILE *fp;
-  char  buf[REG_MAX_MSG_SIZE];
-  char  filename[REG_MAX_STRING_LENGTH];
+  FILE           *fp;
+  Msg_writer_type msg;
+  char            filename[REG_MAX_STRING_LENGTH];
 
   strncpy(Steer_lib_config.Steering_transport_string, "Files", 6);
 
@@ -299,10 +299,16 @@ int Initialize_steering_connection_files(const int  NumSupportedCmds,
 	  filename);
 #endif
 
-  Make_supp_cmds_msg(NumSupportedCmds, SupportedCmds, buf, REG_MAX_MSG_SIZE);
+  if(Make_supp_cmds_msg(NumSupportedCmds, SupportedCmds, &msg,
+			NULL) != REG_SUCCESS){
+    fclose(fp);
+    Delete_msg_writer(&msg);
+    return REG_FAILURE;
+  }
 
-  fprintf(fp, "%s", buf);
+  fwrite(msg.buf, 1, (size_t)(msg.pos - msg.buf), fp);
   fclose(fp);
+  Delete_msg_writer(&msg);
 
   return REG_SUCCESS;
 }
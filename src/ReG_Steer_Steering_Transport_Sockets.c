@@ -62,6 +62,7 @@
 #include "ReG_Steer_Appside_internal.h"
 #include "ReG_Steer_Steerside.h"
 #include "ReG_Steer_Steerside_internal.h"
+#include "ReG_Steer_TLV.h"
 
 /** Basic library config - declared in ReG_Steer_Common */
 extern Steer_lib_config_type Steer_lib_config;
@@ -130,9 +131,14 @@ int Initialize_steering_connection_sockets(const int  NumSupportedCmds,
     return REG_FAILURE;
   }
 
-  /* Create msg about supported commands */
-  Make_supp_cmds_msg(NumSupportedCmds, SupportedCmds,
-		     Steerer_connection.supp_cmds, REG_MAX_MSG_SIZE);
+  /* Create msg about supported commands - including whether we can
+     receive binary messages */
+  if(Make_supp_cmds_msg(NumSupportedCmds, SupportedCmds,
+			&(Steerer_connection.supp_cmds),
+			Tlv_wire_format_enabled() ? "tlv" : NULL)
+     != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
 
   /* try to create listener */
 /*   if(Create_steerer_listener(socket_info) != REG_SUCCESS) { */
@@ -156,6 +162,8 @@ int Initialize_steering_connection_sockets(const int  NumSupportedCmds,
 
 int Finalize_steering_connection_sockets() {
 
+  Delete_msg_writer(&(Steerer_connection.supp_cmds));
+
   if(appside_socket_info.listener_status == REG_COMMS_STATUS_LISTENING) {
     close_steering_listener(&appside_socket_info);
   }
@@ -203,10 +211,14 @@ int Steerer_connected_sockets() {
 
     /* if we are now connected, then send first message */
     if(appside_socket_info.comms_status == REG_COMMS_STATUS_CONNECTED) {
+      /* Talk xml to a new steerer until it shows it can do better */
+      Steerer_connection.wire_format = REG_WIRE_XML;
+
       /* send first message here */
       send_steering_msg(&appside_socket_info,
-			(strlen(Steerer_connection.supp_cmds) + 1),
-			Steerer_connection.supp_cmds);
+			(int)(Steerer_connection.supp_cmds.pos -
+			      Steerer_connection.supp_cmds.buf) + 1,
+			Steerer_connection.supp_cmds.buf);
       return REG_SUCCESS;
     }
   }
@@ -235,6 +247,9 @@ int Detach_from_steerer_sockets() {
   /* send out all the param logs */
   Param_log.send_all         = REG_TRUE;
 
+  /* The next steerer may not understand binary messages */
+  Steerer_connection.wire_format = REG_WIRE_XML;
+
   return REG_SUCCESS;
 }
 
@@ -244,7 +259,9 @@ int Send_status_msg_sockets(char *buf) {
 
   int buf_len;
 
-  buf_len = strlen(buf) + 1; /* +1 for \0 */
+  if((buf_len = Tlv_msg_size(buf)) < 0) {
+    buf_len = strlen(buf) + 1; /* +1 for \0 */
+  }
   if(send_steering_msg(&appside_socket_info, buf_len, buf) == REG_FAILURE) {
     fprintf(stderr, "Send_status_msg: failed to send\n");
     return REG_FAILURE;
@@ -259,24 +276,33 @@ struct msg_struct *Get_control_msg_sockets() {
 
   struct msg_struct* msg = NULL;
   int return_status;
-  char data[REG_MAX_MSG_SIZE];
+  char* data = NULL;
+  int size;
 
   /* will this block? we never want it to! */
   if(poll_steering_msg(&appside_socket_info,
 		       appside_socket_info.connector_handle) == REG_FAILURE)
     return NULL;
 
-  if(consume_steering_msg(&appside_socket_info, data) == REG_SUCCESS) {
+  if(consume_steering_msg(&appside_socket_info, &data,
+			  &size) == REG_SUCCESS) {
+
+    /* A steerer only sends binary messages if we offered to take
+       them, so it can take them from us too */
+    if(Tlv_msg_size(data) > 0 && Tlv_wire_format_enabled()) {
+      Steerer_connection.wire_format = REG_WIRE_TLV;
+    }
 
     msg = New_msg_struct();
 
     /* Pass NULL down here as this is app-side and we have no ptr to
        a Sim_entry struct */
-    return_status = Parse_xml_buf(data, strlen(data), msg, NULL);
+    return_status = parse_steering_msg(data, size, msg, NULL);
 
     if(return_status != REG_SUCCESS) {
       Delete_msg_struct(&msg);
     }
+    free(data);
   }
 
   return msg;
@@ -384,7 +410,8 @@ struct msg_struct *Get_status_msg_sockets(int index, int no_block) {
 
   struct msg_struct* msg = NULL;
   int return_status;
-  char data[REG_MAX_MSG_SIZE];
+  char* data = NULL;
+  int size;
   socket_info_type* socket_info;
 
   socket_info = &(steerer_socket_info_table.socket_info[index]);
@@ -395,16 +422,17 @@ struct msg_struct *Get_status_msg_sockets(int index, int no_block) {
       return NULL;
   }
 
-  if(consume_steering_msg(socket_info, data) == REG_SUCCESS) {
+  if(consume_steering_msg(socket_info, &data, &size) == REG_SUCCESS) {
 
     msg = New_msg_struct();
 
-    return_status = Parse_xml_buf(data, strlen(data), msg,
-				  &(Sim_table.sim[index]));
+    return_status = parse_steering_msg(data, size, msg,
+				       &(Sim_table.sim[index]));
 
     if(return_status != REG_SUCCESS) {
       Delete_msg_struct(&msg);
     }
+    free(data);
   }
 
   return msg;
@@ -419,7 +447,9 @@ int Send_control_msg_sockets(int index, char* buf) {
 
   socket_info = &(steerer_socket_info_table.socket_info[index]);
 
-  buf_len = strlen(buf) + 1; /* +1 for \0 */
+  if((buf_len = Tlv_msg_size(buf)) < 0) {
+    buf_len = strlen(buf) + 1; /* +1 for \0 */
+  }
   if(send_steering_msg(socket_info, buf_len, buf) == REG_FAILURE) {
     fprintf(stderr, "**DIRECT: Send_control_msg_direct: failed to send\n");
     return REG_FAILURE;
@@ -593,7 +623,7 @@ int consume_supp_cmds(int index) {
   }
 
   msg = Get_status_msg_sockets(index, REG_FALSE);
-  if(msg) {
+  if(msg && msg->supp_cmd) {
     cmd = msg->supp_cmd->first_cmd;
 
     while(cmd) {
@@ -610,9 +640,18 @@ int consume_supp_cmds(int index) {
       cmd = cmd->next;
     }
 
+    /* Use binary messages if the app offered to take them */
+    if(msg->supp_cmd->wire_format &&
+       strstr((char*) (msg->supp_cmd->wire_format), "tlv") &&
+       Tlv_wire_format_enabled() &&
+       send_wire_format_ack(socket_info) == REG_SUCCESS) {
+      sim->wire_format = REG_WIRE_TLV;
+    }
+
     Delete_msg_struct(&msg);
   }
   else {
+    if(msg) Delete_msg_struct(&msg);
     fprintf(stderr, "consume_supp_cmds: error parsing cmds\n");
     return REG_FAILURE;
   }
@@ -622,6 +661,41 @@ int consume_supp_cmds(int index) {
 
 /*-------------------------------------------------------*/
 
+int send_wire_format_ack(socket_info_type* socket_info) {
+
+  Msg_writer_type msg;
+  int return_status;
+
+  /* An empty control message in the binary format tells the app
+     that we take binary messages too, without waiting for there to
+     be something to steer */
+  if(Init_msg_writer(&msg, 4*REG_TLV_ELEMENT_HDR,
+		     REG_WIRE_TLV) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
+
+  return_status = Msg_writer_header(&msg);
+  if(return_status == REG_SUCCESS) {
+    return_status = Msg_writer_begin(&msg, MSG_TAG_STEER_CONTROL);
+  }
+  if(return_status == REG_SUCCESS) {
+    return_status = Msg_writer_end(&msg, MSG_TAG_STEER_CONTROL);
+  }
+  if(return_status == REG_SUCCESS) {
+    return_status = Msg_writer_footer(&msg);
+  }
+  if(return_status == REG_SUCCESS) {
+    return_status = send_steering_msg(socket_info,
+				      (size_t) (msg.pos - msg.buf), msg.buf);
+  }
+
+  Delete_msg_writer(&msg);
+
+  return return_status;
+}
+
+/*-------------------------------------------------------*/
+
 int create_steering_connector(socket_info_type* socket_info) {
 
   int i;
@@ -924,10 +998,12 @@ int send_steering_msg(socket_info_type* socket_info,
 
 /*-------------------------------------------------------*/
 
-int consume_steering_msg(socket_info_type* socket_info, char* data) {
+int consume_steering_msg(socket_info_type* socket_info, char** pdata,
+			 int* size) {
 
   int nbytes;
   int data_size;
+  char* data;
   int connector = socket_info->connector_handle;
 
   /* get header */
@@ -945,6 +1021,20 @@ int consume_steering_msg(socket_info_type* socket_info, char* data) {
   }
 #endif
 
+  if(data_size < 1) {
+    fprintf(stderr, "consume_steering_msg: bad message size: %d\n",
+	    data_size);
+    return REG_FAILURE;
+  }
+
+  /* Messages are as big as the sender needs them to be so size
+     the buffer from the header (+1 for \0) */
+  if(!(data = (char*) malloc(data_size + 1))) {
+    fprintf(stderr, "consume_steering_msg: failed to malloc %d bytes\n",
+	    data_size + 1);
+    return REG_FAILURE;
+  }
+
   /* get message */
   nbytes = recv_wait_all(connector, data, data_size, 0);
 
@@ -955,18 +1045,32 @@ int consume_steering_msg(socket_info_type* socket_info, char* data) {
     else {
       perror("recv");
     }
+    free(data);
     return REG_FAILURE;
   }
 
-  if(data[data_size] != '\0') {
-    data[data_size] = '\0';
-  }
+  data[data_size] = '\0';
+  *pdata = data;
+  *size = data_size;
 
   return REG_SUCCESS;
 }
 
 /*-------------------------------------------------------*/
 
+int parse_steering_msg(char* data, int size, struct msg_struct* msg,
+		       Sim_entry_type* sim) {
+
+  /* Each message says for itself which wire format it is in */
+  if(Tlv_msg_size(data) > 0) {
+    return Parse_tlv_buf(data, size, msg, sim);
+  }
+
+  return Parse_xml_buf(data, strlen(data), msg, sim);
+}
+
+/*-------------------------------------------------------*/
+
 int poll_steering_msg(socket_info_type* socket_info, int handle) {
 
   struct timeval timeout;
@@ -62,6 +62,7 @@
 #include "ReG_Steer_Steerside.h"
 #include "ReG_Steer_Steerside_internal.h"
 #include "ReG_Steer_Sockets_Common.h"
+#include "ReG_Steer_Number.h"
 #include "Base64.h"
 #include "soapH.h"
 
@@ -261,11 +262,13 @@ int Initialize_steering_connection_wsrf(const int  NumSupportedCmds,
   }
 
   /* Create msg to send to SGS */
-  Make_supp_cmds_msg(NumSupportedCmds, SupportedCmds,
-		     Steerer_connection.supp_cmds, REG_MAX_MSG_SIZE);
+  if(Make_supp_cmds_msg(NumSupportedCmds, SupportedCmds,
+			&(Steerer_connection.supp_cmds), NULL) != REG_SUCCESS) {
+    return REG_FAILURE;
+  }
 
   /* Strip off any xml version declaration */
-  pchar = strstr(Steerer_connection.supp_cmds,"<ReG_steer_message");
+  pchar = strstr(Steerer_connection.supp_cmds.buf, "<ReG_steer_message");
 
   snprintf(query_buf, REG_MAX_MSG_SIZE, "<%s>%s</%s>",
 	  SUPPORTED_CMDS_RP, pchar, SUPPORTED_CMDS_RP);
@@ -333,6 +336,8 @@ int Finalize_steering_connection_wsrf() {
 	      1,
 	      commands);
 
+  Delete_msg_writer(&(Steerer_connection.supp_cmds));
+
   create_WSRF_header(appside_SGS_info.soap,
                      appside_SGS_info.address,
 		     appside_SGS_info.username,
@@ -826,6 +831,8 @@ int Record_checkpoint_set_wsrf(int ChkType, char* ChkTag, char* Path) {
   char   node_data[REG_MAX_MSG_SIZE];
   char  *pchar;
   char  *pTag;
+  char  *pTime;
+  char   value_buf[REG_NUM_BUF_LEN];
   time_t time_now;
   int    index;
   struct sws__RecordCheckpointResponse response;
@@ -992,13 +999,16 @@ int Record_checkpoint_set_wsrf(int ChkType, char* ChkTag, char* Path) {
 
       /* Get timestamp */
       if( (int)(time_now = time(NULL)) != -1){
-	strcpy(Params_table.param[i].value, ctime(&time_now));
+	pTime = ctime(&time_now);
 	/* Remove new-line character */
-	Params_table.param[i].value[strlen(pchar)-1] = '\0';
+	status = Param_value_set_string(&(Params_table.param[i].value),
+					pTime, (int)strlen(pTime)-1);
       }
       else{
-	strcpy(Params_table.param[i].value, "");
+	status = Param_value_set_string(&(Params_table.param[i].value),
+					"", 0);
       }
+      if(status != REG_SUCCESS) return REG_FAILURE;
     }
 
     /* Don't include raw binary parameters in the log */
@@ -1014,7 +1024,9 @@ int Record_checkpoint_set_wsrf(int ChkType, char* ChkTag, char* Path) {
 		      "<Value>%s</Value>\n</Param>\n",
 		      Params_table.param[i].handle,
 		      Params_table.param[i].label,
-		      Params_table.param[i].value);
+		      Param_value_to_string(Params_table.param[i].type,
+					    &(Params_table.param[i].value),
+					    value_buf));
 
     /* Check for truncation */
     if((nbytes >= (bytes_left-1)) || (nbytes < 1)){
@@ -1516,7 +1528,7 @@ int Get_param_log_wsrf(int sim_index, int handle) {
 
     while(1) {
 
-      sscanf(ptr1, "%f", &dum_float);
+      Parse_float(ptr1, &dum_float);
       sim->Params_table.param[param_index].log[log_index++] = (double)dum_float;
 
       if(!(ptr1 = strchr(ptr1, ' ')))break;
@@ -1533,7 +1545,8 @@ int Get_param_log_wsrf(int sim_index, int handle) {
 
     while(1) {
 
-      sscanf(ptr1, "%lg", &(sim->Params_table.param[param_index].log[log_index++]) );
+      Parse_double(ptr1,
+		   &(sim->Params_table.param[param_index].log[log_index++]));
 
       if(!(ptr1 = strchr(ptr1, ' ')))break;
       if(*(++ptr1) == '\0')break;
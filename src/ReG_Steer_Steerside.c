@@ -57,6 +57,7 @@
 #include "ReG_Steer_Steerside_internal.h"
 #include "ReG_Steer_Browser.h"
 #include "ReG_Steer_XML.h"
+#include "ReG_Steer_Number.h"
 #include "Base64.h"
 #include "ReG_Steer_Steering_Transport_API.h"
 
@@ -188,6 +189,7 @@ int Steerer_finalize()
   Sim_table.num_registered = 0;
   Sim_table.max_entries    = 0;
 
+  Free_msg_writer_bufs();
   Cleanup_xml_parser();
 
   return REG_SUCCESS;
@@ -228,6 +230,9 @@ int Sim_attach_secure(const char                     *SimID,
 
   sim_ptr->msg             = NULL;
   sim_ptr->detached        = REG_TRUE;
+  /* Steering transport may switch this once it knows what the
+     simulation understands */
+  sim_ptr->wire_format     = REG_WIRE_XML;
 
   /* Initialise the table for keeping track of msg uid's that we've
      seen before */
@@ -253,6 +258,7 @@ int Sim_attach_secure(const char                     *SimID,
 
   sim_ptr->Params_table.num_registered = 0;
   sim_ptr->Params_table.max_entries    = REG_INITIAL_NUM_PARAMS;
+  Init_param_table_index(&(sim_ptr->Params_table));
 
   for(i=0; i<Sim_table.sim[current_sim].Params_table.max_entries; i++){
 
@@ -351,12 +357,7 @@ int Sim_attach_secure(const char                     *SimID,
     return REG_MEM_FAIL;
   }
 
-  for(i=0; i<sim_ptr->Chk_log.max_entries; i++){
-
-    for(j=0; j<REG_MAX_NUM_STR_PARAMS; j++){
-      sim_ptr->Chk_log.entry[i].param[j].handle = REG_PARAM_HANDLE_NOTSET;
-    }
-  }
+  Init_log_entries(&(sim_ptr->Chk_log), 0);
 
   /* Initialize security. This is SSL if available or
      plain username + password otherwise. */
@@ -407,8 +408,7 @@ int Sim_attach_secure(const char                     *SimID,
     sim_ptr->IOdef_table.io_def = NULL;
     free(sim_ptr->Chkdef_table.io_def);
     sim_ptr->Chkdef_table.io_def = NULL;
-    free(sim_ptr->Chk_log.entry);
-    sim_ptr->Chk_log.entry = NULL;
+    Delete_log_entries(&(sim_ptr->Chk_log));
   }
 
   return return_status;
@@ -513,7 +513,9 @@ int Consume_param_defs(int SimHandle)
   int                  index;
   int                  j;
   struct param_struct *ptr = NULL;
+  param_entry         *param;
   int                  handle;
+  int                  limit_type;
   int                  return_status = REG_SUCCESS;
 
   /* Read a message containing parameter definitions.  Table of
@@ -560,6 +562,17 @@ int Consume_param_defs(int SimHandle)
 	strcpy(Sim_table.sim[index].Params_table.param[j].label,
 	       (char *)(ptr->label));
       }
+      else{
+	Sim_table.sim[index].Params_table.param[j].label[0] = '\0';
+      }
+
+      if(Param_table_index_add(&(Sim_table.sim[index].Params_table), j)
+	 != REG_SUCCESS){
+	Sim_table.sim[index].Params_table.param[j].handle =
+	  REG_PARAM_HANDLE_NOTSET;
+	return_status = REG_FAILURE;
+	break;
+      }
 
       if(ptr->steerable){
 	sscanf((char *)(ptr->steerable), "%d",
@@ -583,51 +596,34 @@ int Consume_param_defs(int SimHandle)
 	}
       }
 
-      if(ptr->min_val){
-	strcpy(Sim_table.sim[index].Params_table.param[j].min_val,
-	       (char *)ptr->min_val);
-	Sim_table.sim[index].Params_table.param[j].min_val_valid = REG_TRUE;
+      /* Limits of string and 'raw data' parameters are lengths.
+	 Absence of a bound in the xml message (or one we can't parse)
+	 indicates no bound is set */
+      param = &(Sim_table.sim[index].Params_table.param[j]);
+      limit_type = Param_limit_type(param->type);
+      param->min_val_valid = REG_FALSE;
+      if(ptr->min_val &&
+	 Param_value_from_string(limit_type, (char *)ptr->min_val,
+				 &(param->min_val)) == REG_SUCCESS){
+	param->min_val_valid = REG_TRUE;
       }
-      else{
-	/* Absence of a bound in the xml message indicates no bound
-	   is set */
-	sprintf(Sim_table.sim[index].Params_table.param[j].min_val, "--");
-	Sim_table.sim[index].Params_table.param[j].min_val_valid = REG_FALSE;
-      }
-
-      if(ptr->max_val){
-	strcpy(Sim_table.sim[index].Params_table.param[j].max_val,
-	       (char *)ptr->max_val);
-	Sim_table.sim[index].Params_table.param[j].max_val_valid = REG_TRUE;
-      }
-      else{
-	/* Absence of a bound in the xml message indicates no bound
-	   is set */
-	sprintf(Sim_table.sim[index].Params_table.param[j].max_val, "--");
-	Sim_table.sim[index].Params_table.param[j].max_val_valid = REG_FALSE;
+      param->max_val_valid = REG_FALSE;
+      if(ptr->max_val &&
+	 Param_value_from_string(limit_type, (char *)ptr->max_val,
+				 &(param->max_val)) == REG_SUCCESS){
+	param->max_val_valid = REG_TRUE;
       }
 
       /* Special memory buffer for 'raw data' type of monitored parameter */
-      if(Sim_table.sim[index].Params_table.param[j].type == REG_BIN){
-	 if(Sim_table.sim[index].Params_table.param[j].max_val_valid == REG_TRUE){
+      if(param->type == REG_BIN && param->max_val_valid == REG_TRUE){
 
-	   Sim_table.sim[index].Params_table.param[j].ptr_raw =
-	     malloc(atoi(Sim_table.sim[index].Params_table.param[j].max_val));
-	   Sim_table.sim[index].Params_table.param[j].raw_buf_size =
-	     atoi(Sim_table.sim[index].Params_table.param[j].max_val);
-
-	   /* Won't have a traditional value field so blank it */
-	   sprintf(Sim_table.sim[index].Params_table.param[j].value, " ");
-	 }
+	param->ptr_raw = malloc(param->max_val.i);
+	param->raw_buf_size = param->max_val.i;
       }
-      /*
-      else if(ptr->value){
-	strcpy(Sim_table.sim[index].Params_table.param[j].value,
-	(char *)(ptr->value));
-      }*/
+
       /* Don't take the value supplied when param first registered
 	 as may not be valid */
-      Sim_table.sim[index].Params_table.param[j].value[0] = '\0';
+      param->value_set = REG_FALSE;
 
       Sim_table.sim[index].Params_table.num_registered++;
     }
@@ -974,8 +970,10 @@ int Consume_chk_log(Sim_entry_type *sim,
 		    struct chk_log_entry_struct *entry)
 {
   int                  index, count;
+  int                  handle, type, i;
   int                  return_status = REG_SUCCESS;
   struct param_struct *param_ptr = NULL;
+  Param_value_type     value;
 
   index = sim->Chk_log.num_entries;
 
@@ -997,24 +995,42 @@ int Consume_chk_log(Sim_entry_type *sim,
 
   while(param_ptr){
 
-    if(param_ptr->handle){
-      sscanf((char *)(param_ptr->handle), "%d",
-	     &(sim->Chk_log.entry[index].param[count].handle));
+    if(Realloc_log_entry_params(&(sim->Chk_log.entry[index]),
+				count + 1) != REG_SUCCESS){
+      return_status = REG_FAILURE;
+      break;
     }
-    if(param_ptr->value){
-      strcpy(sim->Chk_log.entry[index].param[count].value,
-	     (char *)(param_ptr->value));
+    handle = REG_PARAM_HANDLE_NOTSET;
+    if(param_ptr->handle){
+      sscanf((char *)(param_ptr->handle), "%d", &handle);
     }
-    param_ptr = param_ptr->next;
 
-    if(++count >= REG_MAX_NUM_STR_PARAMS){
-
-      fprintf(stderr, "STEER: WARNING: Consume_chk_log: discarding parameter "
-	      "because max. no. of %d exceeded\n",
-	      REG_MAX_NUM_STR_PARAMS);
-      break;
+    /* Store the value in the type of the parameter it belongs to,
+       falling back to keeping its text if we can't do that */
+    memset(&value, 0, sizeof(Param_value_type));
+    type = REG_CHAR;
+    i = Param_index_from_handle(&(sim->Params_table), handle);
+    if(i != -1 && sim->Params_table.param[i].type != REG_BIN){
+      type = sim->Params_table.param[i].type;
+    }
+    if(param_ptr->value &&
+       Param_value_from_string(type, (char *)(param_ptr->value),
+			       &value) != REG_SUCCESS){
+      type = REG_CHAR;
+      memset(&value, 0, sizeof(Param_value_type));
+      Param_value_from_string(type, (char *)(param_ptr->value), &value);
+    }
+    if(Set_log_param_value(&(sim->Chk_log.entry[index].param[count]),
+			   handle, type, &value) != REG_SUCCESS){
+      return_status = REG_FAILURE;
     }
+    Free_param_value(type, &value);
+    if(return_status != REG_SUCCESS) break;
+
+    param_ptr = param_ptr->next;
+    count++;
   }
+  sim->Chk_log.entry[index].num_param = count;
 
     entry = entry->next;
   }
@@ -1084,13 +1100,12 @@ int Consume_param_log(Sim_entry_type *sim,
 	sim->Params_table.param[i].log[index++] = (double)dum_long;
         break;
       case REG_FLOAT:
-	sscanf((char *)(param_ptr->value), "%f",
-	       &dum_float);
+	Parse_float((char *)(param_ptr->value), &dum_float);
 	sim->Params_table.param[i].log[index++] = (double)dum_float;
 	break;
       case REG_DBL:
-	sscanf((char *)(param_ptr->value), "%lg",
-	       &(sim->Params_table.param[i].log[index++]) );
+	Parse_double((char *)(param_ptr->value),
+		     &(sim->Params_table.param[i].log[index++]));
 	break;
       case REG_CHAR:
 	/* This not implemented yet */
@@ -1139,6 +1154,7 @@ int Consume_status(int   SimHandle,
   int                  index;
   int                  handle;
   int                  count;
+  int                  num_lost;
   int                  return_status;
   /* int                  k; For dbg output of Base64 */
 
@@ -1171,7 +1187,14 @@ int Consume_status(int   SimHandle,
   }
 
   count = 0;
-  while(cmd_ptr){
+  num_lost = 0;
+  for(; cmd_ptr; cmd_ptr = cmd_ptr->next){
+
+    /* The caller's array only holds REG_MAX_NUM_STR_CMDS */
+    if(count >= REG_MAX_NUM_STR_CMDS){
+      num_lost++;
+      continue;
+    }
 
     if(cmd_ptr->id){
       sscanf((char *)(cmd_ptr->id), "%d", &(Commands[count]));
@@ -1193,23 +1216,22 @@ int Consume_status(int   SimHandle,
 	  else{
 	    fprintf(stderr, "STEER: Consume_status: unrecognised cmd name: %s\n",
 		    (char *)cmd_ptr->name);
-	    cmd_ptr = cmd_ptr->next;
+	    continue;
 	  }
     }
     else{
       fprintf(stderr, "STEER: ERROR: Consume_status: skipping cmd because is missing "
 	      "both id and name\n");
-      cmd_ptr = cmd_ptr->next;
+      continue;
     }
 
     count++;
+  }
 
-    if(count >= REG_MAX_NUM_STR_CMDS){
-
-      fprintf(stderr, "STEER: WARNING: Consume_status: truncating list of cmds\n");
-      break;
-    }
-    cmd_ptr = cmd_ptr->next;
+  if(num_lost > 0){
+    fprintf(stderr, "STEER: WARNING: Consume_status: status msg holds %d "
+	    "more cmds than the %d that can be returned\n", num_lost,
+	    REG_MAX_NUM_STR_CMDS);
   }
 
   *NumCmds = count;
@@ -1218,7 +1240,9 @@ int Consume_status(int   SimHandle,
   fprintf(stderr, "STEER: Consume_status: got %d commands\n", (*NumCmds));
 #endif
 
-  /* ...and now the parameters... */
+  /* ...and now the parameters. The report may only hold those that
+     have changed since the last one (see Enable_delta_status()) so
+     any not in it keep the values we already have. */
 
   param_ptr = Sim_table.sim[index].msg->status->first_param;
 
@@ -1259,18 +1283,19 @@ int Consume_status(int   SimHandle,
 	}
 	printf("<<ARPDBG\n");
 	*/
-
-	/* Put blank in actual 'value' field */
-	sprintf(Sim_table.sim[index].Params_table.param[j].value, " ");
+      }
+      else if(Param_value_from_string(
+		Sim_table.sim[index].Params_table.param[j].type,
+		(char *)(param_ptr->value),
+		&(Sim_table.sim[index].Params_table.param[j].value))
+	      == REG_SUCCESS){
+	Sim_table.sim[index].Params_table.param[j].value_set = REG_TRUE;
       }
       else{
-	strcpy(Sim_table.sim[index].Params_table.param[j].value,
-	       (char *)(param_ptr->value));
+	fprintf(stderr, "STEER: Consume_status: failed to read value of "
+		"param with handle %d\n", handle);
       }
     }
-    else{
-      sprintf(Sim_table.sim[index].Params_table.param[j].value, " ");
-    }
 
     count++;
     param_ptr = param_ptr->next;
@@ -1284,7 +1309,7 @@ int Consume_status(int   SimHandle,
   }
   else{
 
-    sscanf(Sim_table.sim[index].Params_table.param[j].value, "%d", SeqNum);
+    *SeqNum = Sim_table.sim[index].Params_table.param[j].value.i;
   }
 
   /* Clean up */
@@ -1405,15 +1430,13 @@ int Emit_control(int    SimHandle,
 		 int   *SysCommands,
 		 char **SysCmdParams)
 {
-  int   i;
-  int   simid;
-  int   count;
-  int   num_to_emit;
-  char  param_buf[REG_MAX_STRING_LENGTH];
-  char *param_ptr;
-  char  buf[REG_MAX_MSG_SIZE];
-  char *pbuf;
-  int   bytes_left = REG_MAX_MSG_SIZE;
+  int             i;
+  int             simid;
+  int             count;
+  int             status;
+  char            param_buf[REG_MAX_STRING_LENGTH];
+  char           *param_ptr;
+  Msg_writer_type msg;
 
   /* Find the simulation referred to */
 
@@ -1423,47 +1446,50 @@ int Emit_control(int    SimHandle,
     return REG_FAILURE;
   }
 
-  /* Create control message in buffer */
-  pbuf = buf;
-  Write_xml_header(&pbuf, &bytes_left);
-
-  pbuf += sprintf(pbuf, "<Steer_control>\n");
-
-  /* Enforce a hard limit of no more than REG_MAX_NUM_STR_CMDS commands
-     per message */
-
-  num_to_emit = NumCommands;
-  if(NumCommands >= REG_MAX_NUM_STR_CMDS){
-
-    num_to_emit = REG_MAX_NUM_STR_CMDS;
-    fprintf(stderr, "STEER: WARNING: Emit_control: no. of emitted commands is "
-	    "limited to %d\n", REG_MAX_NUM_STR_CMDS);
+  /* Create control message in a buffer that grows to hold however
+     many commands and parameters there are, in whichever wire format
+     was agreed when we attached */
+  if(Init_msg_writer(&msg, REG_MAX_MSG_SIZE,
+		     Sim_table.sim[simid].wire_format) != REG_SUCCESS){
+    return REG_FAILURE;
+  }
+  status = Msg_writer_header(&msg);
+  if(status == REG_SUCCESS){
+    status = Msg_writer_begin(&msg, MSG_TAG_STEER_CONTROL);
   }
 
-  for(i=0; i<num_to_emit; i++){
+  for(i=0; i<NumCommands && status == REG_SUCCESS; i++){
 
     /* Check that simulation supports each requested command */
     if(Command_supported(simid, SysCommands[i])==REG_SUCCESS){
 
-      pbuf += sprintf(pbuf, "<Command>\n");
-      pbuf += sprintf(pbuf, "  <Cmd_id>%d</Cmd_id>\n", SysCommands[i]);
+      status = Msg_writer_begin(&msg, MSG_TAG_COMMAND);
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_int(&msg, MSG_TAG_CMD_ID, SysCommands[i]);
+      }
 
       if(SysCmdParams){
 
 	strcpy(param_buf, SysCmdParams[i]);
 
 	param_ptr = strtok(param_buf, " ");
-	while(param_ptr){
+	while(param_ptr && status == REG_SUCCESS){
 
-    	  pbuf += sprintf(pbuf, "  <Cmd_param>\n");
-	  pbuf += sprintf(pbuf, "    <Value>%s</Value>\n", param_ptr);
-	  pbuf += sprintf(pbuf, "  </Cmd_param>\n");
+	  status = Msg_writer_begin(&msg, MSG_TAG_CMD_PARAM);
+	  if(status == REG_SUCCESS){
+	    status = Msg_writer_element_string(&msg, MSG_TAG_VALUE, param_ptr);
+	  }
+	  if(status == REG_SUCCESS){
+	    status = Msg_writer_end(&msg, MSG_TAG_CMD_PARAM);
+	  }
 
 	  param_ptr = strtok(NULL, " ");
 	}
 
       }
-      pbuf += sprintf(pbuf, "</Command>\n");
+      if(status == REG_SUCCESS){
+	status = Msg_writer_end(&msg, MSG_TAG_COMMAND);
+      }
     }
   }
 
@@ -1471,28 +1497,26 @@ int Emit_control(int    SimHandle,
 
   count = 0;
 
-  for(i=0; i<Sim_table.sim[simid].Params_table.max_entries; i++){
+  for(i=0; i<Sim_table.sim[simid].Params_table.max_entries &&
+	status == REG_SUCCESS; i++){
 
     if( (Sim_table.sim[simid].Params_table.param[i].handle !=
 	 REG_PARAM_HANDLE_NOTSET) &&
 	Sim_table.sim[simid].Params_table.param[i].modified ){
 
-      /* Enforce a hard limit on the number of parameters that may
-	 be transmitted at any one time */
-
-      if(count == REG_MAX_NUM_STR_PARAMS){
-
-	fprintf(stderr, "STEER: WARNING: Emit_control: no. of emitted params is "
-	        "limited to %d\n", REG_MAX_NUM_STR_PARAMS);
-	break;
+      status = Msg_writer_begin(&msg, MSG_TAG_PARAM);
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_int(&msg, MSG_TAG_HANDLE,
+			    Sim_table.sim[simid].Params_table.param[i].handle);
+      }
+      if(status == REG_SUCCESS){
+	status = Msg_writer_element_value(&msg, MSG_TAG_VALUE,
+			      Sim_table.sim[simid].Params_table.param[i].type,
+			      &(Sim_table.sim[simid].Params_table.param[i].value));
+      }
+      if(status == REG_SUCCESS){
+	status = Msg_writer_end(&msg, MSG_TAG_PARAM);
       }
-
-      pbuf += sprintf(pbuf, "<Param>\n");
-      pbuf += sprintf(pbuf, "<Handle>%d</Handle>\n",
-	      Sim_table.sim[simid].Params_table.param[i].handle);
-      pbuf += sprintf(pbuf, "<Value>%s</Value>\n",
-	      Sim_table.sim[simid].Params_table.param[i].value);
-      pbuf += sprintf(pbuf, "</Param>\n");
 
       /* Unset 'modified' flag */
       Sim_table.sim[simid].Params_table.param[i].modified = REG_FALSE;
@@ -1501,27 +1525,44 @@ int Emit_control(int    SimHandle,
     }
   }
 
+  if(status != REG_SUCCESS){
+
+    fprintf(stderr, "STEER: Emit_control: failed to build message\n");
+    Delete_msg_writer(&msg);
+    return REG_FAILURE;
+  }
+
   /* No parameters or commands to send so we're done */
-  if(count==0 && num_to_emit==0){
+  if(count==0 && NumCommands==0){
 
 #ifdef REG_DEBUG
     fprintf(stderr, "STEER: Emit_control: nothing to send\n");
 #endif
+    Delete_msg_writer(&msg);
     return REG_SUCCESS;
   }
 
-  pbuf += sprintf(pbuf, "</Steer_control>\n");
+  if(Msg_writer_end(&msg, MSG_TAG_STEER_CONTROL) != REG_SUCCESS ||
+     Msg_writer_footer(&msg) != REG_SUCCESS){
 
-  /* how much space is left in the buffer?
-     might as well add the \0 here too. */
-  i = REG_MAX_MSG_SIZE - (strlen(buf) + 1);
-  Write_xml_footer(&pbuf, i);
+    Delete_msg_writer(&msg);
+    return REG_FAILURE;
+  }
 
 #ifdef REG_DEBUG
-  fprintf(stderr, "STEER: Emit_control: sending:\n>>%s<<\n", buf);
+  if(msg.format == REG_WIRE_XML){
+    fprintf(stderr, "STEER: Emit_control: sending:\n>>%s<<\n", msg.buf);
+  }
+  else{
+    fprintf(stderr, "STEER: Emit_control: sending %d-byte binary "
+	    "message\n", (int)(msg.pos - msg.buf));
+  }
 #endif
 
-  return Send_control_msg(simid, buf);
+  status = Send_control_msg(simid, msg.buf);
+  Delete_msg_writer(&msg);
+
+  return status;
 }
 
 /*--------------------------------------------------------------------*/
@@ -1574,10 +1615,9 @@ int Delete_sim_table_entry(int *SimHandle)
   if (sim->Chkdef_table.io_def) free(sim->Chkdef_table.io_def);
   sim->Chkdef_table.io_def = NULL;
 
+  Delete_log_entries(&(sim->Chk_log));
   sim->Chk_log.num_entries = 0;
   sim->Chk_log.max_entries = 0;
-  if (sim->Chk_log.entry) free(sim->Chk_log.entry);
-  sim->Chk_log.entry = NULL;
 
   for(i=0; i<sim->Params_table.max_entries; i++){
     if(sim->Params_table.param[i].handle != REG_PARAM_HANDLE_NOTSET){
@@ -1617,6 +1657,8 @@ int Delete_param_table(Param_table_type *param_table)
       param_table->param[i].log = NULL;
       param_table->param[i].log_size = 0;
       param_table->param[i].log_index = 0;
+
+      Free_param_entry_values(&(param_table->param[i]));
     }
   }
 
@@ -1624,6 +1666,7 @@ int Delete_param_table(Param_table_type *param_table)
     free(param_table->param);
     param_table->param = NULL;
   }
+  Delete_param_table_index(param_table);
 
   param_table->num_registered = 0;
   param_table->max_entries = 0;
@@ -1666,6 +1709,8 @@ int Dump_sim_table()
   int   iotype;
   int   icmd;
 
+  char  buf[REG_NUM_BUF_LEN];
+
   FILE *fp;
   Sim_entry_type *simptr;
   param_entry    *paramptr;
@@ -1703,10 +1748,16 @@ int Dump_sim_table()
  	  fprintf(fp, "strble    = %d\n", paramptr->steerable);
  	  fprintf(fp, "type      = %d\n", paramptr->type);
  	  fprintf(fp, "handle    = %d\n", paramptr->handle);
- 	  fprintf(fp, "value     = %s\n\n", paramptr->value);
- 	  fprintf(fp, "min       = %s\n\n", paramptr->min_val);
+ 	  fprintf(fp, "value     = %s\n\n",
+		  Param_value_to_string(paramptr->type, &(paramptr->value),
+					buf));
+ 	  fprintf(fp, "min       = %s\n\n",
+		  Param_value_to_string(Param_limit_type(paramptr->type),
+					&(paramptr->min_val), buf));
  	  fprintf(fp, "min_valid = %d\n\n", paramptr->min_val_valid);
- 	  fprintf(fp, "max       = %s\n\n", paramptr->max_val);
+ 	  fprintf(fp, "max       = %s\n\n",
+		  Param_value_to_string(Param_limit_type(paramptr->type),
+					&(paramptr->max_val), buf));
  	  fprintf(fp, "max_valid = %d\n\n", paramptr->max_val_valid);
 
  	  paramptr++;
@@ -1732,7 +1783,8 @@ int Dump_sim_table()
           iparam = Param_index_from_handle(&(simptr->Params_table),
 			                   ioptr->freq_param_handle);
           if(iparam != -1){
- 	    fprintf(fp, "frequency = %s\n", simptr->Params_table.param[iparam].value);
+ 	    fprintf(fp, "frequency = %d\n",
+		    simptr->Params_table.param[iparam].value.i);
 	  }
 
  	  fprintf(fp, "\n");
@@ -1760,7 +1812,8 @@ int Dump_sim_table()
           iparam = Param_index_from_handle(&(simptr->Params_table),
 			                   ioptr->freq_param_handle);
           if(iparam != -1){
- 	    fprintf(fp, "frequency = %s\n", simptr->Params_table.param[iparam].value);
+ 	    fprintf(fp, "frequency = %d\n",
+		    simptr->Params_table.param[iparam].value.i);
 	  }
 
  	  fprintf(fp, "\n");
@@ -1848,6 +1901,8 @@ int Get_param_values(int    sim_handle,
   int isim;
   int i;
   int count;
+  param_entry *param;
+  char buf[REG_NUM_BUF_LEN];
 
   /* Return lists of registered parameter handles and associated
      values (as strings), types and limits for the steered simulation
@@ -1888,21 +1943,30 @@ int Get_param_values(int    sim_handle,
 	     supplied from F90) */
 	  trimWhiteSpace(param_details[count].label);
 
-	  strcpy(param_details[count].value,
-		 Sim_table.sim[isim].Params_table.param[i].value);
-
           param_details[count].type = Sim_table.sim[isim].Params_table.param[i].type;
 
-	  if(Sim_table.sim[isim].Params_table.param[i].min_val_valid == REG_TRUE){
+	  /* Values are only turned into text here, for the caller */
+	  param = &(Sim_table.sim[isim].Params_table.param[i]);
+	  if(param->value_set == REG_TRUE){
+	    strcpy(param_details[count].value,
+		   Param_value_to_string(param->type, &(param->value), buf));
+	  }
+	  else{
+	    param_details[count].value[0] = '\0';
+	  }
+
+	  if(param->min_val_valid == REG_TRUE){
 	    strcpy(param_details[count].min_val,
-		   Sim_table.sim[isim].Params_table.param[i].min_val);
+		   Param_value_to_string(Param_limit_type(param->type),
+					 &(param->min_val), buf));
 	  }
 	  else{
 	    sprintf(param_details[count].min_val, "--");
 	  }
-	  if(Sim_table.sim[isim].Params_table.param[i].max_val_valid == REG_TRUE){
+	  if(param->max_val_valid == REG_TRUE){
 	    strcpy(param_details[count].max_val,
-		   Sim_table.sim[isim].Params_table.param[i].max_val);
+		   Param_value_to_string(Param_limit_type(param->type),
+					 &(param->max_val), buf));
 	  }
 	  else{
 	    sprintf(param_details[count].max_val, "--");
@@ -1941,13 +2005,15 @@ int Set_param_values(int    sim_handle,
   int index;
   int i;
   int outside_range;
+  int limit_type;
 
-  int    ivalue, imin, imax;
-  long   lvalue, llimit;
-  float  fvalue, fmin, fmax;
-  double dvalue, dmin, dmax;
+  param_entry     *param;
+  Param_value_type value;
+  char             value_buf[REG_NUM_BUF_LEN];
+  char             min_buf[REG_NUM_BUF_LEN];
+  char             max_buf[REG_NUM_BUF_LEN];
 
-  /* Set the 'values' (held as strings) of the listed params */
+  /* Set the values of the listed params from the strings supplied */
 
   isim = Sim_index_from_handle(sim_handle);
   if(isim != REG_SIM_HANDLE_NOTSET){
@@ -1959,125 +2025,75 @@ int Set_param_values(int    sim_handle,
 	return_status = REG_FAILURE;
 	break;
       }
+      param = &(Sim_table.sim[isim].Params_table.param[index]);
 
       /* Only set the value if parameter is steerable */
 
-      if(Sim_table.sim[isim].Params_table.param[index].steerable){
+      if(param->steerable){
 
 	outside_range = REG_FALSE;
+	limit_type = Param_limit_type(param->type);
+	memset(&value, 0, sizeof(Param_value_type));
 
 	/* Enforce limits specified when parameter was registered */
-	switch(Sim_table.sim[isim].Params_table.param[index].type){
+	switch(param->type){
 
 	case REG_INT:
-	  sscanf(vals[i], "%d", &ivalue);
-	  if(Sim_table.sim[isim].Params_table.param[index].min_val_valid == REG_TRUE){
-	    sscanf(Sim_table.sim[isim].Params_table.param[index].min_val, "%d",
-		   &imin);
-	    if (ivalue < imin) outside_range = REG_TRUE;
-	  }
-	  if(Sim_table.sim[isim].Params_table.param[index].max_val_valid == REG_TRUE){
-	    sscanf(Sim_table.sim[isim].Params_table.param[index].max_val, "%d",
-		   &imax);
-	    if (ivalue > imax) outside_range = REG_TRUE;
-	  }
-	  if(outside_range == REG_TRUE){
-	    fprintf(stderr, "STEER: Set_param_values: new value (%d) of %s is outside\n"
-		    "permitted range (%s,%s) - skipping...\n",
-		    ivalue,
-		    Sim_table.sim[isim].Params_table.param[index].label,
-		    Sim_table.sim[isim].Params_table.param[index].min_val,
-		    Sim_table.sim[isim].Params_table.param[index].max_val);
-	    continue;
-	  }
-	  break;
-
 	case REG_LONG:
-	  sscanf(vals[i], "%ld", &lvalue);
-	  if(Sim_table.sim[isim].Params_table.param[index].min_val_valid == REG_TRUE){
-	    sscanf(Sim_table.sim[isim].Params_table.param[index].min_val,
-		   "%ld", &llimit);
-	    if (lvalue < llimit) outside_range = REG_TRUE;
-	  }
-	  if(Sim_table.sim[isim].Params_table.param[index].max_val_valid == REG_TRUE){
-	    sscanf(Sim_table.sim[isim].Params_table.param[index].max_val,
-		   "%ld", &llimit);
-	    if (lvalue > llimit) outside_range = REG_TRUE;
-	  }
-	  if(outside_range == REG_TRUE){
-	    fprintf(stderr, "STEER: Set_param_values: new value (%ld) of %s is "
-		    "outside\npermitted range (%s,%s) - skipping...\n",
-		    lvalue,
-		    Sim_table.sim[isim].Params_table.param[index].label,
-		    Sim_table.sim[isim].Params_table.param[index].min_val,
-		    Sim_table.sim[isim].Params_table.param[index].max_val);
-	    continue;
-	  }
-	  break;
-
 	case REG_FLOAT:
-	  sscanf(vals[i], "%f", &fvalue);
-	  if(Sim_table.sim[isim].Params_table.param[index].min_val_valid == REG_TRUE){
-	    sscanf(Sim_table.sim[isim].Params_table.param[index].min_val, "%f",
-		   &fmin);
-	    if (fvalue < fmin) outside_range = REG_TRUE;
-	  }
-	  if(Sim_table.sim[isim].Params_table.param[index].max_val_valid == REG_TRUE){
-	    sscanf(Sim_table.sim[isim].Params_table.param[index].max_val, "%f",
-		   &fmax);
-	    if (fvalue > fmax) outside_range = REG_TRUE;
-	  }
-
-	  if(outside_range == REG_TRUE){
-	    fprintf(stderr, "STEER: Set_param_values: new value (%f) of %s is outside\n"
-		    "permitted range (%s,%s) - skipping...\n",
-		    fvalue,
-		    Sim_table.sim[isim].Params_table.param[index].label,
-		    Sim_table.sim[isim].Params_table.param[index].min_val,
-		    Sim_table.sim[isim].Params_table.param[index].max_val);
+	case REG_DBL:
+	  if(Param_value_from_string(param->type, vals[i], &value) !=
+	     REG_SUCCESS){
+	    fprintf(stderr, "STEER: Set_param_values: new value (%s) of %s "
+		    "is not a number - skipping...\n",
+		    vals[i], param->label);
 	    continue;
 	  }
-	  break;
-
-	case REG_DBL:
-	  sscanf(vals[i], "%lg", &dvalue);
-	  if(Sim_table.sim[isim].Params_table.param[index].min_val_valid == REG_TRUE){
-	    sscanf(Sim_table.sim[isim].Params_table.param[index].min_val,
-		   "%lg", &dmin);
-	    if(dvalue < dmin) outside_range = REG_TRUE;
+	  if(param->min_val_valid == REG_TRUE &&
+	     ((param->type == REG_INT   && value.i < param->min_val.i) ||
+	      (param->type == REG_LONG  && value.l < param->min_val.l) ||
+	      (param->type == REG_FLOAT && value.f < param->min_val.f) ||
+	      (param->type == REG_DBL   && value.d < param->min_val.d))){
+	    outside_range = REG_TRUE;
 	  }
-	  if(Sim_table.sim[isim].Params_table.param[index].max_val_valid == REG_TRUE){
-	    sscanf(Sim_table.sim[isim].Params_table.param[index].max_val,
-		   "%lg", &dmax);
-	    if(dvalue > dmax) outside_range = REG_TRUE;
+	  if(param->max_val_valid == REG_TRUE &&
+	     ((param->type == REG_INT   && value.i > param->max_val.i) ||
+	      (param->type == REG_LONG  && value.l > param->max_val.l) ||
+	      (param->type == REG_FLOAT && value.f > param->max_val.f) ||
+	      (param->type == REG_DBL   && value.d > param->max_val.d))){
+	    outside_range = REG_TRUE;
 	  }
-
 	  if(outside_range == REG_TRUE){
-	    fprintf(stderr, "STEER: Set_param_values: new value (%f) of %s is outside\n"
-		    "permitted range (%s,%s) - skipping...\n",
-		    (float)dvalue,
-		    Sim_table.sim[isim].Params_table.param[index].label,
-		    Sim_table.sim[isim].Params_table.param[index].min_val,
-		    Sim_table.sim[isim].Params_table.param[index].max_val);
+	    fprintf(stderr, "STEER: Set_param_values: new value (%s) of %s is "
+		    "outside\npermitted range (%s,%s) - skipping...\n",
+		    Param_value_to_string(param->type, &value, value_buf),
+		    param->label,
+		    (param->min_val_valid == REG_TRUE) ?
+		    Param_value_to_string(limit_type, &(param->min_val),
+					  min_buf) : "--",
+		    (param->max_val_valid == REG_TRUE) ?
+		    Param_value_to_string(limit_type, &(param->max_val),
+					  max_buf) : "--");
 	    continue;
 	  }
+	  param->value = value;
 	  break;
 
 	case REG_CHAR:
 	  /* Max. value taken as maximum possible length of steered
 	     character strings */
-	  if(Sim_table.sim[isim].Params_table.param[index].max_val_valid == REG_TRUE){
-	    sscanf(Sim_table.sim[isim].Params_table.param[index].max_val, "%d",
-		   &imax);
-	    if (strlen(vals[i]) > imax) {
-
-	      fprintf(stderr, "STEER: Set_param_values: new string (%s) of %s exceeds\n"
-		      "maximum length (%s) - skipping...\n",
-		      vals[i],
-		      Sim_table.sim[isim].Params_table.param[index].label,
-		      Sim_table.sim[isim].Params_table.param[index].max_val);
-	      continue;
-	    }
+	  if(param->max_val_valid == REG_TRUE &&
+	     (int)strlen(vals[i]) > param->max_val.i){
+
+	    fprintf(stderr, "STEER: Set_param_values: new string (%s) of %s "
+		    "exceeds\nmaximum length (%d) - skipping...\n",
+		    vals[i], param->label, param->max_val.i);
+	    continue;
+	  }
+	  if(Param_value_set_string(&(param->value), vals[i], -1) !=
+	     REG_SUCCESS){
+	    return_status = REG_FAILURE;
+	    continue;
 	  }
 	  break;
 
@@ -2086,9 +2102,8 @@ int Set_param_values(int    sim_handle,
 
 	}
 
-	sprintf(Sim_table.sim[isim].Params_table.param[index].value,
-		"%s", vals[i]);
-	Sim_table.sim[isim].Params_table.param[index].modified = REG_TRUE;
+	param->value_set = REG_TRUE;
+	param->modified = REG_TRUE;
       }
       else{
 	fprintf(stderr, "STEER: Set_param_values: can only edit steerable parameters\n");
@@ -2257,7 +2272,6 @@ int Get_iotypes(int    sim_handle,
   int i;
   int count;
   int iparam;
-  int nitem;
   int return_status = REG_SUCCESS;
 
   /* Get the first num_iotype IO defs out of the table.  Assumes
@@ -2291,9 +2305,9 @@ int Get_iotypes(int    sim_handle,
 
 	if(iparam != REG_PARAM_HANDLE_NOTSET){
 
-	  nitem = sscanf(Sim_table.sim[isim].Params_table.param[iparam].value,
-			   "%d", &(io_freqs[count]) );
-	  if(nitem != 1){
+	  io_freqs[count] = Sim_table.sim[isim].Params_table.param[iparam].value.i;
+	  if(Sim_table.sim[isim].Params_table.param[iparam].value_set !=
+	     REG_TRUE){
 
 	    fprintf(stderr, "STEER: Get_iotypes: failed to retrieve "
 		    "freq value\n");
@@ -2434,7 +2448,6 @@ int Get_chktypes(int    sim_handle,
   int i;
   int count;
   int iparam;
-  int nitem;
   int return_status = REG_SUCCESS;
 
   /* Get the first num_chktype Chk defs out of the table.  Assumes
@@ -2471,9 +2484,10 @@ int Get_chktypes(int    sim_handle,
 
 	  if(iparam != REG_PARAM_HANDLE_NOTSET){
 
-	    nitem = sscanf(Sim_table.sim[isim].Params_table.param[iparam].value,
-			   "%d", &(chk_freqs[count]) );
-	    if(nitem != 1){
+	    chk_freqs[count] =
+	      Sim_table.sim[isim].Params_table.param[iparam].value.i;
+	    if(Sim_table.sim[isim].Params_table.param[iparam].value_set !=
+	       REG_TRUE){
 
 #ifdef REG_DEBUG
 	      fprintf(stderr, "STEER: Get_chktypes: failed to retrieve freq value\n");
@@ -2824,16 +2838,26 @@ int Get_log_entry_details(Param_table_type *param_table,
 			  Chk_log_entry_type *in,
 			  Output_log_struct  *out)
 {
-  int   i, j;
+  int   i, j, n;
   int   index;
   char *pchar;
+  char  buf[REG_NUM_BUF_LEN];
 
   strcpy(out->chk_tag, in->chk_tag);
 
-  for(i=0; i<REG_MAX_NUM_STR_PARAMS; i++){
+  n = 0;
+  for(i=0; i<in->num_param; i++){
 
     if(in->param[i].handle == REG_PARAM_HANDLE_NOTSET) break;
 
+    /* The entry may hold more parameters than the caller's arrays */
+    if(n >= REG_MAX_NUM_STR_PARAMS){
+      fprintf(stderr, "STEER: WARNING: Get_log_entry_details: entry for "
+	      "%s holds %d params but only %d can be returned\n",
+	      in->chk_tag, in->num_param, REG_MAX_NUM_STR_PARAMS);
+      break;
+    }
+
     index = Param_index_from_handle(param_table,
 				    in->param[i].handle);
 
@@ -2844,12 +2868,12 @@ int Get_log_entry_details(Param_table_type *param_table,
       continue;
     }
 
-    strcpy(out->param_labels[i],
+    strcpy(out->param_labels[n],
 	   param_table->param[index].label);
 
     /* Strip off any trailing space (often an issue with strings
        supplied from F90) */
-    pchar = out->param_labels[i];
+    pchar = out->param_labels[n];
     j = strlen(pchar);
 
     while(pchar[--j] == ' ');
@@ -2859,10 +2883,12 @@ int Get_log_entry_details(Param_table_type *param_table,
       pchar[j+1] = '\0';
     }
 
-    strcpy(out->param_values[i],
-	   in->param[i].value);
+    strcpy(out->param_values[n],
+	   Param_value_to_string(in->param[i].type, &(in->param[i].value),
+				 buf));
+    n++;
   }
-  out->num_param = i;
+  out->num_param = n;
 
   return REG_SUCCESS;
 }
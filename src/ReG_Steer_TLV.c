@@ -0,0 +1,708 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+/** @internal
+    @file ReG_Steer_TLV.c
+    @brief Source file for the binary (TLV) steering wire format.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_Config.h"
+#include "ReG_Steer_types.h"
+#include "ReG_Steer_Common.h"
+#include "ReG_Steer_TLV.h"
+
+#include <limits.h>
+
+/*-----------------------------------------------------------------*/
+
+int Tlv_msg_size(const char* buf) {
+
+  const unsigned char* p = (const unsigned char*) buf;
+  unsigned int len;
+
+  if(!p || p[0] != REG_TLV_MAGIC || p[1] != REG_TLV_VERSION) {
+    return -1;
+  }
+
+  /* Length of the root element follows its tag */
+  len = ((unsigned int) p[3] << 24) | ((unsigned int) p[4] << 16) |
+    ((unsigned int) p[5] << 8) | (unsigned int) p[6];
+
+  if(len > (unsigned int) (INT_MAX - 2 - REG_TLV_ELEMENT_HDR)) {
+    return -1;
+  }
+
+  return 2 + REG_TLV_ELEMENT_HDR + (int) len;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Tlv_wire_format_enabled() {
+
+  char* pchar;
+
+  if((pchar = getenv("REG_STEER_WIRE_FORMAT")) &&
+     (!strcmp(pchar, "xml") || !strcmp(pchar, "XML"))) {
+    return REG_FALSE;
+  }
+
+  return REG_TRUE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Parse_tlv_buf(const char* buf, int size, struct msg_struct* msg,
+		  Sim_entry_type* sim) {
+
+  const unsigned char* pos;
+  const unsigned char* end;
+  const unsigned char* root;
+  const unsigned char* value;
+  int tag;
+  int root_len;
+  int len;
+  int return_status;
+
+  if(!buf) {
+    fprintf(stderr, "STEER: Parse_tlv_buf: ptr to buffer is NULL\n");
+    return REG_FAILURE;
+  }
+
+  if(size < 2 + REG_TLV_ELEMENT_HDR || Tlv_msg_size(buf) < 0 ||
+     Tlv_msg_size(buf) > size) {
+    fprintf(stderr, "STEER: Parse_tlv_buf: not a complete binary "
+	    "steering message\n");
+    return REG_FAILURE;
+  }
+
+  pos = (const unsigned char*) buf + 2;
+  end = (const unsigned char*) buf + size;
+
+  if(Tlv_next_element(&pos, end, &tag, &root, &root_len) != REG_SUCCESS ||
+     tag != MSG_TAG_STEER_MESSAGE) {
+    fprintf(stderr, "STEER: Parse_tlv_buf: message of the wrong type\n");
+    return REG_FAILURE;
+  }
+
+  /* Binary messages carry no UID (these are only used by steering
+     web services) so there is nothing to check against the UIDs
+     stored for sim */
+
+  /* The type of the message is given by the element within the root */
+  pos = root;
+  if(Tlv_next_element(&pos, root + root_len, &tag, &value,
+		      &len) != REG_SUCCESS) {
+    fprintf(stderr, "STEER: Parse_tlv_buf: empty message\n");
+    return REG_FAILURE;
+  }
+
+  msg->msg_type = Get_message_type(Msg_tag_name(tag));
+
+  switch(msg->msg_type) {
+
+  case STATUS:
+  case PARAM_DEFS:
+    /* Use code for 'status' messages because one
+       encapsulates the other */
+    msg->status = New_status_struct(msg->arena);
+    return_status = parseTlvStatus(value, len, msg->arena, msg->status);
+    break;
+
+  case CONTROL:
+    msg->control = New_control_struct(msg->arena);
+    return_status = parseTlvControl(value, len, msg->arena, msg->control);
+    break;
+
+  case SUPP_CMDS:
+    msg->supp_cmd = New_supp_cmd_struct(msg->arena);
+    return_status = parseTlvSuppCmd(value, len, msg->arena, msg->supp_cmd);
+    break;
+
+  case IO_DEFS:
+    msg->io_def = New_io_def_struct(msg->arena);
+    return_status = parseTlvIOTypeDef(value, len, MSG_TAG_IOTYPE,
+				      msg->arena, msg->io_def);
+    break;
+
+  case CHK_DEFS:
+    msg->chk_def = New_io_def_struct(msg->arena);
+    return_status = parseTlvIOTypeDef(value, len, MSG_TAG_CHKTYPE,
+				      msg->arena, msg->chk_def);
+    break;
+
+  case STEER_LOG:
+    msg->log = New_log_struct(msg->arena);
+    return_status = parseTlvLog(value, len, msg->arena, msg->log);
+    break;
+
+  default:
+    fprintf(stderr, "STEER: INFO: Parse_tlv_buf: Unrecognised message"
+	    " tag %d\n", tag);
+    return_status = REG_SUCCESS;
+    break;
+  }
+
+  if(return_status != REG_SUCCESS) {
+    fprintf(stderr, "STEER: Parse_tlv_buf: malformed message\n");
+    return REG_FAILURE;
+  }
+
+#ifdef REG_DEBUG_FULL
+  if(msg->msg_type != MSG_NOTSET) {
+    fprintf(stderr, "STEER: Parse_tlv_buf: Calling Print_msg...\n");
+    Print_msg(msg);
+  }
+#endif
+
+  return REG_SUCCESS;
+}
+
+/*-----------------------------------------------------------------*/
+
+int Tlv_next_element(const unsigned char** pos,
+		     const unsigned char*  end,
+		     int*                  tag,
+		     const unsigned char** value,
+		     int*                  len) {
+
+  const unsigned char* p = *pos;
+  unsigned int l;
+
+  if(p >= end) return REG_EOD;
+
+  if((end - p) < REG_TLV_ELEMENT_HDR) return REG_FAILURE;
+
+  l = ((unsigned int) p[1] << 24) | ((unsigned int) p[2] << 16) |
+    ((unsigned int) p[3] << 8) | (unsigned int) p[4];
+
+  /* Content must lie within the enclosing element */
+  if(l > (unsigned int) (end - p - REG_TLV_ELEMENT_HDR)) return REG_FAILURE;
+
+  *tag = (int) p[0];
+  *value = p + REG_TLV_ELEMENT_HDR;
+  *len = (int) l;
+  *pos = *value + l;
+
+  return REG_SUCCESS;
+}
+
+/*-----------------------------------------------------------------*/
+
+void Tlv_store_string(Msg_arena_type* arena, xmlChar** dest,
+		      const unsigned char* value, int len) {
+
+  *dest = Msg_arena_strndup(arena, (const xmlChar*) value, len);
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvStatus(const unsigned char* buf, int len,
+		   Msg_arena_type* arena, struct status_struct* status) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(status == NULL) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+    switch(tag) {
+
+    case MSG_TAG_PARAM:
+      if(!status->first_param) {
+	status->first_param = New_param_struct(arena);
+	status->param = status->first_param;
+      }
+      else {
+	status->param->next = New_param_struct(arena);
+	status->param = status->param->next;
+      }
+      return_status = parseTlvParam(value, vlen, arena, status->param);
+      break;
+
+    case MSG_TAG_COMMAND:
+      if(!status->first_cmd) {
+	status->first_cmd = New_cmd_struct(arena);
+	status->cmd = status->first_cmd;
+      }
+      else {
+	status->cmd->next = New_cmd_struct(arena);
+	status->cmd = status->cmd->next;
+      }
+      return_status = parseTlvCmd(value, vlen, arena, status->cmd);
+      break;
+
+    default:
+      break;
+    }
+
+    if(return_status != REG_SUCCESS) return REG_FAILURE;
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvControl(const unsigned char* buf, int len,
+		    Msg_arena_type* arena, struct control_struct* ctrl) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(!ctrl) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+    switch(tag) {
+
+    case MSG_TAG_VALID_AFTER:
+      Tlv_store_string(arena, &(ctrl->valid_after), value, vlen);
+      break;
+
+    case MSG_TAG_PARAM:
+      if(!ctrl->first_param) {
+	ctrl->first_param = New_param_struct(arena);
+	ctrl->param = ctrl->first_param;
+      }
+      else {
+	ctrl->param->next = New_param_struct(arena);
+	ctrl->param = ctrl->param->next;
+      }
+      return_status = parseTlvParam(value, vlen, arena, ctrl->param);
+      break;
+
+    case MSG_TAG_COMMAND:
+      if(!ctrl->first_cmd) {
+	ctrl->first_cmd = New_cmd_struct(arena);
+	ctrl->cmd = ctrl->first_cmd;
+      }
+      else {
+	ctrl->cmd->next = New_cmd_struct(arena);
+	ctrl->cmd = ctrl->cmd->next;
+      }
+      return_status = parseTlvCmd(value, vlen, arena, ctrl->cmd);
+      break;
+
+    default:
+      break;
+    }
+
+    if(return_status != REG_SUCCESS) return REG_FAILURE;
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvSuppCmd(const unsigned char* buf, int len,
+		    Msg_arena_type* arena, struct supp_cmd_struct* supp_cmd) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(supp_cmd == NULL) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+    switch(tag) {
+
+    case MSG_TAG_COMMAND:
+      if(!supp_cmd->first_cmd) {
+	supp_cmd->first_cmd = New_cmd_struct(arena);
+	supp_cmd->cmd = supp_cmd->first_cmd;
+      }
+      else {
+	supp_cmd->cmd->next = New_cmd_struct(arena);
+	supp_cmd->cmd = supp_cmd->cmd->next;
+      }
+      return_status = parseTlvCmd(value, vlen, arena, supp_cmd->cmd);
+      break;
+
+    case MSG_TAG_WIRE_FORMAT:
+      Tlv_store_string(arena, &(supp_cmd->wire_format), value, vlen);
+      break;
+
+    default:
+      break;
+    }
+
+    if(return_status != REG_SUCCESS) return REG_FAILURE;
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvIOTypeDef(const unsigned char* buf, int len, int type_tag,
+		      Msg_arena_type* arena, struct io_def_struct* io_def) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(!io_def) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+
+    /* IOType_defs hold IOTypes and ChkType_defs hold ChkTypes */
+    if(tag != type_tag) continue;
+
+    if(!io_def->first_io) {
+      io_def->first_io = New_io_struct(arena);
+      io_def->io = io_def->first_io;
+    }
+    else {
+      io_def->io->next = New_io_struct(arena);
+      io_def->io = io_def->io->next;
+    }
+
+    if(parseTlvIOType(value, vlen, arena, io_def->io) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvIOType(const unsigned char* buf, int len,
+		   Msg_arena_type* arena, struct io_struct* io) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(!io) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+    switch(tag) {
+
+    case MSG_TAG_HANDLE:
+      Tlv_store_string(arena, &(io->handle), value, vlen);
+      break;
+
+    case MSG_TAG_LABEL:
+      Tlv_store_string(arena, &(io->label), value, vlen);
+      break;
+
+    case MSG_TAG_DIRECTION:
+      Tlv_store_string(arena, &(io->direction), value, vlen);
+      break;
+
+    case MSG_TAG_FREQ_HANDLE:
+      Tlv_store_string(arena, &(io->freq_handle), value, vlen);
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvLog(const unsigned char* buf, int len,
+		Msg_arena_type* arena, struct log_struct* log) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(!log) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+
+    if(tag != MSG_TAG_LOG_ENTRY) continue;
+
+    if(!log->first_entry) {
+      log->first_entry = New_log_entry_struct(arena);
+      log->entry = log->first_entry;
+    }
+    else {
+      log->entry->next = New_log_entry_struct(arena);
+      log->entry = log->entry->next;
+    }
+
+    if(parseTlvLogEntry(value, vlen, arena, log->entry) != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvLogEntry(const unsigned char* buf, int len,
+		     Msg_arena_type* arena, struct log_entry_struct* log) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(!log) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+    switch(tag) {
+
+    case MSG_TAG_KEY:
+      Tlv_store_string(arena, &(log->key), value, vlen);
+      break;
+
+    case MSG_TAG_CHK_LOG_ENTRY:
+      if(!log->first_chk_log) {
+	log->first_chk_log = New_chk_log_entry_struct(arena);
+	log->chk_log = log->first_chk_log;
+      }
+      else {
+	log->chk_log->next = New_chk_log_entry_struct(arena);
+	log->chk_log = log->chk_log->next;
+      }
+      return_status = parseTlvChkLogEntry(value, vlen, arena, log->chk_log);
+      break;
+
+    case MSG_TAG_PARAM:
+      if(!log->first_param_log) {
+	log->first_param_log = New_param_struct(arena);
+	log->param_log = log->first_param_log;
+      }
+      else {
+	log->param_log->next = New_param_struct(arena);
+	log->param_log = log->param_log->next;
+      }
+      return_status = parseTlvParam(value, vlen, arena, log->param_log);
+      break;
+
+    default:
+      break;
+    }
+
+    if(return_status != REG_SUCCESS) return REG_FAILURE;
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvChkLogEntry(const unsigned char* buf, int len,
+			Msg_arena_type* arena,
+			struct chk_log_entry_struct* log_entry) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(!log_entry) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+    switch(tag) {
+
+    case MSG_TAG_CHK_HANDLE:
+      Tlv_store_string(arena, &(log_entry->chk_handle), value, vlen);
+      break;
+
+    case MSG_TAG_CHK_TAG:
+      Tlv_store_string(arena, &(log_entry->chk_tag), value, vlen);
+      break;
+
+    case MSG_TAG_PARAM:
+      if(!log_entry->first_param) {
+	log_entry->first_param = New_param_struct(arena);
+	log_entry->param = log_entry->first_param;
+      }
+      else {
+	log_entry->param->next = New_param_struct(arena);
+	log_entry->param = log_entry->param->next;
+      }
+      return_status = parseTlvParam(value, vlen, arena, log_entry->param);
+      break;
+
+    default:
+      break;
+    }
+
+    if(return_status != REG_SUCCESS) return REG_FAILURE;
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvParam(const unsigned char* buf, int len,
+		  Msg_arena_type* arena, struct param_struct* param) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(param == NULL) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+    switch(tag) {
+
+    case MSG_TAG_HANDLE:
+      Tlv_store_string(arena, &(param->handle), value, vlen);
+      break;
+
+    case MSG_TAG_LABEL:
+      Tlv_store_string(arena, &(param->label), value, vlen);
+      break;
+
+    case MSG_TAG_VALUE:
+      Tlv_store_string(arena, &(param->value), value, vlen);
+      break;
+
+    case MSG_TAG_STEERABLE:
+      Tlv_store_string(arena, &(param->steerable), value, vlen);
+      break;
+
+    case MSG_TAG_TYPE:
+      Tlv_store_string(arena, &(param->type), value, vlen);
+      break;
+
+    case MSG_TAG_IS_INTERNAL:
+      Tlv_store_string(arena, &(param->is_internal), value, vlen);
+      break;
+
+    case MSG_TAG_MIN_VALUE:
+      Tlv_store_string(arena, &(param->min_val), value, vlen);
+      break;
+
+    case MSG_TAG_MAX_VALUE:
+      Tlv_store_string(arena, &(param->max_val), value, vlen);
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
+
+/*-----------------------------------------------------------------*/
+
+int parseTlvCmd(const unsigned char* buf, int len,
+		Msg_arena_type* arena, struct cmd_struct* cmd) {
+
+  const unsigned char* pos = buf;
+  const unsigned char* value;
+  int tag;
+  int vlen;
+  int return_status;
+
+  if(!cmd) return REG_FAILURE;
+
+  while((return_status = Tlv_next_element(&pos, buf + len, &tag, &value,
+					  &vlen)) == REG_SUCCESS) {
+    switch(tag) {
+
+    case MSG_TAG_CMD_ID:
+      Tlv_store_string(arena, &(cmd->id), value, vlen);
+      break;
+
+    case MSG_TAG_CMD_NAME:
+      Tlv_store_string(arena, &(cmd->name), value, vlen);
+      break;
+
+    case MSG_TAG_CMD_PARAM:
+      if(cmd->first_param) {
+	cmd->param->next = New_param_struct(arena);
+	cmd->param = cmd->param->next;
+      }
+      else {
+	cmd->first_param = New_param_struct(arena);
+	cmd->param = cmd->first_param;
+      }
+      return_status = parseTlvParam(value, vlen, arena, cmd->param);
+      break;
+
+    default:
+      break;
+    }
+
+    if(return_status != REG_SUCCESS) return REG_FAILURE;
+  }
+
+  return (return_status == REG_EOD) ? REG_SUCCESS : REG_FAILURE;
+}
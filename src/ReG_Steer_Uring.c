@@ -0,0 +1,550 @@
+/*
+  The RealityGrid Steering Library
+
+  Copyright (c) 2002-2010, University of Manchester, United Kingdom.
+  All rights reserved.
+
+  This software is produced by Research Computing Services, University
+  of Manchester as part of the RealityGrid project and associated
+  follow on projects, funded by the EPSRC under grants GR/R67699/01,
+  GR/R67699/02, GR/T27488/01, EP/C536452/1, EP/D500028/1,
+  EP/F00561X/1.
+
+  LICENCE TERMS
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+    * Redistributions of source code must retain the above copyright
+       notice, this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above
+      copyright notice, this list of conditions and the following
+      disclaimer in the documentation and/or other materials provided
+      with the distribution.
+
+    * Neither the name of The University of Manchester nor the names
+      of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written
+      permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+  COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+  POSSIBILITY OF SUCH DAMAGE.
+
+  Author: Robert Haines
+ */
+
+/** @internal
+    @file ReG_Steer_Uring.c
+    @brief Source file for the io_uring backend of the samples
+    transports.
+    @author Robert Haines
+  */
+
+#include "ReG_Steer_Config.h"
+#include "ReG_Steer_types.h"
+#include "ReG_Steer_Uring.h"
+
+#if REG_HAS_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+/** @internal A transfer being driven to completion by uring_run() */
+typedef struct {
+  /** IORING_OP_WRITE(_FIXED), IORING_OP_SENDMSG or IORING_OP_RECV */
+  int           opcode;
+  /** File or socket to transfer to/from */
+  int           fd;
+  /** Data still to be transferred */
+  struct iovec  iov[2];
+  /** No. of entries used in @p iov */
+  int           num_iov;
+  /** Message header for IORING_OP_SENDMSG */
+  struct msghdr msg;
+  /** Position in the file (writes only) */
+  unsigned long long offset;
+  /** No. of bytes transferred so far */
+  size_t        done;
+  /** Non-zero once the transfer has finished */
+  int           finished;
+} uring_request_type;
+
+/*---------------------------------------------------*/
+
+static int uring_setup(unsigned entries, struct io_uring_params* params) {
+  return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+/*---------------------------------------------------*/
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete) {
+  return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+		       IORING_ENTER_GETEVENTS, NULL, 0);
+}
+
+/*---------------------------------------------------*/
+
+static int uring_register(int fd, unsigned opcode, void* arg,
+			  unsigned nr_args) {
+  return (int) syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+/*---------------------------------------------------*/
+
+static void uring_request_init(uring_request_type* req,
+			       const int           opcode,
+			       const int           fd,
+			       const void*         data,
+			       const size_t        num_bytes) {
+  memset(req, 0, sizeof(uring_request_type));
+  req->opcode = opcode;
+  req->fd = fd;
+  req->iov[0].iov_base = (void*) data;
+  req->iov[0].iov_len = num_bytes;
+  req->num_iov = 1;
+}
+
+/*---------------------------------------------------*/
+
+/* Put a request on the submission queue. The ring is always large
+   enough for the handful of requests that are in flight at once. */
+static void uring_queue(uring_type* ring, uring_request_type* req,
+			const int id) {
+  struct io_uring_sqe* sqe;
+  unsigned             tail = *(ring->sq_tail);
+  unsigned             i = tail & *(ring->sq_mask);
+  struct iovec*        iov = req->iov;
+
+  /* Skip over anything already transferred */
+  while(iov->iov_len == 0 && iov < req->iov + req->num_iov - 1) iov++;
+
+  sqe = &(((struct io_uring_sqe*) ring->sqes)[i]);
+  memset(sqe, 0, sizeof(struct io_uring_sqe));
+  sqe->opcode = (unsigned char) req->opcode;
+  sqe->fd = req->fd;
+  sqe->user_data = ((unsigned long long) ring->batch << 32) | (unsigned) id;
+
+  switch(req->opcode) {
+  case IORING_OP_SENDMSG:
+    req->msg.msg_iov = iov;
+    req->msg.msg_iovlen = req->num_iov - (int)(iov - req->iov);
+    sqe->addr = (unsigned long long)(unsigned long) &(req->msg);
+    sqe->len = 1;
+#if REG_HAS_MSG_NOSIGNAL
+    sqe->msg_flags = MSG_NOSIGNAL;
+#endif
+    break;
+
+  case IORING_OP_RECV:
+    sqe->addr = (unsigned long long)(unsigned long) iov->iov_base;
+    sqe->len = (unsigned) iov->iov_len;
+    sqe->msg_flags = MSG_WAITALL;
+    break;
+
+  default:
+    /* Writes - the staging buffer is fixed buffer 0 */
+    sqe->addr = (unsigned long long)(unsigned long) iov->iov_base;
+    sqe->len = (unsigned) iov->iov_len;
+    sqe->off = req->offset + req->done;
+    break;
+  }
+
+  ring->sq_array[i] = i;
+  __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/*---------------------------------------------------*/
+
+/* Account for @p num_bytes transferred by @p req. Returns non-zero
+   if there is more to do. */
+static int uring_advance(uring_request_type* req, size_t num_bytes) {
+  int i;
+
+  req->done += num_bytes;
+  for(i = 0; i < req->num_iov; i++) {
+    if(num_bytes >= req->iov[i].iov_len) {
+      num_bytes -= req->iov[i].iov_len;
+      req->iov[i].iov_base = (char*) req->iov[i].iov_base +
+	req->iov[i].iov_len;
+      req->iov[i].iov_len = 0;
+    }
+    else {
+      req->iov[i].iov_base = (char*) req->iov[i].iov_base + num_bytes;
+      req->iov[i].iov_len -= num_bytes;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/*---------------------------------------------------*/
+
+/* Submit @p num requests in one go and wait for all of them,
+   resubmitting any that complete short. */
+static int uring_run(uring_type* ring, uring_request_type* reqs,
+		     const int num) {
+  struct io_uring_cqe* cqe;
+  uring_request_type*  req;
+  unsigned             head;
+  unsigned             to_submit;
+  int                  outstanding = num;
+  int                  status = REG_SUCCESS;
+  int                  i;
+
+  /* Completions left over from a failed batch must be ignored */
+  ring->batch++;
+  for(i = 0; i < num; i++) {
+    uring_queue(ring, &(reqs[i]), i);
+  }
+
+  while(outstanding > 0) {
+    to_submit = *(ring->sq_tail) -
+      __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+    if(uring_enter(ring->fd, to_submit, 1) < 0 && errno != EINTR) {
+      perror("io_uring_enter");
+      return REG_FAILURE;
+    }
+
+    head = *(ring->cq_head);
+    while(head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+      cqe = &(((struct io_uring_cqe*)
+	       ring->cqes)[head & *(ring->cq_mask)]);
+      i = (int)(cqe->user_data & 0xffffffff);
+      head++;
+
+      if((unsigned)(cqe->user_data >> 32) != ring->batch || i >= num) {
+	continue;
+      }
+      req = &(reqs[i]);
+
+      if(cqe->res == -EINTR || cqe->res == -EAGAIN) {
+	uring_queue(ring, req, i);
+      }
+      else if(cqe->res < 0) {
+	errno = -(cqe->res);
+	perror("io_uring");
+	status = REG_FAILURE;
+	req->finished = REG_TRUE;
+	outstanding--;
+      }
+      else if(cqe->res == 0) {
+	/* Connection closed or no progress possible */
+	if(req->opcode != IORING_OP_RECV) status = REG_FAILURE;
+	req->finished = REG_TRUE;
+	outstanding--;
+      }
+      else if(uring_advance(req, (size_t) cqe->res)) {
+	uring_queue(ring, req, i);
+      }
+      else {
+	req->finished = REG_TRUE;
+	outstanding--;
+      }
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+  }
+
+  return status;
+}
+
+/*---------------------------------------------------*/
+
+static void uring_unmap(uring_type* ring) {
+  if(ring->sqes) munmap(ring->sqes, ring->sqes_size);
+  if(ring->cq_ring && ring->cq_ring != ring->sq_ring) {
+    munmap(ring->cq_ring, ring->cq_ring_size);
+  }
+  if(ring->sq_ring) munmap(ring->sq_ring, ring->sq_ring_size);
+  ring->sqes = NULL;
+  ring->cq_ring = NULL;
+  ring->sq_ring = NULL;
+}
+
+/*---------------------------------------------------*/
+
+int Uring_init(uring_type*    ring,
+	       const unsigned entries,
+	       const size_t   staging_size) {
+  struct io_uring_params params;
+  struct iovec           iov;
+  char*                  ptr;
+
+  memset(ring, 0, sizeof(uring_type));
+  memset(&params, 0, sizeof(struct io_uring_params));
+
+  ring->fd = uring_setup(entries > 0 ? entries : REG_URING_ENTRIES,
+			 &params);
+  if(ring->fd < 0) {
+    perror("STEER: Uring_init: io_uring_setup");
+    return REG_FAILURE;
+  }
+  ring->entries = params.sq_entries;
+
+  ring->sq_ring_size = params.sq_off.array +
+    params.sq_entries * sizeof(unsigned);
+  ring->cq_ring_size = params.cq_off.cqes +
+    params.cq_entries * sizeof(struct io_uring_cqe);
+  ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  /* Newer kernels map both rings with one call */
+  if(params.features & IORING_FEAT_SINGLE_MMAP) {
+    if(ring->cq_ring_size > ring->sq_ring_size) {
+      ring->sq_ring_size = ring->cq_ring_size;
+    }
+    ring->cq_ring_size = ring->sq_ring_size;
+  }
+
+  ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+		       MAP_SHARED | MAP_POPULATE, ring->fd,
+		       IORING_OFF_SQ_RING);
+  if(ring->sq_ring == MAP_FAILED) {
+    ring->sq_ring = NULL;
+  }
+  else if(params.features & IORING_FEAT_SINGLE_MMAP) {
+    ring->cq_ring = ring->sq_ring;
+  }
+  else {
+    ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+			 MAP_SHARED | MAP_POPULATE, ring->fd,
+			 IORING_OFF_CQ_RING);
+    if(ring->cq_ring == MAP_FAILED) ring->cq_ring = NULL;
+  }
+  if(ring->cq_ring) {
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+		      MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if(ring->sqes == MAP_FAILED) ring->sqes = NULL;
+  }
+  if(!ring->sqes) {
+    perror("STEER: Uring_init: mmap");
+    uring_unmap(ring);
+    close(ring->fd);
+    return REG_FAILURE;
+  }
+
+  ptr = (char*) ring->sq_ring;
+  ring->sq_head = (unsigned*)(ptr + params.sq_off.head);
+  ring->sq_tail = (unsigned*)(ptr + params.sq_off.tail);
+  ring->sq_mask = (unsigned*)(ptr + params.sq_off.ring_mask);
+  ring->sq_array = (unsigned*)(ptr + params.sq_off.array);
+  ptr = (char*) ring->cq_ring;
+  ring->cq_head = (unsigned*)(ptr + params.cq_off.head);
+  ring->cq_tail = (unsigned*)(ptr + params.cq_off.tail);
+  ring->cq_mask = (unsigned*)(ptr + params.cq_off.ring_mask);
+  ring->cqes = (void*)(ptr + params.cq_off.cqes);
+
+  ring->staging_size = staging_size > 0 ?
+    staging_size : REG_URING_STAGING_SIZE;
+  if(posix_memalign((void**) &(ring->staging), 4096, ring->staging_size)) {
+    fprintf(stderr, "STEER: Uring_init: failed to allocate memory\n");
+    uring_unmap(ring);
+    close(ring->fd);
+    return REG_FAILURE;
+  }
+  ring->stage_limit = ring->staging_size / 4;
+  ring->staged = 0;
+  ring->staged_fd = -1;
+
+  /* Registering pins the buffer so it can fail if the locked memory
+     limit is low - unregistered writes still work */
+  iov.iov_base = ring->staging;
+  iov.iov_len = ring->staging_size;
+  ring->registered =
+    (uring_register(ring->fd, IORING_REGISTER_BUFFERS, &iov, 1) == 0);
+
+#ifdef REG_DEBUG
+  fprintf(stderr, "STEER: Uring_init: %u entries, %d byte staging buffer "
+	  "(%sregistered)\n", ring->entries, (int) ring->staging_size,
+	  ring->registered ? "" : "not ");
+#endif
+
+  return REG_SUCCESS;
+}
+
+/*---------------------------------------------------*/
+
+void Uring_finalize(uring_type* ring) {
+  if(ring->fd < 0) return;
+
+  uring_unmap(ring);
+  close(ring->fd);
+  ring->fd = -1;
+
+  free(ring->staging);
+  ring->staging = NULL;
+  ring->staged = 0;
+}
+
+/*---------------------------------------------------*/
+
+int Uring_write(uring_type*              ring,
+		const int                fd,
+		const unsigned long long offset,
+		const void*              data,
+		const size_t             num_bytes) {
+  uring_request_type reqs[2];
+  int                num = 0;
+
+  /* Staged data must be immediately before this write */
+  if(ring->staged > 0 && (fd != ring->staged_fd ||
+			  offset != ring->staged_offset + ring->staged)) {
+    if(Uring_flush(ring) != REG_SUCCESS) return REG_FAILURE;
+  }
+
+  if(num_bytes < ring->stage_limit &&
+     ring->staged + num_bytes <= ring->staging_size) {
+    if(ring->staged == 0) {
+      ring->staged_fd = fd;
+      ring->staged_offset = offset;
+    }
+    memcpy(ring->staging + ring->staged, data, num_bytes);
+    ring->staged += num_bytes;
+    return REG_SUCCESS;
+  }
+
+  if(ring->staged > 0) {
+    uring_request_init(&(reqs[num]), ring->registered ?
+		       IORING_OP_WRITE_FIXED : IORING_OP_WRITE,
+		       fd, ring->staging, ring->staged);
+    reqs[num++].offset = ring->staged_offset;
+    ring->staged = 0;
+  }
+  uring_request_init(&(reqs[num]), IORING_OP_WRITE, fd, data, num_bytes);
+  reqs[num++].offset = offset;
+
+  return uring_run(ring, reqs, num);
+}
+
+/*---------------------------------------------------*/
+
+int Uring_flush(uring_type* ring) {
+  uring_request_type req;
+
+  if(ring->staged == 0) return REG_SUCCESS;
+
+  uring_request_init(&req, ring->registered ?
+		     IORING_OP_WRITE_FIXED : IORING_OP_WRITE,
+		     ring->staged_fd, ring->staging, ring->staged);
+  req.offset = ring->staged_offset;
+  ring->staged = 0;
+
+  return uring_run(ring, &req, 1);
+}
+
+/*---------------------------------------------------*/
+
+int Uring_send(uring_type*  ring,
+	       const int    fd,
+	       const void*  data,
+	       const size_t num_bytes,
+	       const int    more) {
+  uring_request_type req;
+
+  /* Don't let data meant for one connection go down another */
+  if(ring->staged > 0 && fd != ring->staged_fd) {
+    if(Uring_send(ring, ring->staged_fd, NULL, 0, REG_FALSE)
+       != REG_SUCCESS) {
+      return REG_FAILURE;
+    }
+  }
+
+  if(more && num_bytes < ring->stage_limit &&
+     ring->staged + num_bytes <= ring->staging_size) {
+    ring->staged_fd = fd;
+    memcpy(ring->staging + ring->staged, data, num_bytes);
+    ring->staged += num_bytes;
+    return REG_SUCCESS;
+  }
+
+  if(ring->staged == 0 && num_bytes == 0) return REG_SUCCESS;
+
+  uring_request_init(&req, IORING_OP_SENDMSG, fd,
+		     ring->staging, ring->staged);
+  req.iov[1].iov_base = (void*) data;
+  req.iov[1].iov_len = num_bytes;
+  req.num_iov = 2;
+  ring->staged = 0;
+
+  return uring_run(ring, &req, 1);
+}
+
+/*---------------------------------------------------*/
+
+int Uring_recv(uring_type*  ring,
+	       const int    fd,
+	       void*        data,
+	       const size_t num_bytes) {
+  uring_request_type req;
+
+  uring_request_init(&req, IORING_OP_RECV, fd, data, num_bytes);
+
+  if(uring_run(ring, &req, 1) != REG_SUCCESS) return -1;
+
+  return (int) req.done;
+}
+
+/*---------------------------------------------------*/
+
+void Uring_discard(uring_type* ring) {
+  ring->staged = 0;
+}
+
+#else /* REG_HAS_IO_URING */
+
+/*---------------------------------------------------*/
+
+int Uring_init(uring_type*    ring,
+	       const unsigned entries,
+	       const size_t   staging_size) {
+  fprintf(stderr, "STEER: Uring_init: io_uring is not available in "
+	  "this build\n");
+  return REG_FAILURE;
+}
+
+void Uring_finalize(uring_type* ring) {}
+
+int Uring_write(uring_type*              ring,
+		const int                fd,
+		const unsigned long long offset,
+		const void*              data,
+		const size_t             num_bytes) {
+  return REG_FAILURE;
+}
+
+int Uring_send(uring_type*  ring,
+	       const int    fd,
+	       const void*  data,
+	       const size_t num_bytes,
+	       const int    more) {
+  return REG_FAILURE;
+}
+
+int Uring_recv(uring_type*  ring,
+	       const int    fd,
+	       void*        data,
+	       const size_t num_bytes) {
+  return -1;
+}
+
+int Uring_flush(uring_type* ring) {
+  return REG_FAILURE;
+}
+
+void Uring_discard(uring_type* ring) {}
+
+#endif /* REG_HAS_IO_URING */
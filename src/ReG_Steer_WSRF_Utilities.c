@@ -386,8 +386,8 @@ int Get_IOTypes(const char                     *address,
   cur = cur->xmlChildrenNode->xmlChildrenNode;
 
   msg = New_msg_struct();
-  msg->io_def = New_io_def_struct();
-  parseIOTypeDef(doc, cur, msg->io_def);
+  msg->io_def = New_io_def_struct(msg->arena);
+  parseIOTypeDef(doc, cur, msg->arena, msg->io_def);
 
   if(!(ioPtr = msg->io_def->first_io)) {
     fprintf(stderr, "ERROR: Get_IOTypes: Got no IOType definitions from %s\n",
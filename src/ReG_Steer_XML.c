@@ -56,6 +56,7 @@
 #include "ReG_Steer_types.h"
 #include "ReG_Steer_Common.h"
 #include "ReG_Steer_XML.h"
+#include "ReG_Steer_SAX.h"
 #include "ReG_Steer_Browser.h"
 #include "ReG_Steer_Steerside.h"
 
@@ -66,22 +67,68 @@ extern struct msg_store_struct *Msg_store_tail;
 /** Declared in ReG_Steer_Appside.c */
 extern struct msg_uid_history_struct Msg_uid_store;
 
+/** Arenas of deleted messages, ready to be reused */
+static Msg_arena_type *Msg_arena_free_list = NULL;
+/** No. of arenas on Msg_arena_free_list */
+static int Num_free_msg_arenas = 0;
+
+/** No. of Init_xml_parser calls not yet matched by a cleanup */
+static int Xml_parser_users = 0;
+
 #if REG_VALIDATE_XML
 /* The schema to validate against, compiled into the library */
 extern unsigned int reg_steer_comm_xsd_len;
 extern unsigned char reg_steer_comm_xsd[];
+
+/** The compiled schema and the context used to validate each
+    message against it */
+static xmlSchemaPtr          Xml_schema = NULL;
+static xmlSchemaValidCtxtPtr Xml_schema_valid = NULL;
+/** Validate every Nth message; 0 turns validation off */
+static int                   Xml_validate_every = 1;
+/** No. of messages seen since the last one validated */
+static int                   Xml_validate_count = 0;
 #endif
 
 /*-----------------------------------------------------------------*/
 
 void Init_xml_parser() {
+#if REG_VALIDATE_XML
+  char *pchar;
+#endif
+
+  /* An application may also be a steering client, so only set
+     things up the first time round */
+  if(Xml_parser_users++ > 0) return;
+
   xmlInitParser();
   xmlInitThreads();
+
+#if REG_VALIDATE_XML
+  if((pchar = getenv("REG_VALIDATE_XML_EVERY"))) {
+    Xml_validate_every = atoi(pchar);
+    if(Xml_validate_every < 0) Xml_validate_every = 0;
+  }
+  Xml_validate_count = 0;
+
+  if(Xml_validate_every > 0) {
+    Load_xml_schema();
+  }
+#endif
 }
 
 /*-----------------------------------------------------------------*/
 
 void Cleanup_xml_parser() {
+  if(Xml_parser_users == 0 || --Xml_parser_users > 0) return;
+
+  Cleanup_sax_parser();
+  Free_msg_arenas();
+#if REG_VALIDATE_XML
+  /* Must go before xmlCleanupParser as the schema holds on to
+     libxml2's global state */
+  Free_xml_schema();
+#endif
   xmlCleanupParser();
 }
 
@@ -92,6 +139,15 @@ int Parse_xml_file(char* filename, struct msg_struct *msg,
 {
   xmlDocPtr doc;
 
+#if REG_USE_SAX_PARSER
+  /* Steering messages are parsed in one pass; anything else
+     still needs the whole document */
+  if(msg){
+    int status = Parse_sax_file(filename, msg, sim);
+    if(status != REG_UNFINISHED) return status;
+  }
+#endif
+
   doc = xmlParseFile(filename);
 
   if (doc == NULL){
@@ -116,6 +172,15 @@ int Parse_xml_buf(char* buf, int size, struct msg_struct *msg,
     return REG_FAILURE;
   }
 
+#if REG_USE_SAX_PARSER
+  /* Steering messages are parsed in one pass; anything else
+     still needs the whole document */
+  if(msg){
+    int status = Parse_sax_buf(buf, size, msg, sim);
+    if(status != REG_UNFINISHED) return status;
+  }
+#endif
+
 #if defined(REG_DEBUG_FULL) || !REG_HAS_XMLREADMEMORY
   doc = xmlParseMemory(buf, size);
 #else
@@ -220,30 +285,77 @@ int Parse_xml(xmlDocPtr doc, struct msg_struct *msg,
 }
 
 #if REG_VALIDATE_XML
-int Validate_xml(xmlDocPtr doc) {
+int Load_xml_schema() {
   xmlSchemaParserCtxtPtr schema_ctxt;
-  xmlSchemaValidCtxtPtr schema_valid;
-  xmlSchemaPtr schema;
-  int result = REG_SUCCESS;
 
-  /* Have to reload the schema each time. Can't simply load it
-     once then reuse it for some reason. */
-  schema_ctxt = xmlSchemaNewMemParserCtxt(reg_steer_comm_xsd,
-					  reg_steer_comm_xsd_len);
-  schema = xmlSchemaParse(schema_ctxt);
-  schema_valid = xmlSchemaNewValidCtxt(schema);
+  if(Xml_schema_valid) return REG_SUCCESS;
 
-  if(xmlSchemaValidateDoc(schema_valid, doc) != 0) {
-    fprintf(stderr, "STEER: Validate_xml: message could not be validated "
-	    "against its schema.");
-    result = REG_FAILURE;
+  schema_ctxt = xmlSchemaNewMemParserCtxt((const char *)reg_steer_comm_xsd,
+					  reg_steer_comm_xsd_len);
+  if(!schema_ctxt) {
+    fprintf(stderr, "STEER: Load_xml_schema: failed to create schema "
+	    "parser context\n");
+    return REG_FAILURE;
   }
 
-  xmlSchemaFreeValidCtxt(schema_valid);
-  xmlSchemaFree(schema);
+  Xml_schema = xmlSchemaParse(schema_ctxt);
   xmlSchemaFreeParserCtxt(schema_ctxt);
 
-  return result;
+  if(!Xml_schema) {
+    fprintf(stderr, "STEER: Load_xml_schema: failed to compile schema\n");
+    return REG_FAILURE;
+  }
+
+  if(!(Xml_schema_valid = xmlSchemaNewValidCtxt(Xml_schema))) {
+    fprintf(stderr, "STEER: Load_xml_schema: failed to create schema "
+	    "validation context\n");
+    xmlSchemaFree(Xml_schema);
+    Xml_schema = NULL;
+    return REG_FAILURE;
+  }
+
+  return REG_SUCCESS;
+}
+
+/*-----------------------------------------------------------------*/
+
+void Free_xml_schema() {
+  if(Xml_schema_valid) {
+    xmlSchemaFreeValidCtxt(Xml_schema_valid);
+    Xml_schema_valid = NULL;
+  }
+  if(Xml_schema) {
+    xmlSchemaFree(Xml_schema);
+    Xml_schema = NULL;
+  }
+}
+
+/*-----------------------------------------------------------------*/
+
+int Validate_xml(xmlDocPtr doc) {
+
+  if(Xml_validate_every == 0) return REG_SUCCESS;
+
+  /* Only check a sample of the messages if asked to */
+  if(++Xml_validate_count < Xml_validate_every) return REG_SUCCESS;
+  Xml_validate_count = 0;
+
+  /* Schema failed to compile - we've already complained about
+     that so let the message through */
+  if(!Xml_schema_valid && Load_xml_schema() != REG_SUCCESS) {
+    Xml_validate_every = 0;
+    return REG_SUCCESS;
+  }
+
+  /* The validation context resets itself for each document so
+     can be reused from one message to the next */
+  if(xmlSchemaValidateDoc(Xml_schema_valid, doc) != 0) {
+    fprintf(stderr, "STEER: Validate_xml: message could not be validated "
+	    "against its schema.\n");
+    return REG_FAILURE;
+  }
+
+  return REG_SUCCESS;
 }
 #endif
 
@@ -381,11 +493,11 @@ int parseResourceProperties(xmlDocPtr doc, xmlNodePtr cur,
 	/* Pretend we've received a detach command - aids compatibility
 	   with higher levels of library */
 	curMsg->msg = New_msg_struct();
-	curMsg->msg->control = New_control_struct();
-	curMsg->msg->control->first_cmd = New_cmd_struct();
+	curMsg->msg->control = New_control_struct(curMsg->msg->arena);
+	curMsg->msg->control->first_cmd = New_cmd_struct(curMsg->msg->arena);
 	curMsg->msg->control->cmd = curMsg->msg->control->first_cmd;
-	curMsg->msg->control->cmd->name = (xmlChar *)xmlMalloc(16);
-	sprintf((char *)curMsg->msg->control->first_cmd->name, "DETACH");
+	curMsg->msg->control->cmd->name =
+	  Msg_arena_strndup(curMsg->msg->arena, (const xmlChar *)"DETACH", -1);
 
 	curMsg->next = New_msg_store_struct();
 	curMsg = curMsg->next;
@@ -430,7 +542,8 @@ int parseSteerMessage(xmlDocPtr doc, xmlNodePtr cur,
   }
 
   /* Get the msg UID if present */
-  if((msg->msg_uid = xmlGetProp(cur, (const xmlChar*) "UID"))) {
+  if((msg->msg_uid = Msg_arena_take_string(msg->arena,
+			   xmlGetProp(cur, (const xmlChar*) "UID")))) {
 #ifdef REG_DEBUG_FULL
     fprintf(stderr, "STEER: INFO: parseSteerMessage: msg UID = %s\n",
 	    (char*)(msg->msg_uid));
@@ -477,8 +590,8 @@ int parseSteerMessage(xmlDocPtr doc, xmlNodePtr cur,
     fprintf(stderr, "STEER: INFO: parseSteerMessage: Calling "
 	    "parseStatus...\n");
 #endif
-    msg->status = New_status_struct();
-    parseStatus(doc, cur, msg->status);
+    msg->status = New_status_struct(msg->arena);
+    parseStatus(doc, cur, msg->arena, msg->status);
     break;
 
   case CONTROL:
@@ -486,8 +599,8 @@ int parseSteerMessage(xmlDocPtr doc, xmlNodePtr cur,
     fprintf(stderr, "STEER: INFO: parseSteerMessage: Calling "
 	    "parseControl...\n");
 #endif
-    msg->control = New_control_struct();
-    parseControl(doc, cur, msg->control);
+    msg->control = New_control_struct(msg->arena);
+    parseControl(doc, cur, msg->arena, msg->control);
    break;
 
   case SUPP_CMDS:
@@ -495,8 +608,8 @@ int parseSteerMessage(xmlDocPtr doc, xmlNodePtr cur,
     fprintf(stderr, "STEER: INFO: parseSteerMessage: Calling "
 	    "parseSuppCmd...\n");
 #endif
-    msg->supp_cmd = New_supp_cmd_struct();
-    parseSuppCmd(doc, cur, msg->supp_cmd);
+    msg->supp_cmd = New_supp_cmd_struct(msg->arena);
+    parseSuppCmd(doc, cur, msg->arena, msg->supp_cmd);
     break;
 
   case PARAM_DEFS:
@@ -506,8 +619,8 @@ int parseSteerMessage(xmlDocPtr doc, xmlNodePtr cur,
 #endif
     /* Use code for 'status' messages because one
        encapsulates the other */
-    msg->status = New_status_struct();
-    parseStatus(doc, cur, msg->status);
+    msg->status = New_status_struct(msg->arena);
+    parseStatus(doc, cur, msg->arena, msg->status);
     break;
 
   case IO_DEFS:
@@ -515,8 +628,8 @@ int parseSteerMessage(xmlDocPtr doc, xmlNodePtr cur,
     fprintf(stderr, "STEER: INFO: parseSteerMessage: Calling "
 	    "parseIOTypeDef...\n");
 #endif
-    msg->io_def = New_io_def_struct();
-    parseIOTypeDef(doc, cur, msg->io_def);
+    msg->io_def = New_io_def_struct(msg->arena);
+    parseIOTypeDef(doc, cur, msg->arena, msg->io_def);
     break;
 
   case CHK_DEFS:
@@ -524,16 +637,16 @@ int parseSteerMessage(xmlDocPtr doc, xmlNodePtr cur,
     fprintf(stderr, "STEER: INFO: parseSteerMessage: Calling "
 	    "parseChkTypeDef...\n");
 #endif
-    msg->chk_def = New_io_def_struct();
-    parseChkTypeDef(doc, cur, msg->chk_def);
+    msg->chk_def = New_io_def_struct(msg->arena);
+    parseChkTypeDef(doc, cur, msg->arena, msg->chk_def);
     break;
 
   case STEER_LOG:
 #ifdef REG_DEBUG_FULL
     fprintf(stderr, "STEER: INFO: parseSteerMessage: Calling parseLog...\n");
 #endif
-    msg->log = New_log_struct();
-    parseLog(doc, cur, msg->log);
+    msg->log = New_log_struct(msg->arena);
+    parseLog(doc, cur, msg->arena, msg->log);
     break;
 
   default:
@@ -548,7 +661,8 @@ int parseSteerMessage(xmlDocPtr doc, xmlNodePtr cur,
 
 /*-----------------------------------------------------------------*/
 
-int parseStatus(xmlDocPtr doc, xmlNodePtr cur, struct status_struct *status) {
+int parseStatus(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
+		struct status_struct *status) {
 
   if(status == NULL){
     return REG_FAILURE;
@@ -561,35 +675,35 @@ int parseStatus(xmlDocPtr doc, xmlNodePtr cur, struct status_struct *status) {
 
       if( !status->first_param ){
 
-	status->first_param = New_param_struct();
+	status->first_param = New_param_struct(arena);
 	status->param = status->first_param;
       }
       else{
-        status->param->next = New_param_struct();
+        status->param->next = New_param_struct(arena);
         status->param = status->param->next;
       }
 
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: Calling parseParam...\n");
 #endif
-      parseParam(doc, cur, status->param);
+      parseParam(doc, cur, arena, status->param);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Command") ){
 
       if( !status->first_cmd ){
 
-	status->first_cmd = New_cmd_struct();
+	status->first_cmd = New_cmd_struct(arena);
 	status->cmd = status->first_cmd;
       }
       else{
-	status->cmd->next = New_cmd_struct();
+	status->cmd->next = New_cmd_struct(arena);
 	status->cmd = status->cmd->next;
       }
 
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: Calling parseCmd...\n");
 #endif
-      parseCmd(doc, cur, status->cmd);
+      parseCmd(doc, cur, arena, status->cmd);
     }
 
     cur = cur->next;
@@ -599,7 +713,8 @@ int parseStatus(xmlDocPtr doc, xmlNodePtr cur, struct status_struct *status) {
 
 /*-----------------------------------------------------------------*/
 
-int parseControl(xmlDocPtr doc, xmlNodePtr cur, struct control_struct *ctrl) {
+int parseControl(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
+		 struct control_struct *ctrl) {
   if(!ctrl){
     return REG_FAILURE;
   }
@@ -610,41 +725,41 @@ int parseControl(xmlDocPtr doc, xmlNodePtr cur, struct control_struct *ctrl) {
 
     if( !xmlStrcmp(cur->name, (const xmlChar *) "Valid_after") ){
 
-      ctrl->valid_after = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      ctrl->valid_after = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Param") ){
 
       if( !ctrl->first_param ){
 
-	ctrl->first_param = New_param_struct();
+	ctrl->first_param = New_param_struct(arena);
 	ctrl->param = ctrl->first_param;
       }
       else{
-        ctrl->param->next = New_param_struct();
+        ctrl->param->next = New_param_struct(arena);
         ctrl->param = ctrl->param->next;
       }
 
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: Calling parseParam...\n");
 #endif
-      parseParam(doc, cur, ctrl->param);
+      parseParam(doc, cur, arena, ctrl->param);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Command") ){
 
       if( !ctrl->first_cmd ){
 
-	ctrl->first_cmd = New_cmd_struct();
+	ctrl->first_cmd = New_cmd_struct(arena);
 	ctrl->cmd = ctrl->first_cmd;
       }
       else{
-	ctrl->cmd->next = New_cmd_struct();
+	ctrl->cmd->next = New_cmd_struct(arena);
 	ctrl->cmd = ctrl->cmd->next;
       }
 
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: Calling parseCmd...\n");
 #endif
-      parseCmd(doc, cur, ctrl->cmd);
+      parseCmd(doc, cur, arena, ctrl->cmd);
     }
 
     cur = cur->next;
@@ -655,7 +770,7 @@ int parseControl(xmlDocPtr doc, xmlNodePtr cur, struct control_struct *ctrl) {
 
 /*-----------------------------------------------------------------*/
 
-int parseIOTypeDef(xmlDocPtr doc, xmlNodePtr cur,
+int parseIOTypeDef(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
 		   struct io_def_struct *io_def) {
 
   if(!io_def){
@@ -671,18 +786,18 @@ int parseIOTypeDef(xmlDocPtr doc, xmlNodePtr cur,
 
       if(!io_def->first_io){
 
-	io_def->first_io = New_io_struct();
+	io_def->first_io = New_io_struct(arena);
 	io_def->io = io_def->first_io;
       }
       else{
-	io_def->io->next = New_io_struct();
+	io_def->io->next = New_io_struct(arena);
 	io_def->io = io_def->io->next;
       }
 
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: parseIOTypeDef: Calling parseIOType...\n");
 #endif
-      parseIOType(doc, cur, io_def->io);
+      parseIOType(doc, cur, arena, io_def->io);
     }
 
     cur = cur->next;
@@ -693,7 +808,7 @@ int parseIOTypeDef(xmlDocPtr doc, xmlNodePtr cur,
 
 /*-----------------------------------------------------------------*/
 
-int parseChkTypeDef(xmlDocPtr doc, xmlNodePtr cur,
+int parseChkTypeDef(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
 		    struct io_def_struct *chk_def) {
 
   if(!chk_def){
@@ -709,18 +824,18 @@ int parseChkTypeDef(xmlDocPtr doc, xmlNodePtr cur,
 
       if(!chk_def->first_io){
 
-	chk_def->first_io = New_io_struct();
+	chk_def->first_io = New_io_struct(arena);
 	chk_def->io = chk_def->first_io;
       }
       else{
-	chk_def->io->next = New_io_struct();
+	chk_def->io->next = New_io_struct(arena);
 	chk_def->io = chk_def->io->next;
       }
 
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: parseChkTypeDef: Calling parseIOType...\n");
 #endif
-      parseIOType(doc, cur, chk_def->io);
+      parseIOType(doc, cur, arena, chk_def->io);
     }
 
     cur = cur->next;
@@ -731,7 +846,8 @@ int parseChkTypeDef(xmlDocPtr doc, xmlNodePtr cur,
 
 /*-----------------------------------------------------------------*/
 
-int parseIOType(xmlDocPtr doc, xmlNodePtr cur, struct io_struct *io) {
+int parseIOType(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
+		struct io_struct *io) {
   if(!io){
 
     return REG_FAILURE;
@@ -742,19 +858,19 @@ int parseIOType(xmlDocPtr doc, xmlNodePtr cur, struct io_struct *io) {
 
     if( !xmlStrcmp(cur->name, (const xmlChar *) "Handle") ) {
 
-      io->handle = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      io->handle = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Label") ){
 
-      io->label = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      io->label = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Direction") ){
 
-      io->direction = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      io->direction = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Freq_handle") ){
 
-      io->freq_handle = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      io->freq_handle = Msg_arena_node_string(arena, doc, cur);
     }
 
     cur = cur->next;
@@ -765,7 +881,7 @@ int parseIOType(xmlDocPtr doc, xmlNodePtr cur, struct io_struct *io) {
 
 /*-----------------------------------------------------------------*/
 
-int parseSuppCmd(xmlDocPtr doc, xmlNodePtr cur,
+int parseSuppCmd(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
 		 struct supp_cmd_struct *supp_cmd) {
   if(supp_cmd == NULL){
     return REG_FAILURE;
@@ -778,18 +894,22 @@ int parseSuppCmd(xmlDocPtr doc, xmlNodePtr cur,
 
       if( !supp_cmd->first_cmd ){
 
-	supp_cmd->first_cmd = New_cmd_struct();
+	supp_cmd->first_cmd = New_cmd_struct(arena);
 	supp_cmd->cmd = supp_cmd->first_cmd;
       }
       else{
-	supp_cmd->cmd->next = New_cmd_struct();
+	supp_cmd->cmd->next = New_cmd_struct(arena);
 	supp_cmd->cmd = supp_cmd->cmd->next;
       }
 
 #ifdef REG_DEBUG_FULL
       fprintf(stderr, "STEER: parseSuppCmd: Calling parseCmd...\n");
 #endif
-      parseCmd(doc, cur, supp_cmd->cmd);
+      parseCmd(doc, cur, arena, supp_cmd->cmd);
+    }
+    else if( !xmlStrcmp(cur->name, (const xmlChar *) "Wire_format") ){
+
+      supp_cmd->wire_format = Msg_arena_node_string(arena, doc, cur);
     }
 #ifdef REG_DEBUG
     else{
@@ -805,7 +925,8 @@ int parseSuppCmd(xmlDocPtr doc, xmlNodePtr cur,
 
 /*-----------------------------------------------------------------*/
 
-int parseLog(xmlDocPtr doc, xmlNodePtr cur, struct log_struct *log) {
+int parseLog(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
+	     struct log_struct *log) {
   if (!log) return REG_FAILURE;
 
   cur = cur->xmlChildrenNode;
@@ -815,18 +936,18 @@ int parseLog(xmlDocPtr doc, xmlNodePtr cur, struct log_struct *log) {
 
       if(!log->first_entry){
 
-	log->first_entry = New_log_entry_struct();
+	log->first_entry = New_log_entry_struct(arena);
 	log->entry = log->first_entry;
       }
       else{
-	log->entry->next = New_log_entry_struct();
+	log->entry->next = New_log_entry_struct(arena);
 	log->entry = log->entry->next;
       }
 
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: parseLog: calling parseLogEntry\n");
 #endif
-      parseLogEntry(doc, cur, log->entry);
+      parseLogEntry(doc, cur, arena, log->entry);
 
     }
     cur = cur->next;
@@ -837,7 +958,8 @@ int parseLog(xmlDocPtr doc, xmlNodePtr cur, struct log_struct *log) {
 
 /*-----------------------------------------------------------------*/
 
-int parseLogEntry(xmlDocPtr doc, xmlNodePtr cur, struct log_entry_struct *log) {
+int parseLogEntry(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
+		  struct log_entry_struct *log) {
   int return_status = REG_SUCCESS;
 
   if(!log) return REG_FAILURE;
@@ -847,39 +969,38 @@ int parseLogEntry(xmlDocPtr doc, xmlNodePtr cur, struct log_entry_struct *log) {
 
     if( !xmlStrcmp(cur->name, (const xmlChar *)"Key") ){
 
-      log->key = xmlNodeListGetString(doc,
-				      cur->xmlChildrenNode, 1);
+      log->key = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *)"Chk_log_entry") ){
       if(!log->first_chk_log){
 
-	log->first_chk_log = New_chk_log_entry_struct();
+	log->first_chk_log = New_chk_log_entry_struct(arena);
 	log->chk_log = log->first_chk_log;
       }
       else{
-	log->chk_log->next = New_chk_log_entry_struct();
+	log->chk_log->next = New_chk_log_entry_struct(arena);
 	log->chk_log = log->chk_log->next;
       }
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: parseLogEntry: calling parseChkLogEntry\n");
 #endif
-      return_status = parseChkLogEntry(doc, cur, log->chk_log);
+      return_status = parseChkLogEntry(doc, cur, arena, log->chk_log);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *)"Param") ){
       if(!log->first_param_log){
 
-	log->first_param_log = New_param_struct();
+	log->first_param_log = New_param_struct(arena);
 	log->param_log = log->first_param_log;
       }
       else{
-	log->param_log->next = New_param_struct();
+	log->param_log->next = New_param_struct(arena);
 	log->param_log = log->param_log->next;
       }
 
 #ifdef REG_DEBUG
       fprintf(stderr, "STEER: parseLogEntry: calling parseParam\n");
 #endif
-      return_status = parseParam(doc, cur, log->param_log);
+      return_status = parseParam(doc, cur, arena, log->param_log);
     }
 
     cur = cur->next;
@@ -889,7 +1010,7 @@ int parseLogEntry(xmlDocPtr doc, xmlNodePtr cur, struct log_entry_struct *log) {
 
 /*-----------------------------------------------------------------*/
 
-int parseChkLogEntry(xmlDocPtr doc, xmlNodePtr cur,
+int parseChkLogEntry(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
 		     struct chk_log_entry_struct *log_entry) {
   int return_status = REG_SUCCESS;
 
@@ -900,27 +1021,25 @@ int parseChkLogEntry(xmlDocPtr doc, xmlNodePtr cur,
 
     if(!xmlStrcmp(cur->name, (const xmlChar *)"Chk_handle") ){
 
-      log_entry->chk_handle = xmlNodeListGetString(doc,
-					    cur->xmlChildrenNode, 1);
+      log_entry->chk_handle = Msg_arena_node_string(arena, doc, cur);
     }
     else if(!xmlStrcmp(cur->name, (const xmlChar *)"Chk_tag")){
 
-      log_entry->chk_tag = xmlNodeListGetString(doc,
-					      cur->xmlChildrenNode, 1);
+      log_entry->chk_tag = Msg_arena_node_string(arena, doc, cur);
     }
     else if(!xmlStrcmp(cur->name, (const xmlChar *)"Param")){
 
       if(!log_entry->first_param){
 
-	log_entry->first_param = New_param_struct();
+	log_entry->first_param = New_param_struct(arena);
 	log_entry->param = log_entry->first_param;
       }
       else{
-	log_entry->param->next = New_param_struct();
+	log_entry->param->next = New_param_struct(arena);
 	log_entry->param = log_entry->param->next;
       }
 
-      return_status = parseParam(doc, cur, log_entry->param);
+      return_status = parseParam(doc, cur, arena, log_entry->param);
     }
 
     cur = cur->next;
@@ -931,7 +1050,8 @@ int parseChkLogEntry(xmlDocPtr doc, xmlNodePtr cur,
 
 /*-----------------------------------------------------------------*/
 
-int parseParam(xmlDocPtr doc, xmlNodePtr cur, struct param_struct *param) {
+int parseParam(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
+	       struct param_struct *param) {
   if(param == NULL){
 
     return REG_FAILURE;
@@ -942,35 +1062,35 @@ int parseParam(xmlDocPtr doc, xmlNodePtr cur, struct param_struct *param) {
 
     if( !xmlStrcmp(cur->name, (const xmlChar *)"Handle") ){
 
-      param->handle = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      param->handle = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Label") ){
 
-      param->label = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      param->label = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Value") ){
 
-      param->value = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      param->value = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Steerable") ){
 
-      param->steerable = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      param->steerable = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Type") ){
 
-      param->type = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      param->type = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Is_internal") ){
 
-      param->is_internal = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      param->is_internal = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Min_value") ){
 
-      param->min_val = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      param->min_val = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Max_value") ){
 
-      param->max_val = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      param->max_val = Msg_arena_node_string(arena, doc, cur);
     }
 
     cur = cur->next;
@@ -981,7 +1101,8 @@ int parseParam(xmlDocPtr doc, xmlNodePtr cur, struct param_struct *param) {
 
 /*-----------------------------------------------------------------*/
 
-int parseCmd(xmlDocPtr doc, xmlNodePtr cur, struct cmd_struct *cmd) {
+int parseCmd(xmlDocPtr doc, xmlNodePtr cur, Msg_arena_type *arena,
+	     struct cmd_struct *cmd) {
   if(!cmd){
     return REG_FAILURE;
   }
@@ -992,25 +1113,25 @@ int parseCmd(xmlDocPtr doc, xmlNodePtr cur, struct cmd_struct *cmd) {
 
     if( !xmlStrcmp(cur->name, (const xmlChar *) "Cmd_id") ){
 
-      cmd->id = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      cmd->id = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Cmd_name") ){
 
-      cmd->name = xmlNodeListGetString(doc, cur->xmlChildrenNode, 1);
+      cmd->name = Msg_arena_node_string(arena, doc, cur);
     }
     else if( !xmlStrcmp(cur->name, (const xmlChar *) "Cmd_param") ){
 
       if(cmd->first_param){
 
-	cmd->param->next = New_param_struct();
+	cmd->param->next = New_param_struct(arena);
         cmd->param = cmd->param->next;
       }
       else{
-	cmd->first_param = New_param_struct();
+	cmd->first_param = New_param_struct(arena);
 	cmd->param = cmd->first_param;
       }
 
-      parseParam(doc, cur, cmd->param);
+      parseParam(doc, cur, arena, cmd->param);
     }
 
     cur = cur->next;
@@ -1040,10 +1161,13 @@ struct msg_store_struct *New_msg_store_struct()
 
 struct msg_struct *New_msg_struct()
 {
-
+  Msg_arena_type    *arena;
   struct msg_struct *msg;
 
-  msg = (struct msg_struct *)malloc(sizeof(struct msg_struct));
+  if( !(arena = New_msg_arena()) ) return NULL;
+
+  msg = (struct msg_struct *)Msg_arena_alloc(arena,
+					     sizeof(struct msg_struct));
 
   if(msg){
 
@@ -1055,6 +1179,10 @@ struct msg_struct *New_msg_struct()
     msg->io_def   = NULL;
     msg->chk_def  = NULL;
     msg->log      = NULL;
+    msg->arena    = arena;
+  }
+  else{
+    Release_msg_arena(arena);
   }
 
   return msg;
@@ -1062,11 +1190,12 @@ struct msg_struct *New_msg_struct()
 
 /*-----------------------------------------------------------------*/
 
-struct status_struct *New_status_struct()
+struct status_struct *New_status_struct(Msg_arena_type *arena)
 {
   struct status_struct *status;
 
-  status = (struct status_struct *)malloc(sizeof(struct status_struct));
+  status = (struct status_struct *)Msg_arena_alloc(arena,
+					sizeof(struct status_struct));
 
   if(status){
 
@@ -1082,11 +1211,12 @@ struct status_struct *New_status_struct()
 
 /*-----------------------------------------------------------------*/
 
-struct control_struct *New_control_struct()
+struct control_struct *New_control_struct(Msg_arena_type *arena)
 {
   struct control_struct *ctrl;
 
-  ctrl = (struct control_struct *)malloc(sizeof(struct control_struct));
+  ctrl = (struct control_struct *)Msg_arena_alloc(arena,
+					sizeof(struct control_struct));
 
   if(ctrl){
     ctrl->valid_after = NULL;
@@ -1100,11 +1230,12 @@ struct control_struct *New_control_struct()
 }
 /*-----------------------------------------------------------------*/
 
-struct io_def_struct *New_io_def_struct()
+struct io_def_struct *New_io_def_struct(Msg_arena_type *arena)
 {
   struct io_def_struct *io_def;
 
-  io_def = (struct io_def_struct *)malloc(sizeof(struct io_def_struct));
+  io_def = (struct io_def_struct *)Msg_arena_alloc(arena,
+					sizeof(struct io_def_struct));
 
   if(io_def){
 
@@ -1117,11 +1248,11 @@ struct io_def_struct *New_io_def_struct()
 
 /*-----------------------------------------------------------------*/
 
-struct io_struct *New_io_struct()
+struct io_struct *New_io_struct(Msg_arena_type *arena)
 {
   struct io_struct *io;
 
-  io = (struct io_struct *)malloc(sizeof(struct io_struct));
+  io = (struct io_struct *)Msg_arena_alloc(arena, sizeof(struct io_struct));
 
   if(io){
 
@@ -1137,11 +1268,12 @@ struct io_struct *New_io_struct()
 
 /*-----------------------------------------------------------------*/
 
-struct param_struct *New_param_struct()
+struct param_struct *New_param_struct(Msg_arena_type *arena)
 {
   struct param_struct *param;
 
-  param = (struct param_struct *)malloc(sizeof(struct param_struct));
+  param = (struct param_struct *)Msg_arena_alloc(arena,
+					sizeof(struct param_struct));
 
   if(param){
     param->handle = NULL;
@@ -1160,16 +1292,18 @@ struct param_struct *New_param_struct()
 
 /*-----------------------------------------------------------------*/
 
-struct supp_cmd_struct *New_supp_cmd_struct()
+struct supp_cmd_struct *New_supp_cmd_struct(Msg_arena_type *arena)
 {
   struct supp_cmd_struct *supp_cmd;
 
-  supp_cmd = (struct supp_cmd_struct *)malloc(sizeof(struct supp_cmd_struct));
+  supp_cmd = (struct supp_cmd_struct *)Msg_arena_alloc(arena,
+					sizeof(struct supp_cmd_struct));
 
   if(supp_cmd){
 
-    supp_cmd->cmd       = NULL;
-    supp_cmd->first_cmd = NULL;
+    supp_cmd->cmd         = NULL;
+    supp_cmd->first_cmd   = NULL;
+    supp_cmd->wire_format = NULL;
   }
 
   return supp_cmd;
@@ -1177,11 +1311,12 @@ struct supp_cmd_struct *New_supp_cmd_struct()
 
 /*-----------------------------------------------------------------*/
 
-struct cmd_struct *New_cmd_struct()
+struct cmd_struct *New_cmd_struct(Msg_arena_type *arena)
 {
   struct cmd_struct *cmd;
 
-  cmd = (struct cmd_struct *)malloc(sizeof(struct cmd_struct));
+  cmd = (struct cmd_struct *)Msg_arena_alloc(arena,
+					     sizeof(struct cmd_struct));
 
   if(cmd){
 
@@ -1197,11 +1332,12 @@ struct cmd_struct *New_cmd_struct()
 
 /*-----------------------------------------------------------------*/
 
-struct log_struct *New_log_struct()
+struct log_struct *New_log_struct(Msg_arena_type *arena)
 {
   struct log_struct *log;
 
-  log = (struct log_struct *)malloc(sizeof(struct log_struct));
+  log = (struct log_struct *)Msg_arena_alloc(arena,
+					     sizeof(struct log_struct));
 
   if(log){
 
@@ -1214,12 +1350,12 @@ struct log_struct *New_log_struct()
 
 /*-----------------------------------------------------------------*/
 
-struct log_entry_struct *New_log_entry_struct()
+struct log_entry_struct *New_log_entry_struct(Msg_arena_type *arena)
 {
   struct log_entry_struct *entry;
 
   entry = (struct log_entry_struct *)
-                      malloc(sizeof(struct log_entry_struct));
+                      Msg_arena_alloc(arena, sizeof(struct log_entry_struct));
 
   if(entry){
 
@@ -1238,12 +1374,12 @@ struct log_entry_struct *New_log_entry_struct()
 
 /*-----------------------------------------------------------------*/
 
-struct chk_log_entry_struct *New_chk_log_entry_struct()
+struct chk_log_entry_struct *New_chk_log_entry_struct(Msg_arena_type *arena)
 {
   struct chk_log_entry_struct *entry;
 
   entry = (struct chk_log_entry_struct *)
-                      malloc(sizeof(struct chk_log_entry_struct));
+               Msg_arena_alloc(arena, sizeof(struct chk_log_entry_struct));
 
   if(entry){
 
@@ -1264,238 +1400,207 @@ void Delete_msg_struct(struct msg_struct **msgIn)
   struct msg_struct *msg = *msgIn;
   if (!msg) return;
 
-  if(msg->msg_uid){
-    xmlFree(msg->msg_uid);
-    msg->msg_uid = NULL;
-  }
-
-  if(msg->status){
-
-    Delete_status_struct(msg->status);
-    msg->status = NULL;
-  }
-
-  if(msg->control){
-
-    Delete_control_struct(msg->control);
-    msg->control = NULL;
-  }
-
-  if(msg->supp_cmd){
-
-    Delete_supp_cmd_struct(msg->supp_cmd);
-    msg->supp_cmd = NULL;
-  }
-
-  if(msg->io_def){
-
-    Delete_io_def_struct(msg->io_def);
-    msg->io_def = NULL;
-  }
-
-  if(msg->chk_def){
-
-    Delete_io_def_struct(msg->chk_def);
-    msg->chk_def = NULL;
-  }
-
-  if(msg->log){
-
-    Delete_log_struct(msg->log);
-    msg->log = NULL;
-  }
-
-  free(*msgIn);
+  /* Everything, including the msg_struct itself, is in the arena */
+  Release_msg_arena(msg->arena);
   *msgIn = NULL;
 }
 
 /*-----------------------------------------------------------------*/
 
-void Delete_status_struct(struct status_struct *status)
+Msg_arena_type *New_msg_arena()
 {
-  if (!status) return;
+  Msg_arena_type *arena;
 
-  if(status->first_param){
+  if(Msg_arena_free_list){
 
-    Delete_param_struct(status->first_param);
-    status->first_param = NULL;
-    status->param       = NULL;
+    arena = Msg_arena_free_list;
+    Msg_arena_free_list = arena->next_free;
+    Num_free_msg_arenas--;
+    arena->next_free = NULL;
+    return arena;
   }
 
-  if(status->first_cmd){
+  /* The arena and its first block share one allocation */
+  arena = (Msg_arena_type *)malloc(REG_MSG_ARENA_ROUND(sizeof(Msg_arena_type))
+				   + REG_MSG_ARENA_HDR
+				   + REG_MSG_ARENA_BLOCK_SIZE);
+  if(!arena){
 
-    Delete_cmd_struct(status->first_cmd);
-    status->first_cmd = NULL;
-    status->cmd       = NULL;
+    fprintf(stderr, "STEER: New_msg_arena: malloc failed\n");
+    return NULL;
   }
 
-  free(status);
+  arena->first = (Msg_arena_block_type *)((char *)arena +
+			 REG_MSG_ARENA_ROUND(sizeof(Msg_arena_type)));
+  arena->first->next = NULL;
+  arena->first->size = REG_MSG_ARENA_BLOCK_SIZE;
+  arena->first->used = 0;
+  arena->cur = arena->first;
+  arena->next_free = NULL;
+
+  return arena;
 }
 
 /*-----------------------------------------------------------------*/
 
-void Delete_control_struct(struct control_struct *ctrl)
+void Release_msg_arena(Msg_arena_type *arena)
 {
-  if (!ctrl) return;
-
-  if (ctrl->valid_after) xmlFree(ctrl->valid_after);
-
-  if(ctrl->first_param){
+  Msg_arena_block_type *block;
+  Msg_arena_block_type *next;
+  size_t                total = 0;
 
-    Delete_param_struct(ctrl->first_param);
-    ctrl->first_param = NULL;
-    ctrl->param       = NULL;
-  }
+  if(!arena) return;
 
-  if(ctrl->first_cmd){
+  for(block = arena->first; block; block = block->next){
 
-    Delete_cmd_struct(ctrl->first_cmd);
-    ctrl->first_cmd = NULL;
-    ctrl->cmd       = NULL;
+    block->used = 0;
+    total += block->size;
   }
+  arena->cur = arena->first;
 
-  free(ctrl);
-}
+  /* Don't hang on to the memory used by one unusually large message */
+  if(total > REG_MSG_ARENA_MAX_RETAINED){
 
-/*-----------------------------------------------------------------*/
+    block = arena->first->next;
+    while(block){
 
-void Delete_supp_cmd_struct(struct supp_cmd_struct *supp_cmd)
-{
-  if (!supp_cmd) return;
+      next = block->next;
+      free(block);
+      block = next;
+    }
+    arena->first->next = NULL;
+  }
 
-  if(supp_cmd->first_cmd){
+  if(Num_free_msg_arenas >= REG_MAX_FREE_MSG_ARENAS){
 
-    Delete_cmd_struct(supp_cmd->first_cmd);
-    supp_cmd->first_cmd = NULL;
-    supp_cmd->cmd       = NULL;
+    Free_msg_arena(arena);
+    return;
   }
 
-  free(supp_cmd);
+  arena->next_free = Msg_arena_free_list;
+  Msg_arena_free_list = arena;
+  Num_free_msg_arenas++;
 }
 
 /*-----------------------------------------------------------------*/
 
-void Delete_cmd_struct(struct cmd_struct *cmd)
+void Free_msg_arena(Msg_arena_type *arena)
 {
-  struct cmd_struct *dum_ptr;
+  Msg_arena_block_type *block;
+  Msg_arena_block_type *next;
 
-  while(cmd){
+  if(!arena) return;
 
-    if(cmd->id) xmlFree(cmd->id);
-    if(cmd->name) xmlFree(cmd->name);
+  /* The first block was allocated along with the arena */
+  block = arena->first->next;
+  while(block){
 
-    if(cmd->first_param){
-      Delete_param_struct(cmd->first_param);
-      cmd->first_param = NULL;
-      cmd->param       = NULL;
-    }
-
-    dum_ptr = cmd->next;
-    free(cmd);
-    cmd = dum_ptr;
+    next = block->next;
+    free(block);
+    block = next;
   }
+
+  free(arena);
 }
 
 /*-----------------------------------------------------------------*/
 
-void Delete_io_def_struct(struct io_def_struct *io_def)
+void Free_msg_arenas()
 {
-  if(io_def){
+  Msg_arena_type *arena;
+
+  while( (arena = Msg_arena_free_list) ){
 
-    Delete_io_struct(io_def->first_io);
-    free (io_def);
+    Msg_arena_free_list = arena->next_free;
+    Free_msg_arena(arena);
   }
+  Num_free_msg_arenas = 0;
 }
 
 /*-----------------------------------------------------------------*/
 
-void Delete_io_struct(struct io_struct *io)
+void *Msg_arena_alloc(Msg_arena_type *arena, size_t size)
 {
-  struct io_struct *dum_ptr;
+  Msg_arena_block_type *block;
+  size_t                new_size;
+  char                 *ptr;
 
-  while(io){
+  if(!arena) return NULL;
 
-    if(io->label)       xmlFree(io->label);
-    if(io->handle)      xmlFree(io->handle);
-    if(io->direction)   xmlFree(io->direction);
-    if(io->freq_handle) xmlFree(io->freq_handle);
+  size = REG_MSG_ARENA_ROUND(size);
+  block = arena->cur;
 
-    dum_ptr = io->next;
-    free(io);
-    io = dum_ptr;
-  }
-}
+  /* Move on to the next block, allocating it if need be, until one
+     is found with enough room */
+  while(block->used + size > block->size){
 
-/*-----------------------------------------------------------------*/
+    if(!block->next){
 
-void Delete_param_struct(struct param_struct *param)
-{
-  struct param_struct *dum_ptr;
+      new_size = 2*block->size;
+      if(new_size < size) new_size = size;
 
-  while(param){
+      if( !(block->next = (Msg_arena_block_type *)
+	    malloc(REG_MSG_ARENA_HDR + new_size)) ){
 
-    if (param->handle)      xmlFree(param->handle);
-    if (param->label)       xmlFree(param->label);
-    if (param->value)       xmlFree(param->value);
-    if (param->type)        xmlFree(param->type);
-    if (param->steerable)   xmlFree(param->steerable);
-    if (param->is_internal) xmlFree(param->is_internal);
-    if (param->min_val)     xmlFree(param->min_val);
-    if (param->max_val)     xmlFree(param->max_val);
-
-    dum_ptr = param->next;
-    free(param);
-    param = dum_ptr;
+	fprintf(stderr, "STEER: Msg_arena_alloc: malloc of %d bytes "
+		"failed\n", (int)new_size);
+	return NULL;
+      }
+      block->next->next = NULL;
+      block->next->size = new_size;
+      block->next->used = 0;
+    }
+    block = block->next;
   }
+  arena->cur = block;
+
+  ptr = (char *)block + REG_MSG_ARENA_HDR + block->used;
+  block->used += size;
+
+  return (void *)ptr;
 }
 
 /*-----------------------------------------------------------------*/
 
-void Delete_chk_log_entry_struct(struct chk_log_entry_struct *log)
+xmlChar *Msg_arena_strndup(Msg_arena_type *arena, const xmlChar *str,
+			   int len)
 {
-  struct chk_log_entry_struct *dum_ptr;
+  xmlChar *copy;
 
-  while(log){
+  if(!str) return NULL;
+  if(len < 0) len = xmlStrlen(str);
 
-    xmlFree(log->chk_handle);
-    xmlFree(log->chk_tag);
+  if( (copy = (xmlChar *)Msg_arena_alloc(arena, (size_t)len + 1)) ){
 
-    Delete_param_struct(log->first_param);
-
-    dum_ptr = log->next;
-    free(log);
-    log = dum_ptr;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
   }
+
+  return copy;
 }
 
 /*-----------------------------------------------------------------*/
 
-void Delete_log_entry_struct(struct log_entry_struct *log)
+xmlChar *Msg_arena_node_string(Msg_arena_type *arena, xmlDocPtr doc,
+			       xmlNodePtr cur)
 {
-  struct log_entry_struct *dum_ptr;
-
-  while(log){
-
-    xmlFree(log->key);
-
-    Delete_chk_log_entry_struct(log->first_chk_log);
-    Delete_param_struct(log->first_param_log);
-
-    dum_ptr = log->next;
-    free(log);
-    log = dum_ptr;
-  }
+  return Msg_arena_take_string(arena,
+			       xmlNodeListGetString(doc, cur->xmlChildrenNode,
+						    1));
 }
 
 /*-----------------------------------------------------------------*/
 
-void Delete_log_struct(struct log_struct *log)
+xmlChar *Msg_arena_take_string(Msg_arena_type *arena, xmlChar *str)
 {
-  if(log){
+  xmlChar *copy;
 
-    Delete_log_entry_struct(log->first_entry);
-    free(log);
-  }
+  if(!str) return NULL;
+
+  copy = Msg_arena_strndup(arena, str, -1);
+  xmlFree(str);
+
+  return copy;
 }
 
 /*-----------------------------------------------------------------*/
@@ -1664,6 +1769,10 @@ void Print_supp_cmd_struct(struct supp_cmd_struct *supp_cmd)
     fprintf(stderr, "STEER: Supported commands:\n");
     Print_cmd_struct(supp_cmd->first_cmd);
   }
+  if(supp_cmd->wire_format){
+    fprintf(stderr, "STEER: Wire format: %s\n",
+	    (char *)(supp_cmd->wire_format));
+  }
 }
 
 /*-----------------------------------------------------------------*/